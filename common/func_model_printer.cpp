@@ -237,12 +237,19 @@ void printer::print(expr_ptr expr, ostream & out)
     }
     else if (auto ext = dynamic_pointer_cast<external>(expr))
     {
-        out << "external ";
-        out << ext->name;
-        out << " :: ";
-        out << '\'';
-        print(ext->type_expr, out);
-        out << '\'';
+        if (ext->is_builtin)
+        {
+            out << ext->name;
+        }
+        else
+        {
+            out << "external ";
+            out << ext->name;
+            out << " :: ";
+            out << '\'';
+            print(ext->type_expr, out);
+            out << '\'';
+        }
     }
     else if (auto type_name = dynamic_pointer_cast<type_name_expr>(expr))
     {
@@ -470,6 +470,7 @@ public:
     virtual expr_ptr visit_external(const shared_ptr<external> & ext) override
     {
         ext->type_expr = visit(ext->type_expr);
+        ext->cost_expr = visit(ext->cost_expr);
         return ext;
     }
     virtual expr_ptr visit_type_name(const shared_ptr<type_name_expr> & tn) override
@@ -0,0 +1,44 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "functional_model.hpp"
+
+namespace stream {
+namespace functional {
+
+static thread_local node_pool * g_current_node_pool = nullptr;
+
+node_pool::node_pool(): m_previous(g_current_node_pool)
+{
+    g_current_node_pool = this;
+}
+
+node_pool::~node_pool()
+{
+    g_current_node_pool = m_previous;
+}
+
+node_pool * node_pool::current()
+{
+    return g_current_node_pool;
+}
+
+}
+}
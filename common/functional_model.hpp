@@ -27,6 +27,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include "module.hpp"
 #include "../frontend/location.hh"
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <utility>
 #include <iostream>
@@ -44,6 +45,50 @@ using std::pair;
 using std::unordered_set;
 typedef code_location location_type;
 
+// Nodes created by repeated copying of expressions
+// (function instantiation, folding, array reduction)
+// are allocated from the pool of the current compilation,
+// rather than individually from the heap.
+// Memory of destroyed nodes is reused for new nodes.
+// A pool is current in its thread while it exists,
+// and it must outlive all nodes allocated from it.
+// Without a current pool, nodes are allocated from the heap.
+// Constants are not copied, but shared between the copies.
+
+class node_pool
+{
+public:
+    node_pool();
+    ~node_pool();
+    node_pool(const node_pool &) = delete;
+    node_pool & operator=(const node_pool &) = delete;
+
+    static node_pool * current();
+
+    std::pmr::memory_resource * resource() { return &m_resource; }
+
+    // Number of nodes allocated from this pool so far.
+    size_t node_count() const { return m_node_count; }
+    void count_node() { ++m_node_count; }
+
+private:
+    std::pmr::unsynchronized_pool_resource m_resource;
+    size_t m_node_count = 0;
+    node_pool * m_previous;
+};
+
+template <typename T, typename ... Args>
+std::shared_ptr<T> make_node(Args && ... args)
+{
+    auto * pool = node_pool::current();
+    if (!pool)
+        return std::make_shared<T>(std::forward<Args>(args)...);
+
+    pool->count_node();
+    return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(pool->resource()),
+                                   std::forward<Args>(args)...);
+}
+
 class var
 {
 public:
@@ -432,8 +477,20 @@ class external : public expression
 {
 public:
     bool is_input = false;
+    // A built-in function implemented by the C++ support library.
+    // It has no type expression: its type is inferred from arguments.
+    bool is_builtin = false;
     string name;
     expr_slot type_expr;
+    // Declared attributes of an external function.
+    // A pure function has no side effects and its result only depends
+    // on its arguments. A thread-safe function may be called concurrently.
+    bool is_pure = false;
+    bool is_thread_safe = false;
+    // Approximate number of operations per call, or 0 if unknown.
+    // The type checker reduces the cost expression to the cost.
+    expr_slot cost_expr;
+    int cost = 0;
 };
 
 class type_name_expr : public expression
@@ -41,6 +41,8 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <memory>
 #include <unordered_map>
 #include <list>
+#include <complex>
+#include <cstdint>
 
 namespace stream {
 namespace polyhedral {
@@ -64,6 +66,15 @@ enum {
     infinite = -1
 };
 
+// Value of an element of an array evaluated by the compiler.
+struct constant_value
+{
+    // Booleans and integers, in two's complement.
+    uint64_t bits = 0;
+    // Real and complex numbers.
+    std::complex<double> number;
+};
+
 class array
 {
 public:
@@ -88,6 +99,10 @@ public:
     int last_period_access = 0;
     bool inter_period_dependency = true;
 #endif
+
+    // Values of elements in row-major order,
+    // if the array is evaluated by the compiler.
+    vector<constant_value> constant_values;
 };
 
 class statement
@@ -135,6 +150,18 @@ public:
     int index;
 };
 
+// Properties of an external function declared by the user.
+// A pure function has no side effects and its result only depends
+// on its arguments. A thread-safe function may be called concurrently.
+// Cost is the approximate number of arithmetic operations per call,
+// or 0 if unknown.
+struct external_attributes
+{
+    bool pure = false;
+    bool thread_safe = false;
+    int cost = 0;
+};
+
 class external_call : public functional::expression
 {
 public:
@@ -143,6 +170,10 @@ public:
 
     string name;
     vector<functional::expr_ptr> args;
+    // Calls a function of the C++ support library
+    // instead of a function provided by IO.
+    bool is_builtin = false;
+    external_attributes attributes;
 };
 
 class assignment : public functional::expression
@@ -173,6 +204,8 @@ class model
 public:
     isl::context context;
     vector<array_ptr> arrays;
+    // Arrays evaluated by the compiler, without statements.
+    vector<array_ptr> constant_arrays;
     vector<stmt_ptr> statements;
     vector<io_channel> inputs;
     vector<io_channel> outputs;
@@ -273,29 +306,46 @@ public:
 
     ast_isl(const ast_isl & other)
     {
-        full = isl_ast_node_copy(other.full);
-        prelude = isl_ast_node_copy(other.prelude);
-        period = isl_ast_node_copy(other.period);
+        *this = other;
     }
 
     ~ast_isl()
     {
-        isl_ast_node_free(full);
-        isl_ast_node_free(prelude);
-        isl_ast_node_free(period);
+        free_nodes();
     }
 
     ast_isl & operator=(const ast_isl & other)
     {
+        if (this == &other)
+            return *this;
+        free_nodes();
         full = isl_ast_node_copy(other.full);
         prelude = isl_ast_node_copy(other.prelude);
         period = isl_ast_node_copy(other.period);
+        statement_names = other.statement_names;
+        contexts = other.contexts;
         return *this;
     }
 
     isl_ast_node * full = nullptr;
     isl_ast_node * prelude = nullptr;
     isl_ast_node * period = nullptr;
+
+    // Original names of statements renamed in the full and prelude ASTs,
+    // when they are generated in separate isl contexts.
+    unordered_map<string, string> statement_names;
+
+    // Separate isl contexts which own some of the ASTs.
+    // Destroyed after the ASTs.
+    vector<std::shared_ptr<isl::context>> contexts;
+
+private:
+    void free_nodes()
+    {
+        full = isl_ast_node_free(full);
+        prelude = isl_ast_node_free(prelude);
+        period = isl_ast_node_free(period);
+    }
 };
 
 struct ast_node_info
@@ -39,6 +39,33 @@ primitive_type primitive_type_for_name(const string & name)
         return m->second;
 }
 
+int size_in_bytes(primitive_type pt)
+{
+    switch(pt)
+    {
+    case primitive_type::boolean:
+    case primitive_type::int8:
+    case primitive_type::uint8:
+        return 1;
+    case primitive_type::int16:
+    case primitive_type::uint16:
+        return 2;
+    case primitive_type::int32:
+    case primitive_type::uint32:
+    case primitive_type::real32:
+        return 4;
+    case primitive_type::int64:
+    case primitive_type::uint64:
+    case primitive_type::real64:
+    case primitive_type::complex32:
+        return 8;
+    case primitive_type::complex64:
+        return 16;
+    default:
+        throw error("Unexpected primitive type.");
+    }
+}
+
 string name_of_primitive( primitive_op op )
 {
     switch(op)
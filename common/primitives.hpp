@@ -182,6 +182,9 @@ inline bool is_numeric(primitive_type t)
 
 primitive_type primitive_type_for_name(const string &);
 
+// Size in bytes of the C++ type used to store values of given type.
+int size_in_bytes(primitive_type);
+
 enum class primitive_op
 {
     negate = 0,
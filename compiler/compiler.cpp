@@ -36,8 +36,16 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include "../frontend/array_inflate.hpp"
 #include "../frontend/array_transpose.hpp"
 #include "../frontend/ph_model_gen.hpp"
+#include "../polyhedral/recurrence.hpp"
 #include "../polyhedral/scheduling.hpp"
 #include "../polyhedral/storage_alloc.hpp"
+#include "../polyhedral/cost_model.hpp"
+#include "../polyhedral/cache_analysis.hpp"
+#include "../polyhedral/cse.hpp"
+#include "../polyhedral/constant_arrays.hpp"
+#include "../polyhedral/rematerialization.hpp"
+#include "../polyhedral/external_batching.hpp"
+#include "../polyhedral/invariant_calls.hpp"
 //#include "../polyhedral/modulo_avoidance.hpp"
 #include "../polyhedral/isl_ast_gen.hpp"
 #include "../cpp/cpp_target.hpp"
@@ -47,6 +55,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include "../interface/puredata/generate.h"
 #include "../utility/filesystem.hpp"
 #include "../utility/subprocess.hpp"
+#include "../utility/platform.hpp"
 
 #include <isl-cpp/printer.hpp>
 #include <isl-cpp/utility.hpp>
@@ -57,6 +66,8 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <functional>
 #include <algorithm>
 #include <numeric>
+#include <thread>
+#include <chrono>
 
 using namespace std;
 
@@ -65,6 +76,11 @@ namespace compiler {
 
 void compute_io_latencies(polyhedral::model & ph_model, polyhedral::schedule & schedule);
 void report_io(const polyhedral::model & ph_model);
+void report_cost(const polyhedral::model & ph_model, const polyhedral::schedule & schedule);
+void report_cache(const polyhedral::model & ph_model, const polyhedral::schedule & schedule,
+                  const vector<int64_t> & cache_sizes);
+vector<int64_t> cache_sizes_in_bytes(const options & opts);
+void report_schedule_fallback(const polyhedral::scheduler & scheduler);
 
 result::code compile(const options & opts)
 {
@@ -106,6 +122,11 @@ result::code compile(const options & opts)
 result::code compile_module
 (const module_source & source, istream & text, const options & opts)
 {
+    // Declared first, so that it is destroyed after all nodes allocated from it.
+    functional::node_pool nodes;
+
+    auto frontend_start = std::chrono::steady_clock::now();
+
     module_parser parser;
     parser.set_import_dirs(opts.import_dirs);
     parser.set_import_extensions(opts.import_extensions);
@@ -176,10 +197,15 @@ result::code compile_module
 #endif
         functional::name_provider func_name_provider(':');
 
-        for (auto & id : output_ids)
         {
+            // One reducer for all outputs, so they share function instances.
             arrp::func_reduction func_reducer(func_name_provider);
-            func_reducer.reduce(id);
+
+            for (auto & id : output_ids)
+                func_reducer.reduce(id);
+
+            if (arrp::func_reduction::verbose())
+                func_reducer.print_statistics(cout);
         }
 
         {
@@ -225,7 +251,11 @@ result::code compile_module
         //unordered_set<functional::id_ptr> array_ids;
 
         {
-            functional::type_checker type_checker(func_name_provider);
+            functional::type_checker::options type_opts;
+            type_opts.single_precision = opts.single_precision;
+            type_opts.keep_double_precision = opts.keep_double_precision;
+
+            functional::type_checker type_checker(func_name_provider, type_opts);
             type_checker.process(global_scope);
 
             // Type check does some folding, so we should clean up scopes
@@ -281,6 +311,13 @@ result::code compile_module
             }
         }
 
+        {
+            std::chrono::duration<double> frontend_time =
+                    std::chrono::steady_clock::now() - frontend_start;
+            arrp::report()["compiler"]["frontend_time"] = frontend_time.count();
+            arrp::report()["compiler"]["functional_nodes"] = nodes.node_count();
+        }
+
         {
             // Create polyhedral model
 
@@ -319,15 +356,59 @@ result::code compile_module
                 }
             }
 
+            if (opts.cse)
+            {
+                polyhedral::common_subexpression_elimination cse(ph_model);
+                cse.process();
+                arrp::report()["cse"]["merged_statements"] = cse.merged_count();
+            }
+
+            if (opts.constant_tables)
+            {
+                polyhedral::constant_array_evaluation constants(ph_model);
+                constants.process();
+            }
+
+            if (opts.rematerialize > 0)
+            {
+                polyhedral::rematerialization remat(ph_model, opts.rematerialize);
+                remat.process();
+            }
+
             if (opts.clocked_io)
             {
                 functional::add_io_clock(ph_model);
             }
 
+            if (opts.recurrence_lookahead > 1)
+            {
+                polyhedral::recurrence_lookahead lookahead(ph_model, opts.recurrence_lookahead);
+                lookahead.process();
+                arrp::report()["recurrence_lookahead"]["transformed"] = lookahead.transformed_count();
+                arrp::report()["recurrence_lookahead"]["satisfied"] = int(lookahead.satisfied().size());
+                for (auto & entry : lookahead.rejected())
+                    arrp::report()["recurrence_lookahead"]["rejected"][entry.first] = entry.second;
+            }
+
+            if (opts.loop_invariant_code_motion)
+            {
+                polyhedral::invariant_call_motion motion(ph_model);
+                motion.process();
+                arrp::report()["invariant_calls"]["moved"] = motion.moved_count();
+            }
+
+            if (!opts.batched_externals.empty())
+            {
+                polyhedral::external_batching batching(ph_model, opts.batched_externals);
+                batching.process();
+            }
+
             // Compute polyhedral schedule
 
             polyhedral::schedule schedule(ph_model.context);
 
+            auto cache_sizes = cache_sizes_in_bytes(opts);
+
             {
                 polyhedral::scheduler::options sched_opts;
                 sched_opts.cluster = opts.schedule.cluster;
@@ -337,17 +418,89 @@ result::code compile_module
                 sched_opts.tile_size = opts.schedule.tile_size;
                 sched_opts.tile_parallelism = opts.schedule.tile_parallelism;
                 sched_opts.intra_tile_permutation = opts.schedule.intra_tile_permutation;
+                sched_opts.max_operations = std::max(0, opts.isl_max_operations);
+
+                {
+                    polyhedral::scheduler poly_scheduler( ph_model );
+                    schedule = poly_scheduler.schedule(sched_opts);
+                    report_schedule_fallback(poly_scheduler);
+                }
+
+                if (opts.schedule.auto_tile_level > 0 && opts.schedule.tile_size.empty())
+                {
+                    // Choose tile size based on the untiled schedule,
+                    // then schedule again with that tile size.
+
+                    polyhedral::cache_analysis cache(ph_model, cache_sizes);
+
+                    if (!schedule.period.is_empty())
+                    {
+                        cerr << "Warning: Automatic tiling is only supported"
+                             << " for programs without streams." << endl;
+                    }
+                    else
+                    {
+                        auto tiling = cache.suggest_tile_size
+                                (schedule.full, opts.schedule.auto_tile_level);
+
+                        arrp::report()["cache"]["tile_size"] = tiling.size;
+
+                        if (tiling.size.empty())
+                        {
+                            cerr << "Warning: No tile fits into cache level "
+                                 << opts.schedule.auto_tile_level << ": "
+                                 << tiling.problem << endl;
+                            arrp::report()["cache"]["tile_size_problem"] = tiling.problem;
+                        }
+                        else
+                        {
+                            sched_opts.tile_size = tiling.size;
+                            polyhedral::scheduler poly_scheduler( ph_model );
+                            schedule = poly_scheduler.schedule(sched_opts);
+                            report_schedule_fallback(poly_scheduler);
+                        }
+                    }
+                }
+                else if (opts.out_of_core > 0 && opts.schedule.tile_size.empty() &&
+                         schedule.period.is_empty())
+                {
+                    // Choose tile size so that the data accessed by a tile
+                    // fits into the memory budget for out-of-core arrays.
+
+                    int64_t budget = int64_t(opts.out_of_core) << 10;
+                    polyhedral::cache_analysis memory(ph_model, { budget });
+
+                    auto tiling = memory.suggest_tile_size(schedule.full, 1);
 
-                polyhedral::scheduler poly_scheduler( ph_model );
-                schedule = poly_scheduler.schedule(sched_opts);
+                    arrp::report()["out_of_core"]["tile_size"] = tiling.size;
+
+                    if (tiling.size.empty())
+                    {
+                        cerr << "Warning: No tile fits into " << opts.out_of_core
+                             << " KiB: " << tiling.problem << endl;
+                        arrp::report()["out_of_core"]["tile_size_problem"] = tiling.problem;
+                    }
+                    else
+                    {
+                        sched_opts.tile_size = tiling.size;
+                        polyhedral::scheduler poly_scheduler( ph_model );
+                        schedule = poly_scheduler.schedule(sched_opts);
+                        report_schedule_fallback(poly_scheduler);
+                    }
+                }
             }
 
+            int jobs = opts.jobs;
+            if (jobs < 1)
+                jobs = std::max(1u, std::thread::hardware_concurrency());
+
             // Generate AST for schedule
 
             polyhedral::ast_isl ast;
 
             {
                 polyhedral::ast_gen::options ast_opts;
+                ast_opts.jobs = jobs;
                 ast_opts.separate_loops = opts.separate_loops;
                 ast_opts.parallel = opts.parallel;
                 ast_opts.parallel_dim = opts.parallel_dim;
@@ -360,9 +513,19 @@ result::code compile_module
 
             // Allocate storage (buffers)
 
-            polyhedral::storage_allocator storage_alloc( ph_model, opts.classic_storage_allocation );
+            polyhedral::storage_allocator storage_alloc
+                    ( ph_model, opts.classic_storage_allocation,
+                      std::max(0, opts.isl_max_operations), jobs );
             storage_alloc.allocate(schedule);
 
+            for (auto & fallback : storage_alloc.fallbacks())
+            {
+                cerr << "Warning: Storage allocation for array " << fallback.first
+                     << " exceeded the isl operation limit."
+                     << " Using fallback: " << fallback.second << endl;
+                arrp::report()["fallbacks"]["storage"][fallback.first] = fallback.second;
+            }
+
             compute_io_latencies(ph_model, schedule);
 
             // Modulo avoidance
@@ -395,6 +558,13 @@ result::code compile_module
 
             report_io(ph_model);
 
+            if (!opts.report_file.empty())
+            {
+                report_cost(ph_model, schedule);
+                if (opts.report_cache)
+                    report_cache(ph_model, schedule, cache_sizes);
+            }
+
             string output_filename_base = opts.output_filename_base;
             if (output_filename_base.empty())
                 output_filename_base = main_module->name;
@@ -424,6 +594,7 @@ result::code compile_module
 
                 cpp_gen::generate(namespace_name,
                                   ph_model,
+                                  schedule,
                                   ast,
                                   cpp_file,
                                   opts);
@@ -434,6 +605,7 @@ result::code compile_module
                 arrp::generic_io::options output_opt;
 
                 output_opt.base_file_name = output_filename_base;
+                output_opt.externals_header = opts.generic_io.externals_header;
 
                 arrp::generic_io::generate(output_opt, arrp::report());
             }
@@ -483,6 +655,10 @@ result::code compile_module
         }
         else
         {
+            long peak_memory = arrp::get_platform()->peak_memory_usage();
+            if (peak_memory >= 0)
+                arrp::report()["compiler"]["peak_memory"] = peak_memory;
+
             out << arrp::report().dump(4) << endl;
         }
     }
@@ -614,6 +790,143 @@ void report_io(const polyhedral::model & ph_model)
     arrp::report()["outputs"] = outputs_report;
 }
 
+void report_cost(const polyhedral::model & ph_model, const polyhedral::schedule & schedule)
+{
+    polyhedral::cost_model cost(ph_model, schedule);
+
+    arrp::json report;
+
+    int64_t period_ops = 0;
+    int64_t period_transcendental_ops = 0;
+    int64_t period_external_calls = 0;
+    int64_t period_external_ops = 0;
+    int64_t period_bytes = cost.period_bytes();
+
+    for (auto & stmt : cost.statements())
+    {
+        arrp::json & r = report["statements"][stmt.stmt->name];
+
+        auto expr = stmt.stmt->expr;
+        if (auto assign = dynamic_pointer_cast<polyhedral::assignment>(expr))
+            expr = assign->value;
+        ostringstream location;
+        location << expr->location;
+
+        r["location"] = location.str();
+        r["prelude_instances"] = stmt.prelude_instances;
+        r["period_instances"] = stmt.period_instances;
+        r["arithmetic_ops"] = stmt.arithmetic_ops;
+        r["transcendental_ops"] = stmt.transcendental_ops;
+        r["external_calls"] = stmt.external_calls;
+        r["external_ops"] = stmt.external_ops;
+        r["bytes_read"] = stmt.bytes_read;
+        r["bytes_written"] = stmt.bytes_written;
+        r["period_bytes_read"] = stmt.period_bytes_read;
+        r["period_bytes_written"] = stmt.period_bytes_written;
+        if (!stmt.exact)
+            r["approximate"] = true;
+
+        if (stmt.period_instances < 0)
+            continue;
+
+        period_ops += stmt.period_instances * stmt.arithmetic_ops;
+        period_transcendental_ops += stmt.period_instances * stmt.transcendental_ops;
+        period_external_calls += stmt.period_instances * stmt.external_calls;
+        period_external_ops += stmt.period_instances * stmt.external_ops;
+    }
+
+    {
+        arrp::json & r = report["period"];
+        r["arithmetic_ops"] = period_ops;
+        r["transcendental_ops"] = period_transcendental_ops;
+        r["external_calls"] = period_external_calls;
+        r["external_ops"] = period_external_ops;
+        r["bytes"] = period_bytes;
+        r["samples"] = cost.period_samples();
+    }
+
+    if (cost.period_samples() > 0)
+    {
+        double samples = cost.period_samples();
+
+        arrp::json & r = report["per_sample"];
+        r["arithmetic_ops"] = period_ops / samples;
+        r["transcendental_ops"] = period_transcendental_ops / samples;
+        r["external_calls"] = period_external_calls / samples;
+        r["external_ops"] = period_external_ops / samples;
+        if (period_bytes >= 0)
+            r["bytes"] = period_bytes / samples;
+        if (period_bytes > 0)
+            r["arithmetic_intensity"] = double(period_ops + period_transcendental_ops + period_external_ops) / period_bytes;
+    }
+
+    arrp::report()["cost"] = report;
+}
+
+
+vector<int64_t> cache_sizes_in_bytes(const options & opts)
+{
+    vector<int> kib = opts.cache_sizes;
+    if (kib.empty())
+        kib = { 32, 256, 8192 };
+
+    vector<int64_t> bytes;
+    for (auto size : kib)
+    {
+        if (size < 1)
+            throw error("Invalid cache size: " + to_string(size));
+        bytes.push_back(int64_t(size) * 1024);
+    }
+    return bytes;
+}
+
+void report_cache(const polyhedral::model & ph_model, const polyhedral::schedule & schedule,
+                  const vector<int64_t> & cache_sizes)
+{
+    // Analyze the period if there is one, otherwise the entire program.
+
+    auto sched = schedule.tiled;
+    if (!schedule.period.is_empty())
+        sched = sched.in_domain(schedule.period.domain());
+
+    polyhedral::cache_analysis cache(ph_model, cache_sizes);
+
+    auto level_name = [&](int64_t bytes) -> string {
+        int level = cache.fitting_level(bytes);
+        if (level > 0)
+            return "L" + to_string(level);
+        return "memory";
+    };
+
+    arrp::json & report = arrp::report()["cache"];
+
+    report["sizes"] = cache_sizes;
+
+    for (auto & level : cache.loop_levels(sched))
+    {
+        arrp::json r;
+        r["depth"] = level.depth;
+        r["footprint"] = level.footprint;
+        r["footprint_fits"] = level_name(level.footprint);
+        r["reuse_distance"] = level.reuse_distance;
+        r["reuse_fits"] = level_name(level.reuse_distance);
+        r["carries_reuse"] = level.carries_reuse;
+        report["loops"].push_back(r);
+    }
+}
+
+
+void report_schedule_fallback(const polyhedral::scheduler & scheduler)
+{
+    if (scheduler.fallback().empty())
+        return;
+
+    cerr << "Warning: Scheduling exceeded the isl operation limit."
+         << " Using fallback: " << scheduler.fallback() << endl;
+
+    arrp::report()["fallbacks"]["schedule"] = scheduler.fallback();
+}
+
 
 } // namespace compiler
 } // namespace stream
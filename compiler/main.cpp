@@ -32,7 +32,14 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include "../frontend/array_transpose.hpp"
 #include "../frontend/ph_model_gen.hpp"
 //#include "../polyhedral/modulo_avoidance.hpp"
+#include "../polyhedral/recurrence.hpp"
+#include "../polyhedral/cse.hpp"
+#include "../polyhedral/constant_arrays.hpp"
+#include "../polyhedral/rematerialization.hpp"
+#include "../polyhedral/external_batching.hpp"
+#include "../polyhedral/invariant_calls.hpp"
 #include "../polyhedral/scheduling.hpp"
+#include "../polyhedral/cache_analysis.hpp"
 #include "../polyhedral/isl_ast_gen.hpp"
 #include "../polyhedral/storage_alloc.hpp"
 #include "../cpp/cpp_target.hpp"
@@ -245,14 +252,70 @@ int main(int argc, char *argv[])
                     new int_option(&opt.schedule.period_offset));
     args.add_option({"sched-period-scale", "", "", "Size of period as a multiple of minimal periods."},
                     new int_option(&opt.schedule.period_scale));
+    args.add_option({"sched-tile-auto", "", "<level>",
+                     "Choose tile size so that a tile fits into given cache level"
+                     " (if tile size is not given)."},
+                    new int_option(&opt.schedule.auto_tile_level));
+    args.add_option({"cache-sizes", "", "<L1>,<L2>,...",
+                     "Cache sizes in KiB, used by --sched-tile-auto and --report-cache."
+                     " Defaults: 32,256,8192."},
+                    new int_tuple_parser("cache sizes", &opt.cache_sizes));
+
+    args.add_option({"single-precision", "", "",
+                     "Demote real64 and complex64 computations to real32 and complex32."},
+                    new switch_option(&opt.single_precision));
+    args.add_option({"keep-double", "", "<name>",
+                     "With --single-precision, keep precision of the definition"
+                     " of <name> and its local definitions. Can be repeated."},
+                    new string_list_option(&opt.keep_double_precision));
+
+    args.add_option({"recurrence-lookahead", "", "<distance>",
+                     "Rewrite linear recurrences so that each element depends"
+                     " on elements at least <distance> steps back in time."},
+                    new int_option(&opt.recurrence_lookahead));
+
+    args.add_option({"cse", "", "",
+                     "Merge definitions which compute the same values"
+                     " into a single array."},
+                    new switch_option(&opt.cse));
+
+    args.add_option({"constant-tables", "", "",
+                     "Evaluate finite arrays which do not depend on inputs"
+                     " during compilation, and store them in static tables"
+                     " shared by all program instances."},
+                    new switch_option(&opt.constant_tables));
+
+    args.add_option({"rematerialize", "", "<operations>",
+                     "Recompute cheap arrays wherever they are read instead of"
+                     " storing them, when this saves storage and recomputing"
+                     " an element takes at most <operations> operations."},
+                    new int_option(&opt.rematerialize));
+
+    args.add_option({"batch-external", "", "<name>",
+                     "Call external function <name> once for all elements along"
+                     " the last dimension of an array, with a pointer to each slice"
+                     " of arguments and result, and the number of elements:"
+                     " f(const A * a, ..., R * result, int count)."
+                     " Calls which can not be batched remain per element. May be repeated."},
+                    new string_list_option(&opt.batched_externals));
 
     args.add_option({"ast-avoid-branch-in-loop", "", "", "Split loops to avoid branching inside."},
                     new switch_option(&opt.separate_loops));
 
     args.add_option({"classic-storage", "", "", "Use unmodified successive modulo technique."},
                     new switch_option(&opt.classic_storage_allocation, true));
-
-    args.add_option({"parallel", "", "", "Generate parallelized code, if possible."},
+    args.add_option({"isl-max-ops", "", "<count>",
+                     "Limit isl operations for scheduling and storage allocation of each array."
+                     " When exceeded, simpler methods are used."},
+                    new int_option(&opt.isl_max_operations));
+    args.add_option({"jobs", "", "<count>",
+                     "Number of threads for storage allocation and AST generation."
+                     " Zero means the number of hardware threads. Default: 1."},
+                    new int_option(&opt.jobs));
+
+    args.add_option({"parallel", "", "", "Generate parallelized code, if possible."
+                     " Loops which call external functions not declared"
+                     " pure or thread_safe are not parallelized."},
                     new switch_option(&opt.parallel, true));
     args.add_option({"parallel-dim", "", "<dim>", "Parallelize exclusively dimension <dim> of period, if possible."},
                     new int_option(&opt.parallel_dim));
@@ -261,13 +324,84 @@ int main(int argc, char *argv[])
 
     args.add_option({"align-data", "", "<bytes>", "Alignment requirement of data."},
                     new int_option(&opt.data_alignment));
+    args.add_option({"target-pointer-size", "", "<bytes>",
+                     "Size of pointers on the target. Default: 8."},
+                    new int_option(&opt.target.pointer_size));
+    args.add_option({"target-alignment", "", "<bytes>",
+                     "Maximum alignment of scalar types on the target"
+                     " (e.g. 4 for doubles on 32-bit x86). Default: 8."},
+                    new int_option(&opt.target.max_alignment));
+    args.add_option({"cache-layout", "", "<line>,<sets>,<ways>",
+                     "Lay out buffers to avoid conflicts in a cache with given"
+                     " line size in bytes, number of sets and associativity."
+                     " Defaults: 64,64,8."},
+                    new int_tuple_parser("cache parameters", &opt.cache_layout));
+    args.add_option({"planar-complex", "", "",
+                     "Store complex arrays as separate planes of real and imaginary parts."},
+                    new switch_option(&opt.planar_complex));
+    args.add_option({"mirror-buffers", "", "<page size>",
+                     "Store stream buffers of at least one page in memory mapped"
+                     " several times in a row, so that the period accesses them"
+                     " without wrapping indexes. Requires mmap and a runtime page size"
+                     " which divides the buffer sizes (e.g. 4096)."},
+                    new int_option(&opt.mirror_buffers));
+    args.add_option({"dispatch", "", "<isa>",
+                     "Generate an additional variant of prelude and period compiled"
+                     " for instruction set <isa> (e.g. avx2+fma, avx512f), and select"
+                     " the first variant supported by the CPU when a program instance"
+                     " is created. May be repeated, most preferred first."
+                     " Data is aligned for the widest vectors of all variants."},
+                    new string_list_option(&opt.dispatch));
+    args.add_option({"out-of-core", "", "<KiB>",
+                     "Store finite arrays of at least <KiB> kibibytes in memory-mapped"
+                     " temporary files (in $TMPDIR or /tmp), and tile programs without"
+                      " streams so that the data accessed by a tile fits into <KiB>."
+                     " Paging of tiles is left to the operating system."},
+                    new int_option(&opt.out_of_core));
+    args.add_option({"mapped-input", "", "<name>",
+                     "Allow finite input <name> to be mapped read-only from a file"
+                     " with its raw contents, using program::map_input before the prelude,"
+                     " so that the memory is shared by all program instances."
+                     " Otherwise, the input is read through IO as usual. May be repeated."},
+                    new string_list_option(&opt.mapped_inputs));
+    args.add_option({"output-selection", "", "",
+                     "Allow outputs to be disabled at runtime using"
+                     " program::set_output_active. The period skips loop nests and statements"
+                     " which only contribute to disabled outputs."
+                     " Supports at most 64 outputs."},
+                    new switch_option(&opt.output_selection));
+    args.add_option({"denormals", "", "<mode>",
+                     "Handling of denormal numbers."
+                     " 'keep': no special handling (default)."
+                     " 'flush': enable hardware flush-to-zero during prelude and period."
+                     " 'guard': replace denormal results of recursive statements by zero."},
+                    new enum_option<denormal_mode>(opt.denormals, {
+                        { "keep", denormal_mode::keep },
+                        { "flush", denormal_mode::flush },
+                        { "guard", denormal_mode::guard }
+                    }));
+    args.add_option({"fast-math", "", "<level>",
+                     "Replace real math functions in generated code by vectorizable"
+                     " approximations. Level 0: standard library (default)."
+                     " Level 1: close to single precision."
+                     " Level 2: faster, about 1e-4 error at worst; also approximates pow."
+                     " See arrp/arrp.hpp for error bounds."},
+                    new int_option(&opt.fast_math));
+    args.add_option({"instrument", "", "",
+                     "Count calls and time of prelude, period and outermost loop nests"
+                     " in generated code, and instances of each statement."
+                     " The program class gets a function"
+                     " print_instrumentation() which prints the counters as JSON."},
+                    new switch_option(&opt.instrument));
 
     args.add_option({"no-avoid-modulo-bitmask", "", "", "Disable avoiding modulo in array indexing by extending"
                      " array size to power of two and using bitmasking instead."},
                     new switch_option(&opt.data_size_power_of_two, false));
     args.add_option({"avoid-modulo-datashift", "", "", "Avoid modulo by shifting data in buffers."},
                     new switch_option(&opt.buffer_data_shifting, true));
-    args.add_option({"move-loop-invariant-code", "", "", ""},
+    args.add_option({"move-loop-invariant-code", "", "",
+                     "Move loop-invariant index computations and calls to"
+                     " pure external functions out of loops."},
                     new switch_option(&opt.loop_invariant_code_motion, true));
 
     args.add_option({"io-common-clock", "", "",
@@ -289,6 +423,10 @@ int main(int argc, char *argv[])
     args.add_option({"cpp-namespace", "", "<name>", "Generate C++ output in namespace <name>."},
                     new string_option(&opt.cpp.nmspace));
 
+    args.add_option({"stdio-externals", "", "<file>",
+                     "Header which defines struct arrp::generic_io::External_Functions"
+                     " with the external functions, for the stdio interface."},
+                    new string_option(&opt.generic_io.externals_header));
     args.add_option({"jack-name", "", "", "Jack client name."},
                     new string_option(&opt.jack_io.name));
     args.add_option({"pd-name", "", "", "Pure Data object name (without ~)."},
@@ -308,7 +446,14 @@ int main(int argc, char *argv[])
     verbose_out->add_topic<functional::polyhedral_gen>("ph-model-gen");
     verbose_out->add_topic<polyhedral::model>("ph-model");
     //verbose_out->add_topic<polyhedral::modulo_avoidance>("mod-avoid");
+    verbose_out->add_topic<polyhedral::recurrence_lookahead>("recurrence");
+    verbose_out->add_topic<polyhedral::common_subexpression_elimination>("cse");
+    verbose_out->add_topic<polyhedral::constant_array_evaluation>("constant-tables");
+    verbose_out->add_topic<polyhedral::rematerialization>("rematerialize");
+    verbose_out->add_topic<polyhedral::external_batching>("batch-externals");
+    verbose_out->add_topic<polyhedral::invariant_call_motion>("invariant-calls");
     verbose_out->add_topic<polyhedral::scheduler>("ph-scheduling");
+    verbose_out->add_topic<polyhedral::cache_analysis>("cache");
     verbose_out->add_topic<polyhedral::ast_isl>("ph-ast");
     verbose_out->add_topic<polyhedral::ast_gen>("ph-ast-gen");
     verbose_out->add_topic<polyhedral::storage_allocator>("storage-alloc");
@@ -321,6 +466,10 @@ int main(int argc, char *argv[])
 
     args.add_option({"report", "", "<file>", "Write report to <file>."},
                     new string_option(&opt.report_file));
+    args.add_option({"report-cache", "", "",
+                     "Include footprints and reuse distances of loops in the report,"
+                     " predicted for the cache sizes given by --cache-sizes."},
+                    new switch_option(&opt.report_cache, true));
 
     try {
         args.parse(argc-1, argv+1);
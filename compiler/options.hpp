@@ -30,6 +30,15 @@ namespace compiler {
 using std::string;
 using std::vector;
 
+enum class denormal_mode
+{
+    keep,
+    // Enable hardware flush-to-zero in generated functions.
+    flush,
+    // Flush denormal results of recursive statements in software.
+    guard
+};
+
 struct options
 {
     string input_filename;
@@ -44,6 +53,7 @@ struct options
     } cpp;
 
     struct {
+        string externals_header;
     } generic_io;
 
     struct {
@@ -65,8 +75,34 @@ struct options
       vector<int> periodic_tile_direction;
       int period_offset = 0;
       int period_scale = 1;
+      // If not zero and tile_size is empty, choose tile size
+      // so that a tile fits into this cache level.
+      int auto_tile_level = 0;
     } schedule;
 
+    // Cache sizes in KiB from the innermost level,
+    // used to predict cache behavior of loops.
+    vector<int> cache_sizes;
+
+    // Demote real64 and complex64 computations to 32 bits,
+    // except in ids listed in keep_double_precision.
+    bool single_precision = false;
+    vector<string> keep_double_precision;
+
+    int recurrence_lookahead = 0;
+    // Merge statements which compute the same values.
+    bool cse = false;
+    // Evaluate finite arrays which do not depend on inputs
+    // and store them in static tables.
+    bool constant_tables = false;
+    // Recompute cheap arrays in their readers instead of storing them,
+    // if recomputing an element takes at most this many operations
+    // (0 = disabled).
+    int rematerialize = 0;
+    // External functions called with slices of arrays
+    // instead of once per element.
+    vector<string> batched_externals;
+
     bool split_statements = false;
     bool separate_loops = false;
 
@@ -81,13 +117,59 @@ struct options
     bool vectorize = false;
 
     bool classic_storage_allocation = false;
+    // Maximum number of isl operations for scheduling and
+    // buffer size computation of each array (0 = no limit).
+    // When exceeded, simpler methods are used.
+    int isl_max_operations = 0;
+    // Number of threads for passes that can run concurrently
+    // (0 = number of hardware threads).
+    int jobs = 1;
     bool buffer_data_shifting = false;
     bool loop_invariant_code_motion = false;
 
     int data_alignment = 0;
+    // Size of pointers and maximum alignment of scalar types in bytes
+    // on the target, used to lay out buffers in the program object.
+    struct {
+        int pointer_size = 8;
+        int max_alignment = 8;
+    } target;
     bool data_size_power_of_two = true;
+    // Cache line size, number of sets and associativity.
+    // If not empty, buffers are laid out to avoid cache conflicts.
+    vector<int> cache_layout;
+    // Store complex arrays as separate planes of real and imaginary parts.
+    bool planar_complex = false;
+    // Page size for stream buffers mapped several times in a row
+    // in virtual memory, to avoid wrapping indexes (0 = disabled).
+    int mirror_buffers = 0;
+    // Instruction sets (e.g. "avx2+fma") for which additional variants
+    // of prelude and period are generated, in order of preference.
+    // A variant is selected for each program instance at runtime.
+    vector<string> dispatch;
+    // Finite arrays of at least this many KiB are stored in memory-mapped
+    // temporary files, and finite programs are tiled so that a tile
+    // accesses at most this much data (0 = disabled).
+    int out_of_core = 0;
+    // Finite inputs which can be mapped read-only from files
+    // with the raw contents of the input, instead of being read through IO.
+    vector<string> mapped_inputs;
+    // Outputs can be disabled at runtime, skipping statements in the period
+    // which only contribute to disabled outputs.
+    bool output_selection = false;
+
+    denormal_mode denormals = denormal_mode::keep;
+    // Use approximations of math functions in generated code
+    // (0 = standard library, 1 = accurate, 2 = fast).
+    int fast_math = 0;
+
+    // Count calls and time of functions and loop nests in generated code,
+    // and derive instances of statements from instances per call.
+    bool instrument = false;
 
     string report_file;
+    // Include predicted cache behavior of loops in the report.
+    bool report_cache = false;
 };
 
 }
@@ -1,7 +1,49 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <complex>
+#include <limits>
 #include <vector>
+#include <chrono>
+#include <ostream>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ARRP_HAS_MXCSR 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define ARRP_HAS_RDTSC 1
+#endif
+
+// Code variants for different instruction sets,
+// generated with the --dispatch compiler option.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ARRP_TARGET(isa) __attribute__((target(isa)))
+#define ARRP_CPU_INIT() __builtin_cpu_init()
+#define ARRP_CPU_SUPPORTS(feature) __builtin_cpu_supports(feature)
+#else
+#define ARRP_TARGET(isa)
+#define ARRP_CPU_INIT()
+#define ARRP_CPU_SUPPORTS(feature) false
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#define ARRP_HAS_MMAP 1
+#endif
 
 namespace arrp {
 
@@ -50,4 +92,908 @@ int floor_div(int a, int b)
     return d - ((d < 0) & (d * b != a));
 }
 
+// Enables flushing of denormal numbers to zero while in scope,
+// and restores the previous floating-point state when leaving scope.
+// Has no effect on unsupported architectures.
+
+class denormal_flush_scope
+{
+public:
+#if defined(ARRP_HAS_MXCSR)
+    denormal_flush_scope(): m_state(_mm_getcsr())
+    {
+        // Flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+        _mm_setcsr(m_state | 0x8040);
+    }
+    ~denormal_flush_scope() { _mm_setcsr(m_state); }
+private:
+    unsigned int m_state;
+#elif defined(__aarch64__)
+    denormal_flush_scope()
+    {
+        asm volatile("mrs %0, fpcr" : "=r"(m_state));
+        // Flush-to-zero (bit 24)
+        uint64_t state = m_state | (uint64_t(1) << 24);
+        asm volatile("msr fpcr, %0" : : "r"(state));
+    }
+    ~denormal_flush_scope() { asm volatile("msr fpcr, %0" : : "r"(m_state)); }
+private:
+    uint64_t m_state;
+#else
+    denormal_flush_scope() {}
+#endif
+
+public:
+    denormal_flush_scope(const denormal_flush_scope &) = delete;
+    denormal_flush_scope & operator=(const denormal_flush_scope &) = delete;
+};
+
+// Replaces denormal numbers with zero.
+
+template <typename T> inline
+T flush_denormal(T v)
+{
+    return std::abs(v) < std::numeric_limits<T>::min() ? T(0) : v;
+}
+
+template <typename T> inline
+std::complex<T> flush_denormal(const std::complex<T> & v)
+{
+    return std::complex<T>(flush_denormal(v.real()), flush_denormal(v.imag()));
+}
+
+// Approximations of transcendental functions,
+// used by generated code with the --fast-math compiler option.
+// They avoid branches and library calls, so that loops using them
+// can be vectorized. Level 1 is more accurate, level 2 is faster.
+// Maximum errors with T = double, measured against libm:
+//
+//   function           level 1       level 2
+//   sin, cos           7e-10 abs     2e-4 abs     (|x| < 1e5)
+//   exp, exp2          1e-11 rel     4e-6 rel
+//   log, log2, log10   5e-13 rel     2e-6 rel     (x > 0 normal)
+//   atan               6e-11 abs     5e-6 abs
+//   pow                -             2e-6 |y log2(x)| rel
+//
+// With T = float, the level 1 errors are bounded by float rounding
+// of the argument reduction instead (about 1e-6 for sin and cos
+// with |x| < 1e5, and 4e-6 relative for exp with |x| < 88).
+// Results of exp and exp2 which would be denormal are zero,
+// results which would overflow are infinity, and NaN is returned
+// unchanged. Results of sin and cos are bounded for any finite x.
+
+namespace fast_math {
+
+// M_PI and similar macros are not standard C++.
+
+constexpr double pi = 3.14159265358979323846;
+constexpr double pi_2 = 1.57079632679489661923;
+constexpr double pi_4 = 0.78539816339744830962;
+constexpr double ln2 = 0.69314718055994530942;
+constexpr double log2e = 1.44269504088896340736;
+constexpr double log10e = 0.43429448190325182765;
+constexpr double sqrt2 = 1.41421356237309504880;
+
+template <typename T> struct float_bits;
+template <> struct float_bits<float>
+{
+    using int_type = int32_t;
+    static constexpr int mantissa = 23;
+    static constexpr int bias = 127;
+    static constexpr float max_exp2 = 127.f;
+    static constexpr float min_exp2 = -126.f;
+};
+template <> struct float_bits<double>
+{
+    using int_type = int64_t;
+    static constexpr int mantissa = 52;
+    static constexpr int bias = 1023;
+    static constexpr double max_exp2 = 1023.0;
+    static constexpr double min_exp2 = -1022.0;
+};
+
+template <typename T> inline
+T from_bits(typename float_bits<T>::int_type i)
+{
+    T v;
+    std::memcpy(&v, &i, sizeof(T));
+    return v;
+}
+
+template <typename T> inline
+typename float_bits<T>::int_type to_bits(T v)
+{
+    typename float_bits<T>::int_type i;
+    std::memcpy(&i, &v, sizeof(T));
+    return i;
+}
+
+// Branch-free selection.
+// Conditional expressions are not always if-converted by compilers
+// when both alternatives contain floating point operations.
+
+template <typename I> inline
+I blend(bool c, I a, I b)
+{
+    I mask = -I(c);
+    return (a & mask) | (b & ~mask);
+}
+
+template <typename T> inline
+T select(bool c, T a, T b)
+{
+    return from_bits<T>(blend(c, to_bits(a), to_bits(b)));
+}
+
+// floor(x) as an integer of the same width as T.
+// Conversion to integer vectorizes where std::floor may not.
+// x is clamped to |x| <= 2^mantissa, where all numbers are integers,
+// so that the conversion is defined for any x. NaN is converted to 0.
+
+template <typename T> inline
+typename float_bits<T>::int_type floor_int(T x)
+{
+    using int_type = typename float_bits<T>::int_type;
+    const T limit = T(int_type(1) << float_bits<T>::mantissa);
+    x = select(x < limit, x, limit);
+    x = select(x > -limit, x, -limit);
+    x = select(x == x, x, T(0));
+    int_type k = int_type(x);
+    return k - int_type(T(k) > x);
+}
+
+// Numbers of magnitude at least 2^mantissa, infinity and NaN
+// are returned unchanged.
+
+template <typename T> inline
+T floor(T x)
+{
+    using int_type = typename float_bits<T>::int_type;
+    const T limit = T(int_type(1) << float_bits<T>::mantissa);
+    return select(std::abs(x) < limit, T(floor_int(x)), x);
+}
+
+// Polynomial c0 + c1 x + c2 x^2 + ...
+
+template <typename T> inline
+T poly(T, double c0)
+{
+    return T(c0);
+}
+
+template <typename T, typename ... C> inline
+T poly(T x, double c0, C ... c)
+{
+    return T(c0) + x * poly(x, c...);
+}
+
+// sin(r) for |r| <= pi/2
+
+template <int L, typename T> inline
+T sin_kernel(T r)
+{
+    T r2 = r * r;
+    if (L >= 2)
+        return r * poly(r2, 1, -1.0/6, 1.0/120, -1.0/5040);
+    else
+        return r * poly(r2, 1, -1.0/6, 1.0/120, -1.0/5040,
+                        1.0/362880, -1.0/39916800, 1.0/6227020800);
+}
+
+// (-1)^k for integral k
+
+template <typename T> inline
+T alternating_sign(T k)
+{
+    return T(1) - T(4) * (k * T(0.5) - floor(k * T(0.5)));
+}
+
+// Argument reduction is accurate while k pi_hi is exact,
+// up to |x| of about 2^(mantissa - 8).
+// Beyond that, r is limited to the range of the kernel,
+// so that results are bounded but not accurate.
+
+template <typename T> inline
+T bounded_reduction(T r)
+{
+    return select(std::abs(r) > T(pi_2), T(0), r);
+}
+
+template <int L, typename T> inline
+T sin(T x)
+{
+    // x = k pi + r
+    const T pi_hi = T(3.140625);
+    const T pi_lo = T(9.67653589793238462643e-4);
+    T k = floor(x * T(1/pi) + T(0.5));
+    T r = bounded_reduction((x - k * pi_hi) - k * pi_lo);
+    return alternating_sign(k) * sin_kernel<L>(r);
+}
+
+template <int L, typename T> inline
+T cos(T x)
+{
+    // x = (k + 1/2) pi + r
+    const T pi_hi = T(3.140625);
+    const T pi_lo = T(9.67653589793238462643e-4);
+    T k = floor(x * T(1/pi));
+    T h = k + T(0.5);
+    T r = bounded_reduction((x - h * pi_hi) - h * pi_lo);
+    return -alternating_sign(k) * sin_kernel<L>(r);
+}
+
+template <int L, typename T> inline
+T tan(T x)
+{
+    return sin<L>(x) / cos<L>(x);
+}
+
+template <int L, typename T> inline
+T exp2(T x)
+{
+    using bits = float_bits<T>;
+    using int_type = typename bits::int_type;
+
+    // Clamp to the range of normal results, so that the exponent
+    // can be represented. Results outside the range are set below.
+    // Comparisons with NaN are false, so NaN is clamped as well.
+    T c = select(x > T(bits::min_exp2), x, T(bits::min_exp2));
+    c = select(c < T(bits::max_exp2 + 1), c, T(bits::max_exp2 + 1));
+
+    // c = n + f, |f| <= 1/2, except -1/2 < f <= 1 near overflow
+    int_type n = floor_int(c + T(0.5));
+    n = std::min(n, int_type(bits::max_exp2));
+    T t = (c - T(n)) * T(ln2);
+
+    T p;
+    if (L >= 2)
+        p = poly(t, 1, 1, 1.0/2, 1.0/6, 1.0/24, 1.0/120);
+    else
+        p = poly(t, 1, 1, 1.0/2, 1.0/6, 1.0/24, 1.0/120,
+                 1.0/720, 1.0/5040, 1.0/40320, 1.0/362880);
+
+    int_type exponent = n + bits::bias;
+    T scale = from_bits<T>(exponent << bits::mantissa);
+    T r = p * scale;
+
+    // Underflow to zero, overflow to infinity, NaN unchanged.
+    r = select(x < T(bits::min_exp2), T(0), r);
+    r = select(x >= T(bits::max_exp2 + 1), std::numeric_limits<T>::infinity(), r);
+    r = select(x == x, r, x);
+    return r;
+}
+
+template <int L, typename T> inline
+T exp(T x)
+{
+    return exp2<L>(x * T(log2e));
+}
+
+template <int L, typename T> inline
+T log(T x)
+{
+    using bits = float_bits<T>;
+    using int_type = typename bits::int_type;
+
+    const int exponent_bits = sizeof(T) * 8 - 1 - bits::mantissa;
+    const int_type mantissa_mask = (int_type(1) << bits::mantissa) - 1;
+    const int_type exponent_mask = (int_type(1) << exponent_bits) - 1;
+
+    // x = m 2^e, sqrt(1/2) <= m < sqrt(2)
+    // Integer operations on the representation are used
+    // because float comparisons here prevent vectorization.
+    int_type i = to_bits(x);
+    int_type mantissa = i & mantissa_mask;
+    int_type large = mantissa > (to_bits(T(sqrt2)) & mantissa_mask);
+    int32_t e = int32_t((i >> bits::mantissa) & exponent_mask) - bits::bias + int32_t(large);
+    T m = from_bits<T>(mantissa | (int_type(bits::bias - large) << bits::mantissa));
+
+    // log(m) = 2 atanh(s), s = (m-1)/(m+1)
+    T s = (m - T(1)) / (m + T(1));
+    T s2 = s * s;
+    T p;
+    if (L >= 2)
+        p = s * poly(s2, 2, 2.0/3, 2.0/5);
+    else
+        p = s * poly(s2, 2, 2.0/3, 2.0/5, 2.0/7, 2.0/9, 2.0/11, 2.0/13);
+
+    // Zero, negative numbers (including -0), infinity and NaN
+    int_type r = to_bits(T(e) * T(ln2) + p);
+    r = blend(i == 0, to_bits(-std::numeric_limits<T>::infinity()), r);
+    r = blend(i < 0, to_bits(std::numeric_limits<T>::quiet_NaN()), r);
+    r = blend(i >= to_bits(std::numeric_limits<T>::infinity()), i, r);
+    return from_bits<T>(r);
+}
+
+template <int L, typename T> inline
+T log2(T x)
+{
+    return log<L>(x) * T(log2e);
+}
+
+template <int L, typename T> inline
+T log10(T x)
+{
+    return log<L>(x) * T(log10e);
+}
+
+template <int L, typename T> inline
+T atan(T x)
+{
+    // Reduce to |t| <= tan(pi/8) using
+    // atan(a) = pi/2 - atan(1/a) and atan(a) = pi/4 + atan((a-1)/(a+1)).
+    T a = std::abs(x);
+    bool inverted = a > T(1);
+    a = select(inverted, T(1) / a, a);
+    bool shifted = a > T(0.41421356237309504880);
+    T t = select(shifted, (a - T(1)) / (a + T(1)), a);
+    T t2 = t * t;
+    T p;
+    if (L >= 2)
+        p = t * poly(t2, 1, -1.0/3, 1.0/5, -1.0/7, 1.0/9);
+    else
+        p = t * poly(t2, 1, -1.0/3, 1.0/5, -1.0/7, 1.0/9, -1.0/11,
+                     1.0/13, -1.0/15, 1.0/17, -1.0/19, 1.0/21);
+    p = select(shifted, p + T(pi_4), p);
+    p = select(inverted, T(pi_2) - p, p);
+    return std::copysign(p, x);
+}
+
+template <int L, typename T> inline
+T pow(T x, T y)
+{
+    return exp2<L>(y * log2<L>(x));
+}
+
+}
+
+// Fast Fourier transforms used by built-in functions fft, ifft and rfft.
+// The size N is a power of two. Input and output must not overlap.
+// The inverse transform is scaled by 1/N, so that ifft(fft(x)) = x.
+
+namespace fft {
+
+// Twiddle factors exp(-2 pi i k / s) for spans s = 2, 4, ..., N
+// (stored at offset s/2 - 1 for k < s/2), and bit-reversed indexes.
+// A plan is computed once and shared by all program instances.
+
+template <typename T, int N>
+struct plan
+{
+    T re[N];
+    T im[N];
+    int reversed[N];
+
+    static const plan & get()
+    {
+        static const plan p;
+        return p;
+    }
+
+    plan()
+    {
+        for (int h = 1; h < N; h *= 2)
+        {
+            for (int k = 0; k < h; ++k)
+            {
+                double a = -fast_math::pi * k / h;
+                re[h - 1 + k] = T(std::cos(a));
+                im[h - 1 + k] = T(std::sin(a));
+            }
+        }
+
+        int bits = 0;
+        while ((1 << bits) < N)
+            ++bits;
+
+        for (int i = 0; i < N; ++i)
+        {
+            int r = 0;
+            for (int b = 0; b < bits; ++b)
+                r |= ((i >> b) & 1) << (bits - 1 - b);
+            reversed[i] = r;
+        }
+    }
+};
+
+// In-place forward transform of interleaved complex data
+// in bit-reversed order, using radix-4 butterflies
+// (and one radix-2 stage if log2(N) is odd).
+
+template <typename T, int N> inline
+void transform(T * d)
+{
+    const auto & p = plan<T,N>::get();
+
+    int h = 1;
+
+    int log2n = 0;
+    while ((1 << log2n) < N)
+        ++log2n;
+
+    if (log2n % 2)
+    {
+        for (int k = 0; k < 2 * N; k += 4)
+        {
+            T ar = d[k], ai = d[k+1];
+            T br = d[k+2], bi = d[k+3];
+            d[k] = ar + br; d[k+1] = ai + bi;
+            d[k+2] = ar - br; d[k+3] = ai - bi;
+        }
+        h = 2;
+    }
+
+    for (; h < N; h *= 4)
+    {
+        // Twiddles for spans 2h and 4h.
+        const T * w1r = p.re + h - 1;
+        const T * w1i = p.im + h - 1;
+        const T * w2r = p.re + 2 * h - 1;
+        const T * w2i = p.im + 2 * h - 1;
+
+        for (int k = 0; k < N; k += 4 * h)
+        {
+            T * x0 = d + 2 * k;
+            T * x1 = x0 + 2 * h;
+            T * x2 = x1 + 2 * h;
+            T * x3 = x2 + 2 * h;
+
+            for (int j = 0; j < h; ++j)
+            {
+                T c1 = w1r[j], s1 = w1i[j];
+                T c2 = w2r[j], s2 = w2i[j];
+
+                T x0r = x0[2*j], x0i = x0[2*j+1];
+                T x1r = x1[2*j], x1i = x1[2*j+1];
+                T x2r = x2[2*j], x2i = x2[2*j+1];
+                T x3r = x3[2*j], x3i = x3[2*j+1];
+
+                T t1r = x1r * c1 - x1i * s1, t1i = x1r * s1 + x1i * c1;
+                T t3r = x3r * c1 - x3i * s1, t3i = x3r * s1 + x3i * c1;
+
+                T a0r = x0r + t1r, a0i = x0i + t1i;
+                T a1r = x0r - t1r, a1i = x0i - t1i;
+                T a2r = x2r + t3r, a2i = x2i + t3i;
+                T a3r = x2r - t3r, a3i = x2i - t3i;
+
+                T u2r = a2r * c2 - a2i * s2, u2i = a2r * s2 + a2i * c2;
+                // Multiplied by exp(-2 pi i h / 4h) = -i.
+                T u3r = a3r * s2 + a3i * c2, u3i = a3r * -c2 + a3i * s2;
+
+                x0[2*j] = a0r + u2r; x0[2*j+1] = a0i + u2i;
+                x2[2*j] = a0r - u2r; x2[2*j+1] = a0i - u2i;
+                x1[2*j] = a1r + u3r; x1[2*j+1] = a1i + u3i;
+                x3[2*j] = a1r - u3r; x3[2*j+1] = a1i - u3i;
+            }
+        }
+    }
+}
+
+template <typename T> inline T * data(std::complex<T> * x)
+{
+    return reinterpret_cast<T*>(x);
+}
+
+template <int N, typename T> inline
+void fft(const std::complex<T> * in, std::complex<T> * out)
+{
+    const auto & p = plan<T,N>::get();
+    for (int i = 0; i < N; ++i)
+        out[p.reversed[i]] = in[i];
+    transform<T,N>(data(out));
+}
+
+template <int N, typename T> inline
+void fft(const T * in, std::complex<T> * out)
+{
+    const auto & p = plan<T,N>::get();
+    for (int i = 0; i < N; ++i)
+        out[p.reversed[i]] = std::complex<T>(in[i], T(0));
+    transform<T,N>(data(out));
+}
+
+// ifft(x) = conj(fft(conj(x))) / N
+
+template <int N, typename T> inline
+void ifft(const std::complex<T> * in, std::complex<T> * out)
+{
+    const auto & p = plan<T,N>::get();
+    for (int i = 0; i < N; ++i)
+        out[p.reversed[i]] = std::conj(in[i]);
+    T * d = data(out);
+    transform<T,N>(d);
+    const T scale = T(1) / T(N);
+    for (int i = 0; i < N; ++i)
+    {
+        d[2*i] *= scale;
+        d[2*i+1] *= -scale;
+    }
+}
+
+template <int N, typename T> inline
+void ifft(const T * in, std::complex<T> * out)
+{
+    const auto & p = plan<T,N>::get();
+    for (int i = 0; i < N; ++i)
+        out[p.reversed[i]] = std::complex<T>(in[i], T(0));
+    T * d = data(out);
+    transform<T,N>(d);
+    const T scale = T(1) / T(N);
+    for (int i = 0; i < N; ++i)
+    {
+        d[2*i] *= scale;
+        d[2*i+1] *= -scale;
+    }
+}
+
+// Transform of N real values, producing N/2+1 values
+// (the rest are complex conjugates).
+// Computed by a complex transform of size N/2
+// of even and odd values as real and imaginary parts.
+
+template <int N, typename T> inline
+void rfft(const T * in, std::complex<T> * out)
+{
+    const int M = N / 2;
+
+    const auto & p = plan<T,M>::get();
+    T * d = data(out);
+    for (int i = 0; i < M; ++i)
+    {
+        int r = p.reversed[i];
+        d[2*r] = in[2*i];
+        d[2*r+1] = in[2*i+1];
+    }
+    transform<T,M>(d);
+
+    // Twiddles for span N.
+    const auto & w = plan<T,N>::get();
+    const T * wr = w.re + M - 1;
+    const T * wi = w.im + M - 1;
+
+    for (int k = 1, m = M - 1; k <= m; ++k, --m)
+    {
+        T zkr = d[2*k], zki = d[2*k+1];
+        T zmr = d[2*m], zmi = d[2*m+1];
+
+        // Transforms of even and odd values:
+        // e = (z[k] + conj(z[m])) / 2, o = (z[k] - conj(z[m])) / 2i
+        T e_r = T(0.5) * (zkr + zmr), e_i = T(0.5) * (zki - zmi);
+        T o_r = T(0.5) * (zki + zmi), o_i = T(0.5) * (zmr - zkr);
+
+        // t = w^k o
+        T t_r = o_r * wr[k] - o_i * wi[k];
+        T t_i = o_r * wi[k] + o_i * wr[k];
+
+        // x[k] = e + t, x[m] = conj(e - t)
+        d[2*k] = e_r + t_r; d[2*k+1] = e_i + t_i;
+        d[2*m] = e_r - t_r; d[2*m+1] = t_i - e_i;
+    }
+
+    T z0r = d[0], z0i = d[1];
+    out[0] = std::complex<T>(z0r + z0i, T(0));
+    out[M] = std::complex<T>(z0r - z0i, T(0));
+}
+
+}
+
+#if defined(ARRP_HAS_MMAP)
+
+// Memory used by buffers with the --mirror-buffers compiler option.
+// The same physical pages are mapped at several consecutive virtual addresses,
+// so that an index past the end of one copy accesses the start of the next.
+// The size must be a multiple of the page size.
+
+class mirrored_buffer
+{
+public:
+    mirrored_buffer(size_t size, int copies): m_size(size * copies)
+    {
+        long page_size = sysconf(_SC_PAGESIZE);
+        if (page_size <= 0 || size % page_size != 0)
+            throw std::runtime_error("Mirrored buffer size is not a multiple of page size.");
+
+#if defined(__linux__)
+        int fd = memfd_create("arrp", MFD_CLOEXEC);
+#else
+        char name[64];
+        std::snprintf(name, sizeof(name), "/arrp-%ld-%p", long(getpid()), (void*)this);
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd != -1)
+            shm_unlink(name);
+#endif
+        if (fd == -1)
+            throw std::runtime_error("Failed to create mirrored buffer memory.");
+
+        if (ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to allocate mirrored buffer memory.");
+        }
+
+        void * reserved = mmap(nullptr, m_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (reserved == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to reserve mirrored buffer address space.");
+        }
+
+        m_data = reserved;
+
+        for (int i = 0; i < copies; ++i)
+        {
+            void * address = static_cast<char*>(reserved) + i * size;
+            void * mapped = mmap(address, size, PROT_READ | PROT_WRITE,
+                                 MAP_SHARED | MAP_FIXED, fd, 0);
+            if (mapped != address)
+            {
+                close(fd);
+                munmap(m_data, m_size);
+                throw std::runtime_error("Failed to map mirrored buffer memory.");
+            }
+        }
+
+        close(fd);
+    }
+
+    mirrored_buffer(const mirrored_buffer &) = delete;
+    mirrored_buffer & operator=(const mirrored_buffer &) = delete;
+
+    ~mirrored_buffer()
+    {
+        munmap(m_data, m_size);
+    }
+
+    void * data() const { return m_data; }
+
+private:
+    void * m_data = nullptr;
+    size_t m_size;
+};
+
+// Memory used by large finite arrays with the --out-of-core compiler option.
+// The memory is backed by a temporary file in $TMPDIR (or /tmp),
+// which is deleted immediately, so the operating system can write
+// pages that are not in use to the file instead of keeping them in RAM.
+// No prefetch or eviction hints are given; pages of a tile are
+// read in on first access and written back by the page cache.
+
+class file_buffer
+{
+public:
+    file_buffer(size_t size): m_size(size)
+    {
+        const char * dir = std::getenv("TMPDIR");
+        if (!dir || !*dir)
+            dir = "/tmp";
+
+        std::string path = std::string(dir) + "/arrp-XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back(0);
+
+        int fd = mkstemp(name.data());
+        if (fd == -1)
+            throw std::runtime_error("Failed to create temporary file for array.");
+
+        unlink(name.data());
+
+        if (ftruncate(fd, size) != 0)
+        {
+            close(fd);
+            throw std::runtime_error("Failed to allocate temporary file for array.");
+        }
+
+        m_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (m_data == MAP_FAILED)
+            throw std::runtime_error("Failed to map temporary file for array.");
+    }
+
+    file_buffer(const file_buffer &) = delete;
+    file_buffer & operator=(const file_buffer &) = delete;
+
+    ~file_buffer()
+    {
+        munmap(m_data, m_size);
+    }
+
+    void * data() const { return m_data; }
+
+private:
+    void * m_data = nullptr;
+    size_t m_size;
+};
+
+// Memory of finite inputs with the --mapped-input compiler option.
+// The input is mapped read-only from a file with the raw contents
+// of the input, so that its pages are shared by all program instances
+// and processes mapping the same file.
+// If no file is mapped before the prelude, the input is read
+// through the IO object into anonymous memory instead.
+
+class mapped_input
+{
+public:
+    mapped_input(size_t size): m_size(size) {}
+
+    mapped_input(const mapped_input &) = delete;
+    mapped_input & operator=(const mapped_input &) = delete;
+
+    ~mapped_input()
+    {
+        release();
+    }
+
+    // Maps the file and points 'ptr' to its contents.
+    template <typename P>
+    void map(const char * path, P & ptr)
+    {
+        int fd = open(path, O_RDONLY);
+        if (fd == -1)
+            throw std::runtime_error(std::string("Failed to open mapped input file ") + path);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || size_t(info.st_size) != m_size)
+        {
+            close(fd);
+            throw std::runtime_error(std::string("Size of mapped input file ") + path
+                                     + " does not match input size "
+                                     + std::to_string(m_size) + ".");
+        }
+
+        void * data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        close(fd);
+
+        if (data == MAP_FAILED)
+            throw std::runtime_error(std::string("Failed to map input file ") + path);
+
+        release();
+        m_data = data;
+        ptr = static_cast<P>(m_data);
+    }
+
+    // Allocates writable memory and points 'ptr' to it.
+    template <typename P>
+    void allocate(P & ptr)
+    {
+        void * data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED)
+            throw std::runtime_error("Failed to allocate input memory.");
+
+        release();
+        m_data = data;
+        ptr = static_cast<P>(m_data);
+    }
+
+    void * data() const { return m_data; }
+
+private:
+    void release()
+    {
+        if (m_data)
+            munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+
+    void * m_data = nullptr;
+    size_t m_size;
+};
+
+#endif
+
+// Counters added to generated code by the --instrument compiler option.
+
+namespace instrument {
+
+struct counter
+{
+    uint64_t instances = 0;
+    uint64_t ticks = 0;
+};
+
+struct counter_info
+{
+    const char * kind;
+    const char * name;
+    const char * function;
+    const char * location;
+    // Loops: names of statements in the loop nest, separated by spaces.
+    const char * statements;
+    // Statements are not timed. Their instances are the instances
+    // of the function counter times instances per call (-1 if unknown).
+    int function_counter;
+    int64_t instances_per_call;
+};
+
+inline uint64_t ticks()
+{
+#if defined(ARRP_HAS_RDTSC)
+    return __rdtsc();
+#else
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline const char * tick_unit()
+{
+#if defined(ARRP_HAS_RDTSC)
+    return "tsc";
+#else
+    return "ns";
+#endif
+}
+
+// Counts an instance and its duration while in scope.
+
+class scope
+{
+public:
+    scope(counter & c): m_counter(c), m_start(ticks()) {}
+    ~scope()
+    {
+        m_counter.ticks += ticks() - m_start;
+        ++m_counter.instances;
+    }
+private:
+    counter & m_counter;
+    uint64_t m_start;
+};
+
+inline void print_json_string(std::ostream & out, const char * text)
+{
+    out << '"';
+    for (; *text; ++text)
+    {
+        if (*text == '"' || *text == '\\')
+            out << '\\';
+        out << *text;
+    }
+    out << '"';
+}
+
+inline void print_json(std::ostream & out, const counter * counters,
+                       const counter_info * info, int count)
+{
+    out << "{" << std::endl;
+    out << "  \"tick-unit\": \"" << tick_unit() << "\"," << std::endl;
+    out << "  \"counters\": [" << std::endl;
+    for (int i = 0; i < count; ++i)
+    {
+        out << "    { \"kind\": "; print_json_string(out, info[i].kind);
+        out << ", \"name\": "; print_json_string(out, info[i].name);
+        out << ", \"function\": "; print_json_string(out, info[i].function);
+        out << ", \"location\": "; print_json_string(out, info[i].location);
+        if (*info[i].statements)
+        {
+            out << ", \"statements\": "; print_json_string(out, info[i].statements);
+        }
+        if (info[i].function_counter >= 0)
+        {
+            out << ", \"instances\": ";
+            if (info[i].instances_per_call >= 0)
+                out << counters[info[i].function_counter].instances * info[i].instances_per_call;
+            else
+                out << "null";
+        }
+        else
+        {
+            out << ", \"instances\": " << counters[i].instances;
+            out << ", \"ticks\": " << counters[i].ticks;
+        }
+        out << " }";
+        if (i < count - 1)
+            out << ',';
+        out << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+}
+
 }
@@ -0,0 +1,215 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "buffer_layout.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_set>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace cpp_gen {
+
+static int element_alignment(primitive_type pt, const compiler::options & opt)
+{
+    int alignment = size_in_bytes(pt);
+    if (is_complex(pt))
+        alignment /= 2;
+    return std::min(alignment, opt.target.max_alignment);
+}
+
+static int64_t round_up(int64_t value, int64_t alignment)
+{
+    if (alignment <= 1)
+        return value;
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static int64_t byte_size(const buffer & buf)
+{
+    int64_t size = size_in_bytes(buf.type);
+    for (auto & s : buf.padded_size)
+        size *= s;
+    return size;
+}
+
+static bool is_array(const buffer & buf)
+{
+    return std::any_of(buf.dimension_size.begin(), buf.dimension_size.end(),
+                       [](int s){ return s != 1; });
+}
+
+static void pad_inner_dimension(buffer & buf, const cache_params & cache)
+{
+    // Find innermost dimension which is not collapsed
+
+    int inner_dim = -1;
+    for (int dim = buf.padded_size.size() - 1; dim >= 0; --dim)
+    {
+        if (buf.padded_size[dim] != 1)
+        {
+            inner_dim = dim;
+            break;
+        }
+    }
+
+    if (inner_dim < 1)
+        return;
+
+    // Planes of planar buffers hold real numbers.
+    int elem_size = size_in_bytes(buf.planar ? component_type(buf.type) : buf.type);
+
+    // Consider each outer dimension.
+    // Walking along it touches rows at a fixed stride.
+    // If the stride is a multiple of the line size,
+    // the rows map to a limited number of cache sets.
+
+    bool needs_padding = false;
+
+    int64_t stride = int64_t(buf.padded_size[inner_dim]) * elem_size;
+    for (int dim = inner_dim - 1; dim >= 0; --dim)
+    {
+        int row_count = buf.padded_size[dim];
+
+        if (row_count > 1 && stride % cache.line_size == 0)
+        {
+            int64_t stride_lines = stride / cache.line_size;
+            int64_t distinct_sets = cache.set_count / std::gcd(stride_lines, int64_t(cache.set_count));
+            if (row_count > distinct_sets * cache.associativity)
+                needs_padding = true;
+        }
+
+        stride *= buf.padded_size[dim];
+    }
+
+    if (!needs_padding)
+        return;
+
+    int padding = std::max(1, cache.line_size / elem_size);
+    buf.padded_size[inner_dim] += padding;
+
+    if (verbose<cpp_target>::enabled())
+    {
+        cout << "Padding inner dimension of buffer " << buf.name
+             << " by " << padding << " elements." << endl;
+    }
+}
+
+void layout_buffers(const polyhedral::model & model,
+                    unordered_map<string,buffer> & buffers,
+                    const compiler::options & opt)
+{
+    vector<buffer*> fields;
+    for (auto & array : model.arrays)
+    {
+        auto & buf = buffers.at(array->name);
+        buf.padded_size = buf.dimension_size;
+        buf.padding = 0;
+        buf.offset = -1;
+        // Mirrored, file-backed and mapped buffers are allocated separately.
+        if (!buf.on_stack && !buf.mirror_count && !buf.file_backed && !buf.mapped_input)
+            fields.push_back(&buf);
+    }
+
+    if (opt.target.pointer_size < 1 || opt.target.max_alignment < 1)
+        throw error("Invalid target pointer size or alignment.");
+
+    // The "io" pointer comes first.
+    int64_t offset = opt.target.pointer_size;
+
+    if (opt.cache_layout.empty())
+    {
+        for (auto * buf : fields)
+        {
+            int64_t alignment = element_alignment(buf->type, opt);
+            if (is_array(*buf))
+                alignment = std::max(alignment, int64_t(opt.data_alignment));
+            offset = round_up(offset, alignment);
+            buf->offset = offset;
+            offset += byte_size(*buf);
+        }
+        return;
+    }
+
+    cache_params cache;
+    if (opt.cache_layout.size() > 0)
+        cache.line_size = opt.cache_layout[0];
+    if (opt.cache_layout.size() > 1)
+        cache.set_count = opt.cache_layout[1];
+    if (opt.cache_layout.size() > 2)
+        cache.associativity = opt.cache_layout[2];
+
+    if (cache.line_size < 1 || cache.set_count < 1 || cache.associativity < 1)
+        throw error("Invalid cache parameters.");
+
+    for (auto * buf : fields)
+        pad_inner_dimension(*buf, cache);
+
+    // Place large buffers first, so they get the first choice of sets.
+
+    std::stable_sort(fields.begin(), fields.end(),
+                     [](buffer * a, buffer * b){ return byte_size(*a) > byte_size(*b); });
+
+    int64_t alignment = std::max(cache.line_size, opt.data_alignment);
+
+    unordered_set<int64_t> used_sets;
+
+    for (auto * buf : fields)
+    {
+        int64_t aligned_offset = round_up(offset, alignment);
+
+        // Choose the nearest start whose cache set is not yet used
+        // by the start of another buffer.
+
+        int64_t start = aligned_offset;
+        for (int64_t candidate = aligned_offset;
+             candidate < aligned_offset + cache.way_size();
+             candidate += alignment)
+        {
+            int64_t set = (candidate / cache.line_size) % cache.set_count;
+            if (!used_sets.count(set))
+            {
+                start = candidate;
+                break;
+            }
+        }
+
+        used_sets.insert((start / cache.line_size) % cache.set_count);
+
+        buf->padding = start - aligned_offset;
+        buf->offset = start;
+
+        // Round up the end, so the next buffer does not share a line.
+        offset = round_up(start + byte_size(*buf), cache.line_size);
+
+        if (verbose<cpp_target>::enabled())
+        {
+            cout << "Buffer " << buf->name << " at offset " << buf->offset
+                 << " (set " << (start / cache.line_size) % cache.set_count << ")"
+                 << " with " << buf->padding << " bytes of padding before." << endl;
+        }
+    }
+}
+
+}
+}
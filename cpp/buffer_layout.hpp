@@ -0,0 +1,58 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_CPP_BUFFER_LAYOUT_INCLUDED
+#define STREAM_LANG_CPP_BUFFER_LAYOUT_INCLUDED
+
+#include "cpp_target.hpp"
+
+#include <unordered_map>
+
+namespace stream {
+namespace cpp_gen {
+
+using std::unordered_map;
+
+struct cache_params
+{
+    int line_size = 64;
+    int set_count = 64;
+    int associativity = 8;
+
+    // Addresses that differ by a multiple of this
+    // map to the same cache set.
+    int way_size() const { return line_size * set_count; }
+};
+
+// Assigns byte offsets to buffers stored in the program object.
+// Without cache parameters, buffers are laid out in declaration order.
+// With cache parameters, inner dimensions are padded to avoid mapping
+// rows to the same cache sets, and buffers are ordered and aligned
+// to cache lines so that their starting addresses map to distinct sets
+// and no two buffers share a cache line.
+
+void layout_buffers(const polyhedral::model &,
+                    unordered_map<string,buffer> &,
+                    const compiler::options &);
+
+}
+}
+
+#endif // STREAM_LANG_CPP_BUFFER_LAYOUT_INCLUDED
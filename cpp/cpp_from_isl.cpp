@@ -42,9 +42,34 @@ void cpp_from_isl::generate( isl_ast_node * ast )
     process_node(ast);
 }
 
+static isl_bool collect_statement_name(isl_ast_node *node, void *user)
+{
+    if (isl_ast_node_get_type(node) != isl_ast_node_user)
+        return isl_bool_true;
+
+    auto & names = *reinterpret_cast<vector<string>*>(user);
+
+    auto expr = isl_ast_node_user_get_expr(node);
+    auto func = isl_ast_expr_get_op_arg(expr, 0);
+    auto id = isl_ast_expr_get_id(func);
+    names.push_back(isl_id_get_name(id));
+    isl_id_free(id);
+    isl_ast_expr_free(func);
+    isl_ast_expr_free(expr);
+
+    return isl_bool_true;
+}
+
 void cpp_from_isl::process_node(isl_ast_node *node)
 {
     auto type = isl_ast_node_get_type(node);
+
+    if (m_guard_enter && (type == isl_ast_node_for || type == isl_ast_node_user))
+    {
+        process_guarded(node);
+        return;
+    }
+
     switch(type)
     {
     case isl_ast_node_for:
@@ -68,6 +93,75 @@ void cpp_from_isl::process_node(isl_ast_node *node)
     }
 }
 
+// A loop nest or statement is wrapped into a guard
+// if the enter function returns a condition for the statements in it:
+// if (condition) { ... }
+
+void cpp_from_isl::process_guarded(isl_ast_node *node)
+{
+    vector<string> names;
+    isl_ast_node_foreach_descendant_top_down(node, &collect_statement_name, &names);
+
+    auto generate = [&]()
+    {
+        if (isl_ast_node_get_type(node) == isl_ast_node_for)
+            process_for(node);
+        else
+            process_user(node);
+    };
+
+    auto condition = m_guard_enter(names);
+
+    if (!condition)
+    {
+        generate();
+        m_guard_leave();
+        return;
+    }
+
+    auto body = make_shared<block_statement>();
+
+    m_ctx->push(*body);
+    generate();
+    m_ctx->pop();
+
+    m_guard_leave();
+
+    m_guard_conditions.insert(condition.get());
+    m_ctx->add(make_shared<if_statement>(condition, body, nullptr));
+}
+
+// Consecutive guards with the same condition are merged into one,
+// so that a group of statements is guarded as a whole.
+
+void cpp_from_isl::merge_guards(vector<statement_ptr> & stmts, int begin)
+{
+    int last = -1;
+    int end = begin;
+    for (int i = begin; i < (int) stmts.size(); ++i)
+    {
+        auto guard = dynamic_pointer_cast<if_statement>(stmts[i]);
+        if (guard && !m_guard_conditions.count(guard->condition.get()))
+            guard = nullptr;
+
+        if (guard && last >= 0)
+        {
+            auto prev = static_pointer_cast<if_statement>(stmts[last]);
+            if (prev->condition == guard->condition)
+            {
+                auto & prev_body = static_pointer_cast<block_statement>(prev->true_part)->statements;
+                auto & body = static_pointer_cast<block_statement>(guard->true_part)->statements;
+                prev_body.insert(prev_body.end(), body.begin(), body.end());
+                continue;
+            }
+        }
+
+        last = guard ? end : -1;
+        stmts[end++] = stmts[i];
+    }
+    stmts.resize(end);
+}
+
 void cpp_from_isl::process_block(isl_ast_node *node)
 {
     // The generate AST is weird:
@@ -80,6 +174,9 @@ void cpp_from_isl::process_block(isl_ast_node *node)
 
     //m_ctx->push(&block->statements);
 
+    auto & stmts = *m_ctx->current_block().stmts;
+    int begin = stmts.size();
+
     auto list = isl_ast_node_block_get_children(node);
     int n_children = isl_ast_node_list_n_ast_node(list);
 
@@ -92,6 +189,9 @@ void cpp_from_isl::process_block(isl_ast_node *node)
 
     isl_ast_node_list_free(list);
 
+    if (m_guard_enter)
+        merge_guards(stmts, begin);
+
     //m_ctx->pop();
 
     //m_ctx->add(block);
@@ -174,6 +274,9 @@ void cpp_from_isl::process_for(isl_ast_node *node)
 
     for_stmt->initialization = iter_decl;
 
+    if (m_instrumentation && m_loop_depth == 0)
+        m_instrumentation->loop_statements.clear();
+
     for_stmt->condition = cond;
 
     for_stmt->update = binop(op::assign_add, iter, inc);
@@ -184,7 +287,9 @@ void cpp_from_isl::process_for(isl_ast_node *node)
         m_ctx->push(&stmts);
         m_ctx->current_block().induction_var = iter_id->name;
 
+        ++m_loop_depth;
         process_node(body_node);
+        --m_loop_depth;
 
         m_ctx->pop();
 
@@ -200,7 +305,24 @@ void cpp_from_isl::process_for(isl_ast_node *node)
         for_stmt->is_vector = info->is_vector;
     }
 
-    m_ctx->add(for_stmt);
+    if (m_instrumentation && m_loop_depth == 0)
+    {
+        // Count instances and time of the outermost loop.
+
+        auto & table = *m_instrumentation;
+        string name = table.function + ".loop" + to_string(table.loop_count++);
+        int counter = table.index("loop", name);
+        table.entries[counter].statements = table.loop_statements;
+
+        auto nest = make_shared<block_statement>();
+        nest->statements.push_back(stmt(instrument_table::scope_decl(counter, "instrument_loop_scope")));
+        nest->statements.push_back(for_stmt);
+        m_ctx->add(nest);
+    }
+    else
+    {
+        m_ctx->add(for_stmt);
+    }
 
     isl_ast_expr_free(iter_expr);
     isl_ast_expr_free(init_expr);
@@ -21,12 +21,14 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #ifndef STREAM_LANG_CPP_FROM_ISL_INCLUDED
 #define STREAM_LANG_CPP_FROM_ISL_INCLUDED
 
+#include "cpp_target.hpp"
 #include "../utility/context.hpp"
 #include "../utility/cpp-gen.hpp"
 
 #include <isl/ast.h>
 
 #include <functional>
+#include <unordered_set>
 
 namespace stream {
 namespace cpp_gen {
@@ -50,8 +52,22 @@ public:
         m_id_func = f;
     }
 
+    // Loop nests and statements are wrapped in the condition returned
+    // by the enter function for the names of statements in them, if any.
+    // The leave function is called after each such node.
+    template<typename E, typename L>
+    void set_guard_funcs(E enter, L leave)
+    {
+        m_guard_enter = enter;
+        m_guard_leave = leave;
+    }
+
+    void set_instrumentation(instrument_table * table) { m_instrumentation = table; }
+
 private:
     void process_node(isl_ast_node *node);
+    void process_guarded(isl_ast_node *node);
+    void merge_guards(vector<statement_ptr> & stmts, int begin);
     void process_block(isl_ast_node *node);
     void process_for(isl_ast_node *node);
     void process_if(isl_ast_node *node);
@@ -68,7 +84,17 @@ private:
     std::function<expression_ptr(const string &)>
     m_id_func;
 
+    std::function<expression_ptr(const vector<string> &)>
+    m_guard_enter;
+
+    std::function<void()>
+    m_guard_leave;
+
+    std::unordered_set<expression*> m_guard_conditions;
+
     bool m_is_user_stmt = false;
+    int m_loop_depth = 0;
+    instrument_table * m_instrumentation = nullptr;
     builder *m_ctx;
 };
 
@@ -16,7 +16,84 @@ cpp_from_polyhedral::cpp_from_polyhedral
     m_model(model),
     m_buffers(buffers),
     m_name_mapper(nm)
-{}
+{
+    for (auto & entry : m_buffers)
+    {
+        if (entry.second.planar)
+            m_has_planar_buffers = true;
+    }
+}
+
+void cpp_from_polyhedral::set_denormal_guards(bool flag)
+{
+    m_denormal_guards = flag;
+    m_recursive_arrays.clear();
+
+    if (!flag)
+        return;
+
+    // Find arrays which (indirectly) depend on themselves.
+
+    unordered_map<polyhedral::array*, unordered_set<polyhedral::array*>> sources;
+
+    for (auto & stmt : m_model.statements)
+    {
+        for (auto & write : stmt->array_accesses)
+        {
+            if (!write->writing)
+                continue;
+            for (auto & read : stmt->array_accesses)
+            {
+                if (read->reading)
+                    sources[write->array.get()].insert(read->array.get());
+            }
+        }
+    }
+
+    for (auto & array : m_model.arrays)
+    {
+        unordered_set<polyhedral::array*> visited;
+        vector<polyhedral::array*> work { array.get() };
+
+        while(!work.empty())
+        {
+            auto a = work.back();
+            work.pop_back();
+
+            for (auto source : sources[a])
+            {
+                if (source == array.get())
+                {
+                    m_recursive_arrays.insert(source);
+                    break;
+                }
+                if (visited.insert(source).second)
+                    work.push_back(source);
+            }
+
+            if (m_recursive_arrays.count(array.get()))
+                break;
+        }
+    }
+
+    if (verbose<cpp_target>::enabled())
+    {
+        for (auto array : m_recursive_arrays)
+            cout << "Guarding against denormals in array " << array->name << endl;
+    }
+}
+
+expression_ptr cpp_from_polyhedral::denormal_guard
+(expression_ptr value, polyhedral::array * array)
+{
+    if (!m_denormal_guards || !m_recursive_arrays.count(array))
+        return value;
+
+    if (!is_real(array->type) && !is_complex(array->type))
+        return value;
+
+    return call(make_id("arrp::flush_denormal"), { value });
+}
 
 static primitive_type prim_type(const functional::expression * expr)
 {
@@ -42,7 +119,7 @@ static expression_ptr to_complex64(expression_ptr e, primitive_type t)
     else
         return call(f, {e, literal((double)0)});
 }
-#if 0
+
 static expression_ptr to_complex32(expression_ptr e, primitive_type t)
 {
     if (t == primitive_type::complex32)
@@ -53,9 +130,8 @@ static expression_ptr to_complex32(expression_ptr e, primitive_type t)
     if (t == primitive_type::complex64)
         return call(f, {e});
     else
-        return call(f, {e, literal((double)0)});
+        return call(f, {e, literal((float)0)});
 }
-#endif
 
 static expression_ptr to_real64(expression_ptr e, primitive_type t)
 {
@@ -81,6 +157,58 @@ static expression_ptr to_type(expression_ptr e, primitive_type a, primitive_type
     return cast(type_for(r), e);
 }
 
+// Calls a standard math function, or its approximation in arrp::fast_math
+// if enabled at the given level and the result is a real number.
+
+expression_ptr cpp_from_polyhedral::math_function
+(const string & name, functional::primitive * expr,
+ const vector<expression_ptr> & operands, int min_fast_math_level)
+{
+    auto r_t = prim_type(expr);
+
+    bool fast = m_fast_math >= min_fast_math_level && is_real(r_t);
+    for (auto & operand : expr->operands)
+        fast &= !is_complex(prim_type(operand));
+
+    if (!fast)
+        return call(make_id(name), operands);
+
+    // Approximations are templates, so all arguments must have the result type.
+    vector<expression_ptr> args;
+    for (int i = 0; i < (int) operands.size(); ++i)
+        args.push_back(to_type(operands[i], prim_type(expr->operands[i]), r_t));
+
+    int level = std::min(m_fast_math, 2);
+    return call(make_id("arrp::fast_math::" + name + "<" + to_string(level) + ">"), args);
+}
+
+static expression_ptr zero(primitive_type t)
+{
+    if (t == primitive_type::real32)
+        return literal((float)0);
+    else
+        return literal((double)0);
+}
+
+// Returns an expression that can be evaluated multiple times
+// without repeating computation, storing the value into
+// a temporary variable if needed.
+
+static expression_ptr reusable(expression_ptr e, builder * ctx)
+{
+    if (!e)
+        return e;
+
+    if (dynamic_pointer_cast<id_expression>(e) ||
+            dynamic_pointer_cast<literal_expression<float>>(e) ||
+            dynamic_pointer_cast<literal_expression<double>>(e))
+        return e;
+
+    auto tmp_name = ctx->new_var_id();
+    ctx->add(make_shared<expr_statement>(decl_expr(auto_type(), tmp_name, e)));
+    return make_id(tmp_name);
+}
+
 void cpp_from_polyhedral::generate_statement
 (const string & name, const index_type & index, builder* ctx)
 {
@@ -93,16 +221,124 @@ void cpp_from_polyhedral::generate_statement
     generate_statement((*stmt_ref).get(), index, ctx);
 }
 
+static string statement_location(polyhedral::statement * stmt)
+{
+    auto expr = stmt->expr;
+    if (auto assign = dynamic_pointer_cast<polyhedral::assignment>(expr))
+        expr = assign->value;
+
+    ostringstream text;
+    text << expr->location;
+    return text.str();
+}
+
+void cpp_from_polyhedral::set_output_masks
+(const unordered_map<string, uint64_t> & masks, const string & active_outputs)
+{
+    m_output_masks = masks;
+    m_active_outputs = active_outputs;
+    m_output_guards.clear();
+    m_output_guard_conditions.clear();
+}
+
+// In the period, a loop nest or statement which only contributes
+// to some outputs is skipped unless one of them is active:
+// if (active_outputs & mask) { ... }
+// A guard is only generated where it excludes more outputs
+// than the enclosing guards, so it is normally placed around
+// an outermost loop nest, and statements within it are not guarded.
+
+expression_ptr cpp_from_polyhedral::enter_output_guard(const vector<string> & stmt_names)
+{
+    uint64_t enclosing = m_output_guards.empty() ? ~uint64_t(0) : m_output_guards.back();
+
+    if (!m_in_period || m_active_outputs.empty())
+    {
+        m_output_guards.push_back(enclosing);
+        return nullptr;
+    }
+
+    uint64_t outputs = 0;
+    for (auto & name : stmt_names)
+    {
+        auto mask = m_output_masks.find(name);
+        if (mask == m_output_masks.end())
+        {
+            outputs = ~uint64_t(0);
+            break;
+        }
+        outputs |= mask->second;
+    }
+
+    outputs &= enclosing;
+
+    m_output_guards.push_back(outputs);
+
+    if (outputs == enclosing)
+        return nullptr;
+
+    auto & condition = m_output_guard_conditions[outputs];
+    if (!condition)
+        condition = binop(op::bit_and, make_id(m_active_outputs), literal(outputs));
+    return condition;
+}
+
+void cpp_from_polyhedral::leave_output_guard()
+{
+    m_output_guards.pop_back();
+}
+
 void cpp_from_polyhedral::generate_statement
 (polyhedral::statement *stmt, const index_type & index, builder* ctx)
 {
     m_current_stmt = stmt;
 
+    if (m_instrumentation)
+        m_instrumentation->add_statement(stmt->name, statement_location(stmt));
+
     auto expr = generate_expression(stmt->expr, index, ctx);
 
+    if (auto input = mapped_input(stmt))
+    {
+        ctx->add(mapped_input_fallback(input, expr));
+        return;
+    }
+
     ctx->add(expr);
 }
 
+polyhedral::array * cpp_from_polyhedral::mapped_input(polyhedral::statement * stmt)
+{
+    if (!stmt->is_input_or_output)
+        return nullptr;
+
+    auto call = dynamic_pointer_cast<polyhedral::external_call>(stmt->expr);
+    if (!call || call->args.empty())
+        return nullptr;
+
+    auto access = dynamic_cast<polyhedral::array_access*>(call->args[0].get());
+    if (!access || !access->writing || !m_buffers.at(access->array->name).mapped_input)
+        return nullptr;
+
+    return access->array.get();
+}
+
+// Reads a mapped input through IO into allocated memory,
+// unless it has been mapped from a file:
+// if (!x_mem.data()) { x_mem.allocate(x); io->input_x(x); }
+
+statement_ptr cpp_from_polyhedral::mapped_input_fallback
+(polyhedral::array * array, expression_ptr read)
+{
+    auto mem = make_id(m_name_mapper(array->name + "_mem"));
+    auto data = call(binop(op::member_of_reference, mem, make_id("data")), {});
+    auto allocate = call(binop(op::member_of_reference, mem, make_id("allocate")),
+                         { make_id(m_name_mapper(array->name)) });
+
+    auto body = block({ stmt(allocate), stmt(read) });
+    return make_shared<if_statement>(unop(op::logic_neg, data), body, nullptr);
+}
+
 expression_ptr cpp_from_polyhedral::generate_expression
 (functional::expr_ptr expr, const index_type & index, builder * ctx)
 {
@@ -121,11 +357,20 @@ expression_ptr cpp_from_polyhedral::generate_expression
     }
     else if (auto access = dynamic_cast<polyhedral::array_access*>(expr.get()))
     {
-        index_type target_index;
-        for (auto & e : access->indexes)
-            target_index.push_back(generate_expression(e, index, ctx));
+        if (is_planar(expr))
+        {
+            auto re = generate_planar_access(access, index, ctx, 0);
+            auto im = generate_planar_access(access, index, ctx, 1);
+            result = call(make_id(type_name_for(prim_type(expr))), { re, im });
+        }
+        else
+        {
+            index_type target_index;
+            for (auto & e : access->indexes)
+                target_index.push_back(generate_expression(e, index, ctx));
 
-        result = generate_buffer_access(access->array, target_index, ctx);
+            result = generate_buffer_access(access->array, target_index, ctx);
+        }
     }
     else if ( auto const_int = dynamic_cast<functional::int_const*>(expr.get()) )
     {
@@ -174,6 +419,14 @@ expression_ptr cpp_from_polyhedral::generate_expression
         for (auto & arg : call->args)
             args.push_back(generate_expression(arg, index, ctx));
 
+        if (call->is_builtin)
+        {
+            // The transform size is a template argument.
+            int size = call->args[0]->type->array()->size[0];
+            auto callee = make_id("arrp::fft::" + call->name + "<" + to_string(size) + ">");
+            return make_shared<call_expression>(callee, args);
+        }
+
         // FIXME: don't hardcode "io"
         auto callee = make_shared<bin_op_expression>
                 (op::member_of_pointer, make_id("io"), make_id(call->name));
@@ -181,8 +434,31 @@ expression_ptr cpp_from_polyhedral::generate_expression
     }
     else if (auto assign = dynamic_cast<polyhedral::assignment*>(expr.get()))
     {
+        if (is_planar(assign->destination))
+        {
+            // Store real and imaginary parts into separate planes.
+
+            auto dest = static_cast<polyhedral::array_access*>(assign->destination.get());
+            auto t = component_type(prim_type(assign->destination));
+
+            auto value = generate_complex_parts(assign->value, index, ctx);
+            if (!value.im)
+                value.im = zero(t);
+
+            value.re = denormal_guard(value.re, dest->array.get());
+            value.im = denormal_guard(value.im, dest->array.get());
+
+            auto dest_re = generate_planar_access(dest, index, ctx, 0);
+            ctx->add(cpp_gen::assign(dest_re, value.re));
+
+            auto dest_im = generate_planar_access(dest, index, ctx, 1);
+            return cpp_gen::assign(dest_im, value.im);
+        }
+
         auto dest = generate_expression(assign->destination, index, ctx);
         auto value = generate_expression(assign->value, index, ctx);
+        if (auto dest_access = dynamic_cast<polyhedral::array_access*>(assign->destination.get()))
+            value = denormal_guard(value, dest_access->array.get());
         auto store = make_shared<bin_op_expression>(op::assign, dest, value);
         return store;
     }
@@ -244,6 +520,21 @@ expression_ptr cpp_from_polyhedral::generate_primitive
 
         return id_expr;
     }
+    case primitive_op::real:
+    case primitive_op::imag:
+    {
+        if (!m_has_planar_buffers || !is_complex(prim_type(expr->operands[0])))
+            break;
+
+        // Avoid forming a complex value from planar storage.
+
+        auto parts = generate_complex_parts(expr->operands[0], index, ctx);
+        if (expr->kind == primitive_op::real)
+            return parts.re;
+        if (parts.im)
+            return parts.im;
+        return zero(component_type(prim_type(expr->operands[0])));
+    }
     default:
         break;
     }
@@ -292,16 +583,29 @@ expression_ptr cpp_from_polyhedral::generate_primitive
         }
         else if ( r_t == t::complex32 )
         {
-            if (!is_complex(lhs_t))
+            // Operands may have higher precision with --single-precision.
+            if (is_complex(lhs_t))
+                lhs = to_complex32(lhs, lhs_t);
+            else
+                lhs = to_real32(lhs, lhs_t);
+
+            if (is_complex(rhs_t))
+                rhs = to_complex32(rhs, rhs_t);
+            else
+                rhs = to_real32(rhs, rhs_t);
+        }
+        else if ( r_t == t::real32 )
+        {
+            if (lhs_t == t::real64)
                 lhs = to_real32(lhs, lhs_t);
-            if (!is_complex(rhs_t))
+            if (rhs_t == t::real64)
                 rhs = to_real32(rhs, rhs_t);
         }
         else if (expr->kind == primitive_op::divide)
         {
             if (is_integer(lhs_t) && is_integer(rhs_t))
             {
-                lhs = cast(double_type(), lhs);
+                lhs = cast(type_for(r_t), lhs);
             }
         }
 
@@ -363,7 +667,8 @@ expression_ptr cpp_from_polyhedral::generate_primitive
     }
     case primitive_op::raise:
     {
-        return make_shared<call_expression>("pow", operands[0], operands[1]);
+        // Approximation of pow has a large error, so only at level 2.
+        return math_function("pow", expr, operands, 2);
     }
     case primitive_op::floor:
     {
@@ -397,27 +702,26 @@ expression_ptr cpp_from_polyhedral::generate_primitive
     }
     case primitive_op::log:
     {
-        return make_shared<call_expression>("log", operands[0]);
+        return math_function("log", expr, operands);
     }
     case primitive_op::log2:
     {
-        return make_shared<call_expression>("log2", operands[0]);
+        return math_function("log2", expr, operands);
     }
     case primitive_op::log10:
     {
-        return make_shared<call_expression>("log10", operands[0]);
+        return math_function("log10", expr, operands);
     }
     case primitive_op::exp:
     {
-        return make_shared<call_expression>("exp", operands[0]);
+        return math_function("exp", expr, operands);
     }
     case primitive_op::exp2:
     {
         auto arg_t = prim_type(expr->operands[0]);
-        expression_ptr result = make_shared<call_expression>("exp2", operands[0]);
         if (is_integer(arg_t))
-            result = cast(type_for(arg_t), result);
-        return result;
+            return cast(type_for(arg_t), make_shared<call_expression>("exp2", operands[0]));
+        return math_function("exp2", expr, operands);
     }
     case primitive_op::sqrt:
     {
@@ -425,15 +729,15 @@ expression_ptr cpp_from_polyhedral::generate_primitive
     }
     case primitive_op::sin:
     {
-        return make_shared<call_expression>("sin", operands[0]);
+        return math_function("sin", expr, operands);
     }
     case primitive_op::cos:
     {
-        return make_shared<call_expression>("cos", operands[0]);
+        return math_function("cos", expr, operands);
     }
     case primitive_op::tan:
     {
-        return make_shared<call_expression>("tan", operands[0]);
+        return math_function("tan", expr, operands);
     }
     case primitive_op::asin:
     {
@@ -445,7 +749,7 @@ expression_ptr cpp_from_polyhedral::generate_primitive
     }
     case primitive_op::atan:
     {
-        return make_shared<call_expression>("atan", operands[0]);
+        return math_function("atan", expr, operands);
     }
     case primitive_op::real:
     {
@@ -493,60 +797,253 @@ expression_ptr cpp_from_polyhedral::generate_primitive
         return cast(btype("uint64_t"), operands[0]);
     }
     case primitive_op::to_real32:
+    case primitive_op::to_real64:
+    {
+        // The result type may be demoted by --single-precision.
+        return to_type(operands[0], prim_type(expr->operands[0]), prim_type(expr));
+    }
+    case primitive_op::to_complex32:
+    case primitive_op::to_complex64:
     {
-        if (expr->operands[0]->type->scalar()->primitive != primitive_type::real32)
-            return cast(float_type(), operands[0]);
+        auto t = expr->operands[0]->type->scalar()->primitive;
+        if (prim_type(expr) == primitive_type::complex32)
+            return to_complex32(operands[0], t);
         else
-            return operands[0];
+            return to_complex64(operands[0], t);
     }
-    case primitive_op::to_real64:
+    default:
+        ostringstream text;
+        text << "Unexpected primitive op: " << expr->kind;
+        throw error(text.str());
+    }
+}
+
+bool cpp_from_polyhedral::is_planar(const functional::expr_ptr & expr)
+{
+    auto access = dynamic_cast<polyhedral::array_access*>(expr.get());
+    if (!access || !access->type->is_scalar())
+        return false;
+    return m_buffers.at(access->array->name).planar;
+}
+
+expression_ptr cpp_from_polyhedral::generate_planar_access
+(polyhedral::array_access * access, const index_type & index, builder * ctx, int plane)
+{
+    index_type target_index;
+    for (auto & e : access->indexes)
+        target_index.push_back(generate_expression(e, index, ctx));
+
+    return generate_buffer_access(access->array, target_index, ctx, plane);
+}
+
+cpp_from_polyhedral::complex_parts
+cpp_from_polyhedral::generate_complex_parts
+(functional::expr_ptr expr, const index_type & index, builder * ctx)
+{
+    auto t = prim_type(expr);
+
+    if (!is_complex(t))
+    {
+        return { generate_expression(expr, index, ctx), nullptr };
+    }
+
+    if (is_planar(expr))
+    {
+        auto access = static_cast<polyhedral::array_access*>(expr.get());
+        return { generate_planar_access(access, index, ctx, 0),
+                 generate_planar_access(access, index, ctx, 1) };
+    }
+
+    if (auto const_complex = dynamic_cast<functional::complex_const*>(expr.get()))
     {
-        if (expr->operands[0]->type->scalar()->primitive != primitive_type::real64)
-            return cast(double_type(), operands[0]);
+        auto v = const_complex->value;
+        if (t == primitive_type::complex32)
+            return { literal((float)v.real()), literal((float)v.imag()) };
         else
-            return operands[0];
+            return { literal(v.real()), literal(v.imag()) };
+    }
+
+    if (auto op = dynamic_cast<functional::primitive*>(expr.get()))
+    {
+        switch(op->kind)
+        {
+        case primitive_op::negate:
+        case primitive_op::add:
+        case primitive_op::subtract:
+        case primitive_op::multiply:
+        case primitive_op::divide:
+        case primitive_op::to_complex32:
+        case primitive_op::to_complex64:
+        case primitive_op::conditional:
+            return generate_complex_arithmetic(op, index, ctx);
+        default:
+            break;
+        }
+    }
+
+    // Compute a complex value and take it apart.
+
+    auto value = reusable(generate_expression(expr, index, ctx), ctx);
+    auto re = call(binop(op::member_of_reference, value, make_id("real")), {});
+    auto im = call(binop(op::member_of_reference, value, make_id("imag")), {});
+    return { re, im };
+}
+
+cpp_from_polyhedral::complex_parts
+cpp_from_polyhedral::generate_complex_arithmetic
+(functional::primitive * expr, const index_type & index, builder * ctx)
+{
+    auto t = component_type(prim_type(expr));
+
+    switch(expr->kind)
+    {
+    case primitive_op::negate:
+    {
+        auto a = generate_complex_parts(expr->operands[0], index, ctx);
+        a.re = unop(op::u_minus, a.re);
+        if (a.im)
+            a.im = unop(op::u_minus, a.im);
+        return a;
     }
     case primitive_op::to_complex32:
+    case primitive_op::to_complex64:
     {
-        auto t = expr->operands[0]->type->scalar()->primitive;
-        if (t != primitive_type::complex32)
+        auto a = generate_complex_parts(expr->operands[0], index, ctx);
+        auto a_t = component_type(prim_type(expr->operands[0]));
+        a.re = to_type(a.re, a_t, t);
+        if (a.im)
+            a.im = to_type(a.im, a_t, t);
+        return a;
+    }
+    case primitive_op::add:
+    case primitive_op::subtract:
+    {
+        auto o = expr->kind == primitive_op::add ? op::add : op::sub;
+        auto a = generate_complex_parts(expr->operands[0], index, ctx);
+        auto b = generate_complex_parts(expr->operands[1], index, ctx);
+
+        complex_parts r;
+        r.re = binop(o, a.re, b.re);
+        if (a.im && b.im)
+            r.im = binop(o, a.im, b.im);
+        else if (a.im)
+            r.im = a.im;
+        else if (b.im)
+            r.im = o == op::add ? b.im : unop(op::u_minus, b.im);
+        return r;
+    }
+    case primitive_op::multiply:
+    {
+        auto a = generate_complex_parts(expr->operands[0], index, ctx);
+        auto b = generate_complex_parts(expr->operands[1], index, ctx);
+
+        if (!a.im)
+            std::swap(a, b);
+
+        complex_parts r;
+
+        if (!b.im)
         {
-            auto f = make_shared<id_expression>("complex<float>");
-            if (t == primitive_type::complex64)
-                return call(f, {operands[0]});
-            else
-                return call(f, {operands[0], literal((float)0)});
+            // Scaling by a real number.
+            b.re = reusable(b.re, ctx);
+            r.re = binop(op::mult, a.re, b.re);
+            if (a.im)
+                r.im = binop(op::mult, a.im, b.re);
         }
         else
         {
-            return operands[0];
+            a.re = reusable(a.re, ctx);
+            a.im = reusable(a.im, ctx);
+            b.re = reusable(b.re, ctx);
+            b.im = reusable(b.im, ctx);
+            r.re = binop(op::sub, binop(op::mult, a.re, b.re), binop(op::mult, a.im, b.im));
+            r.im = binop(op::add, binop(op::mult, a.re, b.im), binop(op::mult, a.im, b.re));
         }
+
+        return r;
     }
-    case primitive_op::to_complex64:
+    case primitive_op::divide:
     {
-        auto t = expr->operands[0]->type->scalar()->primitive;
-        if (t != primitive_type::complex64)
+        auto a = generate_complex_parts(expr->operands[0], index, ctx);
+        auto b = generate_complex_parts(expr->operands[1], index, ctx);
+
+        complex_parts r;
+
+        if (!b.im)
         {
-            auto f = make_shared<id_expression>("complex<double>");
-            if (t == primitive_type::complex32)
-                return call(f, {operands[0]});
-            else
-                return call(f, {operands[0], literal((double)0)});
+            b.re = reusable(b.re, ctx);
+            r.re = binop(op::div, a.re, b.re);
+            if (a.im)
+                r.im = binop(op::div, a.im, b.re);
         }
         else
         {
-            return operands[0];
+            // (a.re + i a.im) / (b.re + i b.im) =
+            // ((a.re b.re + a.im b.im) + i (a.im b.re - a.re b.im)) / (b.re^2 + b.im^2)
+
+            a.re = reusable(a.re, ctx);
+            a.im = reusable(a.im, ctx);
+            b.re = reusable(b.re, ctx);
+            b.im = reusable(b.im, ctx);
+
+            auto d = binop(op::add, binop(op::mult, b.re, b.re), binop(op::mult, b.im, b.im));
+            d = reusable(d, ctx);
+
+            auto re = binop(op::mult, a.re, b.re);
+            expression_ptr im = unop(op::u_minus, binop(op::mult, a.re, b.im));
+            if (a.im)
+            {
+                re = binop(op::add, re, binop(op::mult, a.im, b.im));
+                im = binop(op::sub, binop(op::mult, a.im, b.re), binop(op::mult, a.re, b.im));
+            }
+
+            r.re = binop(op::div, re, d);
+            r.im = binop(op::div, im, d);
         }
+
+        return r;
+    }
+    case primitive_op::conditional:
+    {
+        auto type = type_for(t);
+
+        string re_id, im_id;
+        ctx->add(make_shared<expr_statement>(ctx->new_var(type, re_id)));
+        ctx->add(make_shared<expr_statement>(ctx->new_var(type, im_id)));
+
+        auto condition_expr = generate_expression(expr->operands[0], index, ctx);
+
+        auto true_block = new block_statement;
+        auto false_block = new block_statement;
+
+        auto generate_branch = [&](block_statement * block, const functional::expr_ptr & e)
+        {
+            ctx->push(&block->statements);
+            auto parts = generate_complex_parts(e, index, ctx);
+            if (!parts.im)
+                parts.im = zero(t);
+            ctx->add(make_shared<expr_statement>(assign(make_id(re_id), parts.re)));
+            ctx->add(make_shared<expr_statement>(assign(make_id(im_id), parts.im)));
+            ctx->pop();
+        };
+
+        generate_branch(true_block, expr->operands[1]);
+        generate_branch(false_block, expr->operands[2]);
+
+        auto if_stmt = make_shared<if_statement>
+                (condition_expr, statement_ptr(true_block), statement_ptr(false_block));
+
+        ctx->add(if_stmt);
+
+        return { make_id(re_id), make_id(im_id) };
     }
     default:
-        ostringstream text;
-        text << "Unexpected primitive op: " << expr->kind;
-        throw error(text.str());
+        throw error("Unexpected complex operation.");
     }
 }
 
 expression_ptr cpp_from_polyhedral::generate_buffer_access
-(polyhedral::array_ptr array, const index_type & index, builder * ctx)
+(polyhedral::array_ptr array, const index_type & index, builder * ctx, int plane)
 {
     index_type buffer_index = index;
     string array_name = m_name_mapper(array->name);
@@ -556,7 +1053,11 @@ expression_ptr cpp_from_polyhedral::generate_buffer_access
     expression_ptr buffer = make_shared<id_expression>(array_name);
 
     if (index.empty())
+    {
+        if (plane >= 0)
+            return make_shared<array_access_expression>(buffer, index_type{ literal(plane) });
         return buffer;
+    }
 
     // Add buffer phase
 
@@ -570,6 +1071,10 @@ expression_ptr cpp_from_polyhedral::generate_buffer_access
         i = make_shared<bin_op_expression>(op::add, i, phase);
     }
 
+    // Mirrored buffers are accessed in the period without wrapping,
+    // relative to a base index.
+    bool is_mirrored = m_in_period && buffer_info.mirror_count > 0;
+
     if (m_in_period)
     {
         int offset = 0;
@@ -578,6 +1083,9 @@ expression_ptr cpp_from_polyhedral::generate_buffer_access
         if (stmt_offset != m_current_stmt->array_access_offset.end())
             offset += stmt_offset->second;
 
+        if (is_mirrored)
+            offset -= buffer_info.mirror_base;
+
         if (offset != 0)
         {
             expression_ptr & i = buffer_index[0];
@@ -596,7 +1104,7 @@ expression_ptr cpp_from_polyhedral::generate_buffer_access
 
         expression_ptr i = buffer_index[dim];
 
-        if (buffer_info.dimension_needs_wrapping[dim])
+        if (buffer_info.dimension_needs_wrapping[dim] && !(dim == 0 && is_mirrored))
         {
             bool size_is_power_of_two =
                     buffer_size == (int)std::pow(2, (int)std::log2(buffer_size));
@@ -618,6 +1126,9 @@ expression_ptr cpp_from_polyhedral::generate_buffer_access
         compressed_index.push_back(i);
     }
 
+    if (plane >= 0)
+        compressed_index.insert(compressed_index.begin(), literal(plane));
+
     if (compressed_index.empty())
         return buffer;
 
@@ -31,6 +31,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <unordered_set>
 #include <string>
 #include <tuple>
+#include <cstdint>
 
 namespace stream {
 namespace cpp_gen {
@@ -59,6 +60,17 @@ public:
 
     void set_in_period(bool flag) { m_in_period = flag; }
     void set_move_loop_invariant_code(bool flag) { m_move_loop_invariant_code = flag; }
+    void set_denormal_guards(bool flag);
+    void set_fast_math(int level) { m_fast_math = level; }
+    void set_instrumentation(instrument_table * table) { m_instrumentation = table; }
+    // Masks of outputs by statement name, and the name of the
+    // variable holding the mask of active outputs.
+    void set_output_masks(const unordered_map<string, uint64_t> & masks,
+                          const string & active_outputs);
+
+    // Guards of loop nests and statements by active outputs.
+    expression_ptr enter_output_guard(const vector<string> & stmt_names);
+    void leave_output_guard();
 
     expression_ptr generate_buffer_phase(const string & id, builder *);
 
@@ -71,7 +83,36 @@ private:
     (functional::primitive*, const index_type&, builder*);
 
     expression_ptr generate_buffer_access
-    (polyhedral::array_ptr, const index_type&, builder*);
+    (polyhedral::array_ptr, const index_type&, builder*, int plane = -1);
+
+    // Real and imaginary parts of a complex value.
+    // A null imaginary part stands for zero.
+    struct complex_parts
+    {
+        expression_ptr re;
+        expression_ptr im;
+    };
+
+    complex_parts generate_complex_parts
+    (functional::expr_ptr, const index_type&, builder*);
+
+    complex_parts generate_complex_arithmetic
+    (functional::primitive*, const index_type&, builder*);
+
+    expression_ptr generate_planar_access
+    (polyhedral::array_access*, const index_type&, builder*, int plane);
+
+    bool is_planar(const functional::expr_ptr &);
+
+    // The array of a mapped input written by the statement, if any.
+    polyhedral::array * mapped_input(polyhedral::statement *);
+    statement_ptr mapped_input_fallback(polyhedral::array *, expression_ptr read);
+
+    expression_ptr denormal_guard(expression_ptr, polyhedral::array *);
+
+    expression_ptr math_function(const string & name, functional::primitive *,
+                                 const vector<expression_ptr> & operands,
+                                 int min_fast_math_level = 1);
 
     index_type mapped_index( const index_type & index,
                              const polyhedral::affine_matrix &,
@@ -92,7 +133,19 @@ private:
     unordered_map<string,buffer> m_buffers;
     bool m_in_period = false;
     bool m_move_loop_invariant_code = false;
+    bool m_has_planar_buffers = false;
+    instrument_table * m_instrumentation = nullptr;
+    bool m_denormal_guards = false;
+    // Level of approximation of math functions (0 = use standard library).
+    int m_fast_math = 0;
+    // Arrays whose elements depend on other elements of the same array.
+    unordered_set<polyhedral::array*> m_recursive_arrays;
     polyhedral::statement * m_current_stmt = nullptr;
+    unordered_map<string, uint64_t> m_output_masks;
+    string m_active_outputs;
+    // Outputs which may be active within the enclosing guards.
+    vector<uint64_t> m_output_guards;
+    unordered_map<uint64_t, expression_ptr> m_output_guard_conditions;
     name_mapper & m_name_mapper;
 };
 
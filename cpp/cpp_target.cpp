@@ -22,15 +22,22 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 //#include "cpp_from_cloog.hpp"
 #include "cpp_from_polyhedral.hpp"
 #include "cpp_from_isl.hpp"
+#include "buffer_layout.hpp"
 #include "../utility/cpp-gen.hpp"
 #include "../compiler/report.hpp"
 #include "../polyhedral/storage_alloc.hpp"
+#include "../polyhedral/cost_model.hpp"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <iostream>
+#include <cctype>
 #include <cmath>
 #include <cstdint>
+#include <limits>
+#include <numeric>
+#include <sstream>
 
 using namespace std;
 
@@ -147,9 +154,16 @@ variable_decl_ptr buffer_decl(const buffer & buf,
     auto elem_type = type_for(buf.type);
 
     vector<int> compressed_size;
-    for (auto & s : buf.dimension_size)
-        if (s != 1)
-            compressed_size.push_back(s);
+
+    if (buf.planar)
+    {
+        elem_type = type_for(component_type(buf.type));
+        compressed_size.push_back(2);
+    }
+
+    for (int dim = 0; dim < buf.dimension_size.size(); ++dim)
+        if (buf.dimension_size[dim] != 1)
+            compressed_size.push_back(buf.padded_size[dim]);
 
     if (compressed_size.empty())
     {
@@ -248,10 +262,463 @@ shared_ptr<custom_decl> io_latency_decl(const vector<polyhedral::io_channel> & c
     return decl;
 }
 
+static string real_literal(double value, bool single)
+{
+    const char * type = single ? "float" : "double";
+
+    if (std::isnan(value))
+        return string("std::numeric_limits<") + type + ">::quiet_NaN()";
+    if (std::isinf(value))
+        return string(value < 0 ? "-" : "") + "std::numeric_limits<" + type + ">::infinity()";
+
+    ostringstream text;
+    text.precision(single ? std::numeric_limits<float>::max_digits10
+                          : std::numeric_limits<double>::max_digits10);
+    text << value;
+
+    string result = text.str();
+    if (result.find_first_of(".e") == string::npos)
+        result += ".0";
+    if (single)
+        result += 'f';
+    return result;
+}
+
+static string constant_literal(primitive_type type, const polyhedral::constant_value & v)
+{
+    switch(type)
+    {
+    case primitive_type::boolean:
+        return v.bits ? "true" : "false";
+    case primitive_type::int8:
+    case primitive_type::int16:
+    case primitive_type::int32:
+    case primitive_type::int64:
+    {
+        int64_t i = v.bits;
+        if (i == std::numeric_limits<int64_t>::min())
+            return "(-9223372036854775807 - 1)";
+        return to_string(i);
+    }
+    case primitive_type::uint8:
+    case primitive_type::uint16:
+    case primitive_type::uint32:
+    case primitive_type::uint64:
+        return to_string(v.bits) + 'u';
+    case primitive_type::real32:
+        return real_literal(v.number.real(), true);
+    case primitive_type::real64:
+        return real_literal(v.number.real(), false);
+    case primitive_type::complex32:
+        return "{ " + real_literal(v.number.real(), true) + ", "
+                + real_literal(v.number.imag(), true) + " }";
+    case primitive_type::complex64:
+        return "{ " + real_literal(v.number.real(), false) + ", "
+                + real_literal(v.number.imag(), false) + " }";
+    default:
+        throw error("Unexpected primitive type.");
+    }
+}
+
+// Static member holding the values of an array evaluated by the compiler.
+
+shared_ptr<custom_decl> constant_table_decl(const polyhedral::array & array,
+                                            const buffer & buf,
+                                            name_mapper & namer,
+                                            int alignment)
+{
+    vector<int> compressed_size;
+    for (auto size : buf.dimension_size)
+        if (size != 1)
+            compressed_size.push_back(size);
+
+    ostringstream text;
+
+    if (alignment && !compressed_size.empty())
+        text << "alignas(" << alignment << ") ";
+
+    text << "static constexpr " << type_name_for(buf.type) << " " << namer(buf.name);
+
+    if (compressed_size.empty())
+    {
+        assert_or_throw(array.constant_values.size() == 1);
+        text << " = " << constant_literal(buf.type, array.constant_values[0]);
+    }
+    else
+    {
+        for (auto size : compressed_size)
+            text << '[' << size << ']';
+
+        text << " = {";
+        for (size_t i = 0; i < array.constant_values.size(); ++i)
+        {
+            if (i % 8 == 0)
+                text << endl;
+            text << constant_literal(buf.type, array.constant_values[i]) << ", ";
+        }
+        text << endl << "}";
+    }
+
+    auto decl = make_shared<custom_decl>();
+    decl->text = text.str();
+    return decl;
+}
+
+// Declares the memory of a buffer stored outside of the program object
+// (mirrored, file-backed or mapped input) and a pointer to it, which is indexed
+// like an array with the same dimensions.
+
+static pair<shared_ptr<custom_decl>, shared_ptr<custom_decl>>
+indirect_buffer_decl(const buffer & buf, name_mapper & namer)
+{
+    int64_t bytes = size_in_bytes(buf.type) * volume(buf.padded_size);
+
+    string name = namer(buf.name);
+    string mem_name = namer(buf.name + "_mem");
+
+    auto mem = make_shared<custom_decl>();
+    {
+        ostringstream text;
+        if (buf.mapped_input)
+            text << "arrp::mapped_input " << mem_name << " { " << bytes << " }";
+        else if (buf.file_backed)
+            text << "arrp::file_buffer " << mem_name << " { " << bytes << " }";
+        else
+            text << "arrp::mirrored_buffer " << mem_name
+                 << " { " << bytes << ", " << buf.mirror_count << " }";
+        mem->text = text.str();
+    }
+
+    // Pointer to element type, or to array of inner dimensions.
+    string elem_type = type_name_for(buf.type);
+    string inner_dims;
+    for (int dim = 1; dim < buf.padded_size.size(); ++dim)
+        if (buf.dimension_size[dim] != 1)
+            inner_dims += "[" + to_string(buf.padded_size[dim]) + "]";
+
+    auto ptr = make_shared<custom_decl>();
+    {
+        string ptr_type = inner_dims.empty() ? elem_type + " *" : elem_type + " (*)" + inner_dims;
+        string declarator = inner_dims.empty() ? "* " + name : "(*" + name + ")" + inner_dims;
+        ostringstream text;
+        text << elem_type << " " << declarator
+             << " = static_cast<" << ptr_type << ">(" << mem_name << ".data())";
+        ptr->text = text.str();
+    }
+
+    return { mem, ptr };
+}
+
+// A field of program state.
+// If pointed_bytes is not 0, the field points to the data
+// (mirrored, file-backed and mapped input buffers), otherwise it holds the data.
+// The 'prepare' statement is executed before the data is overwritten.
+
+struct state_field
+{
+    string name;
+    int64_t pointed_bytes = 0;
+    string prepare;
+
+    string address(const string & object = string()) const
+    {
+        return (pointed_bytes ? "" : "&") + object + name;
+    }
+
+    string size() const
+    {
+        return pointed_bytes ? to_string(pointed_bytes) : "sizeof(" + name + ")";
+    }
+};
+
+// Adds functions to save the state of the program to a flat byte buffer
+// (snapshot), load it again (restore), and copy it from another instance
+// (clone_from). The state consists of the given fields; "io" is not part of it.
+// The snapshot starts with a hash of the field layout and the total size,
+// so that restore rejects snapshots made by a differently compiled program.
+
+static void add_snapshot_members(class_node * def,
+                                 const vector<state_field> & fields,
+                                 uint64_t layout_hash)
+{
+    auto & public_sec = def->sections[0];
+
+    {
+        ostringstream text;
+        text << "static constexpr std::uint64_t state_layout_hash = 0x"
+             << std::hex << layout_hash << std::dec << "ull";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "static constexpr std::size_t snapshot_size()" << endl;
+        text << "{" << endl;
+        text << "return sizeof(std::uint64_t) * 2";
+        for (auto & field : fields)
+            text << " + " << field.size();
+        text << ";" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "std::size_t snapshot(void * data, std::size_t size) const" << endl;
+        text << "{" << endl;
+        text << "if (size < snapshot_size()) return 0;" << endl;
+        text << "auto * p = static_cast<unsigned char*>(data);" << endl;
+        text << "const std::uint64_t header[2] = { state_layout_hash, snapshot_size() };" << endl;
+        text << "std::memcpy(p, header, sizeof(header)); p += sizeof(header);" << endl;
+        for (auto & field : fields)
+            text << "std::memcpy(p, " << field.address() << ", " << field.size() << ");"
+                 << " p += " << field.size() << ";" << endl;
+        text << "return snapshot_size();" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "bool restore(const void * data, std::size_t size)" << endl;
+        text << "{" << endl;
+        text << "if (size < snapshot_size()) return false;" << endl;
+        text << "auto * p = static_cast<const unsigned char*>(data);" << endl;
+        text << "std::uint64_t header[2];" << endl;
+        text << "std::memcpy(header, p, sizeof(header)); p += sizeof(header);" << endl;
+        text << "if (header[0] != state_layout_hash || header[1] != snapshot_size()) return false;" << endl;
+        for (auto & field : fields)
+            text << field.prepare
+                 << "std::memcpy(" << field.address() << ", p, " << field.size() << ");"
+                 << " p += " << field.size() << ";" << endl;
+        text << "return true;" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "void clone_from(const program & other)" << endl;
+        text << "{" << endl;
+        for (auto & field : fields)
+            text << field.prepare
+                 << "std::memcpy(" << field.address() << ", " << field.address("other.")
+                 << ", " << field.size() << ");" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+}
+
+// Adds a function to map a finite input from a file by name,
+// before the prelude. It returns false if the input can not be mapped.
+// The type of each mappable input is checked against traits at compile time.
+
+static void add_map_input_member(class_node * def,
+                                 const polyhedral::model & model,
+                                 const unordered_map<string,buffer> & buffers,
+                                 name_mapper & namer)
+{
+    ostringstream text;
+    text << "bool map_input(const char * name, const char * path)" << endl;
+    text << "{" << endl;
+    for (auto & in : model.inputs)
+    {
+        auto b = buffers.find(in.array->name);
+        if (b == buffers.end() || !b->second.mapped_input)
+            continue;
+
+        const auto & buf = b->second;
+        string type = in.name + "_type";
+        int64_t bytes = size_in_bytes(buf.type) * volume(buf.padded_size);
+
+        text << "if (std::strcmp(name, \"" << in.name << "\") == 0)" << endl;
+        text << "{" << endl;
+        text << "static_assert(sizeof(traits::" << type << ") == " << bytes << ", "
+             << "\"Size of mapped input " << in.name << " does not match traits.\");" << endl;
+        text << "static_assert(std::is_same<std::remove_all_extents<traits::" << type << ">::type, "
+             << type_for(buf.type)->name << ">::value, "
+             << "\"Element type of mapped input " << in.name << " does not match traits.\");" << endl;
+        text << namer(buf.name + "_mem") << ".map(path, " << namer(buf.name) << ");" << endl;
+        text << "return true;" << endl;
+        text << "}" << endl;
+    }
+    text << "return false;" << endl;
+    text << "}";
+
+    auto decl = make_shared<custom_decl>();
+    decl->text = text.str();
+    def->sections[0].members.push_back(decl);
+}
+
+// For each statement which contributes to some but not all outputs,
+// a mask with a bit for each of those outputs, in the order of model.outputs.
+// A statement contributes to an output if the output reads its array,
+// directly or through other statements.
+// Input statements are always executed, so that all inputs advance together.
+
+static unordered_map<string, uint64_t> output_masks(const polyhedral::model & model)
+{
+    if (model.outputs.size() > 64)
+        throw error("Output selection supports at most 64 outputs.");
+
+    unordered_map<polyhedral::array*, vector<polyhedral::statement*>> writers;
+    for (auto & stmt : model.statements)
+    {
+        for (auto & access : stmt->array_accesses)
+        {
+            if (access->writing)
+                writers[access->array.get()].push_back(stmt.get());
+        }
+    }
+
+    unordered_map<polyhedral::statement*, uint64_t> masks;
+
+    for (int i = 0; i < (int) model.outputs.size(); ++i)
+    {
+        uint64_t bit = uint64_t(1) << i;
+        auto output_array = model.outputs[i].array.get();
+
+        vector<polyhedral::statement*> work;
+        for (auto & stmt : model.statements)
+        {
+            if (!stmt->is_input_or_output)
+                continue;
+            for (auto & access : stmt->array_accesses)
+            {
+                if (access->reading && access->array.get() == output_array)
+                    work.push_back(stmt.get());
+            }
+        }
+
+        while (!work.empty())
+        {
+            auto stmt = work.back();
+            work.pop_back();
+
+            auto & mask = masks[stmt];
+            if (mask & bit)
+                continue;
+            mask |= bit;
+
+            for (auto & access : stmt->array_accesses)
+            {
+                if (!access->reading)
+                    continue;
+                auto w = writers.find(access->array.get());
+                if (w != writers.end())
+                    work.insert(work.end(), w->second.begin(), w->second.end());
+            }
+        }
+    }
+
+    uint64_t all = model.outputs.size() == 64 ?
+                ~uint64_t(0) : (uint64_t(1) << model.outputs.size()) - 1;
+
+    unordered_map<string, uint64_t> result;
+
+    for (auto & stmt : model.statements)
+    {
+        bool is_input = stmt->is_input_or_output &&
+                std::any_of(stmt->array_accesses.begin(), stmt->array_accesses.end(),
+                            [](const shared_ptr<polyhedral::array_access> & a){ return a->writing; });
+        if (is_input)
+            continue;
+
+        auto mask = masks.find(stmt.get());
+        if (mask == masks.end() || mask->second == all)
+            continue;
+
+        result[stmt->name] = mask->second;
+    }
+
+    if (verbose<cpp_target>::enabled())
+    {
+        cout << "Statements guarded by output masks:" << endl;
+        for (auto & entry : result)
+            cout << "  " << entry.first << ": " << std::hex << entry.second << std::dec << endl;
+    }
+
+    return result;
+}
+
+// Adds the mask of active outputs (all by default), and functions to
+// activate and deactivate outputs by name. The mask is not part of the state,
+// so it is kept by restore and clone_from.
+
+static void add_output_selection_members(class_node * def,
+                                         const polyhedral::model & model,
+                                         const string & active_outputs)
+{
+    {
+        auto field = decl(make_shared<basic_type>("std::uint64_t"), active_outputs);
+        field->value = literal(~uint64_t(0));
+        def->sections[1].members.push_back(make_shared<data_field>(field));
+    }
+    {
+        ostringstream text;
+        text << "static int output_index(const char * name)" << endl;
+        text << "{" << endl;
+        for (int i = 0; i < (int) model.outputs.size(); ++i)
+            text << "if (std::strcmp(name, \"" << model.outputs[i].name << "\") == 0)"
+                 << " return " << i << ";" << endl;
+        text << "return -1;" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        def->sections[0].members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "bool set_output_active(const char * name, bool active)" << endl;
+        text << "{" << endl;
+        text << "int i = output_index(name);" << endl;
+        text << "if (i < 0) return false;" << endl;
+        text << "std::uint64_t bit = std::uint64_t(1) << i;" << endl;
+        text << "if (active) " << active_outputs << " |= bit;"
+             << " else " << active_outputs << " &= ~bit;" << endl;
+        text << "return true;" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        def->sections[0].members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "bool output_active(const char * name) const" << endl;
+        text << "{" << endl;
+        text << "int i = output_index(name);" << endl;
+        text << "return i >= 0 && ((" << active_outputs << " >> i) & 1);" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        def->sections[0].members.push_back(decl);
+    }
+}
+
+// FNV-1a
+
+static uint64_t layout_hash(const string & text)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
 class_node * state_type_def(const polyhedral::model & model,
                             unordered_map<string,buffer> & buffers,
                             name_mapper & namer,
-                            int data_alignment)
+                            int data_alignment,
+                            int field_alignment = 0)
 {
     auto def = new class_node(class_class, "program");
     def->template_parameters.push_back("IO");
@@ -277,13 +744,73 @@ class_node * state_type_def(const polyhedral::model & model,
 
     auto & private_sec = def->sections[1];
 
+    // Declare fields in the order of their layout.
+
+    vector<const buffer*> fields;
+    vector<const buffer*> indirect;
     for (auto array : model.arrays)
     {
         const auto & buf = buffers.at(array->name);
         if (buf.on_stack)
             continue;
-        auto field = make_shared<data_field>(buffer_decl(buf,namer,data_alignment));
-        private_sec.members.push_back(field);
+        if (buf.mirror_count || buf.file_backed || buf.mapped_input)
+            indirect.push_back(&buf);
+        else
+            fields.push_back(&buf);
+    }
+
+    std::stable_sort(fields.begin(), fields.end(),
+                     [](const buffer * a, const buffer * b){ return a->offset < b->offset; });
+
+    // Fields in the state, and a description of their layout.
+    vector<state_field> state_fields;
+    ostringstream layout;
+
+    for (auto buf : fields)
+    {
+        if (buf->padding)
+        {
+            auto pad_t = make_shared<basic_type>("char");
+            auto pad = make_shared<array_decl>(pad_t, namer(buf->name + "_pad"),
+                                               vector<int>{ int(buf->padding) });
+            private_sec.members.push_back(make_shared<data_field>(pad));
+        }
+
+        auto field = buffer_decl(*buf,namer,data_alignment);
+        if (field_alignment)
+            field->alignment = field_alignment;
+        private_sec.members.push_back(make_shared<data_field>(field));
+
+        state_fields.push_back({ field->name });
+        layout << field->name << ":" << buf->type;
+        if (buf->planar)
+            layout << ":planar";
+        for (auto & s : buf->padded_size)
+            layout << ":" << s;
+        layout << ";";
+    }
+
+    for (auto buf : indirect)
+    {
+        auto decl = indirect_buffer_decl(*buf, namer);
+        private_sec.members.push_back(decl.first);
+        private_sec.members.push_back(decl.second);
+
+        // A mapped input may be read-only, so it is replaced by
+        // a private copy when the state is overwritten.
+        int64_t bytes = size_in_bytes(buf->type) * volume(buf->padded_size);
+        string prepare;
+        if (buf->mapped_input)
+            prepare = namer(buf->name + "_mem") + ".allocate(" + namer(buf->name) + "); ";
+        state_fields.push_back({ namer(buf->name), bytes, prepare });
+        layout << namer(buf->name) << ":" << buf->type;
+        if (buf->mapped_input)
+            layout << ":mapped";
+        else
+            layout << (buf->file_backed ? ":file" : ":mirrored");
+        for (auto & s : buf->padded_size)
+            layout << ":" << s;
+        layout << ";";
     }
 
     for (auto array : model.arrays)
@@ -294,16 +821,119 @@ class_node * state_type_def(const polyhedral::model & model,
         auto field = decl(int_t, namer(array->name + "_ph"));
         field->value = literal((int)0);
         private_sec.members.push_back(make_shared<data_field>(field));
+
+        state_fields.push_back({ field->name });
+        layout << field->name << ":int;";
+    }
+
+    add_snapshot_members(def, state_fields, layout_hash(layout.str()));
+
+    if (std::any_of(buffers.begin(), buffers.end(),
+                    [](const pair<const string,buffer> & b){ return b.second.mapped_input; }))
+        add_map_input_member(def, model, buffers, namer);
+
+    for (auto array : model.constant_arrays)
+    {
+        const auto & buf = buffers.at(array->name);
+        private_sec.members.push_back(constant_table_decl(*array, buf, namer, data_alignment));
     }
 
     return def;
 }
 
+// Arrays passed by pointer or reference to external functions
+// (including IO) must keep interleaved storage.
+
+static void find_arrays_passed_to_externals(const functional::expr_ptr & expr,
+                                     unordered_set<polyhedral::array*> & arrays)
+{
+    if (auto call = dynamic_cast<polyhedral::external_call*>(expr.get()))
+    {
+        for (auto & arg : call->args)
+        {
+            auto access = dynamic_cast<polyhedral::array_access*>(arg.get());
+            if (access && (access->writing || !access->type->is_scalar()))
+                arrays.insert(access->array.get());
+            find_arrays_passed_to_externals(arg, arrays);
+        }
+    }
+    else if (auto access = dynamic_cast<polyhedral::array_access*>(expr.get()))
+    {
+        for (auto & index : access->indexes)
+            find_arrays_passed_to_externals(index, arrays);
+    }
+    else if (auto op = dynamic_cast<functional::primitive*>(expr.get()))
+    {
+        for (auto & operand : op->operands)
+            find_arrays_passed_to_externals(operand, arrays);
+    }
+    else if (auto assign = dynamic_cast<polyhedral::assignment*>(expr.get()))
+    {
+        find_arrays_passed_to_externals(assign->destination, arrays);
+        find_arrays_passed_to_externals(assign->value, arrays);
+    }
+}
+
+// Stores a stream buffer in mirrored memory, if it would otherwise
+// wrap indexes in dimension 0 and it is at least a page large.
+// Dimension 0 is enlarged so the buffer is a whole number of pages.
+
+static void mirror_buffer(buffer & buf, const polyhedral::array & array, int page_size)
+{
+    if (!array.is_infinite || buf.planar || buf.dimension_size.empty() ||
+            !buf.dimension_needs_wrapping[0])
+        return;
+
+    int64_t row_bytes = size_in_bytes(buf.type);
+    for (int dim = 1; dim < buf.dimension_size.size(); ++dim)
+        row_bytes *= std::max(1, buf.dimension_size[dim]);
+
+    int64_t size = buf.dimension_size[0];
+    if (size * row_bytes < page_size)
+    {
+        if (verbose<cpp_target>::enabled())
+            cout << "Buffer " << buf.name << " is smaller than a page and is not mirrored." << endl;
+        return;
+    }
+
+    int64_t rows_per_page = page_size / std::gcd(int64_t(page_size), row_bytes);
+    size = (size + rows_per_page - 1) / rows_per_page * rows_per_page;
+
+    buf.dimension_size[0] = size;
+    buf.has_phase = array.period % size != 0;
+
+    // Indexes in the period are in [first_period_access, last_period_access],
+    // plus the phase, if any. Subtracting a multiple of the size
+    // brings them close to 0 without changing them modulo the size.
+
+    int64_t first = array.first_period_access;
+    int64_t base = (first >= 0 ? first : first - size + 1) / size * size;
+    int64_t max_index = array.last_period_access - base;
+    if (buf.has_phase)
+        max_index += size - 1;
+
+    buf.mirror_base = base;
+    buf.mirror_count = max_index / size + 1;
+
+    if (verbose<cpp_target>::enabled())
+    {
+        cout << "Buffer " << buf.name << " is mirrored " << buf.mirror_count << " times"
+             << " with size " << size << " and index base " << base << "." << endl;
+    }
+}
+
 unordered_map<string,buffer>
 buffer_analysis(const polyhedral::model & model, const compiler::options & opt)
 {
     using polyhedral::array;
 
+    unordered_set<array*> arrays_passed_to_externals;
+    if (opt.planar_complex)
+    {
+        for (auto & stmt : model.statements)
+            find_arrays_passed_to_externals(stmt->expr, arrays_passed_to_externals);
+    }
+
     std::vector<array*> buffers_on_stack;
     std::vector<array*> buffers_in_memory;
 
@@ -319,6 +949,12 @@ buffer_analysis(const polyhedral::model & model, const compiler::options & opt)
 
         buf.period_offset = array->period;
 
+        buf.planar = opt.planar_complex && is_complex(array->type) &&
+                !arrays_passed_to_externals.count(array.get());
+
+        if (buf.planar && verbose<cpp_target>::enabled())
+            cout << "Storing " << array->name << " in planar form." << endl;
+
         // Compute buffer size
 
         for(int dim = 0; dim < array->buffer_size.size(); ++dim)
@@ -402,6 +1038,9 @@ buffer_analysis(const polyhedral::model & model, const compiler::options & opt)
             buf.dimension_needs_wrapping.push_back(may_need_wrapping);
         }
 
+        if (opt.mirror_buffers > 0)
+            mirror_buffer(buf, *array, opt.mirror_buffers);
+
         buf.size = volume(buf.dimension_size);
 
         buffers.emplace(array->name, buf);
@@ -429,7 +1068,7 @@ buffer_analysis(const polyhedral::model & model, const compiler::options & opt)
         polyhedral::array *array = buffers_on_stack[idx];
         buffer & b = buffers.at(array->name);
 
-        int64_t elem_size = size_for(array->type);
+        int64_t elem_size = size_in_bytes(array->type);
 
         int64_t mem_size = b.size * elem_size;
 
@@ -452,6 +1091,77 @@ buffer_analysis(const polyhedral::model & model, const compiler::options & opt)
         b.on_stack = false;
     }
 
+    // Large finite buffers are stored in memory-mapped temporary files.
+
+    if (opt.out_of_core > 0)
+    {
+        int64_t threshold = int64_t(opt.out_of_core) << 10;
+
+        for (const auto & array : model.arrays)
+        {
+            buffer & b = buffers.at(array->name);
+            if (array->is_infinite || b.on_stack || b.planar)
+                continue;
+            if (b.size * size_in_bytes(b.type) < threshold)
+                continue;
+
+            b.file_backed = true;
+
+            if (verbose<cpp_target>::enabled())
+                cout << "Storing " << array->name << " in a temporary file." << endl;
+        }
+    }
+
+    // Mapped inputs are stored entirely, outside of the program object,
+    // with the same layout as the input type in traits.
+
+    for (const auto & name : opt.mapped_inputs)
+    {
+        auto in = std::find_if(model.inputs.begin(), model.inputs.end(),
+                               [&](const polyhedral::io_channel & c){ return c.name == name; });
+        if (in == model.inputs.end())
+            throw error("Mapped input " + name + " does not exist.");
+
+        const auto & array = in->array;
+        if (array->is_infinite || array->size.empty())
+            throw error("Mapped input " + name + " is not a finite array.");
+
+        auto call = dynamic_pointer_cast<polyhedral::external_call>(in->statement->expr);
+        auto access = call ? dynamic_cast<polyhedral::array_access*>(call->args[0].get()) : nullptr;
+        if (!access || !access->indexes.empty())
+            throw error("Mapped input " + name + " is not read as a whole.");
+
+        auto b = buffers.find(array->name);
+        if (b == buffers.end())
+            continue;
+
+        if (b->second.planar || b->second.dimension_size != array->size)
+            throw error("Mapped input " + name + " is not stored entirely.");
+
+        b->second.mapped_input = true;
+        b->second.file_backed = false;
+        b->second.on_stack = false;
+
+        if (verbose<cpp_target>::enabled())
+            cout << "Input " << name << " may be mapped from a file." << endl;
+    }
+
+    // Constant arrays are stored entirely, outside of the program object.
+
+    for (const auto & array : model.constant_arrays)
+    {
+        buffer buf;
+        buf.name = array->name;
+        buf.type = array->type;
+        buf.is_constant = true;
+        buf.on_stack = false;
+        buf.dimension_size = array->size.empty() ? vector<int>{ 1 } : array->size;
+        buf.dimension_needs_wrapping.assign(buf.dimension_size.size(), false);
+        buf.padded_size = buf.dimension_size;
+        buf.size = volume(buf.dimension_size);
+
+        buffers.emplace(array->name, buf);
+    }
 
     return buffers;
 }
@@ -490,19 +1200,29 @@ static void advance_buffers(const polyhedral::model & model,
 
                 auto buf_ptr = make_id("d");
 
+                auto elem_type = buf.planar ? component_type(buf.type) : buf.type;
+
                 {
-                    auto buf_address = cast(pointer(type_for(buf.type)), make_id(buf.name));
+                    auto buf_address = cast(pointer(type_for(elem_type)), make_id(buf.name));
                     auto buf_ptr_decl = decl_expr(auto_type(), *buf_ptr, buf_address);
                     shift_block->statements.push_back(stmt(buf_ptr_decl));
                 }
+
+                // Planar buffers shift each plane separately.
+
+                int plane_count = buf.planar ? 2 : 1;
+                int64_t plane_size = volume(buf.padded_size);
+
+                for (int plane = 0; plane < plane_count; ++plane)
                 {
-                    auto extent = buf.dimension_size;
+                    auto extent = buf.padded_size;
                     extent[0] = 1;
                     int64_t factor = volume(extent);
+                    int64_t plane_address = plane * plane_size;
 
-                    int64_t source_address = buf.data_shift.source * factor;
-                    int64_t end_address = (buf.data_shift.source + buf.data_shift.size) * factor;
-                    int64_t dest_address = (buf.data_shift.source - buf.data_shift.period_count * buf.period_offset) * factor;
+                    int64_t source_address = plane_address + buf.data_shift.source * factor;
+                    int64_t end_address = plane_address + (buf.data_shift.source + buf.data_shift.size) * factor;
+                    int64_t dest_address = plane_address + (buf.data_shift.source - buf.data_shift.period_count * buf.period_offset) * factor;
 
                     auto source = binop(op::add, buf_ptr, literal(source_address));
                     auto end = binop(op::add, buf_ptr, literal(end_address));
@@ -653,6 +1373,7 @@ static void report_buffer_sizes(const unordered_map<string,buffer> & buffers)
     arrp::json sizes;
 
     int64_t total_mem = 0;
+    int64_t constant_mem = 0;
 
     for (const auto & entry : buffers)
     {
@@ -666,20 +1387,278 @@ static void report_buffer_sizes(const unordered_map<string,buffer> & buffers)
 
         out[buffer.name]["shape"] = shape;
 
-        total_mem += flat_size * size_t(cpp_gen::size_for(buffer.type));
+        if (buffer.padded_size != shape)
+            out[buffer.name]["padded-shape"] = buffer.padded_size;
+
+        if (buffer.is_constant)
+        {
+            out[buffer.name]["constant"] = true;
+            constant_mem += flat_size * size_t(size_in_bytes(buffer.type));
+            continue;
+        }
+
+        if (buffer.mirror_count)
+            out[buffer.name]["mirrored"] = buffer.mirror_count;
+        else if (buffer.file_backed)
+            out[buffer.name]["file"] = true;
+        else if (buffer.mapped_input)
+            out[buffer.name]["mapped"] = true;
+        else if (!buffer.on_stack)
+            out[buffer.name]["offset"] = buffer.offset;
+
+        total_mem += flat_size * size_t(size_in_bytes(buffer.type));
     }
 
     out["memory"] = total_mem;
+    out["constant-memory"] = constant_mem;
+}
+
+static string c_string_literal(const string & text)
+{
+    string result = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    result += '"';
+    return result;
+}
+
+// Adds counters used by instrumented code and a function
+// to print them as JSON to the public section of program class.
+
+static void add_instrumentation_members(class_node * def, const instrument_table & table)
+{
+    int count = table.entries.size();
+    int size = std::max(1, count);
+
+    auto & public_sec = def->sections[0];
+
+    {
+        auto decl = make_shared<custom_decl>();
+        decl->text = "arrp::instrument::counter instrument_counters[" + to_string(size) + "];";
+        public_sec.members.push_back(decl);
+    }
+    {
+        ostringstream text;
+        text << "void print_instrumentation(std::ostream & out) const" << endl;
+        text << "{" << endl;
+        text << "static const arrp::instrument::counter_info info[" << size << "] = {" << endl;
+        for (auto & e : table.entries)
+        {
+            string statements;
+            for (auto & name : e.statements)
+            {
+                if (!statements.empty())
+                    statements += ' ';
+                statements += name;
+            }
+
+            int function_counter = -1;
+            if (e.kind == "statement")
+            {
+                for (int i = 0; i < count; ++i)
+                {
+                    auto & f = table.entries[i];
+                    if (f.kind == "function" && f.name == e.function)
+                        function_counter = i;
+                }
+            }
+
+            text << "{ " << c_string_literal(e.kind)
+                 << ", " << c_string_literal(e.name)
+                 << ", " << c_string_literal(e.function)
+                 << ", " << c_string_literal(e.location)
+                 << ", " << c_string_literal(statements)
+                 << ", " << function_counter
+                 << ", " << e.instances_per_call
+                 << " }," << endl;
+        }
+        text << "};" << endl;
+        text << "arrp::instrument::print_json(out, instrument_counters, info, " << count << ");" << endl;
+        text << "}";
+
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        public_sec.members.push_back(decl);
+    }
+
+    if (verbose<cpp_target>::enabled())
+    {
+        cout << "Instrumentation counters: " << count << endl;
+    }
+}
+
+// Enables flushing denormals to zero until the end of the function.
+
+static variable_decl_ptr denormal_flush_decl()
+{
+    return decl(btype("arrp::denormal_flush_scope"), "denormal_flush");
+}
+
+// A variant of prelude and period compiled for an instruction set
+// (--dispatch option).
+
+struct isa_variant
+{
+    // CPU features, e.g. "avx2" and "fma".
+    vector<string> features;
+    // Suffix of function names.
+    string suffix;
+    // Size of the widest vectors in bytes.
+    int vector_size = 0;
+};
+
+static vector<isa_variant> isa_variants(const vector<string> & names)
+{
+    static const unordered_map<string,int> vector_sizes = {
+        { "sse2", 16 }, { "sse3", 16 }, { "ssse3", 16 },
+        { "sse4.1", 16 }, { "sse4.2", 16 }, { "popcnt", 16 },
+        { "avx", 32 }, { "avx2", 32 }, { "fma", 32 }, { "f16c", 32 },
+        { "avx512f", 64 }, { "avx512cd", 64 }, { "avx512bw", 64 },
+        { "avx512dq", 64 }, { "avx512vl", 64 }
+    };
+
+    vector<isa_variant> variants;
+
+    for (auto & name : names)
+    {
+        isa_variant variant;
+
+        istringstream features(name);
+        string feature;
+        while(getline(features, feature, '+'))
+        {
+            auto size = vector_sizes.find(feature);
+            if (size == vector_sizes.end())
+                throw error("Unknown instruction set: " + feature);
+            variant.features.push_back(feature);
+            variant.vector_size = std::max(variant.vector_size, size->second);
+        }
+
+        if (variant.features.empty())
+            throw error("Empty instruction set.");
+
+        for (char c : name)
+            variant.suffix += isalnum(c) ? c : '_';
+
+        variants.push_back(variant);
+    }
+
+    return variants;
+}
+
+static string isa_target_attribute(const isa_variant & variant)
+{
+    string target;
+    for (auto & feature : variant.features)
+    {
+        if (!target.empty())
+            target += ',';
+        target += feature;
+    }
+    return "ARRP_TARGET(\"" + target + "\")";
+}
+
+// Declares the functions of each variant, and a field which selects
+// the variant when the program instance is created.
+
+static void add_dispatch_members(class_node * def, const vector<isa_variant> & variants)
+{
+    auto & private_sec = def->sections[1];
+
+    auto add_func_decl = [&](const string & name, const string & attribute)
+    {
+        auto sig = make_shared<func_signature>(name);
+        sig->attribute = attribute;
+        private_sec.members.push_back(make_shared<func_decl>(sig));
+    };
+
+    for (auto & variant : variants)
+    {
+        string attribute = isa_target_attribute(variant);
+        add_func_decl("prelude_" + variant.suffix, attribute);
+        add_func_decl("period_" + variant.suffix, attribute);
+    }
+
+    add_func_decl("prelude_generic", "");
+    add_func_decl("period_generic", "");
+
+    {
+        ostringstream text;
+        text << "static int select_isa_variant()" << endl;
+        text << "{" << endl;
+        text << "ARRP_CPU_INIT();" << endl;
+        for (int i = 0; i < (int) variants.size(); ++i)
+        {
+            text << "if (";
+            for (int f = 0; f < (int) variants[i].features.size(); ++f)
+            {
+                if (f > 0)
+                    text << " && ";
+                text << "ARRP_CPU_SUPPORTS(\"" << variants[i].features[f] << "\")";
+            }
+            text << ") return " << i << ";" << endl;
+        }
+        text << "return -1;" << endl;
+        text << "}";
+        auto decl = make_shared<custom_decl>();
+        decl->text = text.str();
+        private_sec.members.push_back(decl);
+    }
+    {
+        auto decl = make_shared<custom_decl>();
+        decl->text = "int isa_variant = select_isa_variant()";
+        private_sec.members.push_back(decl);
+    }
+}
+
+// Calls the variant of a function selected for the program instance.
+
+static shared_ptr<func_def> dispatch_func(const string & name,
+                                          const vector<isa_variant> & variants)
+{
+    auto sig = make_shared<func_signature>("program<IO>::" + name, explicit_inline);
+    sig->template_parameters.push_back("IO");
+
+    auto func = make_shared<func_def>(sig);
+
+    statement_ptr stmt = make_shared<expr_statement>
+            (make_shared<call_expression>(name + "_generic"));
+
+    for (int i = (int) variants.size() - 1; i >= 0; --i)
+    {
+        auto call = make_shared<expr_statement>
+                (make_shared<call_expression>(name + "_" + variants[i].suffix));
+        auto condition = binop(op::equal, make_shared<id_expression>("isa_variant"), literal(i));
+        stmt = make_shared<if_statement>(condition, call, stmt);
+    }
+
+    func->body.statements.push_back(stmt);
+
+    return func;
 }
 
 void generate(const string & name,
               const polyhedral::model & model,
+              const polyhedral::schedule & schedule,
               const polyhedral::ast_isl & ast,
               std::ostream & src_stream,
-              const compiler::options & opt)
+              const compiler::options & options)
 {
+    auto variants = isa_variants(options.dispatch);
+
+    // All variants use the same data, aligned for the widest vectors.
+    compiler::options opt = options;
+    for (auto & variant : variants)
+        opt.data_alignment = std::max(opt.data_alignment, variant.vector_size);
+
     unordered_map<string,buffer> buffers = buffer_analysis(model, opt);
 
+    layout_buffers(model, buffers, opt);
+
     if (verbose<polyhedral::storage_output>::enabled())
     {
         report_buffer_sizes(buffers);
@@ -692,12 +1671,39 @@ void generate(const string & name,
     cpp_from_isl isl(&b);
     cpp_from_polyhedral poly(model, buffers, name_mapper);
     poly.set_move_loop_invariant_code(opt.loop_invariant_code_motion);
+    poly.set_denormal_guards(opt.denormals == compiler::denormal_mode::guard);
+    poly.set_fast_math(opt.fast_math);
+
+    instrument_table instrumentation;
+    if (opt.instrument)
+    {
+        poly.set_instrumentation(&instrumentation);
+        isl.set_instrumentation(&instrumentation);
+
+        // Statements are counted from the number of instances per call,
+        // unless it is approximated.
+        polyhedral::cost_model cost(model, schedule);
+        for (auto & stmt : cost.statements())
+        {
+            if (!stmt.exact)
+                continue;
+            if (stmt.prelude_instances >= 0)
+                instrumentation.instance_counts["prelude"][stmt.stmt->name] = stmt.prelude_instances;
+            if (stmt.period_instances >= 0)
+                instrumentation.instance_counts["period"][stmt.stmt->name] = stmt.period_instances;
+        }
+    }
 
     m.members.push_back(make_shared<include_dir>("cstdint"));
+    m.members.push_back(make_shared<include_dir>("cstring"));
     m.members.push_back(make_shared<include_dir>("cmath"));
     m.members.push_back(make_shared<include_dir>("algorithm"));
     m.members.push_back(make_shared<include_dir>("complex"));
     m.members.push_back(make_shared<include_dir>("unordered_map"));
+    if (!model.constant_arrays.empty())
+        m.members.push_back(make_shared<include_dir>("limits"));
+    if (!opt.mapped_inputs.empty())
+        m.members.push_back(make_shared<include_dir>("type_traits"));
     m.members.push_back(make_shared<include_dir>("arrp/arrp.hpp"));
 
     m.members.push_back(make_shared<using_decl>("namespace std"));
@@ -726,18 +1732,55 @@ void generate(const string & name,
 
     nmspc->members.push_back(traits);
 
+    class_node * state_def;
+
     // FIXME: rather include header:
-    nmspc->members.push_back
-            (namespace_member_ptr(state_type_def(model, buffers, name_mapper, opt.data_alignment)));
+    {
+        int field_alignment = 0;
+        if (!opt.cache_layout.empty())
+            field_alignment = std::max(opt.cache_layout[0], opt.data_alignment);
+
+        state_def = state_type_def(model, buffers, name_mapper,
+                                   opt.data_alignment, field_alignment);
+        nmspc->members.push_back(namespace_member_ptr(state_def));
+    }
+
+    // The mask of active outputs is copied to a local variable
+    // at the start of the period, so that guards are loop invariant.
+    string active_outputs, period_outputs;
+
+    if (opt.output_selection)
+    {
+        active_outputs = name_mapper(".active_outputs");
+        period_outputs = name_mapper(".period_outputs");
+        add_output_selection_members(state_def, model, active_outputs);
+        auto masks = output_masks(model);
+        poly.set_output_masks(masks, period_outputs);
+
+        for (auto & entry : masks)
+            arrp::report()["output_selection"][entry.first] = entry.second;
+    }
 
     // FIXME: not of much use with infinite I/O
     //add_output_getter_func(m, *nmspc, model.arrays.back());
 
+    // Statements may be renamed in ASTs generated in separate isl contexts.
+    const unordered_map<string,string> * statement_names = nullptr;
+
     auto stmt_func = [&]
             ( const string & name,
             const vector<expression_ptr> & index,
             builder * ctx)
     {
+        if (statement_names)
+        {
+            auto original = statement_names->find(name);
+            if (original != statement_names->end())
+            {
+                poly.generate_statement(original->second, index, ctx);
+                return;
+            }
+        }
         poly.generate_statement(name, index, ctx);
     };
 
@@ -749,7 +1792,29 @@ void generate(const string & name,
     isl.set_stmt_func(stmt_func);
     isl.set_id_func(id_func);
 
+    if (opt.output_selection)
     {
+        auto guard_enter = [&]( const vector<string> & names )
+        {
+            if (!statement_names)
+                return poly.enter_output_guard(names);
+
+            vector<string> original_names;
+            for (auto & name : names)
+            {
+                auto original = statement_names->find(name);
+                original_names.push_back(original != statement_names->end() ?
+                                         original->second : name);
+            }
+            return poly.enter_output_guard(original_names);
+        };
+
+        isl.set_guard_funcs(guard_enter, [&](){ poly.leave_output_guard(); });
+    }
+
+    {
+        instrumentation.begin_function("prelude");
+
         auto sig = make_shared<func_signature>("program<IO>::prelude", explicit_inline);
         sig->template_parameters.push_back("IO");
 
@@ -761,6 +1826,15 @@ void generate(const string & name,
 
             b.push(&func->body.statements);
 
+            if (opt.denormals == compiler::denormal_mode::flush)
+                b.add(make_shared<var_decl_expression>(denormal_flush_decl()));
+
+            if (opt.instrument)
+            {
+                int counter = instrumentation.index("function", instrumentation.function);
+                b.add(instrument_table::scope_decl(counter, "instrument_function_scope"));
+            }
+
             for (auto array : model.arrays)
             {
                 const auto & buf = buffers.at(array->name);
@@ -769,7 +1843,9 @@ void generate(const string & name,
                           (buffer_decl(buf,name_mapper,opt.data_alignment)));
             }
 
+            statement_names = &ast.statement_names;
             isl.generate(ast.prelude);
+            statement_names = nullptr;
 
             //advance_buffers(model, buffers, &b, name_mapper, true);
 
@@ -780,6 +1856,8 @@ void generate(const string & name,
     }
 
     {
+        instrumentation.begin_function("period");
+
         auto sig = make_shared<func_signature>("program<IO>::period", explicit_inline);
         sig->template_parameters.push_back("IO");
 
@@ -792,6 +1870,23 @@ void generate(const string & name,
 
             b.push(&func->body.statements);
 
+            if (opt.denormals == compiler::denormal_mode::flush)
+                b.add(make_shared<var_decl_expression>(denormal_flush_decl()));
+
+            if (opt.instrument)
+            {
+                int counter = instrumentation.index("function", instrumentation.function);
+                b.add(instrument_table::scope_decl(counter, "instrument_function_scope"));
+            }
+
+            if (opt.output_selection)
+            {
+                auto type = btype("std::uint64_t");
+                type->is_const = true;
+                b.add(make_shared<var_decl_expression>
+                      (decl(type, period_outputs, make_id(active_outputs))));
+            }
+
             for (auto array : model.arrays)
             {
                 const auto & buf = buffers.at(array->name);
@@ -810,6 +1905,46 @@ void generate(const string & name,
         nmspc->members.push_back(func);
     }
 
+    if (!variants.empty())
+    {
+        // Rename prelude and period to generic variants,
+        // add copies for each instruction set, and dispatch functions.
+
+        add_dispatch_members(state_def, variants);
+
+        vector<shared_ptr<func_def>> funcs;
+        for (auto & member : nmspc->members)
+        {
+            auto func = dynamic_pointer_cast<func_def>(member);
+            if (func && (func->signature->name == "program<IO>::prelude" ||
+                         func->signature->name == "program<IO>::period"))
+                funcs.push_back(func);
+        }
+
+        for (auto & func : funcs)
+        {
+            string func_name = func->signature->name;
+            string short_name = func_name.substr(func_name.find("::") + 2);
+
+            for (auto & variant : variants)
+            {
+                auto sig = make_shared<func_signature>(*func->signature);
+                sig->name = func_name + "_" + variant.suffix;
+                sig->attribute = isa_target_attribute(variant);
+                auto copy = make_shared<func_def>(sig);
+                copy->body.statements = func->body.statements;
+                nmspc->members.push_back(copy);
+            }
+
+            func->signature->name = func_name + "_generic";
+
+            nmspc->members.push_back(dispatch_func(short_name, variants));
+        }
+    }
+
+    if (opt.instrument)
+        add_instrumentation_members(state_def, instrumentation);
+
     {
         cpp_gen::options opt;
         opt.indentation_size = 2;
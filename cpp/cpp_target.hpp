@@ -28,6 +28,8 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <algorithm>
 #include <cstdint>
 
 namespace stream {
@@ -57,12 +59,117 @@ struct buffer
     vector<int> dimension_size;
     vector<bool> dimension_needs_wrapping;
 
+    // Size of each dimension in memory, including padding.
+    vector<int> padded_size;
+
     int64_t size;
+
+    // Byte offset within program object, or -1 if on stack.
+    int64_t offset = -1;
+    // Bytes of padding inserted before the buffer.
+    int64_t padding = 0;
+
+    // Complex elements are stored as two planes of real numbers:
+    // real parts in plane 0 and imaginary parts in plane 1.
+    bool planar = false;
+
+    // Stored in a static table with values computed by the compiler.
+    bool is_constant = false;
+
+    // Stored in memory which is mapped mirror_count times in a row,
+    // so that the period accesses dimension 0 without wrapping,
+    // at an index offset by -mirror_base.
+    int mirror_count = 0;
+    int mirror_base = 0;
+
+    // Stored in a memory-mapped temporary file.
+    bool file_backed = false;
+
+    // A finite input, which is either mapped read-only from a file
+    // or read through IO into separately allocated memory.
+    bool mapped_input = false;
 };
 
 // For verbose output
 struct cpp_target {};
 
+// Counters added to generated code by --instrument.
+// Each counter is identified by kind ("function", "loop" or "statement"),
+// name and the generated function containing it.
+// Functions and outermost loop nests are timed. Statements are not:
+// their instances are computed from the number of calls of the function
+// and the number of instances per call known at compile time.
+
+struct instrument_table
+{
+    struct entry
+    {
+        string kind;
+        string name;
+        string function;
+        string location;
+        // Statements: instances per call of the function, -1 if unknown.
+        int64_t instances_per_call = -1;
+        // Loops: names of statements in the loop nest.
+        vector<string> statements;
+    };
+
+    vector<entry> entries;
+    string function;
+    int loop_count = 0;
+
+    // Statement instances per call, by function and statement name.
+    unordered_map<string, unordered_map<string, int64_t>> instance_counts;
+
+    // Statements generated since the start of the current loop nest.
+    vector<string> loop_statements;
+
+    void begin_function(const string & name)
+    {
+        function = name;
+        loop_count = 0;
+    }
+
+    int index(const string & kind, const string & name, const string & location = string())
+    {
+        for (int i = 0; i < (int) entries.size(); ++i)
+        {
+            auto & e = entries[i];
+            if (e.kind == kind && e.name == name && e.function == function)
+                return i;
+        }
+        entry e;
+        e.kind = kind;
+        e.name = name;
+        e.function = function;
+        e.location = location;
+        entries.push_back(e);
+        return (int) entries.size() - 1;
+    }
+
+    void add_statement(const string & name, const string & location)
+    {
+        int i = index("statement", name, location);
+
+        auto & counts = instance_counts[function];
+        auto count = counts.find(name);
+        if (count != counts.end())
+            entries[i].instances_per_call = count->second;
+
+        if (std::find(loop_statements.begin(), loop_statements.end(), name)
+                == loop_statements.end())
+            loop_statements.push_back(name);
+    }
+
+    // Declaration of a scoped counter in generated code.
+    static expression_ptr scope_decl(int index, const string & var_name)
+    {
+        auto counter = std::make_shared<array_access_expression>
+                (make_id("instrument_counters"), vector<expression_ptr>{ literal(index) });
+        return decl_expr(btype("arrp::instrument::scope"), var_name, counter);
+    }
+};
+
 inline
 string type_name_for(primitive_type pt)
 {
@@ -104,39 +211,23 @@ inline basic_type_ptr type_for(primitive_type pt)
     return std::make_shared<basic_type>(type_name_for(pt));
 }
 
-inline int size_for(primitive_type pt)
+// Type of real and imaginary parts of a complex type.
+inline primitive_type component_type(primitive_type pt)
 {
     switch(pt)
     {
-    case primitive_type::boolean:
-        return 4;
-    case primitive_type::int8:
-    case primitive_type::uint8:
-        return 1;
-    case primitive_type::int16:
-    case primitive_type::uint16:
-        return 2;
-    case primitive_type::int32:
-    case primitive_type::uint32:
-        return 4;
-    case primitive_type::int64:
-    case primitive_type::uint64:
-        return 8;
-    case primitive_type::real32:
-        return 32;
-    case primitive_type::real64:
-        return 64;
     case primitive_type::complex32:
-        return 2 * 32;
+        return primitive_type::real32;
     case primitive_type::complex64:
-        return 2 * 64;
+        return primitive_type::real64;
     default:
-        throw error("Unexpected primitive type.");
+        return pt;
     }
 }
 
 void generate(const string & name,
               const polyhedral::model & model,
+              const polyhedral::schedule & schedule,
               const polyhedral::ast_isl & ast,
               ostream & cpp_file,
               const compiler::options &);
@@ -437,7 +437,8 @@ expr_ptr array_reducer::reduce(std::shared_ptr<func_app> app)
         arg = reduce(arg);
 
         // Lift complex arguments to external calls.
-        if (dynamic_pointer_cast<array>(arg.expr))
+        if (dynamic_pointer_cast<array>(arg.expr) ||
+                (dynamic_pointer_cast<func_app>(arg.expr) && arg->type->is_array()))
         {
             arg = lambda_lift(arg, "_tmp");
         }
@@ -13,36 +13,40 @@ copier::copier(unordered_set<id_ptr> & ids, name_provider & nmp):
 
 }
 
+// Constants are never modified, so copies share them.
+// The type checker replaces a shared constant when it needs
+// a different type in the context of a copy.
+
 expr_ptr copier::visit_int(const shared_ptr<int_const> & i)
 {
-    return make_shared<int_const>(*i);
+    return i;
 }
 
 expr_ptr copier::visit_real(const shared_ptr<real_const> & d)
 {
-    return make_shared<real_const>(*d);
+    return d;
 }
 
 expr_ptr copier::visit_complex(const shared_ptr<complex_const> & d)
 {
-    return make_shared<complex_const>(*d);
+    return d;
 }
 
 expr_ptr copier::visit_bool(const shared_ptr<bool_const> & b)
 {
-    return make_shared<bool_const>(*b);
+    return b;
 }
 
 expr_ptr copier::visit_infinity(const shared_ptr<infinity> & inf)
 {
-    return make_shared<infinity>(*inf);
+    return inf;
 }
 
 expr_ptr copier::visit_ref(const shared_ptr<reference> & ref)
 {
     if (auto a_var = dynamic_pointer_cast<array_var>(ref->var))
     {
-        auto new_ref = make_shared<reference>(*ref);
+        auto new_ref = make_node<reference>(*ref);
         auto binding = m_copy_context.find(a_var);
         if (binding)
             new_ref->var = binding.value();
@@ -50,7 +54,7 @@ expr_ptr copier::visit_ref(const shared_ptr<reference> & ref)
     }
     else if (auto f_var = dynamic_pointer_cast<func_var>(ref->var))
     {
-        auto new_ref = make_shared<reference>(*ref);
+        auto new_ref = make_node<reference>(*ref);
         auto binding = m_copy_context.find(f_var);
         if (binding)
             new_ref->var = binding.value();
@@ -61,7 +65,7 @@ expr_ptr copier::visit_ref(const shared_ptr<reference> & ref)
         // FIXME: Go reduce the expression of id to replace
         // array vars with copied ones.
 
-        auto new_ref = make_shared<reference>(*ref);
+        auto new_ref = make_node<reference>(*ref);
 
         auto binding = m_copy_context.find(id);
         if (binding)
@@ -89,12 +93,12 @@ expr_ptr copier::visit_array_self_ref(const shared_ptr<array_self_ref> & ref)
         arr = ref->arr;
     else
         arr = m_array_copy_stack.top();
-    return make_shared<array_self_ref>(arr, ref->location, ref->type);
+    return make_node<array_self_ref>(arr, ref->location, ref->type);
 }
 
 expr_ptr copier::visit_primitive(const shared_ptr<primitive> & op)
 {
-    auto new_op = make_shared<primitive>();
+    auto new_op = make_node<primitive>();
     new_op->location = op->location;
     new_op->type = op->type;
     new_op->kind = op->kind;
@@ -107,7 +111,7 @@ expr_ptr copier::visit_primitive(const shared_ptr<primitive> & op)
 
 expr_ptr copier::visit_operation(const shared_ptr<operation> & op)
 {
-    auto new_op = make_shared<operation>();
+    auto new_op = make_node<operation>();
     new_op->location = op->location;
     new_op->type = op->type;
     new_op->kind = op->kind;
@@ -125,7 +129,7 @@ expr_ptr copier::visit_affine(const shared_ptr<affine_expr> &)
 
 expr_ptr copier::visit_cases(const shared_ptr<case_expr> & c)
 {
-    auto result = make_shared<case_expr>();
+    auto result = make_node<case_expr>();
     result->location = c->location;
     result->type = c->type;
     for (auto & a_case : c->cases)
@@ -137,7 +141,7 @@ expr_ptr copier::visit_cases(const shared_ptr<case_expr> & c)
 
 expr_ptr copier::visit_array(const shared_ptr<array> & arr)
 {
-    auto new_arr = make_shared<array>();
+    auto new_arr = make_node<array>();
     new_arr->location = arr->location;
     new_arr->type = arr->type;
     new_arr->is_recursive = arr->is_recursive;
@@ -148,7 +152,7 @@ expr_ptr copier::visit_array(const shared_ptr<array> & arr)
 
     for (auto & var : arr->vars)
     {
-        auto new_var = make_shared<array_var>(copy(var->range), var->location);
+        auto new_var = make_node<array_var>(copy(var->range), var->location);
         new_var->range.location = var->range.location;
 
         new_arr->vars.push_back(new_var);
@@ -163,7 +167,7 @@ expr_ptr copier::visit_array(const shared_ptr<array> & arr)
 
 expr_ptr copier::visit_array_patterns(const shared_ptr<array_patterns> & ap)
 {
-    auto new_ap = make_shared<array_patterns>();
+    auto new_ap = make_node<array_patterns>();
     new_ap->location = ap->location;
     new_ap->type = ap->type;
 
@@ -185,7 +189,7 @@ expr_ptr copier::visit_array_patterns(const shared_ptr<array_patterns> & ap)
 
 expr_ptr copier::visit_array_app(const shared_ptr<array_app> & app)
 {
-    auto new_app = make_shared<array_app>();
+    auto new_app = make_node<array_app>();
     new_app->location = app->location;
     new_app->type = app->type;
     new_app->object = copy(app->object);
@@ -196,7 +200,7 @@ expr_ptr copier::visit_array_app(const shared_ptr<array_app> & app)
 
 expr_ptr copier::visit_array_size(const shared_ptr<array_size> & as)
 {
-    auto new_as = make_shared<array_size>();
+    auto new_as = make_node<array_size>();
     new_as->location = as->location;
     new_as->type = as->type;
     new_as->object = copy(as->object);
@@ -208,7 +212,7 @@ expr_ptr copier::visit_array_size(const shared_ptr<array_size> & as)
 
 expr_ptr copier::visit_func(const shared_ptr<function> & func)
 {
-    auto new_func = make_shared<function>();
+    auto new_func = make_node<function>();
     new_func->location = func->location;
     new_func->type = func->type;
 
@@ -216,7 +220,7 @@ expr_ptr copier::visit_func(const shared_ptr<function> & func)
 
     for (auto & var : func->vars)
     {
-        auto new_var = make_shared<func_var>(*var);
+        auto new_var = make_node<func_var>(*var);
         new_func->vars.push_back(new_var);
         m_copy_context.bind(var, new_var);
     }
@@ -228,7 +232,7 @@ expr_ptr copier::visit_func(const shared_ptr<function> & func)
 
 expr_ptr copier::visit_func_app(const shared_ptr<func_app> & app)
 {
-    auto new_app = make_shared<func_app>();
+    auto new_app = make_node<func_app>();
     new_app->location = app->location;
     new_app->type = app->type;
     new_app->object = copy(app->object);
@@ -239,18 +243,23 @@ expr_ptr copier::visit_func_app(const shared_ptr<func_app> & app)
 
 expr_ptr copier::visit_external(const shared_ptr<external> & e)
 {
-    auto r = make_shared<external>();
+    auto r = make_node<external>();
     r->location = e->location;
     r->type = e->type;
     r->is_input = e->is_input;
+    r->is_builtin = e->is_builtin;
     r->name = e->name;
     r->type_expr = copy(e->type_expr);
+    r->is_pure = e->is_pure;
+    r->is_thread_safe = e->is_thread_safe;
+    r->cost_expr = copy(e->cost_expr);
+    r->cost = e->cost;
     return r;
 }
 
 expr_ptr copier::visit_type_name(const shared_ptr<type_name_expr> & e)
 {
-    auto r = make_shared<type_name_expr>();
+    auto r = make_node<type_name_expr>();
     r->location = e->location;
     r->type = e->type;
     r->name = e->name;
@@ -259,7 +268,7 @@ expr_ptr copier::visit_type_name(const shared_ptr<type_name_expr> & e)
 
 expr_ptr copier::visit_array_type(const shared_ptr<array_type_expr> & e)
 {
-    auto r = make_shared<array_type_expr>();
+    auto r = make_node<array_type_expr>();
     r->location = e->location;
     r->type = e->type;
 
@@ -273,7 +282,7 @@ expr_ptr copier::visit_array_type(const shared_ptr<array_type_expr> & e)
 
 expr_ptr copier::visit_func_type(const shared_ptr<func_type_expr> & e)
 {
-    auto r = make_shared<func_type_expr>();
+    auto r = make_node<func_type_expr>();
     r->location = e->location;
     r->type = e->type;
 
@@ -287,7 +296,7 @@ expr_ptr copier::visit_func_type(const shared_ptr<func_type_expr> & e)
 
 expr_ptr copier::visit_scope(const shared_ptr<scope_expr> & e)
 {
-    auto r = make_shared<scope_expr>(expr_slot());
+    auto r = make_node<scope_expr>(expr_slot());
     r->location = e->location;
     r->type = e->type;
 
@@ -296,7 +305,7 @@ expr_ptr copier::visit_scope(const shared_ptr<scope_expr> & e)
     for(auto & id : e->local.ids)
     {
         auto new_name = m_name_provider.new_name(id->name);
-        auto new_id = make_shared<identifier>(new_name, id->expr, id->location);
+        auto new_id = make_node<identifier>(new_name, id->expr, id->location);
         new_id->type_expr = copy(id->type_expr);
         new_id->explicit_type = id->explicit_type;
         new_id->is_recursive = id->is_recursive;
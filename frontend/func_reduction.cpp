@@ -3,6 +3,8 @@
 #include "../common/func_model_printer.hpp"
 #include "../utility/debug.hpp"
 
+#include <sstream>
+
 using namespace stream;
 using namespace stream::functional;
 using namespace std;
@@ -104,6 +106,114 @@ fn::expr_ptr func_reduction::visit_func(const shared_ptr<fn::function> & f)
 }
 
 fn::expr_ptr func_reduction::visit_func_app(const shared_ptr<fn::func_app> & app)
+{
+    // Applications of the same function to the same identifiers
+    // and constants reduce to the same expression.
+    // Reuse a copy of the first reduction instead of repeating it.
+
+    string key;
+    vector<id_ptr> key_ids;
+    if (!instance_key(app, key, key_ids))
+        return reduce_func_app(app);
+
+    auto cached = m_instances.find(key);
+    if (cached != m_instances.end())
+    {
+        ++m_instance_stats.hits;
+
+        if (verbose())
+            cout << "Reusing instance: " << key << endl;
+
+        return copy_instance(cached->second.expr);
+    }
+
+    ++m_instance_stats.misses;
+
+    auto result = reduce_func_app(app);
+
+    // The result may be modified by further reduction of the
+    // enclosing expression, so we cache a copy.
+    m_instances.emplace(key, instance { copy_instance(result), key_ids });
+
+    return result;
+}
+
+bool func_reduction::instance_key(const shared_ptr<fn::func_app> & app, string & key,
+                                  vector<id_ptr> & key_ids)
+{
+    auto ref = dynamic_pointer_cast<reference>(app->object.expr);
+    if (!ref)
+        return false;
+
+    auto id = dynamic_pointer_cast<identifier>(ref->var);
+    if (!id || id->is_recursive)
+        return false;
+
+    if (!m_visited_ids.count(id))
+        reduce(id);
+
+    auto f = dynamic_pointer_cast<fn::function>(id->expr.expr);
+    if (!f || f->vars.size() != app->args.size())
+        return false;
+
+    ostringstream text;
+    text << id->name << '@' << id.get() << '(';
+    key_ids.push_back(id);
+
+    for (auto & arg : app->args)
+    {
+        if (auto arg_ref = dynamic_pointer_cast<reference>(arg.expr))
+        {
+            // Function and array variables may be substituted
+            // differently at each application.
+            auto arg_id = dynamic_pointer_cast<identifier>(arg_ref->var);
+            if (!arg_id)
+                return false;
+            text << arg_id->name << '@' << arg_id.get();
+            key_ids.push_back(arg_id);
+        }
+        else if (auto i = dynamic_pointer_cast<int_const>(arg.expr))
+        {
+            text << "int " << i->text();
+            if (i->type)
+                text << " :: " << *i->type;
+        }
+        else if (auto r = dynamic_pointer_cast<real_const>(arg.expr))
+        {
+            text << "real " << std::hexfloat << r->value << std::defaultfloat;
+        }
+        else if (auto b = dynamic_pointer_cast<bool_const>(arg.expr))
+        {
+            text << "bool " << b->value;
+        }
+        else
+        {
+            return false;
+        }
+
+        text << ',';
+    }
+
+    text << ')';
+
+    key = text.str();
+    return true;
+}
+
+fn::expr_ptr func_reduction::copy_instance(const fn::expr_ptr & e)
+{
+    unordered_set<id_ptr> ids;
+    copier copy(ids, m_name_provider);
+    auto result = copy.copy(e);
+
+    // Local ids of the instance are already reduced.
+    for (auto & id : ids)
+        m_visited_ids.insert(id);
+
+    return result;
+}
+
+fn::expr_ptr func_reduction::reduce_func_app(const shared_ptr<fn::func_app> & app)
 {
     int tag = new_log_tag();
 
@@ -180,7 +290,13 @@ fn::expr_ptr func_reduction::visit_func_app(const shared_ptr<fn::func_app> & app
     {
         bool ok = false;
 
-        if (auto ref = dynamic_pointer_cast<reference>(object))
+        if (auto ext = dynamic_pointer_cast<external>(object))
+        {
+            ok = ext->is_builtin;
+            if (ok && verbose())
+                cout << "Terminating application at built-in function." << endl;
+        }
+        else if (auto ref = dynamic_pointer_cast<reference>(object))
         {
             if (dynamic_pointer_cast<func_var>(ref->var))
             {
@@ -209,12 +325,31 @@ fn::expr_ptr func_reduction::visit_func_app(const shared_ptr<fn::func_app> & app
         app->object = object;
         app->args = vector<expr_slot>(remaining_args,
                                       remaining_args + remaining_arg_count);
+
+        // Arguments of built-in functions must be reduced to arrays.
+        if (dynamic_pointer_cast<external>(object))
+        {
+            for (auto & arg : app->args)
+                arg = visit(arg);
+        }
+
         return app;
     }
 
     return object;
 }
 
+void func_reduction::print_statistics(ostream & out)
+{
+    int total = m_instance_stats.hits + m_instance_stats.misses;
+
+    out << "Function instances: " << total
+        << ", reused: " << m_instance_stats.hits;
+    if (total > 0)
+        out << " (" << (100 * m_instance_stats.hits / total) << "%)";
+    out << endl;
+}
+
 fn::expr_ptr func_reduction::apply(shared_ptr<fn::function> f,
                                    fn::expr_ptr* args,
                                    int applied_arg_count)
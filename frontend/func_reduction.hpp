@@ -8,6 +8,8 @@
 #include "../common/func_model_printer.hpp"
 
 #include <unordered_set>
+#include <unordered_map>
+#include <iostream>
 
 namespace arrp {
 
@@ -30,10 +32,16 @@ public:
 
     void reduce(fn::id_ptr id);
 
+    void print_statistics(std::ostream &);
+
 private:
     virtual void visit_local_id(const id_ptr & id) override;
     fn::expr_ptr visit_func(const shared_ptr<fn::function> &) override;
     fn::expr_ptr visit_func_app(const shared_ptr<fn::func_app> &) override;
+    fn::expr_ptr reduce_func_app(const shared_ptr<fn::func_app> &);
+    bool instance_key(const shared_ptr<fn::func_app> &, std::string & key,
+                      vector<id_ptr> & key_ids);
+    fn::expr_ptr copy_instance(const fn::expr_ptr &);
     fn::expr_ptr visit_ref(const shared_ptr<fn::reference> &) override;
     fn::expr_ptr visit_scope(const shared_ptr<fn::scope_expr> &) override;
     fn::expr_ptr apply(shared_ptr<fn::function> f,
@@ -44,6 +52,23 @@ private:
     fn::name_provider & m_name_provider;
     std::unordered_set<id_ptr> m_visited_ids;
 
+    struct instance
+    {
+        fn::expr_ptr expr;
+        // Keeps alive the ids whose addresses are part of the key.
+        vector<id_ptr> key_ids;
+    };
+
+    // Reduced function applications by function and arguments.
+    std::unordered_map<std::string, instance> m_instances;
+
+    struct
+    {
+        int hits = 0;
+        int misses = 0;
+    }
+    m_instance_stats;
+
     fn::printer m_printer;
 
     int new_log_tag() { return ++m_log_tag; }
@@ -44,6 +44,11 @@ unordered_map<string, primitive_op> generator::m_prim_ops =
     { "complex64", primitive_op::to_complex64 },
 };
 
+unordered_set<string> generator::m_builtin_funcs =
+{
+    "fft", "ifft", "rfft"
+};
+
 source_error generator::module_error(const string & what, const parsing::location & loc)
 {
     return source_error(what, location_in_module(loc));
@@ -302,6 +307,10 @@ void generator::apply_declaration(id_ptr id, ast::node_ptr root)
         ext->name = name;
 
         ext->type_expr = expr_slot(do_type_expr(type_node));
+
+        if (root->as_list()->elements.size() > 2)
+            do_external_attributes(ext, root->as_list()->elements[2]);
+
         id->expr = expr_slot(ext);
         id->type_expr = ext->type_expr;
         id->is_external = true;
@@ -876,6 +885,22 @@ expr_ptr generator::do_func_apply(ast::node_ptr root)
             op->location = location_in_module(root->location);
             return op;
         }
+
+        // Builtin functions can be shadowed by names in scope.
+
+        if (m_builtin_funcs.count(name) && !m_context.find(name))
+        {
+            auto ext = make_shared<external>();
+            ext->is_builtin = true;
+            ext->name = name;
+            ext->location = location_in_module(object_node->location);
+
+            auto result = make_shared<func_app>();
+            result->object = expr_slot(ext);
+            result->args = args;
+            result->location = location_in_module(root->location);
+            return result;
+        }
     }
 
     auto object = do_expr(object_node);
@@ -920,6 +945,37 @@ expr_ptr generator::do_func_comp(ast::node_ptr root)
     return func;
 }
 
+void generator::do_external_attributes(const shared_ptr<external> & ext, ast::node_ptr root)
+{
+    if (!root)
+        return;
+
+    for (auto & attribute : root->as_list()->elements)
+    {
+        auto name = attribute->as_list()->elements[0]->as_leaf<string>()->value;
+        auto value = attribute->as_list()->elements[1];
+
+        if (name == "pure" && !value)
+        {
+            ext->is_pure = true;
+            ext->is_thread_safe = true;
+        }
+        else if (name == "thread_safe" && !value)
+        {
+            ext->is_thread_safe = true;
+        }
+        else if (name == "cost" && value)
+        {
+            ext->cost_expr = expr_slot(do_expr(value));
+        }
+        else
+        {
+            throw source_error("Invalid attribute of external function.",
+                               location_in_module(attribute->location));
+        }
+    }
+}
+
 expr_ptr generator::do_type_expr(ast::node_ptr root)
 {
     expr_ptr result;
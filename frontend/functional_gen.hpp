@@ -31,6 +31,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <stack>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
 #include <tuple>
 
@@ -76,6 +77,7 @@ private:
     expr_ptr do_func_apply(ast::node_ptr);
     expr_ptr do_func_comp(ast::node_ptr);
     expr_ptr do_type_expr(ast::node_ptr);
+    void do_external_attributes(const shared_ptr<external> &, ast::node_ptr);
 
     string qualified_name(const string & name);
 
@@ -98,6 +100,7 @@ private:
     source_error module_error(const string & what, const parsing::location & loc);
 
     static unordered_map<string, primitive_op> m_prim_ops;
+    static unordered_set<string> m_builtin_funcs;
 
     unordered_map<string, id_ptr> m_final_ids;
 
@@ -1,8 +1,8 @@
-// A Bison parser, made by GNU Bison 3.0.4.
+// A Bison parser, made by GNU Bison 3.8.2.
 
 // Skeleton implementation for Bison LALR(1) parsers in C++
 
-// Copyright (C) 2002-2015 Free Software Foundation, Inc.
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
 
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -15,7 +15,7 @@
 // GNU General Public License for more details.
 
 // You should have received a copy of the GNU General Public License
-// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 // As a special exception, you may create a larger work that contains
 // part or all of the Bison parser skeleton and distribute that work
@@ -30,26 +30,19 @@
 // This special exception was added by the Free Software Foundation in
 // version 2.2 of Bison.
 
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
 
-// First part of user declarations.
 
-#line 37 "parser.cpp" // lalr1.cc:404
 
-# ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
-#  else
-#   define YY_NULLPTR 0
-#  endif
-# endif
 
 #include "parser.hpp"
 
-// User implementation prologue.
 
-#line 51 "parser.cpp" // lalr1.cc:412
 // Unqualified %code blocks.
-#line 57 "parser.y" // lalr1.cc:413
+#line 57 "parser.y"
 
 #include "driver.hpp"
 #include "scanner.hpp"
@@ -60,7 +53,7 @@
 using namespace stream::ast;
 using op_type = stream::primitive_op;
 
-#line 64 "parser.cpp" // lalr1.cc:413
+#line 57 "parser.cpp"
 
 
 #ifndef YY_
@@ -75,6 +68,16 @@ using op_type = stream::primitive_op;
 # endif
 #endif
 
+
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
+# else
+#  define YY_EXCEPTIONS 1
+# endif
+#endif
+
 #define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -92,13 +95,10 @@ using op_type = stream::primitive_op;
         {                                                               \
           (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
         }                                                               \
-    while (/*CONSTCOND*/ false)
+    while (false)
 # endif
 
 
-// Suppress unused-variable warnings by "using" E.
-#define YYUSE(E) ((void) (E))
-
 // Enable debugging if requested.
 #if YYDEBUG
 
@@ -111,7 +111,7 @@ using op_type = stream::primitive_op;
     {                                           \
       *yycdebug_ << Title << ' ';               \
       yy_print_ (*yycdebug_, Symbol);           \
-      *yycdebug_ << std::endl;                  \
+      *yycdebug_ << '\n';                       \
     }                                           \
   } while (false)
 
@@ -124,15 +124,15 @@ using op_type = stream::primitive_op;
 # define YY_STACK_PRINT()               \
   do {                                  \
     if (yydebug_)                       \
-      yystack_print_ ();                \
+      yy_stack_print_ ();                \
   } while (false)
 
 #else // !YYDEBUG
 
 # define YYCDEBUG if (false) std::cerr
-# define YY_SYMBOL_PRINT(Title, Symbol)  YYUSE(Symbol)
-# define YY_REDUCE_PRINT(Rule)           static_cast<void>(0)
-# define YY_STACK_PRINT()                static_cast<void>(0)
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
 
 #endif // !YYDEBUG
 
@@ -144,54 +144,17 @@ using op_type = stream::primitive_op;
 #define YYERROR         goto yyerrorlab
 #define YYRECOVERING()  (!!yyerrstatus_)
 
-#line 13 "parser.y" // lalr1.cc:479
+#line 13 "parser.y"
 namespace stream { namespace parsing {
-#line 150 "parser.cpp" // lalr1.cc:479
-
-  /* Return YYSTR after stripping away unnecessary quotes and
-     backslashes, so that it's suitable for yyerror.  The heuristic is
-     that double-quoting is unnecessary unless the string contains an
-     apostrophe, a comma, or backslash (other than backslash-backslash).
-     YYSTR is taken from yytname.  */
-  std::string
-  parser::yytnamerr_ (const char *yystr)
-  {
-    if (*yystr == '"')
-      {
-        std::string yyr = "";
-        char const *yyp = yystr;
-
-        for (;;)
-          switch (*++yyp)
-            {
-            case '\'':
-            case ',':
-              goto do_not_strip_quotes;
-
-            case '\\':
-              if (*++yyp != '\\')
-                goto do_not_strip_quotes;
-              // Fall through.
-            default:
-              yyr += *yyp;
-              break;
-
-            case '"':
-              return yyr;
-            }
-      do_not_strip_quotes: ;
-      }
-
-    return yystr;
-  }
-
+#line 150 "parser.cpp"
 
   /// Build a parser object.
   parser::parser (class stream::parsing::driver& driver_yyarg)
-    :
 #if YYDEBUG
-      yydebug_ (false),
+    : yydebug_ (false),
       yycdebug_ (&std::cerr),
+#else
+    :
 #endif
       driver (driver_yyarg)
   {}
@@ -199,144 +162,128 @@ namespace stream { namespace parsing {
   parser::~parser ()
   {}
 
-
-  /*---------------.
-  | Symbol types.  |
-  `---------------*/
-
-  inline
-  parser::syntax_error::syntax_error (const location_type& l, const std::string& m)
-    : std::runtime_error (m)
-    , location (l)
+  parser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
   {}
 
+  /*---------.
+  | symbol.  |
+  `---------*/
+
   // basic_symbol.
   template <typename Base>
-  inline
-  parser::basic_symbol<Base>::basic_symbol ()
-    : value ()
+  parser::basic_symbol<Base>::basic_symbol (const basic_symbol& that)
+    : Base (that)
+    , value (that.value)
+    , location (that.location)
   {}
 
-  template <typename Base>
-  inline
-  parser::basic_symbol<Base>::basic_symbol (const basic_symbol& other)
-    : Base (other)
-    , value ()
-    , location (other.location)
-  {
-    value = other.value;
-  }
-
 
+  /// Constructor for valueless symbols.
   template <typename Base>
-  inline
-  parser::basic_symbol<Base>::basic_symbol (typename Base::kind_type t, const semantic_type& v, const location_type& l)
+  parser::basic_symbol<Base>::basic_symbol (typename Base::kind_type t, YY_MOVE_REF (location_type) l)
     : Base (t)
-    , value (v)
+    , value ()
     , location (l)
   {}
 
-
-  /// Constructor for valueless symbols.
   template <typename Base>
-  inline
-  parser::basic_symbol<Base>::basic_symbol (typename Base::kind_type t, const location_type& l)
+  parser::basic_symbol<Base>::basic_symbol (typename Base::kind_type t, YY_RVREF (value_type) v, YY_RVREF (location_type) l)
     : Base (t)
-    , value ()
-    , location (l)
+    , value (YY_MOVE (v))
+    , location (YY_MOVE (l))
   {}
 
-  template <typename Base>
-  inline
-  parser::basic_symbol<Base>::~basic_symbol ()
-  {
-    clear ();
-  }
 
   template <typename Base>
-  inline
-  void
-  parser::basic_symbol<Base>::clear ()
+  parser::symbol_kind_type
+  parser::basic_symbol<Base>::type_get () const YY_NOEXCEPT
   {
-    Base::clear ();
+    return this->kind ();
   }
 
+
   template <typename Base>
-  inline
   bool
-  parser::basic_symbol<Base>::empty () const
+  parser::basic_symbol<Base>::empty () const YY_NOEXCEPT
   {
-    return Base::type_get () == empty_symbol;
+    return this->kind () == symbol_kind::S_YYEMPTY;
   }
 
   template <typename Base>
-  inline
   void
   parser::basic_symbol<Base>::move (basic_symbol& s)
   {
-    super_type::move(s);
-    value = s.value;
-    location = s.location;
+    super_type::move (s);
+    value = YY_MOVE (s.value);
+    location = YY_MOVE (s.location);
   }
 
-  // by_type.
-  inline
-  parser::by_type::by_type ()
-    : type (empty_symbol)
+  // by_kind.
+  parser::by_kind::by_kind () YY_NOEXCEPT
+    : kind_ (symbol_kind::S_YYEMPTY)
   {}
 
-  inline
-  parser::by_type::by_type (const by_type& other)
-    : type (other.type)
+#if 201103L <= YY_CPLUSPLUS
+  parser::by_kind::by_kind (by_kind&& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {
+    that.clear ();
+  }
+#endif
+
+  parser::by_kind::by_kind (const by_kind& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
   {}
 
-  inline
-  parser::by_type::by_type (token_type t)
-    : type (yytranslate_ (t))
+  parser::by_kind::by_kind (token_kind_type t) YY_NOEXCEPT
+    : kind_ (yytranslate_ (t))
   {}
 
-  inline
+
+
   void
-  parser::by_type::clear ()
+  parser::by_kind::clear () YY_NOEXCEPT
   {
-    type = empty_symbol;
+    kind_ = symbol_kind::S_YYEMPTY;
   }
 
-  inline
   void
-  parser::by_type::move (by_type& that)
+  parser::by_kind::move (by_kind& that)
   {
-    type = that.type;
+    kind_ = that.kind_;
     that.clear ();
   }
 
-  inline
-  int
-  parser::by_type::type_get () const
+  parser::symbol_kind_type
+  parser::by_kind::kind () const YY_NOEXCEPT
   {
-    return type;
+    return kind_;
   }
 
 
+  parser::symbol_kind_type
+  parser::by_kind::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+
   // by_state.
-  inline
-  parser::by_state::by_state ()
+  parser::by_state::by_state () YY_NOEXCEPT
     : state (empty_state)
   {}
 
-  inline
-  parser::by_state::by_state (const by_state& other)
-    : state (other.state)
+  parser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
   {}
 
-  inline
   void
-  parser::by_state::clear ()
+  parser::by_state::clear () YY_NOEXCEPT
   {
     state = empty_state;
   }
 
-  inline
   void
   parser::by_state::move (by_state& that)
   {
@@ -344,36 +291,39 @@ namespace stream { namespace parsing {
     that.clear ();
   }
 
-  inline
-  parser::by_state::by_state (state_type s)
+  parser::by_state::by_state (state_type s) YY_NOEXCEPT
     : state (s)
   {}
 
-  inline
-  parser::symbol_number_type
-  parser::by_state::type_get () const
+  parser::symbol_kind_type
+  parser::by_state::kind () const YY_NOEXCEPT
   {
     if (state == empty_state)
-      return empty_symbol;
+      return symbol_kind::S_YYEMPTY;
     else
-      return yystos_[state];
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
   }
 
-  inline
   parser::stack_symbol_type::stack_symbol_type ()
   {}
 
+  parser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.value), YY_MOVE (that.location))
+  {
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
 
-  inline
-  parser::stack_symbol_type::stack_symbol_type (state_type s, symbol_type& that)
-    : super_type (s, that.location)
+  parser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.value), YY_MOVE (that.location))
   {
-    value = that.value;
     // that is emptied.
-    that.type = empty_symbol;
+    that.kind_ = symbol_kind::S_YYEMPTY;
   }
 
-  inline
+#if YY_CPLUSPLUS < 201103L
   parser::stack_symbol_type&
   parser::stack_symbol_type::operator= (const stack_symbol_type& that)
   {
@@ -383,9 +333,19 @@ namespace stream { namespace parsing {
     return *this;
   }
 
+  parser::stack_symbol_type&
+  parser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    value = that.value;
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
 
   template <typename Base>
-  inline
   void
   parser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
   {
@@ -393,50 +353,51 @@ namespace stream { namespace parsing {
       YY_SYMBOL_PRINT (yymsg, yysym);
 
     // User destructor.
-    YYUSE (yysym.type_get ());
+    YY_USE (yysym.kind ());
   }
 
 #if YYDEBUG
   template <typename Base>
   void
-  parser::yy_print_ (std::ostream& yyo,
-                                     const basic_symbol<Base>& yysym) const
+  parser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
   {
     std::ostream& yyoutput = yyo;
-    YYUSE (yyoutput);
-    symbol_number_type yytype = yysym.type_get ();
-    // Avoid a (spurious) G++ 4.8 warning about "array subscript is
-    // below array bounds".
+    YY_USE (yyoutput);
     if (yysym.empty ())
-      std::abort ();
-    yyo << (yytype < yyntokens_ ? "token" : "nterm")
-        << ' ' << yytname_[yytype] << " ("
-        << yysym.location << ": ";
-    YYUSE (yytype);
-    yyo << ')';
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
   }
 #endif
 
-  inline
   void
-  parser::yypush_ (const char* m, state_type s, symbol_type& sym)
+  parser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
   {
-    stack_symbol_type t (s, sym);
-    yypush_ (m, t);
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
   }
 
-  inline
   void
-  parser::yypush_ (const char* m, stack_symbol_type& s)
+  parser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
   {
-    if (m)
-      YY_SYMBOL_PRINT (m, s);
-    yystack_.push (s);
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
   }
 
-  inline
   void
-  parser::yypop_ (unsigned int n)
+  parser::yypop_ (int n) YY_NOEXCEPT
   {
     yystack_.pop (n);
   }
@@ -468,32 +429,37 @@ namespace stream { namespace parsing {
   }
 #endif // YYDEBUG
 
-  inline parser::state_type
+  parser::state_type
   parser::yy_lr_goto_state_ (state_type yystate, int yysym)
   {
-    int yyr = yypgoto_[yysym - yyntokens_] + yystate;
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
     if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
       return yytable_[yyr];
     else
-      return yydefgoto_[yysym - yyntokens_];
+      return yydefgoto_[yysym - YYNTOKENS];
   }
 
-  inline bool
-  parser::yy_pact_value_is_default_ (int yyvalue)
+  bool
+  parser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
   {
     return yyvalue == yypact_ninf_;
   }
 
-  inline bool
-  parser::yy_table_value_is_error_ (int yyvalue)
+  bool
+  parser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
   {
     return yyvalue == yytable_ninf_;
   }
 
+  int
+  parser::operator() ()
+  {
+    return parse ();
+  }
+
   int
   parser::parse ()
   {
-    // State.
     int yyn;
     /// Length of the RHS of the rule being reduced.
     int yylen = 0;
@@ -511,11 +477,11 @@ namespace stream { namespace parsing {
     /// The return value of parse ().
     int yyresult;
 
-    // FIXME: This shoud be completely indented.  It is not yet to
-    // avoid gratuitous conflicts when merging into the master branch.
+#if YY_EXCEPTIONS
     try
+#endif // YY_EXCEPTIONS
       {
-    YYCDEBUG << "Starting parse" << std::endl;
+    YYCDEBUG << "Starting parse\n";
 
 
     /* Initialize the stack.  The initial state will be set in
@@ -523,47 +489,69 @@ namespace stream { namespace parsing {
        location values to have been already stored, initialize these
        stacks with a primary value.  */
     yystack_.clear ();
-    yypush_ (YY_NULLPTR, 0, yyla);
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
 
-    // A new symbol was pushed on the stack.
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
   yynewstate:
-    YYCDEBUG << "Entering state " << yystack_[0].state << std::endl;
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
 
     // Accept?
     if (yystack_[0].state == yyfinal_)
-      goto yyacceptlab;
+      YYACCEPT;
 
     goto yybackup;
 
-    // Backup.
-  yybackup:
 
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
     // Try to take a decision without lookahead.
-    yyn = yypact_[yystack_[0].state];
+    yyn = yypact_[+yystack_[0].state];
     if (yy_pact_value_is_default_ (yyn))
       goto yydefault;
 
     // Read a lookahead token.
     if (yyla.empty ())
       {
-        YYCDEBUG << "Reading a token: ";
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
         try
+#endif // YY_EXCEPTIONS
           {
-            yyla.type = yytranslate_ (yylex (&yyla.value, &yyla.location));
+            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location));
           }
+#if YY_EXCEPTIONS
         catch (const syntax_error& yyexc)
           {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
             error (yyexc);
             goto yyerrlab1;
           }
+#endif // YY_EXCEPTIONS
       }
     YY_SYMBOL_PRINT ("Next token is", yyla);
 
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
+
     /* If the proper action on seeing token YYLA.TYPE is to reduce or
        to detect an error, take that action.  */
-    yyn += yyla.type_get ();
-    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.type_get ())
-      goto yydefault;
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        goto yydefault;
+      }
 
     // Reduce or error.
     yyn = yytable_[yyn];
@@ -580,26 +568,28 @@ namespace stream { namespace parsing {
       --yyerrstatus_;
 
     // Shift the lookahead token.
-    yypush_ ("Shifting", yyn, yyla);
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
     goto yynewstate;
 
+
   /*-----------------------------------------------------------.
   | yydefault -- do the default action for the current state.  |
   `-----------------------------------------------------------*/
   yydefault:
-    yyn = yydefact_[yystack_[0].state];
+    yyn = yydefact_[+yystack_[0].state];
     if (yyn == 0)
       goto yyerrlab;
     goto yyreduce;
 
+
   /*-----------------------------.
-  | yyreduce -- Do a reduction.  |
+  | yyreduce -- do a reduction.  |
   `-----------------------------*/
   yyreduce:
     yylen = yyr2_[yyn];
     {
       stack_symbol_type yylhs;
-      yylhs.state = yy_lr_goto_state_(yystack_[yylen].state, yyr1_[yyn]);
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
       /* If YYLEN is nonzero, implement the default value of the
          action: '$$ = $1'.  Otherwise, use the top of the stack.
 
@@ -611,645 +601,688 @@ namespace stream { namespace parsing {
       else
         yylhs.value = yystack_[0].value;
 
-      // Compute the default @$.
+      // Default location.
       {
-        slice<stack_symbol_type, stack_type> slice (yystack_, yylen);
-        YYLLOC_DEFAULT (yylhs.location, slice, yylen);
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
       }
 
       // Perform the reduction.
       YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
       try
+#endif // YY_EXCEPTIONS
         {
           switch (yyn)
             {
-  case 2:
-#line 73 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list(program, yylhs.location, { (yystack_[2].value), (yystack_[1].value), (yystack_[0].value) });
-    driver.m_ast = (yylhs.value);
+  case 2: // program: module_decl imports declarations
+#line 73 "parser.y"
+  {
+    yylhs.value = make_list(program, yylhs.location, { yystack_[2].value, yystack_[1].value, yystack_[0].value });
+    driver.m_ast = yylhs.value;
   }
-#line 633 "parser.cpp" // lalr1.cc:859
+#line 626 "parser.cpp"
     break;
 
-  case 3:
-#line 81 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = nullptr; }
-#line 639 "parser.cpp" // lalr1.cc:859
+  case 3: // module_decl: %empty
+#line 81 "parser.y"
+  { yylhs.value = nullptr; }
+#line 632 "parser.cpp"
     break;
 
-  case 4:
-#line 84 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = (yystack_[1].value); }
-#line 645 "parser.cpp" // lalr1.cc:859
+  case 4: // module_decl: MODULE id ';'
+#line 84 "parser.y"
+  { yylhs.value = yystack_[1].value; }
+#line 638 "parser.cpp"
     break;
 
-  case 5:
-#line 89 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = nullptr; }
-#line 651 "parser.cpp" // lalr1.cc:859
+  case 5: // imports: %empty
+#line 89 "parser.y"
+  { yylhs.value = nullptr; }
+#line 644 "parser.cpp"
     break;
 
-  case 7:
-#line 96 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( yylhs.location, { (yystack_[0].value) } );
+  case 7: // import_list: import
+#line 96 "parser.y"
+  {
+    yylhs.value = make_list( yylhs.location, { yystack_[0].value } );
   }
-#line 659 "parser.cpp" // lalr1.cc:859
+#line 652 "parser.cpp"
     break;
 
-  case 8:
-#line 101 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 8: // import_list: import_list ';' import
+#line 101 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 669 "parser.cpp" // lalr1.cc:859
+#line 662 "parser.cpp"
     break;
 
-  case 9:
-#line 110 "parser.y" // lalr1.cc:859
-    {
-  (yylhs.value) = make_list( yylhs.location, { (yystack_[0].value), nullptr } );
+  case 9: // import: IMPORT id
+#line 110 "parser.y"
+  {
+  yylhs.value = make_list( yylhs.location, { yystack_[0].value, nullptr } );
   }
-#line 677 "parser.cpp" // lalr1.cc:859
+#line 670 "parser.cpp"
     break;
 
-  case 10:
-#line 115 "parser.y" // lalr1.cc:859
-    {
-  (yylhs.value) = make_list( yylhs.location, { (yystack_[2].value), (yystack_[0].value) } );
+  case 10: // import: IMPORT id AS id
+#line 115 "parser.y"
+  {
+  yylhs.value = make_list( yylhs.location, { yystack_[2].value, yystack_[0].value } );
   }
-#line 685 "parser.cpp" // lalr1.cc:859
+#line 678 "parser.cpp"
     break;
 
-  case 11:
-#line 122 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = nullptr; }
-#line 691 "parser.cpp" // lalr1.cc:859
+  case 11: // declarations: %empty
+#line 122 "parser.y"
+  { yylhs.value = nullptr; }
+#line 684 "parser.cpp"
     break;
 
-  case 13:
-#line 129 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( yylhs.location, { (yystack_[0].value) } );
+  case 13: // declaration_list: declaration
+#line 129 "parser.y"
+  {
+    yylhs.value = make_list( yylhs.location, { yystack_[0].value } );
   }
-#line 699 "parser.cpp" // lalr1.cc:859
+#line 692 "parser.cpp"
     break;
 
-  case 14:
-#line 134 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 14: // declaration_list: declaration_list ';' declaration
+#line 134 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 709 "parser.cpp" // lalr1.cc:859
+#line 702 "parser.cpp"
     break;
 
-  case 19:
-#line 151 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( yylhs.location, { (yystack_[0].value) } );
+  case 19: // nested_decl_list: nested_decl
+#line 151 "parser.y"
+  {
+    yylhs.value = make_list( yylhs.location, { yystack_[0].value } );
   }
-#line 717 "parser.cpp" // lalr1.cc:859
+#line 710 "parser.cpp"
     break;
 
-  case 20:
-#line 156 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 20: // nested_decl_list: nested_decl_list ';' nested_decl
+#line 156 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 727 "parser.cpp" // lalr1.cc:859
+#line 720 "parser.cpp"
     break;
 
-  case 21:
-#line 165 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::input, yylhs.location, {(yystack_[2].value), (yystack_[0].value)}); }
-#line 733 "parser.cpp" // lalr1.cc:859
+  case 21: // external_decl: INPUT id ':' type
+#line 165 "parser.y"
+  { yylhs.value = make_list(ast::input, yylhs.location, {yystack_[2].value, yystack_[0].value}); }
+#line 726 "parser.cpp"
     break;
 
-  case 22:
-#line 168 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::external, yylhs.location, {(yystack_[2].value), (yystack_[0].value)}); }
-#line 739 "parser.cpp" // lalr1.cc:859
+  case 22: // external_decl: EXTERNAL id ':' type
+#line 168 "parser.y"
+  { yylhs.value = make_list(ast::external, yylhs.location, {yystack_[2].value, yystack_[0].value, nullptr}); }
+#line 732 "parser.cpp"
     break;
 
-  case 23:
-#line 171 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::output, yylhs.location, {(yystack_[0].value), nullptr}); }
-#line 745 "parser.cpp" // lalr1.cc:859
+  case 23: // external_decl: EXTERNAL id '(' external_attribute_list ')' ':' type
+#line 171 "parser.y"
+  { yylhs.value = make_list(ast::external, yylhs.location, {yystack_[5].value, yystack_[0].value, yystack_[3].value}); }
+#line 738 "parser.cpp"
     break;
 
-  case 24:
-#line 175 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::output_value, yylhs.location, {(yystack_[2].value), nullptr, (yystack_[0].value)}); }
-#line 751 "parser.cpp" // lalr1.cc:859
+  case 24: // external_decl: OUTPUT id
+#line 174 "parser.y"
+  { yylhs.value = make_list(ast::output, yylhs.location, {yystack_[0].value, nullptr}); }
+#line 744 "parser.cpp"
     break;
 
-  case 25:
-#line 178 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = (yystack_[0].value); (yylhs.value)->type = ast::output_type; }
-#line 757 "parser.cpp" // lalr1.cc:859
+  case 25: // external_decl: OUTPUT id '=' expr
+#line 178 "parser.y"
+  { yylhs.value = make_list(ast::output_value, yylhs.location, {yystack_[2].value, nullptr, yystack_[0].value}); }
+#line 750 "parser.cpp"
     break;
 
-  case 26:
-#line 184 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( ast::binding, yylhs.location, {(yystack_[2].value), nullptr, (yystack_[0].value)} );
+  case 26: // external_decl: OUTPUT id_type_decl
+#line 181 "parser.y"
+  { yylhs.value = yystack_[0].value; yylhs.value->type = ast::output_type; }
+#line 756 "parser.cpp"
+    break;
+
+  case 27: // external_attribute_list: external_attribute
+#line 186 "parser.y"
+  {
+    yylhs.value = make_list( yylhs.location, { yystack_[0].value } );
   }
-#line 765 "parser.cpp" // lalr1.cc:859
+#line 764 "parser.cpp"
     break;
 
-  case 27:
-#line 189 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( ast::binding, yylhs.location, {(yystack_[5].value), (yystack_[3].value), (yystack_[0].value)} );
+  case 28: // external_attribute_list: external_attribute_list ',' external_attribute
+#line 191 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 773 "parser.cpp" // lalr1.cc:859
+#line 774 "parser.cpp"
     break;
 
-  case 28:
-#line 195 "parser.y" // lalr1.cc:859
-    {
-    auto pattern = make_list(yylhs.location, { (yystack_[3].value), (yystack_[0].value) });
-    (yylhs.value) = make_list( ast::array_element_def, yylhs.location, { (yystack_[5].value), pattern });
+  case 29: // external_attribute: id
+#line 200 "parser.y"
+  { yylhs.value = make_list( yylhs.location, { yystack_[0].value, nullptr } ); }
+#line 780 "parser.cpp"
+    break;
+
+  case 30: // external_attribute: id '=' expr
+#line 203 "parser.y"
+  { yylhs.value = make_list( yylhs.location, { yystack_[2].value, yystack_[0].value } ); }
+#line 786 "parser.cpp"
+    break;
+
+  case 31: // binding: id '=' expr
+#line 208 "parser.y"
+  {
+    yylhs.value = make_list( ast::binding, yylhs.location, {yystack_[2].value, nullptr, yystack_[0].value} );
   }
-#line 782 "parser.cpp" // lalr1.cc:859
+#line 794 "parser.cpp"
     break;
 
-  case 29:
-#line 203 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {} ); }
-#line 788 "parser.cpp" // lalr1.cc:859
+  case 32: // binding: id '(' param_list ')' '=' expr
+#line 213 "parser.y"
+  {
+    yylhs.value = make_list( ast::binding, yylhs.location, {yystack_[5].value, yystack_[3].value, yystack_[0].value} );
+  }
+#line 802 "parser.cpp"
     break;
 
-  case 30:
-#line 206 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} ); }
-#line 794 "parser.cpp" // lalr1.cc:859
+  case 33: // binding: id '[' expr_list ']' '=' array_exprs
+#line 219 "parser.y"
+  {
+    auto pattern = make_list(yylhs.location, { yystack_[3].value, yystack_[0].value });
+    yylhs.value = make_list( ast::array_element_def, yylhs.location, { yystack_[5].value, pattern });
+  }
+#line 811 "parser.cpp"
     break;
 
-  case 31:
-#line 209 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 34: // param_list: %empty
+#line 227 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {} ); }
+#line 817 "parser.cpp"
+    break;
+
+  case 35: // param_list: id
+#line 230 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {yystack_[0].value} ); }
+#line 823 "parser.cpp"
+    break;
+
+  case 36: // param_list: param_list ',' id
+#line 233 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 804 "parser.cpp" // lalr1.cc:859
+#line 833 "parser.cpp"
     break;
 
-  case 32:
-#line 218 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::id_type_decl, yylhs.location, {(yystack_[2].value), (yystack_[0].value)}); }
-#line 810 "parser.cpp" // lalr1.cc:859
+  case 37: // id_type_decl: id ':' type
+#line 242 "parser.y"
+    { yylhs.value = make_list(ast::id_type_decl, yylhs.location, {yystack_[2].value, yystack_[0].value}); }
+#line 839 "parser.cpp"
     break;
 
-  case 35:
-#line 227 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::function_type, yylhs.location, {(yystack_[2].value), (yystack_[0].value)}); }
-#line 816 "parser.cpp" // lalr1.cc:859
+  case 40: // function_type: data_type_list RIGHT_ARROW data_type
+#line 251 "parser.y"
+  { yylhs.value = make_list(ast::function_type, yylhs.location, {yystack_[2].value, yystack_[0].value}); }
+#line 845 "parser.cpp"
     break;
 
-  case 36:
-#line 232 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} ); }
-#line 822 "parser.cpp" // lalr1.cc:859
+  case 41: // data_type_list: data_type
+#line 256 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {yystack_[0].value} ); }
+#line 851 "parser.cpp"
     break;
 
-  case 37:
-#line 235 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 42: // data_type_list: data_type_list ',' data_type
+#line 259 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 832 "parser.cpp" // lalr1.cc:859
+#line 861 "parser.cpp"
     break;
 
-  case 40:
-#line 248 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list(ast::array_type, yylhs.location, {(yystack_[2].value), (yystack_[0].value)}); }
-#line 838 "parser.cpp" // lalr1.cc:859
+  case 45: // array_type: '[' expr_list ']' primitive_type
+#line 272 "parser.y"
+  { yylhs.value = make_list(ast::array_type, yylhs.location, {yystack_[2].value, yystack_[0].value}); }
+#line 867 "parser.cpp"
     break;
 
-  case 55:
-#line 284 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( array_concat, yylhs.location, {(yystack_[2].value), (yystack_[0].value)} ); }
-#line 844 "parser.cpp" // lalr1.cc:859
+  case 60: // expr: expr PLUSPLUS expr
+#line 308 "parser.y"
+  { yylhs.value = make_list( array_concat, yylhs.location, {yystack_[2].value, yystack_[0].value} ); }
+#line 873 "parser.cpp"
     break;
 
-  case 56:
-#line 287 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::negate), (yystack_[0].value)} ); }
-#line 850 "parser.cpp" // lalr1.cc:859
+  case 61: // expr: LOGIC_NOT expr
+#line 311 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::negate), yystack_[0].value} ); }
+#line 879 "parser.cpp"
     break;
 
-  case 57:
-#line 290 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_not), (yystack_[0].value)} ); }
-#line 856 "parser.cpp" // lalr1.cc:859
+  case 62: // expr: BIT_NOT expr
+#line 314 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_not), yystack_[0].value} ); }
+#line 885 "parser.cpp"
     break;
 
-  case 58:
-#line 293 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::logic_or), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 862 "parser.cpp" // lalr1.cc:859
+  case 63: // expr: expr LOGIC_OR expr
+#line 317 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::logic_or), yystack_[2].value, yystack_[0].value} ); }
+#line 891 "parser.cpp"
     break;
 
-  case 59:
-#line 296 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::logic_and), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 868 "parser.cpp" // lalr1.cc:859
+  case 64: // expr: expr LOGIC_AND expr
+#line 320 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::logic_and), yystack_[2].value, yystack_[0].value} ); }
+#line 897 "parser.cpp"
     break;
 
-  case 60:
-#line 299 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_eq), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 874 "parser.cpp" // lalr1.cc:859
+  case 65: // expr: expr EQ expr
+#line 323 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_eq), yystack_[2].value, yystack_[0].value} ); }
+#line 903 "parser.cpp"
     break;
 
-  case 61:
-#line 302 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_neq), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 880 "parser.cpp" // lalr1.cc:859
+  case 66: // expr: expr NEQ expr
+#line 326 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_neq), yystack_[2].value, yystack_[0].value} ); }
+#line 909 "parser.cpp"
     break;
 
-  case 62:
-#line 305 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_l), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 886 "parser.cpp" // lalr1.cc:859
+  case 67: // expr: expr LESS expr
+#line 329 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_l), yystack_[2].value, yystack_[0].value} ); }
+#line 915 "parser.cpp"
     break;
 
-  case 63:
-#line 308 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_leq), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 892 "parser.cpp" // lalr1.cc:859
+  case 68: // expr: expr LESS_EQ expr
+#line 332 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_leq), yystack_[2].value, yystack_[0].value} ); }
+#line 921 "parser.cpp"
     break;
 
-  case 64:
-#line 311 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_g), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 898 "parser.cpp" // lalr1.cc:859
+  case 69: // expr: expr MORE expr
+#line 335 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_g), yystack_[2].value, yystack_[0].value} ); }
+#line 927 "parser.cpp"
     break;
 
-  case 65:
-#line 314 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_geq), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 904 "parser.cpp" // lalr1.cc:859
+  case 70: // expr: expr MORE_EQ expr
+#line 338 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::compare_geq), yystack_[2].value, yystack_[0].value} ); }
+#line 933 "parser.cpp"
     break;
 
-  case 66:
-#line 317 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::add), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 910 "parser.cpp" // lalr1.cc:859
+  case 71: // expr: expr '+' expr
+#line 341 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::add), yystack_[2].value, yystack_[0].value} ); }
+#line 939 "parser.cpp"
     break;
 
-  case 67:
-#line 320 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::subtract), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 916 "parser.cpp" // lalr1.cc:859
+  case 72: // expr: expr '-' expr
+#line 344 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::subtract), yystack_[2].value, yystack_[0].value} ); }
+#line 945 "parser.cpp"
     break;
 
-  case 68:
-#line 323 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::negate), (yystack_[0].value)} ); }
-#line 922 "parser.cpp" // lalr1.cc:859
+  case 73: // expr: '-' expr
+#line 347 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::negate), yystack_[0].value} ); }
+#line 951 "parser.cpp"
     break;
 
-  case 69:
-#line 326 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::multiply), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 928 "parser.cpp" // lalr1.cc:859
+  case 74: // expr: expr '*' expr
+#line 350 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::multiply), yystack_[2].value, yystack_[0].value} ); }
+#line 957 "parser.cpp"
     break;
 
-  case 70:
-#line 329 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::divide), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 934 "parser.cpp" // lalr1.cc:859
+  case 75: // expr: expr '/' expr
+#line 353 "parser.y"
+    { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::divide), yystack_[2].value, yystack_[0].value} ); }
+#line 963 "parser.cpp"
     break;
 
-  case 71:
-#line 332 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::divide_integer), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 940 "parser.cpp" // lalr1.cc:859
+  case 76: // expr: expr INT_DIV expr
+#line 356 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::divide_integer), yystack_[2].value, yystack_[0].value} ); }
+#line 969 "parser.cpp"
     break;
 
-  case 72:
-#line 335 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::modulo), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 946 "parser.cpp" // lalr1.cc:859
+  case 77: // expr: expr '%' expr
+#line 359 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::modulo), yystack_[2].value, yystack_[0].value} ); }
+#line 975 "parser.cpp"
     break;
 
-  case 73:
-#line 338 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::raise), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 952 "parser.cpp" // lalr1.cc:859
+  case 78: // expr: expr '^' expr
+#line 362 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::raise), yystack_[2].value, yystack_[0].value} ); }
+#line 981 "parser.cpp"
     break;
 
-  case 74:
-#line 341 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_and), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 958 "parser.cpp" // lalr1.cc:859
+  case 79: // expr: expr BIT_AND expr
+#line 365 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_and), yystack_[2].value, yystack_[0].value} ); }
+#line 987 "parser.cpp"
     break;
 
-  case 75:
-#line 344 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_or), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 964 "parser.cpp" // lalr1.cc:859
+  case 80: // expr: expr BIT_OR expr
+#line 368 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_or), yystack_[2].value, yystack_[0].value} ); }
+#line 993 "parser.cpp"
     break;
 
-  case 76:
-#line 347 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_xor), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 970 "parser.cpp" // lalr1.cc:859
+  case 81: // expr: expr BIT_XOR expr
+#line 371 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_xor), yystack_[2].value, yystack_[0].value} ); }
+#line 999 "parser.cpp"
     break;
 
-  case 77:
-#line 350 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_lshift), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 976 "parser.cpp" // lalr1.cc:859
+  case 82: // expr: expr BIT_SHIFT_LEFT expr
+#line 374 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_lshift), yystack_[2].value, yystack_[0].value} ); }
+#line 1005 "parser.cpp"
     break;
 
-  case 78:
-#line 353 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_rshift), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 982 "parser.cpp" // lalr1.cc:859
+  case 83: // expr: expr BIT_SHIFT_RIGHT expr
+#line 377 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[1].location,op_type::bitwise_rshift), yystack_[2].value, yystack_[0].value} ); }
+#line 1011 "parser.cpp"
     break;
 
-  case 79:
-#line 356 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = (yystack_[1].value); }
-#line 988 "parser.cpp" // lalr1.cc:859
+  case 84: // expr: '(' expr ')'
+#line 380 "parser.y"
+  { yylhs.value = yystack_[1].value; }
+#line 1017 "parser.cpp"
     break;
 
-  case 82:
-#line 363 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( ast::binding, yylhs.location, {(yystack_[2].value), nullptr, (yystack_[0].value)} );
+  case 87: // expr: id '=' expr
+#line 387 "parser.y"
+  {
+    yylhs.value = make_list( ast::binding, yylhs.location, {yystack_[2].value, nullptr, yystack_[0].value} );
   }
-#line 996 "parser.cpp" // lalr1.cc:859
+#line 1025 "parser.cpp"
     break;
 
-  case 83:
-#line 371 "parser.y" // lalr1.cc:859
-    {
-    auto bnd_list = make_list(yystack_[2].location, {(yystack_[2].value)});
-    (yylhs.value) = make_list(ast::local_scope, yylhs.location, { bnd_list, (yystack_[0].value) } );
+  case 88: // let_expr: LET binding IN expr
+#line 395 "parser.y"
+  {
+    auto bnd_list = make_list(yystack_[2].location, {yystack_[2].value});
+    yylhs.value = make_list(ast::local_scope, yylhs.location, { bnd_list, yystack_[0].value } );
   }
-#line 1005 "parser.cpp" // lalr1.cc:859
+#line 1034 "parser.cpp"
     break;
 
-  case 84:
-#line 377 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list(ast::local_scope, yylhs.location, { (yystack_[4].value), (yystack_[0].value) } );
+  case 89: // let_expr: LET '{' nested_decl_list optional_semicolon '}' IN expr
+#line 401 "parser.y"
+  {
+    yylhs.value = make_list(ast::local_scope, yylhs.location, { yystack_[4].value, yystack_[0].value } );
   }
-#line 1013 "parser.cpp" // lalr1.cc:859
+#line 1042 "parser.cpp"
     break;
 
-  case 85:
-#line 384 "parser.y" // lalr1.cc:859
-    {
-    auto bnd_list = make_list(yystack_[0].location, {(yystack_[0].value)});
-    (yylhs.value) = make_list(ast::local_scope, yylhs.location, { bnd_list, (yystack_[2].value) } );
+  case 90: // where_expr: expr WHERE binding
+#line 408 "parser.y"
+  {
+    auto bnd_list = make_list(yystack_[0].location, {yystack_[0].value});
+    yylhs.value = make_list(ast::local_scope, yylhs.location, { bnd_list, yystack_[2].value } );
   }
-#line 1022 "parser.cpp" // lalr1.cc:859
+#line 1051 "parser.cpp"
     break;
 
-  case 86:
-#line 390 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list(ast::local_scope, yylhs.location, { (yystack_[2].value), (yystack_[5].value) } );
+  case 91: // where_expr: expr WHERE '{' nested_decl_list optional_semicolon '}'
+#line 414 "parser.y"
+  {
+    yylhs.value = make_list(ast::local_scope, yylhs.location, { yystack_[2].value, yystack_[5].value } );
   }
-#line 1030 "parser.cpp" // lalr1.cc:859
+#line 1059 "parser.cpp"
     break;
 
-  case 87:
-#line 397 "parser.y" // lalr1.cc:859
-    {
-    auto params = make_list(yylhs.location, { (yystack_[3].value) });
-    (yylhs.value) = make_list(ast::lambda, yylhs.location, { params, (yystack_[0].value) } );
+  case 92: // func_lambda: '(' expr ')' RIGHT_ARROW expr
+#line 421 "parser.y"
+  {
+    auto params = make_list(yylhs.location, { yystack_[3].value });
+    yylhs.value = make_list(ast::lambda, yylhs.location, { params, yystack_[0].value } );
   }
-#line 1039 "parser.cpp" // lalr1.cc:859
+#line 1068 "parser.cpp"
     break;
 
-  case 88:
-#line 403 "parser.y" // lalr1.cc:859
-    {
-    auto params = make_list(yylhs.location, {(yystack_[5].value)});
-    params->as_list()->append((yystack_[3].value)->as_list()->elements);
-    (yylhs.value) = make_list(ast::lambda, yylhs.location, {params, (yystack_[0].value)} );
+  case 93: // func_lambda: '(' expr ',' expr_list ')' RIGHT_ARROW expr
+#line 427 "parser.y"
+  {
+    auto params = make_list(yylhs.location, {yystack_[5].value});
+    params->as_list()->append(yystack_[3].value->as_list()->elements);
+    yylhs.value = make_list(ast::lambda, yylhs.location, {params, yystack_[0].value} );
   }
-#line 1049 "parser.cpp" // lalr1.cc:859
+#line 1078 "parser.cpp"
     break;
 
-  case 89:
-#line 412 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( ast::array_apply, yylhs.location, {(yystack_[3].value), (yystack_[1].value)} ); }
-#line 1055 "parser.cpp" // lalr1.cc:859
+  case 94: // array_apply: expr '[' expr_list ']'
+#line 436 "parser.y"
+  { yylhs.value = make_list( ast::array_apply, yylhs.location, {yystack_[3].value, yystack_[1].value} ); }
+#line 1084 "parser.cpp"
     break;
 
-  case 90:
-#line 417 "parser.y" // lalr1.cc:859
-    {
+  case 95: // array_lambda: '[' array_lambda_params ']' RIGHT_ARROW expr
+#line 441 "parser.y"
+  {
     auto ranges = make_list(yystack_[3].location, {});
     auto indexes = make_list(yystack_[3].location, {});
 
-    for (auto & param : (yystack_[3].value)->as_list()->elements)
+    for (auto & param : yystack_[3].value->as_list()->elements)
     {
       indexes->as_list()->append(param->as_list()->elements[0]);
       ranges->as_list()->append(param->as_list()->elements[1]);
     }
 
-    auto piece = make_list(yystack_[0].location, { nullptr, (yystack_[0].value) });
+    auto piece = make_list(yystack_[0].location, { nullptr, yystack_[0].value });
     auto pieces = make_list(yystack_[0].location, { piece });
     auto pattern = make_list(yylhs.location, { indexes, pieces });
     auto patterns = make_list(yylhs.location, { pattern });
 
-    (yylhs.value) = make_list( ast::array_def, yylhs.location, {ranges, patterns} );
+    yylhs.value = make_list( ast::array_def, yylhs.location, {ranges, patterns} );
   }
-#line 1077 "parser.cpp" // lalr1.cc:859
+#line 1106 "parser.cpp"
     break;
 
-  case 91:
-#line 438 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} ); }
-#line 1083 "parser.cpp" // lalr1.cc:859
+  case 96: // array_lambda_params: array_lambda_param
+#line 462 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {yystack_[0].value} ); }
+#line 1112 "parser.cpp"
     break;
 
-  case 92:
-#line 441 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 97: // array_lambda_params: array_lambda_params ',' array_lambda_param
+#line 465 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 1093 "parser.cpp" // lalr1.cc:859
+#line 1122 "parser.cpp"
     break;
 
-  case 93:
-#line 450 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value), make_node(infinity, yylhs.location)} ); }
-#line 1099 "parser.cpp" // lalr1.cc:859
+  case 98: // array_lambda_param: id
+#line 474 "parser.y"
+    { yylhs.value = make_list( yylhs.location, {yystack_[0].value, make_node(infinity, yylhs.location)} ); }
+#line 1128 "parser.cpp"
     break;
 
-  case 94:
-#line 453 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[2].value), (yystack_[0].value)} ); }
-#line 1105 "parser.cpp" // lalr1.cc:859
+  case 99: // array_lambda_param: id ':' expr
+#line 477 "parser.y"
+    { yylhs.value = make_list( yylhs.location, {yystack_[2].value, yystack_[0].value} ); }
+#line 1134 "parser.cpp"
     break;
 
-  case 95:
-#line 458 "parser.y" // lalr1.cc:859
-    {
-    auto constrained_expr = make_list( yylhs.location, { nullptr, (yystack_[0].value) });
-    (yylhs.value) = make_list( yylhs.location, {constrained_expr} );
+  case 100: // array_exprs: expr
+#line 482 "parser.y"
+  {
+    auto constrained_expr = make_list( yylhs.location, { nullptr, yystack_[0].value });
+    yylhs.value = make_list( yylhs.location, {constrained_expr} );
   }
-#line 1114 "parser.cpp" // lalr1.cc:859
+#line 1143 "parser.cpp"
     break;
 
-  case 96:
-#line 464 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} );
+  case 101: // array_exprs: constrained_array_expr
+#line 488 "parser.y"
+  {
+    yylhs.value = make_list( yylhs.location, {yystack_[0].value} );
   }
-#line 1122 "parser.cpp" // lalr1.cc:859
+#line 1151 "parser.cpp"
     break;
 
-  case 97:
-#line 469 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = (yystack_[2].value); }
-#line 1128 "parser.cpp" // lalr1.cc:859
+  case 102: // array_exprs: '{' constrained_array_expr_list optional_semicolon '}'
+#line 493 "parser.y"
+  { yylhs.value = yystack_[2].value; }
+#line 1157 "parser.cpp"
     break;
 
-  case 98:
-#line 472 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[4].value);
-    (yylhs.value)->as_list()->append( (yystack_[2].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 103: // array_exprs: '{' constrained_array_expr_list ';' final_constrained_array_expr optional_semicolon '}'
+#line 496 "parser.y"
+  {
+    yylhs.value = yystack_[4].value;
+    yylhs.value->as_list()->append( yystack_[2].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 1138 "parser.cpp" // lalr1.cc:859
+#line 1167 "parser.cpp"
     break;
 
-  case 99:
-#line 481 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} ); }
-#line 1144 "parser.cpp" // lalr1.cc:859
+  case 104: // constrained_array_expr_list: constrained_array_expr
+#line 505 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {yystack_[0].value} ); }
+#line 1173 "parser.cpp"
     break;
 
-  case 100:
-#line 484 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
-    (yylhs.value)->location = yylhs.location;
+  case 105: // constrained_array_expr_list: constrained_array_expr_list ';' constrained_array_expr
+#line 508 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
+    yylhs.value->location = yylhs.location;
   }
-#line 1154 "parser.cpp" // lalr1.cc:859
+#line 1183 "parser.cpp"
     break;
 
-  case 101:
-#line 493 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, { (yystack_[0].value), (yystack_[3].value) } ); }
-#line 1160 "parser.cpp" // lalr1.cc:859
+  case 106: // constrained_array_expr: expr ',' IF expr
+#line 517 "parser.y"
+  { yylhs.value = make_list( yylhs.location, { yystack_[0].value, yystack_[3].value } ); }
+#line 1189 "parser.cpp"
     break;
 
-  case 102:
-#line 498 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, { nullptr, (yystack_[2].value) } ); }
-#line 1166 "parser.cpp" // lalr1.cc:859
+  case 107: // final_constrained_array_expr: expr ',' OTHERWISE
+#line 522 "parser.y"
+  { yylhs.value = make_list( yylhs.location, { nullptr, yystack_[2].value } ); }
+#line 1195 "parser.cpp"
     break;
 
-  case 103:
-#line 503 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list(ast::array_enum, yylhs.location, { (yystack_[3].value) });
-    (yylhs.value)->as_list()->append((yystack_[1].value)->as_list()->elements);
+  case 108: // array_enum: '(' expr ',' expr_list ')'
+#line 527 "parser.y"
+  {
+    yylhs.value = make_list(ast::array_enum, yylhs.location, { yystack_[3].value });
+    yylhs.value->as_list()->append(yystack_[1].value->as_list()->elements);
   }
-#line 1175 "parser.cpp" // lalr1.cc:859
+#line 1204 "parser.cpp"
     break;
 
-  case 104:
-#line 511 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( array_size, yylhs.location, { (yystack_[0].value), nullptr } ); }
-#line 1181 "parser.cpp" // lalr1.cc:859
+  case 109: // array_size: '#' expr
+#line 535 "parser.y"
+  { yylhs.value = make_list( array_size, yylhs.location, { yystack_[0].value, nullptr } ); }
+#line 1210 "parser.cpp"
     break;
 
-  case 105:
-#line 514 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( array_size, yylhs.location, { (yystack_[2].value), (yystack_[0].value) } ); }
-#line 1187 "parser.cpp" // lalr1.cc:859
+  case 110: // array_size: '#' expr '@' expr
+#line 538 "parser.y"
+  { yylhs.value = make_list( array_size, yylhs.location, { yystack_[2].value, yystack_[0].value } ); }
+#line 1216 "parser.cpp"
     break;
 
-  case 106:
-#line 519 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( ast::func_apply, yylhs.location, {(yystack_[3].value), (yystack_[1].value)} );
+  case 111: // func_apply: expr '(' expr_list ')'
+#line 543 "parser.y"
+  {
+    yylhs.value = make_list( ast::func_apply, yylhs.location, {yystack_[3].value, yystack_[1].value} );
   }
-#line 1195 "parser.cpp" // lalr1.cc:859
+#line 1224 "parser.cpp"
     break;
 
-  case 107:
-#line 526 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = make_list( ast::func_compose, yylhs.location, {(yystack_[2].value), (yystack_[0].value)} );
+  case 112: // func_composition: expr '.' expr
+#line 550 "parser.y"
+  {
+    yylhs.value = make_list( ast::func_compose, yylhs.location, {yystack_[2].value, yystack_[0].value} );
   }
-#line 1203 "parser.cpp" // lalr1.cc:859
+#line 1232 "parser.cpp"
     break;
 
-  case 108:
-#line 533 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( yylhs.location, {(yystack_[0].value)} ); }
-#line 1209 "parser.cpp" // lalr1.cc:859
+  case 113: // expr_list: expr
+#line 557 "parser.y"
+  { yylhs.value = make_list( yylhs.location, {yystack_[0].value} ); }
+#line 1238 "parser.cpp"
     break;
 
-  case 109:
-#line 536 "parser.y" // lalr1.cc:859
-    {
-    (yylhs.value) = (yystack_[2].value);
-    (yylhs.value)->as_list()->append( (yystack_[0].value) );
+  case 114: // expr_list: expr_list ',' expr
+#line 560 "parser.y"
+  {
+    yylhs.value = yystack_[2].value;
+    yylhs.value->as_list()->append( yystack_[0].value );
   }
-#line 1218 "parser.cpp" // lalr1.cc:859
+#line 1247 "parser.cpp"
     break;
 
-  case 110:
-#line 544 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_list( primitive, yylhs.location, {make_const(yystack_[5].location,op_type::conditional), (yystack_[4].value), (yystack_[2].value), (yystack_[0].value)} ); }
-#line 1224 "parser.cpp" // lalr1.cc:859
+  case 115: // if_expr: IF expr THEN expr ELSE expr
+#line 568 "parser.y"
+  { yylhs.value = make_list( primitive, yylhs.location, {make_const(yystack_[5].location,op_type::conditional), yystack_[4].value, yystack_[2].value, yystack_[0].value} ); }
+#line 1253 "parser.cpp"
     break;
 
-  case 121:
-#line 577 "parser.y" // lalr1.cc:859
-    { (yylhs.value) = make_node(infinity, yylhs.location); }
-#line 1230 "parser.cpp" // lalr1.cc:859
+  case 126: // inf: '~'
+#line 601 "parser.y"
+  { yylhs.value = make_node(infinity, yylhs.location); }
+#line 1259 "parser.cpp"
     break;
 
 
-#line 1234 "parser.cpp" // lalr1.cc:859
+#line 1263 "parser.cpp"
+
             default:
               break;
             }
         }
+#if YY_EXCEPTIONS
       catch (const syntax_error& yyexc)
         {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
           error (yyexc);
           YYERROR;
         }
+#endif // YY_EXCEPTIONS
       YY_SYMBOL_PRINT ("-> $$ =", yylhs);
       yypop_ (yylen);
       yylen = 0;
-      YY_STACK_PRINT ();
 
       // Shift the result of the reduction.
-      yypush_ (YY_NULLPTR, yylhs);
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
     }
     goto yynewstate;
 
+
   /*--------------------------------------.
   | yyerrlab -- here on detecting error.  |
   `--------------------------------------*/
@@ -1258,7 +1291,9 @@ namespace stream { namespace parsing {
     if (!yyerrstatus_)
       {
         ++yynerrs_;
-        error (yyla.location, yysyntax_error_ (yystack_[0].state, yyla));
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
       }
 
 
@@ -1269,7 +1304,7 @@ namespace stream { namespace parsing {
            error, discard it.  */
 
         // Return failure if at end of input.
-        if (yyla.type_get () == yyeof_)
+        if (yyla.kind () == symbol_kind::S_YYEOF)
           YYABORT;
         else if (!yyla.empty ())
           {
@@ -1286,69 +1321,81 @@ namespace stream { namespace parsing {
   | yyerrorlab -- error raised explicitly by YYERROR.  |
   `---------------------------------------------------*/
   yyerrorlab:
-
-    /* Pacify compilers like GCC when the user code never invokes
-       YYERROR and the label yyerrorlab therefore never appears in user
-       code.  */
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
     if (false)
-      goto yyerrorlab;
-    yyerror_range[1].location = yystack_[yylen - 1].location;
+      YYERROR;
+
     /* Do not reclaim the symbols of the rule whose action triggered
        this YYERROR.  */
     yypop_ (yylen);
     yylen = 0;
+    YY_STACK_PRINT ();
     goto yyerrlab1;
 
+
   /*-------------------------------------------------------------.
   | yyerrlab1 -- common code for both syntax error and YYERROR.  |
   `-------------------------------------------------------------*/
   yyerrlab1:
     yyerrstatus_ = 3;   // Each real token shifted decrements this.
-    {
-      stack_symbol_type error_token;
-      for (;;)
-        {
-          yyn = yypact_[yystack_[0].state];
-          if (!yy_pact_value_is_default_ (yyn))
-            {
-              yyn += yyterror_;
-              if (0 <= yyn && yyn <= yylast_ && yycheck_[yyn] == yyterror_)
-                {
-                  yyn = yytable_[yyn];
-                  if (0 < yyn)
-                    break;
-                }
-            }
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
+              {
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
+              }
+          }
 
-          // Pop the current state because it cannot handle the error token.
-          if (yystack_.size () == 1)
-            YYABORT;
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
 
-          yyerror_range[1].location = yystack_[0].location;
-          yy_destroy_ ("Error: popping", yystack_[0]);
-          yypop_ ();
-          YY_STACK_PRINT ();
-        }
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
+    {
+      stack_symbol_type error_token;
 
       yyerror_range[2].location = yyla.location;
       YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
 
       // Shift the error token.
-      error_token.state = yyn;
-      yypush_ ("Shifting", error_token);
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
     }
     goto yynewstate;
 
-    // Accept.
+
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
   yyacceptlab:
     yyresult = 0;
     goto yyreturn;
 
-    // Abort.
+
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
   yyabortlab:
     yyresult = 1;
     goto yyreturn;
 
+
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
   yyreturn:
     if (!yyla.empty ())
       yy_destroy_ ("Cleanup: discarding lookahead", yyla);
@@ -1356,6 +1403,7 @@ namespace stream { namespace parsing {
     /* Do not reclaim the symbols of the rule whose action triggered
        this YYABORT or YYACCEPT.  */
     yypop_ (yylen);
+    YY_STACK_PRINT ();
     while (1 < yystack_.size ())
       {
         yy_destroy_ ("Cleanup: popping", yystack_[0]);
@@ -1364,12 +1412,12 @@ namespace stream { namespace parsing {
 
     return yyresult;
   }
+#if YY_EXCEPTIONS
     catch (...)
       {
-        YYCDEBUG << "Exception caught: cleaning lookahead and stack"
-                 << std::endl;
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
         // Do not try to display the values of the reclaimed symbols,
-        // as their printer might throw an exception.
+        // as their printers might throw an exception.
         if (!yyla.empty ())
           yy_destroy_ (YY_NULLPTR, yyla);
 
@@ -1380,26 +1428,112 @@ namespace stream { namespace parsing {
           }
         throw;
       }
+#endif // YY_EXCEPTIONS
   }
 
   void
   parser::error (const syntax_error& yyexc)
   {
-    error (yyexc.location, yyexc.what());
+    error (yyexc.location, yyexc.what ());
   }
 
-  // Generate an error message.
+  /* Return YYSTR after stripping away unnecessary quotes and
+     backslashes, so that it's suitable for yyerror.  The heuristic is
+     that double-quoting is unnecessary unless the string contains an
+     apostrophe, a comma, or backslash (other than backslash-backslash).
+     YYSTR is taken from yytname.  */
   std::string
-  parser::yysyntax_error_ (state_type yystate, const symbol_type& yyla) const
+  parser::yytnamerr_ (const char *yystr)
   {
-    // Number of reported tokens (one for the "unexpected", one per
-    // "expected").
-    size_t yycount = 0;
-    // Its maximum.
-    enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-    // Arguments of yyformat.
-    char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
+    if (*yystr == '"')
+      {
+        std::string yyr;
+        char const *yyp = yystr;
+
+        for (;;)
+          switch (*++yyp)
+            {
+            case '\'':
+            case ',':
+              goto do_not_strip_quotes;
+
+            case '\\':
+              if (*++yyp != '\\')
+                goto do_not_strip_quotes;
+              else
+                goto append;
+
+            append:
+            default:
+              yyr += *yyp;
+              break;
+
+            case '"':
+              return yyr;
+            }
+      do_not_strip_quotes: ;
+      }
+
+    return yystr;
+  }
+
+  std::string
+  parser::symbol_name (symbol_kind_type yysymbol)
+  {
+    return yytnamerr_ (yytname_[yysymbol]);
+  }
+
+
+
+  // parser::context.
+  parser::context::context (const parser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
 
+  int
+  parser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+    const int yyn = yypact_[+yyparser_.yystack_[0].state];
+    if (!yy_pact_value_is_default_ (yyn))
+      {
+        /* Start YYX at -YYN if negative to avoid negative indexes in
+           YYCHECK.  In other words, skip the first -YYN actions for
+           this state because they are default actions.  */
+        const int yyxbegin = yyn < 0 ? -yyn : 0;
+        // Stay within bounds of both yycheck and yytname.
+        const int yychecklim = yylast_ - yyn + 1;
+        const int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+        for (int yyx = yyxbegin; yyx < yyxend; ++yyx)
+          if (yycheck_[yyx + yyn] == yyx && yyx != symbol_kind::S_YYerror
+              && !yy_table_value_is_error_ (yytable_[yyx + yyn]))
+            {
+              if (!yyarg)
+                ++yycount;
+              else if (yycount == yyargn)
+                return 0;
+              else
+                yyarg[yycount++] = YY_CAST (symbol_kind_type, yyx);
+            }
+      }
+
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
+  }
+
+
+
+
+
+
+  int
+  parser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
     /* There are many possibilities here to consider:
        - If this state is a consistent state with a default action, then
          the only way this function was invoked is if the default action
@@ -1418,41 +1552,32 @@ namespace stream { namespace parsing {
        - Of course, the expected token list depends on states to have
          correct lookahead information, and it depends on the parser not
          to perform extra reductions after fetching a lookahead from the
-         scanner and before detecting a syntax error.  Thus, state
-         merging (from LALR or IELR) and default reductions corrupt the
-         expected token list.  However, the list is correct for
-         canonical LR with one exception: it will still contain any
-         token that will not be accepted due to an error action in a
-         later state.
+         scanner and before detecting a syntax error.  Thus, state merging
+         (from LALR or IELR) and default reductions corrupt the expected
+         token list.  However, the list is correct for canonical LR with
+         one exception: it will still contain any token that will not be
+         accepted due to an error action in a later state.
     */
-    if (!yyla.empty ())
+
+    if (!yyctx.lookahead ().empty ())
       {
-        int yytoken = yyla.type_get ();
-        yyarg[yycount++] = yytname_[yytoken];
-        int yyn = yypact_[yystate];
-        if (!yy_pact_value_is_default_ (yyn))
-          {
-            /* Start YYX at -YYN if negative to avoid negative indexes in
-               YYCHECK.  In other words, skip the first -YYN actions for
-               this state because they are default actions.  */
-            int yyxbegin = yyn < 0 ? -yyn : 0;
-            // Stay within bounds of both yycheck and yytname.
-            int yychecklim = yylast_ - yyn + 1;
-            int yyxend = yychecklim < yyntokens_ ? yychecklim : yyntokens_;
-            for (int yyx = yyxbegin; yyx < yyxend; ++yyx)
-              if (yycheck_[yyx + yyn] == yyx && yyx != yyterror_
-                  && !yy_table_value_is_error_ (yytable_[yyx + yyn]))
-                {
-                  if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                    {
-                      yycount = 1;
-                      break;
-                    }
-                  else
-                    yyarg[yycount++] = yytname_[yyx];
-                }
-          }
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
       }
+    return 0;
+  }
+
+  // Generate an error message.
+  std::string
+  parser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
 
     char const* yyformat = YY_NULLPTR;
     switch (yycount)
@@ -1461,22 +1586,23 @@ namespace stream { namespace parsing {
         case N:                               \
           yyformat = S;                       \
         break
-        YYCASE_(0, YY_("syntax error"));
-        YYCASE_(1, YY_("syntax error, unexpected %s"));
-        YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-        YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-        YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-        YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
 #undef YYCASE_
       }
 
     std::string yyres;
     // Argument number.
-    size_t yyi = 0;
+    std::ptrdiff_t yyi = 0;
     for (char const* yyp = yyformat; *yyp; ++yyp)
       if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
         {
-          yyres += yytnamerr_ (yyarg[yyi++]);
+          yyres += symbol_name (yyarg[yyi++]);
           ++yyp;
         }
       else
@@ -1485,456 +1611,464 @@ namespace stream { namespace parsing {
   }
 
 
-  const short int parser::yypact_ninf_ = -187;
+  const short parser::yypact_ninf_ = -183;
 
-  const signed char parser::yytable_ninf_ = -37;
+  const signed char parser::yytable_ninf_ = -42;
 
-  const short int
+  const short
   parser::yypact_[] =
   {
-      15,     9,    22,    61,  -187,    34,  -187,     9,    66,    67,
-    -187,  -187,    65,     9,     9,     9,  -187,    76,  -187,  -187,
-    -187,  -187,  -187,    11,    61,     9,    77,  -187,    -6,   112,
-      66,  -187,   212,     7,   343,     9,  -187,  -187,     7,   212,
-       7,  -187,  -187,  -187,  -187,  -187,  -187,  -187,   212,     0,
-     212,   212,   212,   212,     9,   343,  -187,   761,  -187,  -187,
-    -187,  -187,  -187,  -187,  -187,  -187,  -187,  -187,  -187,  -187,
-    -187,  -187,  -187,   120,  -187,  -187,   343,  -187,  -187,    48,
-     118,  -187,  -187,  -187,   791,   -20,    13,  -187,  -187,   761,
-    -187,   499,     9,   117,    40,    33,    33,    33,   133,    -3,
-    -187,   127,   567,     1,   212,   212,   212,   212,   212,   212,
-     212,   212,   212,   212,   212,   212,   212,   212,   212,   212,
-     212,   212,   212,   212,   212,   212,   343,   343,   212,    -2,
-       7,     7,   343,   143,     9,   153,   212,  -187,    94,   212,
-     212,     9,   151,   343,   343,   152,     9,  -187,   850,   907,
-     962,  1015,  1066,   238,   238,   238,   238,   238,   238,  1108,
-    1108,  1141,   110,   110,    37,    37,    37,    37,    33,    33,
-       2,    17,   761,     9,  -187,  -187,   791,   142,  -187,   212,
-     699,     9,   115,   761,  -187,  -187,   212,   791,    18,   212,
-      94,  -187,  -187,  -187,   343,   637,  -187,  -187,   761,   212,
-    -187,   154,   761,   157,   761,   122,   637,   123,  -187,   184,
-     442,   212,   212,  -187,   343,   140,   212,   761,   761,   667,
-    -187,   147,  -187,   761,    57,  -187,   145,  -187,  -187,   212,
-       5,   343,   343,   343,   343,     9,   343,   190,     1,   343,
-     343,   343,   343,   343,   343,   343,   343,   343,   343,   343,
-     343,   343,   343,   343,   343,   343,   343,   343,   343,   343,
-     343,   537,     9,   186,    75,    75,    75,   146,     3,   602,
-     343,   104,   879,   935,   989,  1041,  1091,   315,   315,   315,
-     315,   315,   315,  1125,  1125,  1157,   334,   334,   114,   114,
-     114,   114,    75,    75,   212,    94,   343,   343,   189,   343,
-     196,   791,   343,   343,     9,   731,   161,   791,  -187,   343,
-      19,   343,   791,     4,    21,   343,   199,   791,   205,   791,
-     211,   213,   821,   343,   343,   142,   343,   791,   791,   791,
-     791
+      -4,    11,    30,    71,  -183,    37,  -183,    11,    70,    41,
+    -183,  -183,   115,    11,    11,    11,  -183,    89,  -183,  -183,
+    -183,  -183,  -183,    46,    71,    11,   132,  -183,    -6,    45,
+      70,  -183,   224,     9,   358,    11,  -183,  -183,     9,   224,
+       9,    11,  -183,  -183,  -183,  -183,  -183,  -183,  -183,   224,
+      -2,   224,   224,   224,   224,    11,   358,  -183,   782,  -183,
+    -183,  -183,  -183,  -183,  -183,  -183,  -183,  -183,  -183,  -183,
+    -183,  -183,  -183,  -183,   136,  -183,  -183,   358,  -183,  -183,
+      68,   126,  -183,  -183,  -183,   812,    -3,    21,  -183,  -183,
+     782,  -183,    22,  -183,   142,   520,    11,   148,    20,   -31,
+     -31,   -31,    84,     4,  -183,   152,   588,     5,   224,   224,
+     224,   224,   224,   224,   224,   224,   224,   224,   224,   224,
+     224,   224,   224,   224,   224,   224,   224,   224,   224,   224,
+     358,   358,   224,    10,     9,     9,   358,   156,    11,   158,
+      11,   153,   358,   224,  -183,   121,   224,   224,    11,   161,
+     358,   358,   163,    11,  -183,   871,   928,   983,  1036,  1087,
+     249,   249,   249,   249,   249,   249,  1129,  1129,  1162,   392,
+     392,    79,    79,    79,    79,   -31,   -31,    12,    23,   782,
+      11,  -183,  -183,   812,   155,  -183,   224,  -183,     9,   812,
+     720,    11,   119,   782,  -183,  -183,   224,   812,    24,   224,
+     121,  -183,  -183,  -183,   358,   658,  -183,  -183,   782,  -183,
+     224,  -183,   162,   782,   166,   782,   128,   658,   133,  -183,
+     184,   463,   224,   224,  -183,   358,   135,   224,   782,   782,
+     688,  -183,   141,  -183,   782,    80,  -183,   139,  -183,  -183,
+     224,     7,   358,   358,   358,   358,    11,   358,   175,     5,
+     358,   358,   358,   358,   358,   358,   358,   358,   358,   358,
+     358,   358,   358,   358,   358,   358,   358,   358,   358,   358,
+     358,   358,   558,    11,   177,    15,    15,    15,   112,    13,
+     623,   358,    40,   900,   956,  1010,  1062,  1112,   330,   330,
+     330,   330,   330,   330,  1146,  1146,  1178,   478,   478,    98,
+      98,    98,    98,    15,    15,   224,   121,   358,   358,   180,
+     358,   181,   812,   358,   358,    11,   752,   147,   812,  -183,
+     358,    32,   358,   812,    18,    38,   358,   188,   812,   191,
+     812,   195,   196,   842,   358,   358,   155,   358,   812,   812,
+     812,   812
   };
 
   const unsigned char
   parser::yydefact_[] =
   {
-       3,     0,     0,     5,   119,     0,     1,     0,    11,     0,
-       7,     4,     9,     0,     0,     0,     2,   123,    13,    16,
-      15,    17,    18,     0,     6,     0,     0,    25,    23,     0,
-     122,    12,     0,     0,     0,    29,     8,    10,     0,     0,
-       0,    14,   114,   115,   116,   117,   118,   120,     0,     0,
-       0,     0,     0,     0,     0,     0,   121,    26,    80,    81,
-      48,    53,    51,    52,    54,    49,    50,    47,    44,   111,
-     112,   113,    46,    42,    43,    45,     0,    32,    34,     0,
-      33,    38,    39,    41,   108,     0,     0,    30,    21,    24,
-      22,     0,     0,     0,     0,    68,    56,    57,   104,     0,
-      91,    93,     0,     0,     0,     0,     0,     0,     0,     0,
+       3,     0,     0,     5,   124,     0,     1,     0,    11,     0,
+       7,     4,     9,     0,     0,     0,     2,   128,    13,    16,
+      15,    17,    18,     0,     6,     0,     0,    26,    24,     0,
+     127,    12,     0,     0,     0,    34,     8,    10,     0,     0,
+       0,     0,    14,   119,   120,   121,   122,   123,   125,     0,
+       0,     0,     0,     0,     0,     0,     0,   126,    31,    85,
+      86,    53,    58,    56,    57,    59,    54,    55,    52,    49,
+     116,   117,   118,    51,    47,    48,    50,     0,    37,    39,
+       0,    38,    43,    44,    46,   113,     0,     0,    35,    21,
+      25,    22,     0,    27,    29,     0,     0,     0,     0,    73,
+      61,    62,   109,     0,    96,    98,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    19,   123,     0,
-       0,     0,     0,     0,     0,    79,     0,    85,    58,    59,
-      75,    76,    74,    60,    61,    62,    64,    63,    65,    77,
-      78,    55,    66,    67,    69,    70,    71,    72,    73,   107,
-       0,     0,    82,     0,    37,    35,   109,     0,    31,     0,
-       0,   122,     0,    83,   105,    92,     0,    94,     0,     0,
-     123,    89,   106,    40,     0,    95,    28,    96,    27,     0,
-      20,     0,    90,   103,    87,     0,     0,   123,    99,     0,
-     110,     0,     0,    86,   122,     0,     0,    84,    88,     0,
-     100,   123,    97,   101,     0,   122,     0,   102,    98,     0,
-       0,     0,     0,     0,     0,     0,     0,    42,     0,     0,
+       0,     0,     0,     0,    19,   128,     0,     0,     0,     0,
+       0,     0,    84,     0,    90,    63,    64,    80,    81,    79,
+      65,    66,    67,    69,    68,    70,    82,    83,    60,    71,
+      72,    74,    75,    76,    77,    78,   112,     0,     0,    87,
+       0,    42,    40,   114,     0,    36,     0,    28,     0,    30,
+       0,   127,     0,    88,   110,    97,     0,    99,     0,     0,
+     128,    94,   111,    45,     0,   100,    33,   101,    32,    23,
+       0,    20,     0,    95,   108,    92,     0,     0,   128,   104,
+       0,   115,     0,     0,    91,   127,     0,     0,    89,    93,
+       0,   105,   128,   102,   106,     0,   127,     0,   107,   103,
+       0,     0,     0,     0,     0,     0,     0,     0,    47,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    68,    56,    57,   104,     0,     0,
-       0,     0,    58,    59,    75,    76,    74,    60,    61,    62,
-      64,    63,    65,    77,    78,    55,    66,    67,    69,    70,
-      71,    72,    73,   107,     0,   123,     0,     0,     0,     0,
-      79,    82,     0,     0,    29,     0,     0,    83,   105,     0,
-       0,     0,    26,     0,     0,     0,     0,    90,   103,    87,
-       0,     0,   110,     0,     0,     0,     0,    84,    88,    95,
-      27
+       0,     0,     0,     0,     0,    73,    61,    62,   109,     0,
+       0,     0,     0,    63,    64,    80,    81,    79,    65,    66,
+      67,    69,    68,    70,    82,    83,    60,    71,    72,    74,
+      75,    76,    77,    78,   112,     0,   128,     0,     0,     0,
+       0,    84,    87,     0,     0,    34,     0,     0,    88,   110,
+       0,     0,     0,    31,     0,     0,     0,     0,    95,   108,
+      92,     0,     0,   115,     0,     0,     0,     0,    89,    93,
+     100,    32
   };
 
-  const short int
+  const short
   parser::yypgoto_[] =
   {
-    -187,  -187,  -187,  -187,  -187,   216,  -187,  -187,   206,    -7,
-    -137,  -187,   -47,   -63,   228,    60,  -187,  -187,   -85,  -187,
-      70,   200,  -187,  -187,  -187,  -187,  -187,    10,   103,  -187,
-    -187,  -186,  -187,  -187,  -187,  -187,  -187,   -72,  -187,  -187,
-    -187,  -187,  -187,  -187,    -1,  -187,  -187,  -133
+    -183,  -183,  -183,  -183,  -183,   199,  -183,  -183,   189,    -7,
+    -143,  -183,  -183,    85,   -48,   -91,   213,   -35,  -183,  -183,
+      39,  -183,    53,   210,  -183,  -183,  -183,  -183,  -183,    -8,
+      95,  -183,  -183,  -182,  -183,  -183,  -183,  -183,  -183,   -73,
+    -183,  -183,  -183,  -183,  -183,  -183,    -1,  -183,  -183,  -136
   };
 
-  const short int
+  const unsigned char
   parser::yydefgoto_[] =
   {
-      -1,     2,     3,     8,     9,    10,    16,    17,    18,   137,
-     138,    20,    21,    86,    22,    77,    78,    79,    80,    81,
-      82,    84,    58,    59,    60,    61,    62,    99,   100,   196,
-     207,   197,   221,    63,    64,    65,    66,    85,    67,    68,
-      69,    70,    71,    72,   237,    74,    75,    31
+       0,     2,     3,     8,     9,    10,    16,    17,    18,   144,
+     145,    20,    92,    93,    21,    87,    22,    78,    79,    80,
+      81,    82,    83,    85,    59,    60,    61,    62,    63,   103,
+     104,   206,   218,   207,   232,    64,    65,    66,    67,    86,
+      68,    69,    70,    71,    72,    73,   248,    75,    76,    31
   };
 
-  const short int
+  const short
   parser::yytable_[] =
   {
-       5,    19,    93,   132,   129,   182,    12,    23,   208,   190,
-       4,     4,    26,    28,    29,     4,    39,     4,    33,     4,
-     141,   132,     6,    19,    37,   132,   141,   132,   220,    23,
-       1,    73,    83,    32,    87,    33,   134,    83,    73,    83,
-     132,   132,   132,   133,   134,   174,   175,    73,    94,    73,
-      73,    73,    73,   101,   170,   171,   147,   205,    92,   146,
-     142,   173,    32,   262,    76,   191,   298,   320,    34,   216,
-      35,   130,   188,   131,   215,   135,     4,     7,   227,   192,
-     203,   318,    25,   321,    13,    14,    15,   124,   226,   125,
-     126,    23,   127,   125,   126,    11,   127,    34,    88,    35,
-      90,    38,    94,    73,    73,    73,    73,    73,    73,    73,
-      73,    73,    73,    73,    73,    73,    73,    73,    73,    73,
-      73,    73,    73,    73,    73,   295,   302,    73,    24,    83,
-      83,   260,   126,   178,   127,    73,    40,    30,    73,    73,
-     101,   -36,   128,   -36,   139,    23,    42,    43,    44,    45,
-      46,   143,     4,    47,   229,   181,   120,   121,   122,   123,
-     124,   303,   306,   304,   259,   177,   125,   126,   230,   127,
-     260,   126,    83,   127,   200,   179,   186,   189,    73,   201,
-      23,   211,   212,   263,   214,    73,   213,   231,    73,   125,
-     126,   147,   127,   140,   232,   233,   216,   234,    73,   235,
-     194,   236,   260,   126,   222,   127,   297,    56,   225,   228,
-      73,    73,   270,   296,   309,    73,    42,    43,    44,    45,
-      46,   311,     4,    47,    48,   316,   323,   310,    73,    94,
-     324,   313,    57,   325,   101,   326,    41,   271,    49,    89,
-      36,   314,    27,   193,   185,   268,     0,     0,    91,     0,
-      95,    96,    97,    98,     0,   102,     0,    50,     0,     0,
-       0,    23,     0,     0,    51,    52,     0,    53,     0,    54,
-       0,    55,     0,     0,     0,     0,     0,    56,     0,   115,
-     116,   117,   118,   119,   120,   121,   122,   123,   124,     0,
-       0,     0,     0,    73,   125,   126,     0,   127,     0,     0,
-       0,     0,     0,    87,   148,   149,   150,   151,   152,   153,
-     154,   155,   156,   157,   158,   159,   160,   161,   162,   163,
-     164,   165,   166,   167,   168,   169,     0,     0,   172,     0,
-       0,     0,   176,     0,     0,     0,   180,     0,     0,   183,
-     184,     0,     0,   187,     0,     0,     0,    42,    43,    44,
-      45,    46,     0,     4,    47,   229,   250,   251,   252,   253,
-     254,   255,   256,   257,   258,   259,     0,     0,     0,   230,
-       0,   260,   126,     0,   127,     0,     0,   195,     0,   198,
-     255,   256,   257,   258,   259,     0,   202,     0,   231,   204,
-     260,   126,     0,   127,   206,   232,   233,     0,   234,   210,
-     235,     0,   236,     0,     0,     0,     0,     0,    56,     0,
-       0,   217,   218,     0,   219,     0,   223,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,   261,
-       0,   264,   265,   266,   267,     0,   269,     0,     0,   272,
-     273,   274,   275,   276,   277,   278,   279,   280,   281,   282,
+       5,    19,    97,    89,   133,    91,    12,    23,     4,   192,
+     200,     1,    26,    28,    29,     4,    39,     4,    33,     4,
+     136,     4,   219,    19,    37,   129,   130,   148,   131,    23,
+       6,    74,    84,   136,    88,   136,   148,    84,    74,    84,
+      94,   136,    32,   231,   138,   140,   136,   136,    74,    98,
+      74,    74,    74,    74,   105,   136,    96,   177,   178,   154,
+     137,   138,   313,   153,   216,   273,    77,   149,    32,    40,
+      33,   271,   130,   180,   131,   201,   309,    34,   198,    35,
+       4,   331,   226,   139,   141,   202,   214,     7,    13,    14,
+      15,   134,   227,   135,   329,    23,   237,   314,    11,   315,
+     332,   238,    24,    34,    41,    35,    98,    74,    74,    74,
+      74,    74,    74,    74,    74,    74,    74,    74,    74,    74,
+      74,    74,    74,    74,    74,    74,    74,    74,    74,   128,
+     306,    74,    25,    84,    84,   129,   130,   185,   131,    94,
+     129,   130,    74,   131,   147,    74,    74,   105,   270,   -41,
+      30,   -41,    23,   209,   271,   130,    38,   131,   132,    43,
+      44,    45,    46,    47,   142,     4,    48,   240,   271,   130,
+     317,   131,   308,   181,   182,   146,   150,   188,   184,    84,
+     186,   241,   191,   212,   211,    74,   196,    84,   199,   222,
+      23,   223,   224,   274,   225,    74,   227,   281,    74,   233,
+     242,   154,   236,   239,   307,   320,   322,   243,   244,    74,
+     245,   327,   246,   204,   247,   334,   335,   336,   337,    42,
+      57,    74,    74,    36,   325,   187,    74,    27,    43,    44,
+      45,    46,    47,   203,     4,    48,    49,   321,   279,    74,
+      98,   324,    58,   195,     0,   105,     0,     0,   282,    90,
+      50,     0,     0,     0,     0,     0,     0,     0,     0,    95,
+       0,    99,   100,   101,   102,     0,   106,     0,     0,    51,
+       0,     0,    23,     0,     0,     0,    52,    53,     0,    54,
+       0,    55,     0,    56,     0,     0,     0,     0,     0,    57,
+     119,   120,   121,   122,   123,   124,   125,   126,   127,   128,
+       0,     0,     0,     0,    74,   129,   130,     0,   131,     0,
+       0,     0,     0,     0,    88,     0,     0,     0,   155,   156,
+     157,   158,   159,   160,   161,   162,   163,   164,   165,   166,
+     167,   168,   169,   170,   171,   172,   173,   174,   175,   176,
+       0,     0,   179,     0,     0,     0,   183,     0,     0,     0,
+       0,     0,   189,   190,     0,     0,   193,   194,     0,     0,
+     197,     0,    43,    44,    45,    46,    47,     0,     4,    48,
+     240,   261,   262,   263,   264,   265,   266,   267,   268,   269,
+     270,     0,     0,     0,   241,     0,   271,   130,     0,   131,
+       0,     0,     0,     0,   205,     0,   208,     0,     0,     0,
+       0,     0,     0,   242,     0,     0,   213,     0,     0,   215,
+     243,   244,     0,   245,   217,   246,     0,   247,     0,     0,
+     221,     0,     0,    57,     0,     0,     0,     0,     0,     0,
+       0,     0,   228,   229,     0,   230,     0,   234,   124,   125,
+     126,   127,   128,     0,     0,     0,     0,     0,   129,   130,
+     272,   131,   275,   276,   277,   278,     0,   280,     0,     0,
      283,   284,   285,   286,   287,   288,   289,   290,   291,   292,
-     293,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-     301,     0,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,   113,   114,   115,   116,   117,   118,   119,   120,   121,
-     122,   123,   124,     0,   305,     0,   307,   308,   125,   126,
-       0,   127,   312,     0,     0,     0,     0,     0,     0,   317,
-       0,   319,   136,     0,     0,   322,     0,     0,     0,     0,
-       0,     0,     0,   327,   328,   329,   330,   103,     0,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     293,   294,   295,   296,   297,   298,   299,   300,   301,   302,
+     303,   304,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,   312,     0,   108,   109,   110,   111,   112,   113,   114,
      115,   116,   117,   118,   119,   120,   121,   122,   123,   124,
-     294,     0,     0,     0,     0,   125,   126,     0,   127,     0,
-       0,     0,     0,     0,     0,   103,     0,   104,   105,   106,
-     107,   108,   109,   110,   111,   112,   113,   114,   115,   116,
-     117,   118,   119,   120,   121,   122,   123,   124,     0,     0,
-     144,     0,     0,   125,   126,   238,   127,   239,   240,   241,
-     242,   243,   244,   245,   246,   247,   248,   249,   250,   251,
-     252,   253,   254,   255,   256,   257,   258,   259,     0,     0,
-       0,     0,     0,   260,   126,   299,   127,     0,     0,   145,
-     238,     0,   239,   240,   241,   242,   243,   244,   245,   246,
-     247,   248,   249,   250,   251,   252,   253,   254,   255,   256,
-     257,   258,   259,     0,     0,     0,     0,     0,   260,   126,
-     209,   127,     0,     0,   300,   238,     0,   239,   240,   241,
-     242,   243,   244,   245,   246,   247,   248,   249,   250,   251,
-     252,   253,   254,   255,   256,   257,   258,   259,     0,     0,
-     224,     0,     0,   260,   126,   238,   127,   239,   240,   241,
-     242,   243,   244,   245,   246,   247,   248,   249,   250,   251,
-     252,   253,   254,   255,   256,   257,   258,   259,     0,     0,
-       0,     0,     0,   260,   126,     0,   127,   103,   199,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     125,   126,   127,   128,     0,   316,     0,   318,   319,   129,
+     130,     0,   131,   323,   266,   267,   268,   269,   270,     0,
+     328,     0,   330,   143,   271,   130,   333,   131,     0,     0,
+       0,     0,     0,     0,   338,   339,   340,   341,   107,     0,
+     108,   109,   110,   111,   112,   113,   114,   115,   116,   117,
+     118,   119,   120,   121,   122,   123,   124,   125,   126,   127,
+     128,   305,     0,     0,     0,     0,   129,   130,     0,   131,
+       0,     0,     0,     0,     0,     0,   107,     0,   108,   109,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,     0,
+       0,   151,     0,     0,   129,   130,   249,   131,   250,   251,
+     252,   253,   254,   255,   256,   257,   258,   259,   260,   261,
+     262,   263,   264,   265,   266,   267,   268,   269,   270,     0,
+       0,     0,     0,     0,   271,   130,   310,   131,     0,     0,
+     152,   249,     0,   250,   251,   252,   253,   254,   255,   256,
+     257,   258,   259,   260,   261,   262,   263,   264,   265,   266,
+     267,   268,   269,   270,     0,     0,     0,     0,     0,   271,
+     130,   220,   131,     0,     0,   311,   249,     0,   250,   251,
+     252,   253,   254,   255,   256,   257,   258,   259,   260,   261,
+     262,   263,   264,   265,   266,   267,   268,   269,   270,     0,
+       0,   235,     0,     0,   271,   130,   249,   131,   250,   251,
+     252,   253,   254,   255,   256,   257,   258,   259,   260,   261,
+     262,   263,   264,   265,   266,   267,   268,   269,   270,     0,
+       0,     0,     0,     0,   271,   130,     0,   131,   107,   210,
+     108,   109,   110,   111,   112,   113,   114,   115,   116,   117,
+     118,   119,   120,   121,   122,   123,   124,   125,   126,   127,
+     128,     0,     0,     0,     0,     0,   129,   130,     0,   131,
+     107,   326,   108,   109,   110,   111,   112,   113,   114,   115,
+     116,   117,   118,   119,   120,   121,   122,   123,   124,   125,
+     126,   127,   128,     0,     0,     0,     0,     0,   129,   130,
+     107,   131,   108,   109,   110,   111,   112,   113,   114,   115,
+     116,   117,   118,   119,   120,   121,   122,   123,   124,   125,
+     126,   127,   128,     0,     0,     0,     0,     0,   129,   130,
+     249,   131,   250,   251,   252,   253,   254,   255,   256,   257,
+     258,   259,   260,   261,   262,   263,   264,   265,   266,   267,
+     268,   269,   270,     0,     0,     0,     0,     0,   271,   130,
+       0,   131,   250,   251,   252,   253,   254,   255,   256,   257,
+     258,   259,   260,   261,   262,   263,   264,   265,   266,   267,
+     268,   269,   270,     0,     0,     0,     0,     0,   271,   130,
+       0,   131,   109,   110,   111,   112,   113,   114,   115,   116,
+     117,   118,   119,   120,   121,   122,   123,   124,   125,   126,
+     127,   128,     0,     0,     0,     0,     0,   129,   130,     0,
+     131,   251,   252,   253,   254,   255,   256,   257,   258,   259,
+     260,   261,   262,   263,   264,   265,   266,   267,   268,   269,
+     270,     0,     0,     0,     0,     0,   271,   130,     0,   131,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,     0,
+       0,     0,     0,     0,   129,   130,     0,   131,   252,   253,
+     254,   255,   256,   257,   258,   259,   260,   261,   262,   263,
+     264,   265,   266,   267,   268,   269,   270,     0,     0,     0,
+       0,     0,   271,   130,     0,   131,   111,   112,   113,   114,
      115,   116,   117,   118,   119,   120,   121,   122,   123,   124,
-       0,     0,     0,     0,     0,   125,   126,     0,   127,   103,
-     315,   104,   105,   106,   107,   108,   109,   110,   111,   112,
-     113,   114,   115,   116,   117,   118,   119,   120,   121,   122,
-     123,   124,     0,     0,     0,     0,     0,   125,   126,   103,
-     127,   104,   105,   106,   107,   108,   109,   110,   111,   112,
-     113,   114,   115,   116,   117,   118,   119,   120,   121,   122,
-     123,   124,     0,     0,     0,     0,     0,   125,   126,   238,
-     127,   239,   240,   241,   242,   243,   244,   245,   246,   247,
-     248,   249,   250,   251,   252,   253,   254,   255,   256,   257,
-     258,   259,     0,     0,     0,     0,     0,   260,   126,     0,
-     127,   239,   240,   241,   242,   243,   244,   245,   246,   247,
-     248,   249,   250,   251,   252,   253,   254,   255,   256,   257,
-     258,   259,     0,     0,     0,     0,     0,   260,   126,     0,
-     127,   105,   106,   107,   108,   109,   110,   111,   112,   113,
-     114,   115,   116,   117,   118,   119,   120,   121,   122,   123,
-     124,     0,     0,     0,     0,     0,   125,   126,     0,   127,
-     240,   241,   242,   243,   244,   245,   246,   247,   248,   249,
-     250,   251,   252,   253,   254,   255,   256,   257,   258,   259,
-       0,     0,     0,     0,     0,   260,   126,     0,   127,   106,
-     107,   108,   109,   110,   111,   112,   113,   114,   115,   116,
-     117,   118,   119,   120,   121,   122,   123,   124,     0,     0,
-       0,     0,     0,   125,   126,     0,   127,   241,   242,   243,
-     244,   245,   246,   247,   248,   249,   250,   251,   252,   253,
-     254,   255,   256,   257,   258,   259,     0,     0,     0,     0,
-       0,   260,   126,     0,   127,   107,   108,   109,   110,   111,
+     125,   126,   127,   128,     0,     0,     0,     0,     0,   129,
+     130,     0,   131,   253,   254,   255,   256,   257,   258,   259,
+     260,   261,   262,   263,   264,   265,   266,   267,   268,   269,
+     270,     0,     0,     0,     0,     0,   271,   130,     0,   131,
      112,   113,   114,   115,   116,   117,   118,   119,   120,   121,
-     122,   123,   124,     0,     0,     0,     0,     0,   125,   126,
-       0,   127,   242,   243,   244,   245,   246,   247,   248,   249,
-     250,   251,   252,   253,   254,   255,   256,   257,   258,   259,
-       0,     0,     0,     0,     0,   260,   126,     0,   127,   108,
-     109,   110,   111,   112,   113,   114,   115,   116,   117,   118,
-     119,   120,   121,   122,   123,   124,     0,     0,     0,     0,
-       0,   125,   126,     0,   127,   243,   244,   245,   246,   247,
-     248,   249,   250,   251,   252,   253,   254,   255,   256,   257,
-     258,   259,     0,     0,     0,     0,     0,   260,   126,     0,
-     127,   109,   110,   111,   112,   113,   114,   115,   116,   117,
-     118,   119,   120,   121,   122,   123,   124,     0,     0,     0,
-       0,     0,   125,   126,     0,   127,   244,   245,   246,   247,
-     248,   249,   250,   251,   252,   253,   254,   255,   256,   257,
-     258,   259,     0,     0,     0,     0,     0,   260,   126,     0,
-     127,   117,   118,   119,   120,   121,   122,   123,   124,     0,
-       0,     0,     0,     0,   125,   126,     0,   127,   252,   253,
-     254,   255,   256,   257,   258,   259,     0,     0,     0,     0,
-       0,   260,   126,     0,   127,   118,   119,   120,   121,   122,
-     123,   124,     0,     0,     0,     0,     0,   125,   126,     0,
-     127,   253,   254,   255,   256,   257,   258,   259,     0,     0,
-       0,     0,     0,   260,   126,     0,   127
+     122,   123,   124,   125,   126,   127,   128,     0,     0,     0,
+       0,     0,   129,   130,     0,   131,   254,   255,   256,   257,
+     258,   259,   260,   261,   262,   263,   264,   265,   266,   267,
+     268,   269,   270,     0,     0,     0,     0,     0,   271,   130,
+       0,   131,   113,   114,   115,   116,   117,   118,   119,   120,
+     121,   122,   123,   124,   125,   126,   127,   128,     0,     0,
+       0,     0,     0,   129,   130,     0,   131,   255,   256,   257,
+     258,   259,   260,   261,   262,   263,   264,   265,   266,   267,
+     268,   269,   270,     0,     0,     0,     0,     0,   271,   130,
+       0,   131,   121,   122,   123,   124,   125,   126,   127,   128,
+       0,     0,     0,     0,     0,   129,   130,     0,   131,   263,
+     264,   265,   266,   267,   268,   269,   270,     0,     0,     0,
+       0,     0,   271,   130,     0,   131,   122,   123,   124,   125,
+     126,   127,   128,     0,     0,     0,     0,     0,   129,   130,
+       0,   131,   264,   265,   266,   267,   268,   269,   270,     0,
+       0,     0,     0,     0,   271,   130,     0,   131
   };
 
-  const short int
+  const short
   parser::yycheck_[] =
   {
-       1,     8,    49,    23,    76,   138,     7,     8,   194,   146,
-      10,    10,    13,    14,    15,    10,    22,    10,    24,    10,
-      23,    23,     0,    30,    25,    23,    23,    23,   214,    30,
-      15,    32,    33,    22,    35,    24,    23,    38,    39,    40,
-      23,    23,    23,    63,    23,   130,   131,    48,    49,    50,
-      51,    52,    53,    54,   126,   127,   103,   190,    58,    58,
-      63,    63,    22,    58,    57,    63,    63,    63,    57,    12,
-      59,    23,   144,    25,   207,    62,    10,    16,    21,    62,
-      62,    62,    17,    62,    18,    19,    20,    50,   221,    56,
-      57,    92,    59,    56,    57,    61,    59,    57,    38,    59,
-      40,    24,   103,   104,   105,   106,   107,   108,   109,   110,
+       1,     8,    50,    38,    77,    40,     7,     8,    10,   145,
+     153,    15,    13,    14,    15,    10,    22,    10,    24,    10,
+      23,    10,   204,    30,    25,    56,    57,    23,    59,    30,
+       0,    32,    33,    23,    35,    23,    23,    38,    39,    40,
+      41,    23,    22,   225,    23,    23,    23,    23,    49,    50,
+      51,    52,    53,    54,    55,    23,    58,   130,   131,   107,
+      63,    23,    22,    58,   200,    58,    57,    63,    22,    24,
+      24,    56,    57,    63,    59,    63,    63,    57,   151,    59,
+      10,    63,   218,    62,    62,    62,    62,    16,    18,    19,
+      20,    23,    12,    25,    62,    96,   232,    57,    61,    59,
+      62,    21,    61,    57,    59,    59,   107,   108,   109,   110,
      111,   112,   113,   114,   115,   116,   117,   118,   119,   120,
-     121,   122,   123,   124,   125,   262,    22,   128,    61,   130,
-     131,    56,    57,   134,    59,   136,    24,    61,   139,   140,
-     141,    23,    22,    25,    27,   146,     4,     5,     6,     7,
-       8,    24,    10,    11,    12,    61,    46,    47,    48,    49,
-      50,    57,   295,    59,    50,    22,    56,    57,    26,    59,
-      56,    57,   173,    59,   181,    22,    25,    25,   179,    64,
-     181,    27,    25,   230,    61,   186,    64,    45,   189,    56,
-      57,   238,    59,    60,    52,    53,    12,    55,   199,    57,
-      58,    59,    56,    57,    64,    59,    60,    65,    61,    64,
-     211,   212,    22,    27,    25,   216,     4,     5,     6,     7,
-       8,    25,    10,    11,    12,    64,    27,   299,   229,   230,
-      25,   303,    32,    22,   235,    22,    30,   238,    26,    39,
-      24,   304,    14,   173,   141,   235,    -1,    -1,    48,    -1,
-      50,    51,    52,    53,    -1,    55,    -1,    45,    -1,    -1,
-      -1,   262,    -1,    -1,    52,    53,    -1,    55,    -1,    57,
-      -1,    59,    -1,    -1,    -1,    -1,    -1,    65,    -1,    41,
-      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
-      -1,    -1,    -1,   294,    56,    57,    -1,    59,    -1,    -1,
-      -1,    -1,    -1,   304,   104,   105,   106,   107,   108,   109,
+     121,   122,   123,   124,   125,   126,   127,   128,   129,    50,
+     273,   132,    17,   134,   135,    56,    57,   138,    59,   140,
+      56,    57,   143,    59,    60,   146,   147,   148,    50,    23,
+      61,    25,   153,   188,    56,    57,    24,    59,    22,     4,
+       5,     6,     7,     8,    22,    10,    11,    12,    56,    57,
+     306,    59,    60,   134,   135,    27,    24,    24,    22,   180,
+      22,    26,    61,    64,   191,   186,    25,   188,    25,    27,
+     191,    25,    64,   241,    61,   196,    12,    22,   199,    64,
+      45,   249,    61,    64,    27,    25,    25,    52,    53,   210,
+      55,    64,    57,    58,    59,    27,    25,    22,    22,    30,
+      65,   222,   223,    24,   315,   140,   227,    14,     4,     5,
+       6,     7,     8,   180,    10,    11,    12,   310,   246,   240,
+     241,   314,    32,   148,    -1,   246,    -1,    -1,   249,    39,
+      26,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    49,
+      -1,    51,    52,    53,    54,    -1,    56,    -1,    -1,    45,
+      -1,    -1,   273,    -1,    -1,    -1,    52,    53,    -1,    55,
+      -1,    57,    -1,    59,    -1,    -1,    -1,    -1,    -1,    65,
+      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
+      -1,    -1,    -1,    -1,   305,    56,    57,    -1,    59,    -1,
+      -1,    -1,    -1,    -1,   315,    -1,    -1,    -1,   108,   109,
      110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
-     120,   121,   122,   123,   124,   125,    -1,    -1,   128,    -1,
-      -1,    -1,   132,    -1,    -1,    -1,   136,    -1,    -1,   139,
-     140,    -1,    -1,   143,    -1,    -1,    -1,     4,     5,     6,
-       7,     8,    -1,    10,    11,    12,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    -1,    -1,    -1,    26,
-      -1,    56,    57,    -1,    59,    -1,    -1,   177,    -1,   179,
-      46,    47,    48,    49,    50,    -1,   186,    -1,    45,   189,
-      56,    57,    -1,    59,   194,    52,    53,    -1,    55,   199,
-      57,    -1,    59,    -1,    -1,    -1,    -1,    -1,    65,    -1,
-      -1,   211,   212,    -1,   214,    -1,   216,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,   229,
-      -1,   231,   232,   233,   234,    -1,   236,    -1,    -1,   239,
-     240,   241,   242,   243,   244,   245,   246,   247,   248,   249,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
+      -1,    -1,   132,    -1,    -1,    -1,   136,    -1,    -1,    -1,
+      -1,    -1,   142,   143,    -1,    -1,   146,   147,    -1,    -1,
+     150,    -1,     4,     5,     6,     7,     8,    -1,    10,    11,
+      12,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    -1,    -1,    -1,    26,    -1,    56,    57,    -1,    59,
+      -1,    -1,    -1,    -1,   184,    -1,   186,    -1,    -1,    -1,
+      -1,    -1,    -1,    45,    -1,    -1,   196,    -1,    -1,   199,
+      52,    53,    -1,    55,   204,    57,    -1,    59,    -1,    -1,
+     210,    -1,    -1,    65,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,   222,   223,    -1,   225,    -1,   227,    46,    47,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+     240,    59,   242,   243,   244,   245,    -1,   247,    -1,    -1,
      250,   251,   252,   253,   254,   255,   256,   257,   258,   259,
-     260,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-     270,    -1,    30,    31,    32,    33,    34,    35,    36,    37,
+     260,   261,   262,   263,   264,   265,   266,   267,   268,   269,
+     270,   271,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,   281,    -1,    30,    31,    32,    33,    34,    35,    36,
+      37,    38,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    -1,   305,    -1,   307,   308,    56,
+      57,    -1,    59,   313,    46,    47,    48,    49,    50,    -1,
+     320,    -1,   322,    13,    56,    57,   326,    59,    -1,    -1,
+      -1,    -1,    -1,    -1,   334,   335,   336,   337,    28,    -1,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    13,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,
+      -1,    -1,    -1,    -1,    -1,    -1,    28,    -1,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    23,    -1,    -1,    56,    57,    28,    59,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    -1,    -1,    -1,    56,    57,    23,    59,    -1,    -1,
+      62,    28,    -1,    30,    31,    32,    33,    34,    35,    36,
+      37,    38,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,
+      57,    23,    59,    -1,    -1,    62,    28,    -1,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    23,    -1,    -1,    56,    57,    28,    59,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    -1,    -1,    -1,    56,    57,    -1,    59,    28,    29,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
       38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
-      48,    49,    50,    -1,   294,    -1,   296,   297,    56,    57,
-      -1,    59,   302,    -1,    -1,    -1,    -1,    -1,    -1,   309,
-      -1,   311,    13,    -1,    -1,   315,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,   323,   324,   325,   326,    28,    -1,    30,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
-      13,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,    -1,
-      -1,    -1,    -1,    -1,    -1,    28,    -1,    30,    31,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      23,    -1,    -1,    56,    57,    28,    59,    30,    31,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      -1,    -1,    -1,    56,    57,    23,    59,    -1,    -1,    62,
-      28,    -1,    30,    31,    32,    33,    34,    35,    36,    37,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+      28,    59,    30,    31,    32,    33,    34,    35,    36,    37,
       38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
       48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
-      23,    59,    -1,    -1,    62,    28,    -1,    30,    31,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      23,    -1,    -1,    56,    57,    28,    59,    30,    31,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      -1,    -1,    -1,    56,    57,    -1,    59,    28,    29,    30,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
-      -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,    28,
-      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    28,
-      59,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    28,
-      59,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,
-      59,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      28,    59,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+      -1,    59,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+      -1,    59,    31,    32,    33,    34,    35,    36,    37,    38,
       39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
       49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,
       59,    31,    32,    33,    34,    35,    36,    37,    38,    39,
       40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
       50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
-      -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    -1,    -1,    -1,    56,    57,    -1,    59,    32,    33,
+      34,    35,    36,    37,    38,    39,    40,    41,    42,    43,
+      44,    45,    46,    47,    48,    49,    50,    -1,    -1,    -1,
+      -1,    -1,    56,    57,    -1,    59,    33,    34,    35,    36,
+      37,    38,    39,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,
+      57,    -1,    59,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,
+      34,    35,    36,    37,    38,    39,    40,    41,    42,    43,
+      44,    45,    46,    47,    48,    49,    50,    -1,    -1,    -1,
+      -1,    -1,    56,    57,    -1,    59,    34,    35,    36,    37,
+      38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+      -1,    59,    35,    36,    37,    38,    39,    40,    41,    42,
       43,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      -1,    -1,    -1,    56,    57,    -1,    59,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    -1,    -1,    -1,    -1,
-      -1,    56,    57,    -1,    59,    33,    34,    35,    36,    37,
+      -1,    -1,    -1,    56,    57,    -1,    59,    35,    36,    37,
       38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
       48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
-      -1,    59,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
-      -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,    34,
-      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    -1,    -1,    -1,    -1,
-      -1,    56,    57,    -1,    59,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,
-      59,    35,    36,    37,    38,    39,    40,    41,    42,    43,
+      -1,    59,    43,    44,    45,    46,    47,    48,    49,    50,
+      -1,    -1,    -1,    -1,    -1,    56,    57,    -1,    59,    43,
       44,    45,    46,    47,    48,    49,    50,    -1,    -1,    -1,
-      -1,    -1,    56,    57,    -1,    59,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,
-      59,    43,    44,    45,    46,    47,    48,    49,    50,    -1,
-      -1,    -1,    -1,    -1,    56,    57,    -1,    59,    43,    44,
-      45,    46,    47,    48,    49,    50,    -1,    -1,    -1,    -1,
-      -1,    56,    57,    -1,    59,    44,    45,    46,    47,    48,
-      49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,    -1,
-      59,    44,    45,    46,    47,    48,    49,    50,    -1,    -1,
-      -1,    -1,    -1,    56,    57,    -1,    59
+      -1,    -1,    56,    57,    -1,    59,    44,    45,    46,    47,
+      48,    49,    50,    -1,    -1,    -1,    -1,    -1,    56,    57,
+      -1,    59,    44,    45,    46,    47,    48,    49,    50,    -1,
+      -1,    -1,    -1,    -1,    56,    57,    -1,    59
   };
 
-  const unsigned char
+  const signed char
   parser::yystos_[] =
   {
-       0,    15,    67,    68,    10,   110,     0,    16,    69,    70,
-      71,    61,   110,    18,    19,    20,    72,    73,    74,    75,
-      77,    78,    80,   110,    61,    17,   110,    80,   110,   110,
-      61,   113,    22,    24,    57,    59,    71,   110,    24,    22,
-      24,    74,     4,     5,     6,     7,     8,    11,    12,    26,
-      45,    52,    53,    55,    57,    59,    65,    87,    88,    89,
-      90,    91,    92,    99,   100,   101,   102,   104,   105,   106,
-     107,   108,   109,   110,   111,   112,    57,    81,    82,    83,
-      84,    85,    86,   110,    87,   103,    79,   110,    81,    87,
-      81,    87,    58,    78,   110,    87,    87,    87,    87,    93,
-      94,   110,    87,    28,    30,    31,    32,    33,    34,    35,
-      36,    37,    38,    39,    40,    41,    42,    43,    44,    45,
-      46,    47,    48,    49,    50,    56,    57,    59,    22,   103,
-      23,    25,    23,    63,    23,    62,    13,    75,    76,    27,
-      60,    23,    63,    24,    23,    62,    58,    78,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-     103,   103,    87,    63,    84,    84,    87,    22,   110,    22,
-      87,    61,   113,    87,    87,    94,    25,    87,   103,    25,
-      76,    63,    62,    86,    58,    87,    95,    97,    87,    29,
-      75,    64,    87,    62,    87,   113,    87,    96,    97,    23,
-      87,    27,    25,    64,    61,   113,    12,    87,    87,    87,
-      97,    98,    64,    87,    23,    61,   113,    21,    64,    12,
-      26,    45,    52,    53,    55,    57,    59,   110,    28,    30,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
-      56,    87,    58,    78,    87,    87,    87,    87,    93,    87,
-      22,   110,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    13,    76,    27,    60,    63,    23,
-      62,    87,    22,    57,    59,    87,   113,    87,    87,    25,
-     103,    25,    87,   103,    79,    29,    64,    87,    62,    87,
-      63,    62,    87,    27,    25,    22,    22,    87,    87,    87,
-      87
+       0,    15,    67,    68,    10,   112,     0,    16,    69,    70,
+      71,    61,   112,    18,    19,    20,    72,    73,    74,    75,
+      77,    80,    82,   112,    61,    17,   112,    82,   112,   112,
+      61,   115,    22,    24,    57,    59,    71,   112,    24,    22,
+      24,    59,    74,     4,     5,     6,     7,     8,    11,    12,
+      26,    45,    52,    53,    55,    57,    59,    65,    89,    90,
+      91,    92,    93,    94,   101,   102,   103,   104,   106,   107,
+     108,   109,   110,   111,   112,   113,   114,    57,    83,    84,
+      85,    86,    87,    88,   112,    89,   105,    81,   112,    83,
+      89,    83,    78,    79,   112,    89,    58,    80,   112,    89,
+      89,    89,    89,    95,    96,   112,    89,    28,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    56,
+      57,    59,    22,   105,    23,    25,    23,    63,    23,    62,
+      23,    62,    22,    13,    75,    76,    27,    60,    23,    63,
+      24,    23,    62,    58,    80,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,   105,   105,    89,
+      63,    86,    86,    89,    22,   112,    22,    79,    24,    89,
+      89,    61,   115,    89,    89,    96,    25,    89,   105,    25,
+      76,    63,    62,    88,    58,    89,    97,    99,    89,    83,
+      29,    75,    64,    89,    62,    89,   115,    89,    98,    99,
+      23,    89,    27,    25,    64,    61,   115,    12,    89,    89,
+      89,    99,   100,    64,    89,    23,    61,   115,    21,    64,
+      12,    26,    45,    52,    53,    55,    57,    59,   112,    28,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,    43,    44,    45,    46,    47,    48,    49,
+      50,    56,    89,    58,    80,    89,    89,    89,    89,    95,
+      89,    22,   112,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    13,    76,    27,    60,    63,
+      23,    62,    89,    22,    57,    59,    89,   115,    89,    89,
+      25,   105,    25,    89,   105,    81,    29,    64,    89,    62,
+      89,    63,    62,    89,    27,    25,    22,    22,    89,    89,
+      89,    89
   };
 
-  const unsigned char
+  const signed char
   parser::yyr1_[] =
   {
        0,    66,    67,    68,    68,    69,    69,    70,    70,    71,
       71,    72,    72,    73,    73,    74,    74,    75,    75,    76,
-      76,    77,    77,    77,    77,    77,    78,    78,    78,    79,
-      79,    79,    80,    81,    81,    82,    83,    83,    84,    84,
-      85,    86,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    87,    87,    87,    87,    87,    87,    87,
-      87,    87,    87,    88,    88,    89,    89,    90,    90,    91,
-      92,    93,    93,    94,    94,    95,    95,    95,    95,    96,
-      96,    97,    98,    99,   100,   100,   101,   102,   103,   103,
-     104,   105,   105,   105,   106,   107,   108,   109,   109,   110,
-     111,   112,   113,   113
+      76,    77,    77,    77,    77,    77,    77,    78,    78,    79,
+      79,    80,    80,    80,    81,    81,    81,    82,    83,    83,
+      84,    85,    85,    86,    86,    87,    88,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    90,    90,
+      91,    91,    92,    92,    93,    94,    95,    95,    96,    96,
+      97,    97,    97,    97,    98,    98,    99,   100,   101,   102,
+     102,   103,   104,   105,   105,   106,   107,   107,   107,   108,
+     109,   110,   111,   111,   112,   113,   114,   115,   115
   };
 
-  const unsigned char
+  const signed char
   parser::yyr2_[] =
   {
        0,     2,     3,     0,     3,     0,     2,     1,     3,     2,
        4,     0,     2,     1,     3,     1,     1,     1,     1,     1,
-       3,     4,     4,     2,     4,     2,     3,     6,     6,     0,
-       1,     3,     3,     1,     1,     3,     1,     3,     1,     1,
-       4,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     3,     2,     2,     3,     3,
-       3,     3,     3,     3,     3,     3,     3,     3,     2,     3,
-       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
-       1,     1,     3,     4,     7,     3,     6,     5,     7,     4,
-       5,     1,     3,     1,     3,     1,     1,     4,     6,     1,
-       3,     4,     3,     5,     2,     4,     4,     3,     1,     3,
-       6,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     0
+       3,     4,     4,     7,     2,     4,     2,     1,     3,     1,
+       3,     3,     6,     6,     0,     1,     3,     3,     1,     1,
+       3,     1,     3,     1,     1,     4,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       3,     2,     2,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     2,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     1,     1,     3,     4,     7,
+       3,     6,     5,     7,     4,     5,     1,     3,     1,     3,
+       1,     1,     4,     6,     1,     3,     4,     3,     5,     2,
+       4,     4,     3,     1,     3,     6,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     0
   };
 
 
-
+#if YYDEBUG || 1
   // YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
-  // First, the terminals, then, starting at \a yyntokens_, nonterminals.
+  // First, the terminals, then, starting at \a YYNTOKENS, nonterminals.
   const char*
   const parser::yytname_[] =
   {
-  "\"end of file\"", "error", "$undefined", "\"invalid token\"", "INT",
-  "REAL", "COMPLEX", "TRUE", "FALSE", "STRING", "ID", "QUALIFIED_ID", "IF",
-  "THEN", "CASE", "MODULE", "IMPORT", "AS", "INPUT", "OUTPUT", "EXTERNAL",
-  "OTHERWISE", "'='", "','", "':'", "RIGHT_ARROW", "LET", "IN", "WHERE",
-  "ELSE", "LOGIC_OR", "LOGIC_AND", "BIT_OR", "BIT_XOR", "BIT_AND", "EQ",
-  "NEQ", "LESS", "MORE", "LESS_EQ", "MORE_EQ", "BIT_SHIFT_LEFT",
-  "BIT_SHIFT_RIGHT", "PLUSPLUS", "'+'", "'-'", "'*'", "'/'", "INT_DIV",
-  "'%'", "'^'", "DOTDOT", "LOGIC_NOT", "BIT_NOT", "UMINUS", "'#'", "'.'",
-  "'['", "'{'", "'('", "'@'", "';'", "')'", "']'", "'}'", "'~'", "$accept",
-  "program", "module_decl", "imports", "import_list", "import",
-  "declarations", "declaration_list", "declaration", "nested_decl",
-  "nested_decl_list", "external_decl", "binding", "param_list",
+  "\"end of file\"", "error", "\"invalid token\"", "\"invalid token\"",
+  "INT", "REAL", "COMPLEX", "TRUE", "FALSE", "STRING", "ID",
+  "QUALIFIED_ID", "IF", "THEN", "CASE", "MODULE", "IMPORT", "AS", "INPUT",
+  "OUTPUT", "EXTERNAL", "OTHERWISE", "'='", "','", "':'", "RIGHT_ARROW",
+  "LET", "IN", "WHERE", "ELSE", "LOGIC_OR", "LOGIC_AND", "BIT_OR",
+  "BIT_XOR", "BIT_AND", "EQ", "NEQ", "LESS", "MORE", "LESS_EQ", "MORE_EQ",
+  "BIT_SHIFT_LEFT", "BIT_SHIFT_RIGHT", "PLUSPLUS", "'+'", "'-'", "'*'",
+  "'/'", "INT_DIV", "'%'", "'^'", "DOTDOT", "LOGIC_NOT", "BIT_NOT",
+  "UMINUS", "'#'", "'.'", "'['", "'{'", "'('", "'@'", "';'", "')'", "']'",
+  "'}'", "'~'", "$accept", "program", "module_decl", "imports",
+  "import_list", "import", "declarations", "declaration_list",
+  "declaration", "nested_decl", "nested_decl_list", "external_decl",
+  "external_attribute_list", "external_attribute", "binding", "param_list",
   "id_type_decl", "type", "function_type", "data_type_list", "data_type",
   "array_type", "primitive_type", "expr", "let_expr", "where_expr",
   "func_lambda", "array_apply", "array_lambda", "array_lambda_params",
@@ -1944,48 +2078,48 @@ namespace stream { namespace parsing {
   "number", "int", "real", "complex", "boolean", "id", "qualified_id",
   "inf", "optional_semicolon", YY_NULLPTR
   };
+#endif
+
 
 #if YYDEBUG
-  const unsigned short int
+  const short
   parser::yyrline_[] =
   {
        0,    72,    72,    81,    83,    89,    91,    95,   100,   109,
      114,   122,   124,   128,   133,   142,   142,   146,   146,   150,
-     155,   164,   167,   170,   173,   177,   183,   188,   194,   203,
-     205,   208,   217,   222,   222,   226,   231,   234,   243,   243,
-     247,   252,   257,   259,   261,   263,   265,   267,   269,   271,
-     273,   275,   277,   279,   281,   283,   286,   289,   292,   295,
-     298,   301,   304,   307,   310,   313,   316,   319,   322,   325,
-     328,   331,   334,   337,   340,   343,   346,   349,   352,   355,
-     358,   360,   362,   370,   376,   383,   389,   396,   402,   411,
-     416,   437,   440,   449,   452,   457,   463,   468,   471,   480,
-     483,   492,   497,   502,   510,   513,   518,   525,   532,   535,
-     543,   548,   550,   552,   555,   558,   561,   565,   567,   570,
-     573,   576,   580,   580
+     155,   164,   167,   170,   173,   176,   180,   185,   190,   199,
+     202,   207,   212,   218,   227,   229,   232,   241,   246,   246,
+     250,   255,   258,   267,   267,   271,   276,   281,   283,   285,
+     287,   289,   291,   293,   295,   297,   299,   301,   303,   305,
+     307,   310,   313,   316,   319,   322,   325,   328,   331,   334,
+     337,   340,   343,   346,   349,   352,   355,   358,   361,   364,
+     367,   370,   373,   376,   379,   382,   384,   386,   394,   400,
+     407,   413,   420,   426,   435,   440,   461,   464,   473,   476,
+     481,   487,   492,   495,   504,   507,   516,   521,   526,   534,
+     537,   542,   549,   556,   559,   567,   572,   574,   576,   579,
+     582,   585,   589,   591,   594,   597,   600,   604,   604
   };
 
-  // Print the state stack on the debug stream.
   void
-  parser::yystack_print_ ()
+  parser::yy_stack_print_ () const
   {
     *yycdebug_ << "Stack now";
     for (stack_type::const_iterator
            i = yystack_.begin (),
            i_end = yystack_.end ();
          i != i_end; ++i)
-      *yycdebug_ << ' ' << i->state;
-    *yycdebug_ << std::endl;
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
   }
 
-  // Report on the debug stream that the rule \a yyrule is going to be reduced.
   void
-  parser::yy_reduce_print_ (int yyrule)
+  parser::yy_reduce_print_ (int yyrule) const
   {
-    unsigned int yylno = yyrline_[yyrule];
+    int yylno = yyrline_[yyrule];
     int yynrhs = yyr2_[yyrule];
     // Print the symbols being reduced, and their result.
     *yycdebug_ << "Reducing stack by rule " << yyrule - 1
-               << " (line " << yylno << "):" << std::endl;
+               << " (line " << yylno << "):\n";
     // The symbols being reduced.
     for (int yyi = 0; yyi < yynrhs; yyi++)
       YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
@@ -1993,16 +2127,16 @@ namespace stream { namespace parsing {
   }
 #endif // YYDEBUG
 
-  // Symbol number corresponding to token number t.
-  inline
-  parser::token_number_type
-  parser::yytranslate_ (int t)
+  parser::symbol_kind_type
+  parser::yytranslate_ (int t) YY_NOEXCEPT
   {
+    // YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to
+    // TOKEN-NUM as returned by yylex.
     static
-    const token_number_type
+    const signed char
     translate_table[] =
     {
-     0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,    55,     2,    49,     2,     2,
@@ -2034,21 +2168,22 @@ namespace stream { namespace parsing {
       38,    39,    40,    41,    42,    43,    48,    51,    52,    53,
       54
     };
-    const unsigned int user_token_number_max_ = 300;
-    const token_number_type undef_token_ = 2;
+    // Last valid token kind.
+    const int code_max = 300;
 
-    if (static_cast<int>(t) <= yyeof_)
-      return yyeof_;
-    else if (static_cast<unsigned int> (t) <= user_token_number_max_)
-      return translate_table[t];
+    if (t <= 0)
+      return symbol_kind::S_YYEOF;
+    else if (t <= code_max)
+      return static_cast <symbol_kind_type> (translate_table[t]);
     else
-      return undef_token_;
+      return symbol_kind::S_YYUNDEF;
   }
 
-#line 13 "parser.y" // lalr1.cc:1167
+#line 13 "parser.y"
 } } // stream::parsing
-#line 2051 "parser.cpp" // lalr1.cc:1167
-#line 583 "parser.y" // lalr1.cc:1168
+#line 2185 "parser.cpp"
+
+#line 607 "parser.y"
 
 
 void
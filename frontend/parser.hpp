@@ -1,8 +1,8 @@
-// A Bison parser, made by GNU Bison 3.0.4.
+// A Bison parser, made by GNU Bison 3.8.2.
 
 // Skeleton interface for Bison LALR(1) parsers in C++
 
-// Copyright (C) 2002-2015 Free Software Foundation, Inc.
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
 
 // This program is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
@@ -15,7 +15,7 @@
 // GNU General Public License for more details.
 
 // You should have received a copy of the GNU General Public License
-// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 // As a special exception, you may create a larger work that contains
 // part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +30,7 @@
 // This special exception was added by the Free Software Foundation in
 // version 2.2 of Bison.
 
+
 /**
  ** \file parser.hpp
  ** Define the stream::parsing::parser class.
@@ -37,15 +38,19 @@
 
 // C++ LALR(1) parser skeleton written by Akim Demaille.
 
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
+
 #ifndef YY_YY_PARSER_HPP_INCLUDED
 # define YY_YY_PARSER_HPP_INCLUDED
-// //                    "%code requires" blocks.
-#line 2 "parser.y" // lalr1.cc:377
+// "%code requires" blocks.
+#line 2 "parser.y"
 
   #include "../common/ast.hpp"
   namespace stream { namespace parsing { class driver; } }
 
-#line 49 "parser.hpp" // lalr1.cc:377
+#line 54 "parser.hpp"
 
 
 # include <cstdlib> // std::abort
@@ -53,51 +58,82 @@
 # include <stdexcept>
 # include <string>
 # include <vector>
-# include "stack.hh"
-# include "location.hh"
 
+#if defined __cplusplus
+# define YY_CPLUSPLUS __cplusplus
+#else
+# define YY_CPLUSPLUS 199711L
+#endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
+// Support move semantics when possible.
+#if 201103L <= YY_CPLUSPLUS
+# define YY_MOVE           std::move
+# define YY_MOVE_OR_COPY   move
+# define YY_MOVE_REF(Type) Type&&
+# define YY_RVREF(Type)    Type&&
+# define YY_COPY(Type)     Type
+#else
+# define YY_MOVE
+# define YY_MOVE_OR_COPY   copy
+# define YY_MOVE_REF(Type) Type&
+# define YY_RVREF(Type)    const Type&
+# define YY_COPY(Type)     const Type&
 #endif
 
-#ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+// Support noexcept when possible.
+#if 201103L <= YY_CPLUSPLUS
+# define YY_NOEXCEPT noexcept
+# define YY_NOTHROW
+#else
+# define YY_NOEXCEPT
+# define YY_NOTHROW throw ()
 #endif
 
-#ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
+// Support constexpr when possible.
+#if 201703 <= YY_CPLUSPLUS
+# define YY_CONSTEXPR constexpr
+#else
+# define YY_CONSTEXPR
 #endif
+# include "location.hh"
+
 
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -110,15 +146,47 @@
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
 /* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
 
-#line 13 "parser.y" // lalr1.cc:377
+#line 13 "parser.y"
 namespace stream { namespace parsing {
-#line 121 "parser.hpp" // lalr1.cc:377
-
+#line 190 "parser.hpp"
 
 
 
@@ -127,90 +195,238 @@ namespace stream { namespace parsing {
   class parser
   {
   public:
-#ifndef YYSTYPE
-    /// Symbol semantic values.
-    typedef stream::ast::semantic_value_type semantic_type;
+#ifdef YYSTYPE
+# ifdef __GNUC__
+#  pragma GCC message "bison: do not #define YYSTYPE in C++, use %define api.value.type"
+# endif
+    typedef YYSTYPE value_type;
 #else
-    typedef YYSTYPE semantic_type;
+    /// Symbol semantic values.
+    typedef stream::ast::semantic_value_type value_type;
 #endif
+    /// Backward compatibility (Bison 3.8).
+    typedef value_type semantic_type;
+
     /// Symbol locations.
     typedef location location_type;
 
     /// Syntax errors thrown from user actions.
     struct syntax_error : std::runtime_error
     {
-      syntax_error (const location_type& l, const std::string& m);
+      syntax_error (const location_type& l, const std::string& m)
+        : std::runtime_error (m)
+        , location (l)
+      {}
+
+      syntax_error (const syntax_error& s)
+        : std::runtime_error (s.what ())
+        , location (s.location)
+      {}
+
+      ~syntax_error () YY_NOEXCEPT YY_NOTHROW;
+
       location_type location;
     };
 
-    /// Tokens.
+    /// Token kinds.
     struct token
     {
-      enum yytokentype
+      enum token_kind_type
       {
-        END = 0,
-        INVALID = 258,
-        INT = 259,
-        REAL = 260,
-        COMPLEX = 261,
-        TRUE = 262,
-        FALSE = 263,
-        STRING = 264,
-        ID = 265,
-        QUALIFIED_ID = 266,
-        IF = 267,
-        THEN = 268,
-        CASE = 269,
-        MODULE = 270,
-        IMPORT = 271,
-        AS = 272,
-        INPUT = 273,
-        OUTPUT = 274,
-        EXTERNAL = 275,
-        OTHERWISE = 276,
-        RIGHT_ARROW = 277,
-        LET = 278,
-        IN = 279,
-        WHERE = 280,
-        ELSE = 281,
-        LOGIC_OR = 282,
-        LOGIC_AND = 283,
-        BIT_OR = 284,
-        BIT_XOR = 285,
-        BIT_AND = 286,
-        EQ = 287,
-        NEQ = 288,
-        LESS = 289,
-        MORE = 290,
-        LESS_EQ = 291,
-        MORE_EQ = 292,
-        BIT_SHIFT_LEFT = 293,
-        BIT_SHIFT_RIGHT = 294,
-        PLUSPLUS = 295,
-        INT_DIV = 296,
-        DOTDOT = 297,
-        LOGIC_NOT = 298,
-        BIT_NOT = 299,
-        UMINUS = 300
+        YYEMPTY = -2,
+    END = 0,                       // "end of file"
+    YYerror = 256,                 // error
+    YYUNDEF = 257,                 // "invalid token"
+    INVALID = 258,                 // "invalid token"
+    INT = 259,                     // INT
+    REAL = 260,                    // REAL
+    COMPLEX = 261,                 // COMPLEX
+    TRUE = 262,                    // TRUE
+    FALSE = 263,                   // FALSE
+    STRING = 264,                  // STRING
+    ID = 265,                      // ID
+    QUALIFIED_ID = 266,            // QUALIFIED_ID
+    IF = 267,                      // IF
+    THEN = 268,                    // THEN
+    CASE = 269,                    // CASE
+    MODULE = 270,                  // MODULE
+    IMPORT = 271,                  // IMPORT
+    AS = 272,                      // AS
+    INPUT = 273,                   // INPUT
+    OUTPUT = 274,                  // OUTPUT
+    EXTERNAL = 275,                // EXTERNAL
+    OTHERWISE = 276,               // OTHERWISE
+    RIGHT_ARROW = 277,             // RIGHT_ARROW
+    LET = 278,                     // LET
+    IN = 279,                      // IN
+    WHERE = 280,                   // WHERE
+    ELSE = 281,                    // ELSE
+    LOGIC_OR = 282,                // LOGIC_OR
+    LOGIC_AND = 283,               // LOGIC_AND
+    BIT_OR = 284,                  // BIT_OR
+    BIT_XOR = 285,                 // BIT_XOR
+    BIT_AND = 286,                 // BIT_AND
+    EQ = 287,                      // EQ
+    NEQ = 288,                     // NEQ
+    LESS = 289,                    // LESS
+    MORE = 290,                    // MORE
+    LESS_EQ = 291,                 // LESS_EQ
+    MORE_EQ = 292,                 // MORE_EQ
+    BIT_SHIFT_LEFT = 293,          // BIT_SHIFT_LEFT
+    BIT_SHIFT_RIGHT = 294,         // BIT_SHIFT_RIGHT
+    PLUSPLUS = 295,                // PLUSPLUS
+    INT_DIV = 296,                 // INT_DIV
+    DOTDOT = 297,                  // DOTDOT
+    LOGIC_NOT = 298,               // LOGIC_NOT
+    BIT_NOT = 299,                 // BIT_NOT
+    UMINUS = 300                   // UMINUS
       };
+      /// Backward compatibility alias (Bison 3.6).
+      typedef token_kind_type yytokentype;
     };
 
-    /// (External) token type, as returned by yylex.
-    typedef token::yytokentype token_type;
+    /// Token kind, as returned by yylex.
+    typedef token::token_kind_type token_kind_type;
 
-    /// Symbol type: an internal symbol number.
-    typedef int symbol_number_type;
+    /// Backward compatibility alias (Bison 3.6).
+    typedef token_kind_type token_type;
 
-    /// The symbol type number to denote an empty symbol.
-    enum { empty_symbol = -2 };
+    /// Symbol kinds.
+    struct symbol_kind
+    {
+      enum symbol_kind_type
+      {
+        YYNTOKENS = 66, ///< Number of tokens.
+        S_YYEMPTY = -2,
+        S_YYEOF = 0,                             // "end of file"
+        S_YYerror = 1,                           // error
+        S_YYUNDEF = 2,                           // "invalid token"
+        S_INVALID = 3,                           // "invalid token"
+        S_INT = 4,                               // INT
+        S_REAL = 5,                              // REAL
+        S_COMPLEX = 6,                           // COMPLEX
+        S_TRUE = 7,                              // TRUE
+        S_FALSE = 8,                             // FALSE
+        S_STRING = 9,                            // STRING
+        S_ID = 10,                               // ID
+        S_QUALIFIED_ID = 11,                     // QUALIFIED_ID
+        S_IF = 12,                               // IF
+        S_THEN = 13,                             // THEN
+        S_CASE = 14,                             // CASE
+        S_MODULE = 15,                           // MODULE
+        S_IMPORT = 16,                           // IMPORT
+        S_AS = 17,                               // AS
+        S_INPUT = 18,                            // INPUT
+        S_OUTPUT = 19,                           // OUTPUT
+        S_EXTERNAL = 20,                         // EXTERNAL
+        S_OTHERWISE = 21,                        // OTHERWISE
+        S_22_ = 22,                              // '='
+        S_23_ = 23,                              // ','
+        S_24_ = 24,                              // ':'
+        S_RIGHT_ARROW = 25,                      // RIGHT_ARROW
+        S_LET = 26,                              // LET
+        S_IN = 27,                               // IN
+        S_WHERE = 28,                            // WHERE
+        S_ELSE = 29,                             // ELSE
+        S_LOGIC_OR = 30,                         // LOGIC_OR
+        S_LOGIC_AND = 31,                        // LOGIC_AND
+        S_BIT_OR = 32,                           // BIT_OR
+        S_BIT_XOR = 33,                          // BIT_XOR
+        S_BIT_AND = 34,                          // BIT_AND
+        S_EQ = 35,                               // EQ
+        S_NEQ = 36,                              // NEQ
+        S_LESS = 37,                             // LESS
+        S_MORE = 38,                             // MORE
+        S_LESS_EQ = 39,                          // LESS_EQ
+        S_MORE_EQ = 40,                          // MORE_EQ
+        S_BIT_SHIFT_LEFT = 41,                   // BIT_SHIFT_LEFT
+        S_BIT_SHIFT_RIGHT = 42,                  // BIT_SHIFT_RIGHT
+        S_PLUSPLUS = 43,                         // PLUSPLUS
+        S_44_ = 44,                              // '+'
+        S_45_ = 45,                              // '-'
+        S_46_ = 46,                              // '*'
+        S_47_ = 47,                              // '/'
+        S_INT_DIV = 48,                          // INT_DIV
+        S_49_ = 49,                              // '%'
+        S_50_ = 50,                              // '^'
+        S_DOTDOT = 51,                           // DOTDOT
+        S_LOGIC_NOT = 52,                        // LOGIC_NOT
+        S_BIT_NOT = 53,                          // BIT_NOT
+        S_UMINUS = 54,                           // UMINUS
+        S_55_ = 55,                              // '#'
+        S_56_ = 56,                              // '.'
+        S_57_ = 57,                              // '['
+        S_58_ = 58,                              // '{'
+        S_59_ = 59,                              // '('
+        S_60_ = 60,                              // '@'
+        S_61_ = 61,                              // ';'
+        S_62_ = 62,                              // ')'
+        S_63_ = 63,                              // ']'
+        S_64_ = 64,                              // '}'
+        S_65_ = 65,                              // '~'
+        S_YYACCEPT = 66,                         // $accept
+        S_program = 67,                          // program
+        S_module_decl = 68,                      // module_decl
+        S_imports = 69,                          // imports
+        S_import_list = 70,                      // import_list
+        S_import = 71,                           // import
+        S_declarations = 72,                     // declarations
+        S_declaration_list = 73,                 // declaration_list
+        S_declaration = 74,                      // declaration
+        S_nested_decl = 75,                      // nested_decl
+        S_nested_decl_list = 76,                 // nested_decl_list
+        S_external_decl = 77,                    // external_decl
+        S_external_attribute_list = 78,          // external_attribute_list
+        S_external_attribute = 79,               // external_attribute
+        S_binding = 80,                          // binding
+        S_param_list = 81,                       // param_list
+        S_id_type_decl = 82,                     // id_type_decl
+        S_type = 83,                             // type
+        S_function_type = 84,                    // function_type
+        S_data_type_list = 85,                   // data_type_list
+        S_data_type = 86,                        // data_type
+        S_array_type = 87,                       // array_type
+        S_primitive_type = 88,                   // primitive_type
+        S_expr = 89,                             // expr
+        S_let_expr = 90,                         // let_expr
+        S_where_expr = 91,                       // where_expr
+        S_func_lambda = 92,                      // func_lambda
+        S_array_apply = 93,                      // array_apply
+        S_array_lambda = 94,                     // array_lambda
+        S_array_lambda_params = 95,              // array_lambda_params
+        S_array_lambda_param = 96,               // array_lambda_param
+        S_array_exprs = 97,                      // array_exprs
+        S_constrained_array_expr_list = 98,      // constrained_array_expr_list
+        S_constrained_array_expr = 99,           // constrained_array_expr
+        S_final_constrained_array_expr = 100,    // final_constrained_array_expr
+        S_array_enum = 101,                      // array_enum
+        S_array_size = 102,                      // array_size
+        S_func_apply = 103,                      // func_apply
+        S_func_composition = 104,                // func_composition
+        S_expr_list = 105,                       // expr_list
+        S_if_expr = 106,                         // if_expr
+        S_number = 107,                          // number
+        S_int = 108,                             // int
+        S_real = 109,                            // real
+        S_complex = 110,                         // complex
+        S_boolean = 111,                         // boolean
+        S_id = 112,                              // id
+        S_qualified_id = 113,                    // qualified_id
+        S_inf = 114,                             // inf
+        S_optional_semicolon = 115               // optional_semicolon
+      };
+    };
+
+    /// (Internal) symbol kind.
+    typedef symbol_kind::symbol_kind_type symbol_kind_type;
 
-    /// Internal symbol number for tokens (subsumed by symbol_number_type).
-    typedef unsigned char token_number_type;
+    /// The number of tokens.
+    static const symbol_kind_type YYNTOKENS = symbol_kind::YYNTOKENS;
 
     /// A complete symbol.
     ///
-    /// Expects its Base type to provide access to the symbol type
-    /// via type_get().
+    /// Expects its Base type to provide access to the symbol kind
+    /// via kind ().
     ///
     /// Provide access to semantic value and location.
     template <typename Base>
@@ -220,85 +436,135 @@ namespace stream { namespace parsing {
       typedef Base super_type;
 
       /// Default constructor.
-      basic_symbol ();
+      basic_symbol () YY_NOEXCEPT
+        : value ()
+        , location ()
+      {}
+
+#if 201103L <= YY_CPLUSPLUS
+      /// Move constructor.
+      basic_symbol (basic_symbol&& that)
+        : Base (std::move (that))
+        , value (std::move (that.value))
+        , location (std::move (that.location))
+      {}
+#endif
 
       /// Copy constructor.
-      basic_symbol (const basic_symbol& other);
-
+      basic_symbol (const basic_symbol& that);
       /// Constructor for valueless symbols.
       basic_symbol (typename Base::kind_type t,
-                    const location_type& l);
+                    YY_MOVE_REF (location_type) l);
 
       /// Constructor for symbols with semantic value.
       basic_symbol (typename Base::kind_type t,
-                    const semantic_type& v,
-                    const location_type& l);
+                    YY_RVREF (value_type) v,
+                    YY_RVREF (location_type) l);
 
       /// Destroy the symbol.
-      ~basic_symbol ();
+      ~basic_symbol ()
+      {
+        clear ();
+      }
+
+
 
       /// Destroy contents, and record that is empty.
-      void clear ();
+      void clear () YY_NOEXCEPT
+      {
+        Base::clear ();
+      }
+
+      /// The user-facing name of this symbol.
+      std::string name () const YY_NOEXCEPT
+      {
+        return parser::symbol_name (this->kind ());
+      }
+
+      /// Backward compatibility (Bison 3.6).
+      symbol_kind_type type_get () const YY_NOEXCEPT;
 
       /// Whether empty.
-      bool empty () const;
+      bool empty () const YY_NOEXCEPT;
 
       /// Destructive move, \a s is emptied into this.
       void move (basic_symbol& s);
 
       /// The semantic value.
-      semantic_type value;
+      value_type value;
 
       /// The location.
       location_type location;
 
     private:
+#if YY_CPLUSPLUS < 201103L
       /// Assignment operator.
-      basic_symbol& operator= (const basic_symbol& other);
+      basic_symbol& operator= (const basic_symbol& that);
+#endif
     };
 
     /// Type access provider for token (enum) based symbols.
-    struct by_type
+    struct by_kind
     {
+      /// The symbol kind as needed by the constructor.
+      typedef token_kind_type kind_type;
+
       /// Default constructor.
-      by_type ();
+      by_kind () YY_NOEXCEPT;
 
-      /// Copy constructor.
-      by_type (const by_type& other);
+#if 201103L <= YY_CPLUSPLUS
+      /// Move constructor.
+      by_kind (by_kind&& that) YY_NOEXCEPT;
+#endif
 
-      /// The symbol type as needed by the constructor.
-      typedef token_type kind_type;
+      /// Copy constructor.
+      by_kind (const by_kind& that) YY_NOEXCEPT;
 
       /// Constructor from (external) token numbers.
-      by_type (kind_type t);
+      by_kind (kind_type t) YY_NOEXCEPT;
+
+
 
       /// Record that this symbol is empty.
-      void clear ();
+      void clear () YY_NOEXCEPT;
 
-      /// Steal the symbol type from \a that.
-      void move (by_type& that);
+      /// Steal the symbol kind from \a that.
+      void move (by_kind& that);
 
       /// The (internal) type number (corresponding to \a type).
       /// \a empty when empty.
-      symbol_number_type type_get () const;
+      symbol_kind_type kind () const YY_NOEXCEPT;
 
-      /// The token.
-      token_type token () const;
+      /// Backward compatibility (Bison 3.6).
+      symbol_kind_type type_get () const YY_NOEXCEPT;
 
-      /// The symbol type.
-      /// \a empty_symbol when empty.
-      /// An int, not token_number_type, to be able to store empty_symbol.
-      int type;
+      /// The symbol kind.
+      /// \a S_YYEMPTY when empty.
+      symbol_kind_type kind_;
     };
 
-    /// "External" symbols: returned by the scanner.
-    typedef basic_symbol<by_type> symbol_type;
+    /// Backward compatibility for a private implementation detail (Bison 3.6).
+    typedef by_kind by_type;
 
+    /// "External" symbols: returned by the scanner.
+    struct symbol_type : basic_symbol<by_kind>
+    {};
 
     /// Build a parser object.
     parser (class stream::parsing::driver& driver_yyarg);
     virtual ~parser ();
 
+#if 201103L <= YY_CPLUSPLUS
+    /// Non copyable.
+    parser (const parser&) = delete;
+    /// Non copyable.
+    parser& operator= (const parser&) = delete;
+#endif
+
+    /// Parse.  An alias for parse ().
+    /// \returns  0 iff parsing succeeded.
+    int operator() ();
+
     /// Parse.
     /// \returns  0 iff parsing succeeded.
     virtual int parse ();
@@ -325,92 +591,125 @@ namespace stream { namespace parsing {
     /// Report a syntax error.
     void error (const syntax_error& err);
 
+    /// The user-facing name of the symbol whose (internal) number is
+    /// YYSYMBOL.  No bounds checking.
+    static std::string symbol_name (symbol_kind_type yysymbol);
+
+
+
+    class context
+    {
+    public:
+      context (const parser& yyparser, const symbol_type& yyla);
+      const symbol_type& lookahead () const YY_NOEXCEPT { return yyla_; }
+      symbol_kind_type token () const YY_NOEXCEPT { return yyla_.kind (); }
+      const location_type& location () const YY_NOEXCEPT { return yyla_.location; }
+
+      /// Put in YYARG at most YYARGN of the expected tokens, and return the
+      /// number of tokens stored in YYARG.  If YYARG is null, return the
+      /// number of expected tokens (guaranteed to be less than YYNTOKENS).
+      int expected_tokens (symbol_kind_type yyarg[], int yyargn) const;
+
+    private:
+      const parser& yyparser_;
+      const symbol_type& yyla_;
+    };
+
   private:
-    /// This class is not copyable.
+#if YY_CPLUSPLUS < 201103L
+    /// Non copyable.
     parser (const parser&);
+    /// Non copyable.
     parser& operator= (const parser&);
+#endif
 
-    /// State numbers.
-    typedef int state_type;
 
-    /// Generate an error message.
-    /// \param yystate   the state where the error occurred.
-    /// \param yyla      the lookahead token.
-    virtual std::string yysyntax_error_ (state_type yystate,
-                                         const symbol_type& yyla) const;
+    /// Stored state numbers (used for stacks).
+    typedef short state_type;
+
+    /// The arguments of the error message.
+    int yy_syntax_error_arguments_ (const context& yyctx,
+                                    symbol_kind_type yyarg[], int yyargn) const;
 
+    /// Generate an error message.
+    /// \param yyctx     the context in which the error occurred.
+    virtual std::string yysyntax_error_ (const context& yyctx) const;
     /// Compute post-reduction state.
     /// \param yystate   the current state
     /// \param yysym     the nonterminal to push on the stack
-    state_type yy_lr_goto_state_ (state_type yystate, int yysym);
+    static state_type yy_lr_goto_state_ (state_type yystate, int yysym);
 
     /// Whether the given \c yypact_ value indicates a defaulted state.
     /// \param yyvalue   the value to check
-    static bool yy_pact_value_is_default_ (int yyvalue);
+    static bool yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT;
 
     /// Whether the given \c yytable_ value indicates a syntax error.
     /// \param yyvalue   the value to check
-    static bool yy_table_value_is_error_ (int yyvalue);
+    static bool yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT;
 
-    static const short int yypact_ninf_;
+    static const short yypact_ninf_;
     static const signed char yytable_ninf_;
 
-    /// Convert a scanner token number \a t to a symbol number.
-    static token_number_type yytranslate_ (int t);
+    /// Convert a scanner token kind \a t to a symbol kind.
+    /// In theory \a t should be a token_kind_type, but character literals
+    /// are valid, yet not members of the token_kind_type enum.
+    static symbol_kind_type yytranslate_ (int t) YY_NOEXCEPT;
 
-    // Tables.
-  // YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-  // STATE-NUM.
-  static const short int yypact_[];
+    /// Convert the symbol name \a n to a form suitable for a diagnostic.
+    static std::string yytnamerr_ (const char *yystr);
 
-  // YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-  // Performed when YYTABLE does not specify something else to do.  Zero
-  // means the default is an error.
-  static const unsigned char yydefact_[];
+    /// For a symbol, its name in clear.
+    static const char* const yytname_[];
 
-  // YYPGOTO[NTERM-NUM].
-  static const short int yypgoto_[];
 
-  // YYDEFGOTO[NTERM-NUM].
-  static const short int yydefgoto_[];
+    // Tables.
+    // YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+    // STATE-NUM.
+    static const short yypact_[];
 
-  // YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-  // positive, shift that token.  If negative, reduce the rule whose
-  // number is the opposite.  If YYTABLE_NINF, syntax error.
-  static const short int yytable_[];
+    // YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+    // Performed when YYTABLE does not specify something else to do.  Zero
+    // means the default is an error.
+    static const unsigned char yydefact_[];
 
-  static const short int yycheck_[];
+    // YYPGOTO[NTERM-NUM].
+    static const short yypgoto_[];
 
-  // YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-  // symbol of state STATE-NUM.
-  static const unsigned char yystos_[];
+    // YYDEFGOTO[NTERM-NUM].
+    static const unsigned char yydefgoto_[];
 
-  // YYR1[YYN] -- Symbol number of symbol that rule YYN derives.
-  static const unsigned char yyr1_[];
+    // YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+    // positive, shift that token.  If negative, reduce the rule whose
+    // number is the opposite.  If YYTABLE_NINF, syntax error.
+    static const short yytable_[];
 
-  // YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.
-  static const unsigned char yyr2_[];
+    static const short yycheck_[];
 
+    // YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+    // state STATE-NUM.
+    static const signed char yystos_[];
 
-    /// Convert the symbol name \a n to a form suitable for a diagnostic.
-    static std::string yytnamerr_ (const char *n);
+    // YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.
+    static const signed char yyr1_[];
+
+    // YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.
+    static const signed char yyr2_[];
 
 
-    /// For a symbol, its name in clear.
-    static const char* const yytname_[];
 #if YYDEBUG
-  // YYRLINE[YYN] -- Source line where rule number YYN was defined.
-  static const unsigned short int yyrline_[];
+    // YYRLINE[YYN] -- Source line where rule number YYN was defined.
+    static const short yyrline_[];
     /// Report on the debug stream that the rule \a r is going to be reduced.
-    virtual void yy_reduce_print_ (int r);
+    virtual void yy_reduce_print_ (int r) const;
     /// Print the state stack on the debug stream.
-    virtual void yystack_print_ ();
+    virtual void yy_stack_print_ () const;
 
-    // Debugging.
+    /// Debugging level.
     int yydebug_;
+    /// Debug stream.
     std::ostream* yycdebug_;
 
-    /// \brief Display a symbol type, value and location.
+    /// \brief Display a symbol kind, value and location.
     /// \param yyo    The output stream.
     /// \param yysym  The symbol.
     template <typename Base>
@@ -429,29 +728,30 @@ namespace stream { namespace parsing {
     struct by_state
     {
       /// Default constructor.
-      by_state ();
+      by_state () YY_NOEXCEPT;
 
-      /// The symbol type as needed by the constructor.
+      /// The symbol kind as needed by the constructor.
       typedef state_type kind_type;
 
       /// Constructor.
-      by_state (kind_type s);
+      by_state (kind_type s) YY_NOEXCEPT;
 
       /// Copy constructor.
-      by_state (const by_state& other);
+      by_state (const by_state& that) YY_NOEXCEPT;
 
       /// Record that this symbol is empty.
-      void clear ();
+      void clear () YY_NOEXCEPT;
 
-      /// Steal the symbol type from \a that.
+      /// Steal the symbol kind from \a that.
       void move (by_state& that);
 
-      /// The (internal) type number (corresponding to \a state).
-      /// \a empty_symbol when empty.
-      symbol_number_type type_get () const;
+      /// The symbol kind (corresponding to \a state).
+      /// \a symbol_kind::S_YYEMPTY when empty.
+      symbol_kind_type kind () const YY_NOEXCEPT;
 
       /// The state number used to denote an empty symbol.
-      enum { empty_state = -1 };
+      /// We use the initial state, as it does not have a value.
+      enum { empty_state = 0 };
 
       /// The state.
       /// \a empty when empty.
@@ -465,12 +765,139 @@ namespace stream { namespace parsing {
       typedef basic_symbol<by_state> super_type;
       /// Construct an empty symbol.
       stack_symbol_type ();
+      /// Move or copy construction.
+      stack_symbol_type (YY_RVREF (stack_symbol_type) that);
       /// Steal the contents from \a sym to build this.
-      stack_symbol_type (state_type s, symbol_type& sym);
-      /// Assignment, needed by push_back.
+      stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) sym);
+#if YY_CPLUSPLUS < 201103L
+      /// Assignment, needed by push_back by some old implementations.
+      /// Moves the contents of that.
+      stack_symbol_type& operator= (stack_symbol_type& that);
+
+      /// Assignment, needed by push_back by other implementations.
+      /// Needed by some other old implementations.
       stack_symbol_type& operator= (const stack_symbol_type& that);
+#endif
+    };
+
+    /// A stack with random access from its top.
+    template <typename T, typename S = std::vector<T> >
+    class stack
+    {
+    public:
+      // Hide our reversed order.
+      typedef typename S::iterator iterator;
+      typedef typename S::const_iterator const_iterator;
+      typedef typename S::size_type size_type;
+      typedef typename std::ptrdiff_t index_type;
+
+      stack (size_type n = 200) YY_NOEXCEPT
+        : seq_ (n)
+      {}
+
+#if 201103L <= YY_CPLUSPLUS
+      /// Non copyable.
+      stack (const stack&) = delete;
+      /// Non copyable.
+      stack& operator= (const stack&) = delete;
+#endif
+
+      /// Random access.
+      ///
+      /// Index 0 returns the topmost element.
+      const T&
+      operator[] (index_type i) const
+      {
+        return seq_[size_type (size () - 1 - i)];
+      }
+
+      /// Random access.
+      ///
+      /// Index 0 returns the topmost element.
+      T&
+      operator[] (index_type i)
+      {
+        return seq_[size_type (size () - 1 - i)];
+      }
+
+      /// Steal the contents of \a t.
+      ///
+      /// Close to move-semantics.
+      void
+      push (YY_MOVE_REF (T) t)
+      {
+        seq_.push_back (T ());
+        operator[] (0).move (t);
+      }
+
+      /// Pop elements from the stack.
+      void
+      pop (std::ptrdiff_t n = 1) YY_NOEXCEPT
+      {
+        for (; 0 < n; --n)
+          seq_.pop_back ();
+      }
+
+      /// Pop all elements from the stack.
+      void
+      clear () YY_NOEXCEPT
+      {
+        seq_.clear ();
+      }
+
+      /// Number of elements on the stack.
+      index_type
+      size () const YY_NOEXCEPT
+      {
+        return index_type (seq_.size ());
+      }
+
+      /// Iterator on top of the stack (going downwards).
+      const_iterator
+      begin () const YY_NOEXCEPT
+      {
+        return seq_.begin ();
+      }
+
+      /// Bottom of the stack.
+      const_iterator
+      end () const YY_NOEXCEPT
+      {
+        return seq_.end ();
+      }
+
+      /// Present a slice of the top of a stack.
+      class slice
+      {
+      public:
+        slice (const stack& stack, index_type range) YY_NOEXCEPT
+          : stack_ (stack)
+          , range_ (range)
+        {}
+
+        const T&
+        operator[] (index_type i) const
+        {
+          return stack_[range_ - i];
+        }
+
+      private:
+        const stack& stack_;
+        index_type range_;
+      };
+
+    private:
+#if YY_CPLUSPLUS < 201103L
+      /// Non copyable.
+      stack (const stack&);
+      /// Non copyable.
+      stack& operator= (const stack&);
+#endif
+      /// The wrapped container.
+      S seq_;
     };
 
+
     /// Stack type.
     typedef stack<stack_symbol_type> stack_type;
 
@@ -480,42 +907,39 @@ namespace stream { namespace parsing {
     /// Push a new state on the stack.
     /// \param m    a debug message to display
     ///             if null, no trace is output.
-    /// \param s    the symbol
+    /// \param sym  the symbol
     /// \warning the contents of \a s.value is stolen.
-    void yypush_ (const char* m, stack_symbol_type& s);
+    void yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym);
 
     /// Push a new look ahead token on the state on the stack.
     /// \param m    a debug message to display
     ///             if null, no trace is output.
     /// \param s    the state
     /// \param sym  the symbol (for its value and location).
-    /// \warning the contents of \a s.value is stolen.
-    void yypush_ (const char* m, state_type s, symbol_type& sym);
+    /// \warning the contents of \a sym.value is stolen.
+    void yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym);
 
-    /// Pop \a n symbols the three stacks.
-    void yypop_ (unsigned int n = 1);
+    /// Pop \a n symbols from the stack.
+    void yypop_ (int n = 1) YY_NOEXCEPT;
 
     /// Constants.
     enum
     {
-      yyeof_ = 0,
-      yylast_ = 1216,     ///< Last index in yytable_.
-      yynnts_ = 48,  ///< Number of nonterminal symbols.
-      yyfinal_ = 6, ///< Termination state number.
-      yyterror_ = 1,
-      yyerrcode_ = 256,
-      yyntokens_ = 66  ///< Number of tokens.
+      yylast_ = 1237,     ///< Last index in yytable_.
+      yynnts_ = 50,  ///< Number of nonterminal symbols.
+      yyfinal_ = 6 ///< Termination state number.
     };
 
 
     // User arguments.
     class stream::parsing::driver& driver;
+
   };
 
 
-#line 13 "parser.y" // lalr1.cc:377
+#line 13 "parser.y"
 } } // stream::parsing
-#line 519 "parser.hpp" // lalr1.cc:377
+#line 943 "parser.hpp"
 
 
 
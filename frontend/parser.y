@@ -165,7 +165,10 @@ external_decl:
   { $$ = make_list(ast::input, @$, {$2, $4}); }
   |
   EXTERNAL id ':' type
-  { $$ = make_list(ast::external, @$, {$2, $4}); }
+  { $$ = make_list(ast::external, @$, {$2, $4, nullptr}); }
+  |
+  EXTERNAL id '(' external_attribute_list ')' ':' type
+  { $$ = make_list(ast::external, @$, {$2, $7, $4}); }
   |
   OUTPUT id
   { $$ = make_list(ast::output, @$, {$2, nullptr}); }
@@ -178,6 +181,27 @@ external_decl:
   { $$ = $2; $$->type = ast::output_type; }
 ;
 
+external_attribute_list:
+  external_attribute
+  {
+    $$ = make_list( @$, { $1 } );
+  }
+  |
+  external_attribute_list ',' external_attribute
+  {
+    $$ = $1;
+    $$->as_list()->append( $3 );
+    $$->location = @$;
+  }
+;
+
+external_attribute:
+  id
+  { $$ = make_list( @$, { $1, nullptr } ); }
+  |
+  id '=' expr
+  { $$ = make_list( @$, { $1, $3 } ); }
+;
 
 binding:
   id '=' expr
@@ -811,6 +811,20 @@ expr_ptr polyhedral_gen::visit_func_app(const shared_ptr<func_app> &app)
 
     auto call = make_shared<ph::external_call>();
     call->name = ext->name;
+    call->is_builtin = ext->is_builtin;
+
+    if (ext->is_builtin)
+    {
+        // Functions of the support library only write their result.
+        call->attributes.pure = true;
+        call->attributes.thread_safe = true;
+    }
+    else
+    {
+        call->attributes.pure = ext->is_pure;
+        call->attributes.thread_safe = ext->is_thread_safe;
+        call->attributes.cost = ext->cost;
+    }
 
     for (auto & arg : app->args)
         call->args.push_back(arg);
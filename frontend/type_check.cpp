@@ -113,7 +113,8 @@ string text(primitive_op op, const vector<primitive_type> & args)
     return text.str();
 }
 
-type_checker::type_checker(name_provider & nmp):
+type_checker::type_checker(name_provider & nmp, const options & opt):
+    m_options(opt),
     m_trace("trace"),
     m_name_provider(nmp),
     m_copier(m_ids, nmp),
@@ -124,6 +125,9 @@ type_checker::type_checker(name_provider & nmp):
 
 void type_checker::process(scope & sc)
 {
+    m_top_level_ids.clear();
+    m_top_level_ids.insert(sc.ids.begin(), sc.ids.end());
+
     int pass_count = 3;
     for (m_pass = 1; m_pass <= pass_count; ++m_pass)
     {
@@ -131,9 +135,16 @@ void type_checker::process(scope & sc)
             cout << "--- Type check pass " << m_pass << " ---" << endl;
 
         m_processed_ids.clear();
+        m_reused_id_count = 0;
 
         for (auto & id : sc.ids)
             process(id);
+
+        if (verbose<type_checker>::enabled())
+        {
+            cout << "Ids processed: " << m_processed_ids.size()
+                 << ", results reused: " << m_reused_id_count << endl;
+        }
     }
 }
 
@@ -157,10 +168,66 @@ void type_checker::assign(expr_ptr e, type_ptr t)
     }
 }
 
+static bool has_double_precision(const type_ptr & t)
+{
+    primitive_type p;
+    if (auto s = dynamic_pointer_cast<scalar_type>(t))
+        p = s->primitive;
+    else if (auto a = dynamic_pointer_cast<array_type>(t))
+        p = a->element;
+    else
+        return false;
+    return p == primitive_type::real64 || p == primitive_type::complex64;
+}
+
+bool type_checker::keeps_double_precision(const id_ptr & id)
+{
+    // Ids with an explicit double precision type keep it.
+    if (id->explicit_type && has_double_precision(id->explicit_type))
+        return true;
+
+    // Local ids inherit from the enclosing id.
+    if (!m_top_level_ids.count(id))
+        return !m_keeps_double.empty() && m_keeps_double.top();
+
+    return std::find(m_options.keep_double_precision.begin(),
+                     m_options.keep_double_precision.end(),
+                     id->name) != m_options.keep_double_precision.end();
+}
+
+bool type_checker::in_double_precision_context()
+{
+    // Operands of explicit conversions to double precision keep it,
+    // but ids referenced from them do not.
+    return (!m_keeps_double.empty() && m_keeps_double.top()) ||
+            (!m_in_double_conversion.empty() && m_in_double_conversion.top());
+}
+
+primitive_type type_checker::demoted(primitive_type t)
+{
+    if (!m_options.single_precision)
+        return t;
+
+    if (in_double_precision_context())
+        return t;
+
+    switch(t)
+    {
+    case primitive_type::real64:
+        return primitive_type::real32;
+    case primitive_type::complex64:
+        return primitive_type::complex32;
+    default:
+        return t;
+    }
+}
+
 void type_checker::process(id_ptr id)
 {
     if (m_processed_ids.count(id))
     {
+        ++m_reused_id_count;
+
         if (verbose<type_checker>::enabled())
         {
             cout << "Id already processed: " << id->name << endl;
@@ -196,6 +263,8 @@ void type_checker::process(id_ptr id)
     }
 
     auto processing_id_token = stack_scoped(id, m_processing_ids);
+    auto keeps_double_token = stack_scoped(keeps_double_precision(id), m_keeps_double);
+    auto double_conversion_token = stack_scoped(false, m_in_double_conversion);
 
     id->expr = visit(id->expr);
 
@@ -314,13 +383,33 @@ expr_ptr type_checker::visit_int(const shared_ptr<int_const> & expr)
 
 expr_ptr type_checker::visit_real(const shared_ptr<real_const> & expr)
 {
-    assign(expr, make_shared<scalar_type>(primitive_type::real64));
+    auto t = make_shared<scalar_type>(demoted(primitive_type::real64));
+
+    // The constant may be shared with a context of different precision.
+    if (m_pass < 3 && expr->type && *expr->type != *t)
+    {
+        auto result = make_node<real_const>(*expr);
+        assign(result, t);
+        return result;
+    }
+
+    assign(expr, t);
     return expr;
 }
 
 expr_ptr type_checker::visit_complex(const shared_ptr<complex_const> & expr)
 {
-    assign(expr, make_shared<scalar_type>(primitive_type::complex64));
+    auto t = make_shared<scalar_type>(demoted(primitive_type::complex64));
+
+    // The constant may be shared with a context of different precision.
+    if (m_pass < 3 && expr->type && *expr->type != *t)
+    {
+        auto result = make_node<complex_const>(*expr);
+        assign(result, t);
+        return result;
+    }
+
+    assign(expr, t);
     return expr;
 }
 
@@ -390,6 +479,18 @@ expr_ptr type_checker::visit_ref(const shared_ptr<reference> & ref)
                      << " is constant - using the value instead."
                      << endl;
             }
+
+            // A constant which was demoted with its id keeps
+            // double precision where it is used with double precision.
+            if (m_options.single_precision && !id->explicit_type &&
+                    in_double_precision_context())
+            {
+                if (auto r = dynamic_pointer_cast<real_const>(id->expr.expr))
+                    return visit(make_shared<real_const>(r->value, ref->location));
+                if (auto c = dynamic_pointer_cast<complex_const>(id->expr.expr))
+                    return visit(make_shared<complex_const>(c->value, ref->location));
+            }
+
             return id->expr;
         }
 
@@ -416,9 +517,19 @@ expr_ptr type_checker::visit_primitive(const shared_ptr<primitive> & prim)
     assert(prim);
 #endif
 
-    for (auto & operand : prim->operands)
+    bool is_double_conversion =
+            prim->kind == primitive_op::to_real64 ||
+            prim->kind == primitive_op::to_complex64;
+
     {
-        operand = visit(operand);
+        bool in_conversion = is_double_conversion ||
+                (!m_in_double_conversion.empty() && m_in_double_conversion.top());
+        auto double_conversion_token = stack_scoped(in_conversion, m_in_double_conversion);
+
+        for (auto & operand : prim->operands)
+        {
+            operand = visit(operand);
+        }
     }
 
     {
@@ -466,6 +577,9 @@ expr_ptr type_checker::visit_primitive(const shared_ptr<primitive> & prim)
 
     try {
         result_elem_type = result_type(prim->kind, elem_types);
+        // Explicit conversions keep the requested precision.
+        if (!is_double_conversion)
+            result_elem_type = demoted(result_elem_type);
     }
     catch (no_type &)
     {
@@ -1328,6 +1442,21 @@ expr_ptr type_checker::visit_external(const shared_ptr<external> & ext)
         }
     }
 
+    if (ext->cost_expr)
+    {
+        ext->cost_expr = visit(ext->cost_expr);
+
+        auto ci = dynamic_pointer_cast<int_const>(ext->cost_expr.expr);
+        if (!ci || ci->signed_value() < 0)
+        {
+            throw type_error("Cost of external function must be"
+                             " a non-negative integer constant.",
+                             ext->cost_expr.location);
+        }
+
+        ext->cost = ci->signed_value();
+    }
+
     assign(ext, type);
 
     return ext;
@@ -1427,6 +1556,12 @@ expr_ptr type_checker::visit_func(const shared_ptr<function> & func)
 
 expr_ptr type_checker::visit_func_app(const shared_ptr<func_app> & app)
 {
+    if (auto ext = dynamic_pointer_cast<external>(app->object.expr))
+    {
+        if (ext->is_builtin)
+            return visit_builtin_app(app, ext);
+    }
+
     app->object = visit(app->object);
 
     auto func_type = dynamic_pointer_cast<function_type>(app->object->type);
@@ -1473,6 +1608,91 @@ expr_ptr type_checker::visit_func_app(const shared_ptr<func_app> & app)
     return app;
 }
 
+// Built-in functions:
+// fft, ifft: [N]T -> [N]C
+// rfft: [N]R -> [N/2+1]C
+// N must be a power of two and at least 2.
+// T is real or complex, R is real,
+// and C is the complex type with the same precision as T or R.
+
+expr_ptr type_checker::visit_builtin_app(const shared_ptr<func_app> & app,
+                                         const shared_ptr<external> & ext)
+{
+    auto & args = app->args;
+
+    for (auto & arg : args)
+    {
+        arg = visit(arg);
+    }
+
+    if (args.size() != 1)
+    {
+        ostringstream msg;
+        msg << "Wrong number of arguments in function application: "
+            << "1 expected, " << args.size() << " given.";
+        throw type_error(msg.str(), app->location);
+    }
+
+    auto & arg = args[0];
+
+    if (arg->type->is_undefined())
+    {
+        assign(app, make_shared<scalar_type>(primitive_type::undefined));
+        return app;
+    }
+
+    auto arg_type = dynamic_pointer_cast<array_type>(arg->type);
+    if (!arg_type || arg_type->size.size() != 1 || arg_type->is_infinite())
+    {
+        throw type_error("Argument of " + ext->name +
+                         " must be a finite one-dimensional array.",
+                         arg.location);
+    }
+
+    int size = arg_type->size[0];
+    if (size < 2 || (size & (size - 1)) != 0)
+    {
+        throw type_error("Size of argument of " + ext->name +
+                         " must be a power of two and at least 2.",
+                         arg.location);
+    }
+
+    auto elem_type = arg_type->element;
+    bool is_real_input = is_real(elem_type);
+
+    if (!is_real_input && !is_complex(elem_type))
+    {
+        throw type_error("Elements of argument of " + ext->name +
+                         " must be real or complex.", arg.location);
+    }
+
+    if (ext->name == "rfft")
+    {
+        if (!is_real_input)
+        {
+            throw type_error("Elements of argument of rfft must be real.",
+                             arg.location);
+        }
+        size = size / 2 + 1;
+    }
+
+    bool single = elem_type == primitive_type::real32 ||
+            elem_type == primitive_type::complex32;
+    auto result_elem_type = single ? primitive_type::complex32
+                                   : primitive_type::complex64;
+
+    auto result_type = make_shared<array_type>(array_size_vec{size}, result_elem_type);
+
+    auto func_type = make_shared<function_type>();
+    func_type->params.push_back(arg_type);
+    func_type->value = result_type;
+    ext->type = func_type;
+
+    assign(app, result_type);
+
+    return app;
+}
+
 expr_ptr type_checker::visit_scope(const shared_ptr<scope_expr> &scope)
 {
     for (auto & id : scope->local.ids)
@@ -26,7 +26,16 @@ class type_checker : public rewriter_base
     // outside the array to which the var belongs.
 
 public:
-    type_checker(name_provider &);
+    struct options
+    {
+        // Demote real64 and complex64 computations to 32 bits,
+        // except in explicit conversions, in ids with an explicit type,
+        // and in top-level ids with given names and their local ids.
+        bool single_precision = false;
+        vector<string> keep_double_precision;
+    };
+
+    type_checker(name_provider &, const options &);
 
     unordered_set<id_ptr> & ids() { return m_ids; }
 
@@ -68,11 +77,16 @@ private:
     expr_ptr visit_func_type(const shared_ptr<func_type_expr> &) override;
     expr_ptr visit_func(const shared_ptr<function> & func) override;
     expr_ptr visit_func_app(const shared_ptr<func_app> & app) override;
+    expr_ptr visit_builtin_app(const shared_ptr<func_app> & app, const shared_ptr<external> &);
     expr_ptr visit_scope(const shared_ptr<scope_expr> &scope) override;
     expr_ptr lambda_lift(expr_ptr, const string & name);
 
     void assign(expr_ptr, type_ptr);
 
+    primitive_type demoted(primitive_type);
+    bool keeps_double_precision(const id_ptr &);
+    bool in_double_precision_context();
+
     source_error
     type_error(const string & msg, const location_type & loc)
     {
@@ -82,10 +96,15 @@ private:
     using processing_id_stack_type = stack_adapter<deque<id_ptr>>;
     using array_var_stack_type = stack_adapter<deque<array_var_ptr>>;
 
+    options m_options;
     int m_pass = 0;
     tracing_stack<location_type> m_trace;
     processing_id_stack_type m_processing_ids;
+    stack_adapter<deque<bool>> m_keeps_double;
+    stack_adapter<deque<bool>> m_in_double_conversion;
+    unordered_set<id_ptr> m_top_level_ids;
     unordered_set<id_ptr> m_processed_ids;
+    int m_reused_id_count = 0;
     unordered_set<void*> m_processed_refs;
 
     bool m_force_revisit = false;
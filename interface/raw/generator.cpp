@@ -177,7 +177,10 @@ void generate
 
     ostringstream io_text;
     io_text << "namespace arrp { namespace generic_io {" << endl;
-    io_text << "struct Generated_IO {" << endl;
+    io_text << "struct Generated_IO";
+    if (!options.externals_header.empty())
+        io_text << " : External_Functions";
+    io_text << " {" << endl;
 
     io_text << "static const bool has_period = " << (has_period ? "true" : "false") << ";" << endl;
 
@@ -225,6 +228,8 @@ void generate
     {
         ofstream file(main_cpp_file_name);
         file << "#include <arrp/generic_io/interface.h>" << endl;
+        if (!options.externals_header.empty())
+            file << "#include \"" << options.externals_header << "\"" << endl;
         file << "#include \"" << io_cpp_file_name << "\"" << endl;
         file << "#include \"" << kernel_file_name << "\"" << endl;
         file << "using Generated_Kernel = " << kernel_namespace
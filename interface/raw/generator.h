@@ -14,6 +14,9 @@ struct log {};
 struct options
 {
     std::string base_file_name;
+    // Header which defines struct arrp::generic_io::External_Functions
+    // with the external functions called by the program.
+    std::string externals_header;
 };
 
 void generate(const options &, const nlohmann::json & report);
@@ -3,6 +3,11 @@
 #include <arrp/arguments/arguments.hpp>
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <unordered_set>
 
 using namespace std;
 using namespace arrp::generic_io;
@@ -12,8 +17,115 @@ struct Options
     string default_channel_format = "text";
     int max_buffer_size = 1024;
     unordered_map<string, string> channel_options;
+    // Files mapped as inputs, by input name.
+    unordered_map<string, string> mapped_inputs;
+    // Outputs deactivated in programs compiled with --output-selection.
+    unordered_set<string> inactive_outputs;
+    string counters_file;
+    bool snapshot_prelude = false;
 };
 
+// Prints counters of programs compiled with --instrument.
+
+template <typename K>
+static auto print_instrumentation(const K & kernel, const Options & options, int)
+-> decltype(kernel.print_instrumentation(cerr), void())
+{
+    if (options.counters_file.empty())
+    {
+        kernel.print_instrumentation(cerr);
+        return;
+    }
+
+    ofstream file(options.counters_file);
+    if (!file.is_open())
+    {
+        cerr << "Could not open counters file: " << options.counters_file << endl;
+        return;
+    }
+    kernel.print_instrumentation(file);
+}
+
+template <typename K>
+static void print_instrumentation(const K &, const Options &, long) {}
+
+// Maps input files of programs compiled with --mapped-input.
+
+template <typename K>
+static auto map_inputs(K & kernel, const Options & options, int)
+-> decltype(kernel.map_input("", ""), bool())
+{
+    for (auto & entry : options.mapped_inputs)
+    {
+        bool ok;
+        try { ok = kernel.map_input(entry.first.c_str(), entry.second.c_str()); }
+        catch (std::exception & e)
+        {
+            cerr << "Error: " << e.what() << endl;
+            return false;
+        }
+        if (!ok)
+        {
+            cerr << "Error: Input " << entry.first << " can not be mapped"
+                 << " (compile with --mapped-input " << entry.first << ")." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename K>
+static bool map_inputs(K &, const Options & options, long)
+{
+    for (auto & entry : options.mapped_inputs)
+    {
+        cerr << "Error: Input " << entry.first << " can not be mapped"
+             << " (compile with --mapped-input " << entry.first << ")." << endl;
+    }
+    return options.mapped_inputs.empty();
+}
+
+// Deactivates outputs of programs compiled with --output-selection.
+
+template <typename K>
+static auto select_outputs(K & kernel, const Options & options, int)
+-> decltype(kernel.set_output_active("", true), bool())
+{
+    for (auto & name : options.inactive_outputs)
+        kernel.set_output_active(name.c_str(), false);
+    return true;
+}
+
+template <typename K>
+static bool select_outputs(K &, const Options & options, long)
+{
+    if (!options.inactive_outputs.empty())
+    {
+        cerr << "Error: Outputs can not be deactivated"
+             << " (compile with --output-selection)." << endl;
+    }
+    return options.inactive_outputs.empty();
+}
+
+// Runs the prelude on a separate instance with the same IO,
+// and restores the given instance from a snapshot of its state.
+
+template <typename K>
+static bool run_prelude_from_snapshot(K & kernel, const Options & options)
+{
+    auto source = std::make_unique<K>();
+    source->io = kernel.io;
+    if (!map_inputs(*source, options, 0))
+        return false;
+    source->prelude();
+
+    vector<unsigned char> data(K::snapshot_size());
+    if (source->snapshot(data.data(), data.size()) != data.size())
+        return false;
+
+    return kernel.restore(data.data(), data.size());
+}
+
 static void print_actual_channel_config(ActualChannelConfig config)
 {
     cerr << config.type;
@@ -32,7 +144,7 @@ struct Config
     Config(const Options & options, Generated_IO & io)
     {
         single_input_stream = find_singular_stream(io.input_managers);
-        single_output_stream = find_singular_stream(io.output_managers);
+        single_output_stream = find_singular_stream(io.output_managers, options.inactive_outputs);
 
         for(auto & entry : io.input_managers)
         {
@@ -73,15 +185,24 @@ struct Config
     }
 
 private:
-    string find_singular_stream(const ChannelManagerMap & managers)
+    string find_singular_stream(const ChannelManagerMap & managers,
+                                const unordered_set<string> & ignored = unordered_set<string>())
     {
         // If there's only one channel, use it even if it is not a stream:
-        if (managers.size() == 1)
-            return managers.begin()->first;
+        if (managers.size() - ignored.size() == 1)
+        {
+            for(const auto & entry : managers)
+            {
+                if (!ignored.count(entry.first))
+                    return entry.first;
+            }
+        }
 
         string name;
         for(const auto & entry : managers)
         {
+            if (ignored.count(entry.first))
+                continue;
             const auto & manager = entry.second;
             if (manager->is_stream())
             {
@@ -107,6 +228,12 @@ private:
     {
         ChannelConfig config;
 
+        if (options.mapped_inputs.count(name))
+        {
+            cerr << "Input " << name << ": mapped from " << options.mapped_inputs.at(name) << endl;
+            return false;
+        }
+
         string channel_options;
         if (options.channel_options.count(name))
             channel_options = options.channel_options.at(name);
@@ -224,10 +351,22 @@ void print_help(Generated_IO & io)
     cerr << "    ... Use this format for inputs and outputs without explicit format." << endl;
     cerr << "  -b=<size> or --buffer=<size>" << endl;
     cerr << "    ... Maximum amount of buffered data for inputs and outputs." << endl;
+    cerr << "  --counters=<file>" << endl;
+    cerr << "    ... Write instrumentation counters to file instead of stderr"
+            " (if program is compiled with --instrument)." << endl;
+    cerr << "  --outputs=<output>[,<output>...]" << endl;
+    cerr << "    ... Only compute these outputs and write the others to /dev/null,"
+            " unless specified otherwise (if program is compiled with --output-selection)." << endl;
+    cerr << "  --snapshot-prelude" << endl;
+    cerr << "    ... Run the prelude on a separate program instance"
+            " and restore this one from its snapshot." << endl;
     cerr << "  <input>=<value>" << endl;
     cerr << "    ... Define input value." << endl;
     cerr << "  <input>=<source>[:<format>]" << endl;
     cerr << "    ... Read input from source with given format." << endl;
+    cerr << "  <input>=<filename>:mapped" << endl;
+    cerr << "    ... Map input from file with raw contents"
+            " (if program is compiled with --mapped-input <input>)." << endl;
     cerr << "  <output>=<destination>[:<format>]" << endl;
     cerr << "    ... Write output to destination with given format." << endl;;
 
@@ -260,6 +399,7 @@ int main(int argc, char *argv[])
 
     Options options;
     bool help_requested = false;
+    string active_outputs;
 
     Arguments::Parser parser;
 
@@ -279,6 +419,9 @@ int main(int argc, char *argv[])
     parser.add_option("--format", options.default_channel_format);
     parser.add_option("-b", options.max_buffer_size);
     parser.add_option("--buffer", options.max_buffer_size);
+    parser.add_option("--counters", options.counters_file);
+    parser.add_option("--outputs", active_outputs);
+    parser.add_switch("--snapshot-prelude", options.snapshot_prelude);
     parser.add_switch("-h", help_requested);
     parser.add_switch("--help", help_requested);
 
@@ -295,6 +438,46 @@ int main(int argc, char *argv[])
         return 0;
     }
 
+    for(auto & entry : io.input_managers)
+    {
+        auto & name = entry.first;
+        auto & text = options.channel_options[name];
+        const string suffix = ":mapped";
+        if (text.size() > suffix.size() &&
+                text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            options.mapped_inputs[name] = text.substr(0, text.size() - suffix.size());
+            text.clear();
+        }
+    }
+
+    if (!active_outputs.empty())
+    {
+        unordered_set<string> active;
+        istringstream names(active_outputs);
+        string name;
+        while (getline(names, name, ','))
+        {
+            if (!io.output_managers.count(name))
+            {
+                cerr << "Error: Unknown output: " << name << endl;
+                return 1;
+            }
+            active.insert(name);
+        }
+
+        for(auto & entry : io.output_managers)
+        {
+            auto & name = entry.first;
+            if (active.count(name))
+                continue;
+            options.inactive_outputs.insert(name);
+            auto & text = options.channel_options[name];
+            if (text.empty())
+                text = "/dev/null:raw";
+        }
+    }
+
     try { Config config(options, io); }
     catch (std::exception & e)
     {
@@ -307,7 +490,24 @@ int main(int argc, char *argv[])
 
     try
     {
-        kernel.prelude();
+        if (!map_inputs(kernel, options, 0))
+            return 1;
+
+        if (!select_outputs(kernel, options, 0))
+            return 1;
+
+        if (options.snapshot_prelude)
+        {
+            if (!run_prelude_from_snapshot(kernel, options))
+            {
+                cerr << "Error: Failed to restore program from snapshot." << endl;
+                return 1;
+            }
+        }
+        else
+        {
+            kernel.prelude();
+        }
 
         if (io.has_period)
         {
@@ -324,7 +524,13 @@ int main(int argc, char *argv[])
             ok &= report_stream_error(*entry.second->stream(), entry.first);
         for(auto & entry : io.output_managers)
             ok &= report_stream_error(*entry.second->stream(), entry.first);
+
+        print_instrumentation(kernel, options, 0);
+
         if (!ok)
             return 1;
+        return 0;
     }
+
+    print_instrumentation(kernel, options, 0);
 }
@@ -0,0 +1,368 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "cache_analysis.hpp"
+#include "../common/error.hpp"
+
+#include <isl-cpp/space.hpp>
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+#include <isl-cpp/union_map.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+cache_analysis::cache_analysis(const model & m, const vector<int64_t> & cache_sizes):
+    m_model(m),
+    m_cache_sizes(cache_sizes)
+{}
+
+int cache_analysis::fitting_level(int64_t bytes) const
+{
+    if (bytes < 0)
+        return 0;
+
+    for (int level = 0; level < (int) m_cache_sizes.size(); ++level)
+    {
+        if (bytes <= m_cache_sizes[level])
+            return level + 1;
+    }
+
+    return 0;
+}
+
+vector<cache_analysis::access_schedule>
+cache_analysis::access_schedules(const isl::union_map & schedule, isl::space & sched_space)
+{
+    vector<access_schedule> result;
+
+    sched_space = isl::space(nullptr);
+    schedule.for_each([&](const isl::map & m){
+        sched_space = m.get_space().range();
+        return false;
+    });
+
+    if (!sched_space.is_valid())
+        return result;
+
+    isl::union_map accesses(m_model.context);
+    for (auto & stmt : m_model.statements)
+    {
+        for (auto & access : stmt->array_accesses)
+            accesses |= access->map.in_domain(stmt->domain);
+    }
+
+    auto access_sched = schedule;
+    access_sched.map_domain_through(accesses);
+
+    for (auto & array : m_model.arrays)
+    {
+        auto space = isl::space::from(array->domain.get_space(), sched_space);
+        auto m = access_sched.map_for(space).in_domain(array->domain);
+        if (m.is_empty())
+            continue;
+        result.push_back({ array, m });
+    }
+
+    return result;
+}
+
+isl::basic_map cache_analysis::same_outer_iterations(const isl::space & sched_space, int depth)
+{
+    auto relation = isl::basic_map::universe(isl::space::from(sched_space, sched_space));
+    for (int dim = 0; dim < depth; ++dim)
+    {
+        auto space = relation.get_space();
+        relation.add_constraint(space.in(dim) == space.out(dim));
+    }
+    return relation;
+}
+
+int64_t cache_analysis::footprint
+(const vector<access_schedule> & accesses, const isl::basic_map & time_relation)
+{
+    int64_t bytes = 0;
+
+    for (auto & access : accesses)
+    {
+        // Pairs of elements accessed at related times
+
+        auto pairs = access.map.cross(access.map)
+                .in_range(time_relation.wrapped()).domain().unwrapped();
+
+        if (pairs.is_empty())
+            continue;
+
+        auto deltas = pairs.deltas();
+
+        int64_t elements = 1;
+
+        for (int dim = 0; dim < deltas.dimensions(); ++dim)
+        {
+            auto max = deltas.maximum(deltas.get_space().var(dim));
+            if (!max.is_integer())
+                return -1;
+            elements *= int64_t(max.integer()) + 1;
+        }
+
+        if (!access.array->buffer_size.empty())
+        {
+            int64_t buffer_elements = 1;
+            for (auto s : access.array->buffer_size)
+                buffer_elements *= s;
+            elements = std::min(elements, buffer_elements);
+        }
+
+        bytes += elements * size_in_bytes(access.array->type);
+    }
+
+    return bytes;
+}
+
+bool cache_analysis::has_reuse
+(const vector<access_schedule> & accesses, const isl::basic_map & time_relation)
+{
+    for (auto & access : accesses)
+    {
+        auto pairs = access.map.cross(access.map)
+                .in_range(time_relation.wrapped()).domain().unwrapped();
+
+        auto space = pairs.get_space();
+        int dim_count = space.dimension(isl::space::input);
+        for (int dim = 0; dim < dim_count; ++dim)
+            pairs.add_constraint(space.in(dim) == space.out(dim));
+
+        if (!pairs.is_empty())
+            return true;
+    }
+
+    return false;
+}
+
+vector<cache_analysis::loop_level>
+cache_analysis::loop_levels(const isl::union_map & schedule)
+{
+    vector<loop_level> levels;
+
+    isl::space sched_space(nullptr);
+    auto accesses = access_schedules(schedule, sched_space);
+    if (accesses.empty())
+        return levels;
+
+    int depth_count = sched_space.dimension(isl::space::variable);
+
+    int64_t outer_footprint = footprint(accesses, same_outer_iterations(sched_space, 0));
+
+    for (int depth = 0; depth < depth_count; ++depth)
+    {
+        loop_level level;
+        level.depth = depth;
+        level.footprint = outer_footprint;
+        level.reuse_distance =
+                footprint(accesses, same_outer_iterations(sched_space, depth + 1));
+
+        auto later_iteration = same_outer_iterations(sched_space, depth);
+        {
+            auto space = later_iteration.get_space();
+            later_iteration.add_constraint(space.in(depth) < space.out(depth));
+        }
+        level.carries_reuse = has_reuse(accesses, later_iteration);
+
+        if (verbose<cache_analysis>::enabled())
+        {
+            cout << "Loop depth " << depth << ":"
+                 << " footprint = " << level.footprint
+                 << ", reuse distance = " << level.reuse_distance
+                 << ", carries reuse = " << level.carries_reuse
+                 << endl;
+        }
+
+        levels.push_back(level);
+
+        outer_footprint = level.reuse_distance;
+    }
+
+    return levels;
+}
+
+cache_analysis::tile_suggestion
+cache_analysis::suggest_tile_size(const isl::union_map & schedule, int cache_level)
+{
+    if (cache_level < 1 || cache_level > (int) m_cache_sizes.size())
+        throw error("Invalid cache level: " + to_string(cache_level));
+
+    int64_t capacity = m_cache_sizes[cache_level-1];
+
+    tile_suggestion result;
+
+    isl::space sched_space(nullptr);
+    auto accesses = access_schedules(schedule, sched_space);
+    if (accesses.empty())
+    {
+        result.problem = "The program does not access any arrays.";
+        return result;
+    }
+
+    int dim_count = sched_space.dimension(isl::space::variable);
+
+    // Dimensions which are constant for each statement
+    // represent sequencing of statements and are not tiled.
+    // The extent of other dimensions limits their tile size.
+
+    vector<bool> is_constant(dim_count, true);
+    vector<int64_t> extent(dim_count, 0);
+
+    schedule.for_each([&](const isl::map & m){
+        auto times = m.range();
+        for (int dim = 0; dim < dim_count; ++dim)
+        {
+            auto min = times.minimum(times.get_space().var(dim));
+            auto max = times.maximum(times.get_space().var(dim));
+            if (!min.is_integer() || !max.is_integer())
+            {
+                is_constant[dim] = false;
+                extent[dim] = -1;
+                continue;
+            }
+            if (min.integer() != max.integer())
+                is_constant[dim] = false;
+            if (extent[dim] >= 0)
+            {
+                extent[dim] = std::max(extent[dim],
+                                       int64_t(max.integer()) - int64_t(min.integer()) + 1);
+            }
+        }
+        return true;
+    });
+
+    vector<int> tiled_dims;
+    for (int dim = 0; dim < dim_count; ++dim)
+    {
+        if (!is_constant[dim])
+            tiled_dims.push_back(dim);
+    }
+
+    if (tiled_dims.empty())
+    {
+        result.problem = "The schedule has no dimensions to tile.";
+        return result;
+    }
+
+    auto tile_footprint = [&](const vector<int> & size)
+    {
+        auto relation = isl::basic_map::universe(isl::space::from(sched_space, sched_space));
+        auto space = relation.get_space();
+        for (int dim = 0; dim < dim_count; ++dim)
+        {
+            if (is_constant[dim])
+            {
+                relation.add_constraint(space.in(dim) == space.out(dim));
+            }
+            else
+            {
+                relation.add_constraint(space.out(dim) - space.in(dim) < size[dim]);
+                relation.add_constraint(space.in(dim) - space.out(dim) < size[dim]);
+            }
+        }
+        return footprint(accesses, relation);
+    };
+
+    auto fits = [&](int64_t bytes) { return bytes >= 0 && bytes <= capacity; };
+
+    // Start with tiles of single iterations, and grow the tile size
+    // of each dimension separately, from the innermost dimension,
+    // while the tile fits. This allows different sizes for dimensions
+    // with different reuse.
+
+    const int max_size = 1 << 10;
+
+    vector<int> size(dim_count, 1);
+
+    int64_t bytes = tile_footprint(size);
+    if (bytes < 0)
+    {
+        result.problem = "The data accessed by a single iteration is unbounded.";
+        return result;
+    }
+    if (bytes > capacity)
+    {
+        ostringstream msg;
+        msg << "A single iteration accesses " << bytes
+            << " bytes, more than the capacity of " << capacity << " bytes.";
+        result.problem = msg.str();
+        return result;
+    }
+
+    bool grown = true;
+    while (grown)
+    {
+        grown = false;
+
+        for (auto dim_it = tiled_dims.rbegin(); dim_it != tiled_dims.rend(); ++dim_it)
+        {
+            int dim = *dim_it;
+
+            if (size[dim] >= max_size)
+                continue;
+            if (extent[dim] >= 0 && size[dim] >= extent[dim])
+                continue;
+
+            auto larger = size;
+            larger[dim] *= 2;
+
+            auto larger_bytes = tile_footprint(larger);
+
+            if (verbose<cache_analysis>::enabled())
+            {
+                cout << "Tile size";
+                for (auto d : tiled_dims)
+                    cout << " " << larger[d];
+                cout << ": footprint = " << larger_bytes << endl;
+            }
+
+            if (fits(larger_bytes))
+            {
+                size = larger;
+                grown = true;
+            }
+        }
+    }
+
+    for (auto dim : tiled_dims)
+        result.size.push_back(size[dim]);
+
+    if (std::all_of(result.size.begin(), result.size.end(), [](int s){ return s == 1; }))
+    {
+        result.size.clear();
+        result.problem = "No tile of more than one iteration fits.";
+    }
+
+    return result;
+}
+
+}
+}
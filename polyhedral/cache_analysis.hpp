@@ -0,0 +1,105 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef STREAM_LANG_POLYHEDRAL_CACHE_ANALYSIS_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_CACHE_ANALYSIS_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <cstdint>
+
+namespace stream {
+namespace polyhedral {
+
+// Estimates the amount of data accessed by loops of a schedule,
+// to predict which level of a cache hierarchy holds their working set.
+//
+// The footprint of an array in a loop is estimated as the bounding box
+// of elements accessed by any pair of statement instances
+// which share the iterations of the enclosing loops.
+// This is computed with integer programming on the access relations,
+// so it does not require enumerating instances.
+// Footprints are limited by buffer sizes, if those are known.
+
+class cache_analysis
+{
+public:
+    struct loop_level
+    {
+        int depth = 0;
+        // Bytes accessed by all iterations of the loop,
+        // for one iteration of enclosing loops, or -1 if unbounded.
+        int64_t footprint = 0;
+        // Bytes accessed by one iteration of the loop.
+        // Data reused by different iterations needs to stay in cache
+        // while this amount of other data is accessed.
+        int64_t reuse_distance = 0;
+        // Whether different iterations of the loop access the same data.
+        bool carries_reuse = false;
+    };
+
+    // Cache sizes in bytes, from the innermost level.
+    cache_analysis(const model &, const vector<int64_t> & cache_sizes);
+
+    vector<loop_level> loop_levels(const isl::union_map & schedule);
+
+    struct tile_suggestion
+    {
+        // Tile sizes of the non-constant schedule dimensions,
+        // or empty if no tiling fits.
+        vector<int> size;
+        // Why no tiling fits.
+        string problem;
+    };
+
+    // Suggests tile sizes for the non-constant dimensions
+    // of the given schedule, so that the footprint of a tile
+    // fits into the given cache level (counting from 1).
+    // Tile sizes are powers of two, chosen separately for each dimension.
+    tile_suggestion suggest_tile_size(const isl::union_map & schedule, int cache_level);
+
+    // Innermost cache level (counting from 1) which holds given number of bytes,
+    // or 0 if none.
+    int fitting_level(int64_t bytes) const;
+
+private:
+    struct access_schedule
+    {
+        array_ptr array;
+        // Array elements to times of access.
+        isl::map map { nullptr };
+    };
+
+    vector<access_schedule> access_schedules(const isl::union_map & schedule,
+                                             isl::space & sched_space);
+    int64_t footprint(const vector<access_schedule> &, const isl::basic_map & time_relation);
+    bool has_reuse(const vector<access_schedule> &, const isl::basic_map & time_relation);
+    isl::basic_map same_outer_iterations(const isl::space & sched_space, int depth);
+
+    const model & m_model;
+    vector<int64_t> m_cache_sizes;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_CACHE_ANALYSIS_INCLUDED
@@ -0,0 +1,1165 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "constant_arrays.hpp"
+#include "../common/error.hpp"
+#include "../compiler/report.hpp"
+
+#include <isl/set.h>
+#include <isl/point.h>
+#include <isl/val.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+using value = constant_array_evaluation::value;
+using not_constant = constant_array_evaluation::not_constant;
+using pt = primitive_type;
+
+// Maximum number of statement instances interpreted per array.
+static const int64_t max_instance_count = 1 << 22;
+
+static primitive_type prim_type(const functional::expression * e)
+{
+    auto scalar = dynamic_pointer_cast<functional::scalar_type>(e->type);
+    if (!scalar)
+        throw not_constant();
+    return scalar->primitive;
+}
+
+static primitive_type prim_type(const expr_ptr & e)
+{
+    return prim_type(e.get());
+}
+
+static int bit_count(primitive_type t)
+{
+    switch(t)
+    {
+    case pt::int8:
+    case pt::uint8:
+        return 8;
+    case pt::int16:
+    case pt::uint16:
+        return 16;
+    case pt::int32:
+    case pt::uint32:
+        return 32;
+    default:
+        return 64;
+    }
+}
+
+// Sign-extends or truncates to the size of an integer type.
+
+static uint64_t wrapped(primitive_type t, uint64_t bits)
+{
+    switch(t)
+    {
+    case pt::boolean:
+        return bits != 0;
+    case pt::int8:
+        return uint64_t(int64_t(int8_t(bits)));
+    case pt::uint8:
+        return uint8_t(bits);
+    case pt::int16:
+        return uint64_t(int64_t(int16_t(bits)));
+    case pt::uint16:
+        return uint16_t(bits);
+    case pt::int32:
+        return uint64_t(int64_t(int32_t(bits)));
+    case pt::uint32:
+        return uint32_t(bits);
+    default:
+        return bits;
+    }
+}
+
+static bool is_integral(primitive_type t)
+{
+    return t == pt::boolean || is_integer(t);
+}
+
+static value make_int(primitive_type t, uint64_t bits)
+{
+    value v;
+    v.type = t;
+    v.bits = wrapped(t, bits);
+    return v;
+}
+
+static value make_real(primitive_type t, double x)
+{
+    value v;
+    v.type = t;
+    v.number = t == pt::real32 ? double(float(x)) : x;
+    return v;
+}
+
+static value make_complex(primitive_type t, std::complex<double> c)
+{
+    value v;
+    v.type = t;
+    if (t == pt::complex32)
+        v.number = std::complex<double>(float(c.real()), float(c.imag()));
+    else
+        v.number = c;
+    return v;
+}
+
+static primitive_type component_of(primitive_type t)
+{
+    return t == pt::complex32 ? pt::real32 : pt::real64;
+}
+
+// Value of an integer or real number as a real number of type t,
+// converted directly from integers like C++ does.
+
+static double real_value(const value & v, primitive_type t = pt::real64)
+{
+    if (is_integral(v.type))
+    {
+        bool is_signed = is_signed_int(v.type);
+        if (t == pt::real32)
+            return is_signed ? float(int64_t(v.bits)) : float(v.bits);
+        return is_signed ? double(int64_t(v.bits)) : double(v.bits);
+    }
+    if (is_real(v.type))
+        return t == pt::real32 ? double(float(v.number.real())) : v.number.real();
+    throw not_constant();
+}
+
+// Conversion like static_cast in C++.
+// Conversions with undefined results are not evaluated.
+
+static value convert(const value & v, primitive_type t)
+{
+    if (v.type == t)
+        return v;
+
+    if (t == pt::boolean)
+    {
+        if (is_complex(v.type))
+            throw not_constant();
+        if (is_real(v.type))
+            return make_int(t, v.number.real() != 0);
+        return make_int(t, v.bits);
+    }
+
+    if (is_integer(t))
+    {
+        if (is_integral(v.type))
+            return make_int(t, v.bits);
+
+        if (!is_real(v.type))
+            throw not_constant();
+
+        double x = std::trunc(v.number.real());
+        int bits = bit_count(t);
+        double lower = is_signed_int(t) ? -std::ldexp(1.0, bits - 1) : 0;
+        double upper = std::ldexp(1.0, is_signed_int(t) ? bits - 1 : bits);
+        if (!(x >= lower && x < upper))
+            throw not_constant();
+
+        if (is_signed_int(t))
+            return make_int(t, uint64_t(int64_t(x)));
+        else
+            return make_int(t, uint64_t(x));
+    }
+
+    if (is_real(t))
+        return make_real(t, real_value(v, t));
+
+    if (is_complex(t))
+    {
+        if (is_complex(v.type))
+            return make_complex(t, v.number);
+        return make_complex(t, real_value(v, component_of(t)));
+    }
+
+    throw not_constant();
+}
+
+static bool truth(const value & v)
+{
+    return convert(v, pt::boolean).bits != 0;
+}
+
+// Types used for arithmetic by C++
+
+static primitive_type promoted(primitive_type t)
+{
+    switch(t)
+    {
+    case pt::boolean:
+    case pt::int8:
+    case pt::uint8:
+    case pt::int16:
+    case pt::uint16:
+        return pt::int32;
+    default:
+        return t;
+    }
+}
+
+static primitive_type common_type(primitive_type a, primitive_type b)
+{
+    if (is_complex(a) || is_complex(b))
+    {
+        if (a == pt::complex64 || b == pt::complex64 || a == pt::real64 || b == pt::real64)
+            return pt::complex64;
+        return pt::complex32;
+    }
+
+    if (a == pt::real64 || b == pt::real64)
+        return pt::real64;
+    if (a == pt::real32 || b == pt::real32)
+        return pt::real32;
+
+    a = promoted(a);
+    b = promoted(b);
+    if (a == b)
+        return a;
+
+    int a_bits = bit_count(a);
+    int b_bits = bit_count(b);
+    if (a_bits != b_bits)
+        return a_bits > b_bits ? a : b;
+
+    // Same size, one of them unsigned
+    return a_bits == 64 ? pt::uint64 : pt::uint32;
+}
+
+template <typename R, typename A, typename B>
+static R arithmetic_op(primitive_op op, A a, B b)
+{
+    switch(op)
+    {
+    case primitive_op::add:
+        return a + b;
+    case primitive_op::subtract:
+        return a - b;
+    case primitive_op::multiply:
+        return a * b;
+    case primitive_op::divide:
+        return a / b;
+    default:
+        throw not_constant();
+    }
+}
+
+static value integer_arithmetic(primitive_op op, const value & a, const value & b)
+{
+    auto t = a.type;
+    bool is_signed = is_signed_int(t);
+
+    switch(op)
+    {
+    case primitive_op::add:
+        return make_int(t, a.bits + b.bits);
+    case primitive_op::subtract:
+        return make_int(t, a.bits - b.bits);
+    case primitive_op::multiply:
+        return make_int(t, a.bits * b.bits);
+    case primitive_op::divide:
+    case primitive_op::divide_integer:
+    case primitive_op::modulo:
+    {
+        if (b.bits == 0)
+            throw not_constant();
+
+        bool is_quotient = op != primitive_op::modulo;
+
+        if (is_signed)
+        {
+            int64_t x = a.bits;
+            int64_t y = b.bits;
+            // Overflow of the smallest number divided by -1
+            if (y == -1 && a.bits == wrapped(t, uint64_t(1) << (bit_count(t) - 1)))
+                throw not_constant();
+            return make_int(t, is_quotient ? x / y : x % y);
+        }
+        else
+        {
+            return make_int(t, is_quotient ? a.bits / b.bits : a.bits % b.bits);
+        }
+    }
+    case primitive_op::bitwise_and:
+        return make_int(t, a.bits & b.bits);
+    case primitive_op::bitwise_or:
+        return make_int(t, a.bits | b.bits);
+    case primitive_op::bitwise_xor:
+        return make_int(t, a.bits ^ b.bits);
+    default:
+        throw not_constant();
+    }
+}
+
+// Arithmetic in the common type of operands, like C++.
+
+static value arithmetic(primitive_op op, value a, value b)
+{
+    auto t = common_type(a.type, b.type);
+
+    if (is_complex(t))
+        throw not_constant();
+
+    a = convert(a, t);
+    b = convert(b, t);
+
+    if (t == pt::real32)
+        return make_real(t, arithmetic_op<float>(op, float(a.number.real()), float(b.number.real())));
+    if (t == pt::real64)
+        return make_real(t, arithmetic_op<double>(op, a.number.real(), b.number.real()));
+
+    return integer_arithmetic(op, a, b);
+}
+
+// Arithmetic with a complex result.
+// Generated code converts operands to the result type or its component type.
+
+template <typename T>
+static value complex_arithmetic(primitive_op op, const value & a, const value & b,
+                                primitive_type t)
+{
+    using C = std::complex<T>;
+
+    C ca(a.number.real(), a.number.imag());
+    C cb(b.number.real(), b.number.imag());
+    T ra = T(a.number.real());
+    T rb = T(b.number.real());
+
+    bool a_complex = is_complex(a.type);
+    bool b_complex = is_complex(b.type);
+
+    // Operators with a real operand differ from those with
+    // two complex operands in rounding and special values.
+    C r;
+    if (a_complex && b_complex)
+        r = arithmetic_op<C>(op, ca, cb);
+    else if (a_complex)
+        r = arithmetic_op<C>(op, ca, rb);
+    else if (b_complex)
+        r = arithmetic_op<C>(op, ra, cb);
+    else
+        throw not_constant();
+
+    return make_complex(t, std::complex<double>(r.real(), r.imag()));
+}
+
+static value compare(primitive_op op, value a, value b)
+{
+    auto t = common_type(a.type, b.type);
+
+    int order;
+
+    if (is_complex(t))
+    {
+        if (op != primitive_op::compare_eq && op != primitive_op::compare_neq)
+            throw not_constant();
+        a = convert(a, t);
+        b = convert(b, t);
+        bool equal = a.number == b.number;
+        return make_int(pt::boolean, (op == primitive_op::compare_eq) == equal);
+    }
+    else if (is_real(t))
+    {
+        double x = real_value(a);
+        double y = real_value(b);
+        bool r;
+        switch(op)
+        {
+        case primitive_op::compare_eq: r = x == y; break;
+        case primitive_op::compare_neq: r = x != y; break;
+        case primitive_op::compare_l: r = x < y; break;
+        case primitive_op::compare_g: r = x > y; break;
+        case primitive_op::compare_leq: r = x <= y; break;
+        case primitive_op::compare_geq: r = x >= y; break;
+        default: throw not_constant();
+        }
+        return make_int(pt::boolean, r);
+    }
+    else
+    {
+        a = convert(a, t);
+        b = convert(b, t);
+        if (is_signed_int(t))
+            order = int64_t(a.bits) < int64_t(b.bits) ? -1 : int64_t(a.bits) > int64_t(b.bits);
+        else
+            order = a.bits < b.bits ? -1 : a.bits > b.bits;
+    }
+
+    bool r;
+    switch(op)
+    {
+    case primitive_op::compare_eq: r = order == 0; break;
+    case primitive_op::compare_neq: r = order != 0; break;
+    case primitive_op::compare_l: r = order < 0; break;
+    case primitive_op::compare_g: r = order > 0; break;
+    case primitive_op::compare_leq: r = order <= 0; break;
+    case primitive_op::compare_geq: r = order >= 0; break;
+    default: throw not_constant();
+    }
+    return make_int(pt::boolean, r);
+}
+
+template <typename T>
+static T real_function(primitive_op op, T x)
+{
+    switch(op)
+    {
+    case primitive_op::exp: return std::exp(x);
+    case primitive_op::exp2: return std::exp2(x);
+    case primitive_op::log: return std::log(x);
+    case primitive_op::log2: return std::log2(x);
+    case primitive_op::log10: return std::log10(x);
+    case primitive_op::sqrt: return std::sqrt(x);
+    case primitive_op::sin: return std::sin(x);
+    case primitive_op::cos: return std::cos(x);
+    case primitive_op::tan: return std::tan(x);
+    case primitive_op::asin: return std::asin(x);
+    case primitive_op::acos: return std::acos(x);
+    case primitive_op::atan: return std::atan(x);
+    case primitive_op::floor: return std::floor(x);
+    case primitive_op::ceil: return std::ceil(x);
+    case primitive_op::abs: return std::abs(x);
+    default: throw not_constant();
+    }
+}
+
+template <typename T>
+static std::complex<T> complex_function(primitive_op op, std::complex<T> x)
+{
+    switch(op)
+    {
+    case primitive_op::exp: return std::exp(x);
+    case primitive_op::log: return std::log(x);
+    case primitive_op::log10: return std::log10(x);
+    case primitive_op::sqrt: return std::sqrt(x);
+    case primitive_op::sin: return std::sin(x);
+    case primitive_op::cos: return std::cos(x);
+    case primitive_op::tan: return std::tan(x);
+    case primitive_op::asin: return std::asin(x);
+    case primitive_op::acos: return std::acos(x);
+    case primitive_op::atan: return std::atan(x);
+    default: throw not_constant();
+    }
+}
+
+// A function from <cmath> or <complex>.
+// Integer arguments are converted to double, like the standard overloads do.
+
+static value math_function(primitive_op op, const value & x)
+{
+    if (x.type == pt::complex32)
+    {
+        std::complex<float> c(x.number.real(), x.number.imag());
+        if (op == primitive_op::abs)
+            return make_real(pt::real32, std::abs(c));
+        auto r = complex_function<float>(op, c);
+        return make_complex(x.type, std::complex<double>(r.real(), r.imag()));
+    }
+    if (x.type == pt::complex64)
+    {
+        if (op == primitive_op::abs)
+            return make_real(pt::real64, std::abs(x.number));
+        return make_complex(x.type, complex_function<double>(op, x.number));
+    }
+    if (x.type == pt::real32)
+        return make_real(pt::real32, real_function<float>(op, float(x.number.real())));
+
+    return make_real(pt::real64, real_function<double>(op, real_value(x)));
+}
+
+constant_array_evaluation::constant_array_evaluation(model & m, int max_size):
+    m_model(m),
+    m_max_size(max_size)
+{}
+
+// Visits array accesses, telling whether they are arguments of external calls.
+
+template <typename F>
+static void visit_accesses(const expr_ptr & e, F f, bool in_call = false)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        f(access.get(), in_call);
+        for (auto & index : access->indexes)
+            visit_accesses(index, f, false);
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        for (auto & arg : call->args)
+            visit_accesses(arg, f, true);
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            visit_accesses(operand.expr, f, in_call);
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        visit_accesses(assign->destination, f, in_call);
+        visit_accesses(assign->value, f, in_call);
+    }
+}
+
+static bool has_external_call(const expr_ptr & e)
+{
+    if (dynamic_pointer_cast<external_call>(e))
+        return true;
+
+    if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        return has_external_call(assign->destination) ||
+                has_external_call(assign->value);
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        for (auto & index : access->indexes)
+            if (has_external_call(index))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (has_external_call(operand.expr))
+                return true;
+    }
+
+    return false;
+}
+
+static vector<int> dimensions(const array & a)
+{
+    if (a.size.empty())
+        return { 1 };
+    return a.size;
+}
+
+static int64_t volume(const array & a)
+{
+    int64_t v = 1;
+    for (auto s : dimensions(a))
+        v *= s;
+    return v;
+}
+
+void constant_array_evaluation::process()
+{
+    // Arrays which must remain in memory:
+    // IO arrays and arrays passed to external functions
+    // or accessed with fewer indexes than dimensions.
+
+    unordered_set<array*> excluded;
+
+    for (auto & channel : m_model.inputs)
+        excluded.insert(channel.array.get());
+    for (auto & channel : m_model.outputs)
+        excluded.insert(channel.array.get());
+
+    for (auto & stmt : m_model.statements)
+    {
+        visit_accesses(stmt->expr, [&](array_access * access, bool in_call)
+        {
+            auto & a = *access->array;
+            bool full_index = access->indexes.size() == a.size.size() ||
+                    (a.size.empty() && access->indexes.size() <= 1);
+            if (in_call || !full_index)
+                excluded.insert(&a);
+        });
+    }
+
+    unordered_map<array*, vector<stmt_ptr>> candidates;
+
+    for (auto & array : m_model.arrays)
+    {
+        vector<stmt_ptr> writers;
+        if (is_candidate(array, excluded, writers))
+            candidates.emplace(array.get(), writers);
+    }
+
+    // Evaluate arrays after the arrays they read.
+
+    vector<array_ptr> evaluated;
+    unordered_set<array*> failed;
+
+    bool progress = true;
+    while(progress)
+    {
+        progress = false;
+
+        for (auto & array : m_model.arrays)
+        {
+            auto candidate = candidates.find(array.get());
+            if (candidate == candidates.end())
+                continue;
+            if (failed.count(array.get()) || m_values.count(array.get()))
+                continue;
+
+            auto & writers = candidate->second;
+
+            bool ready = true;
+            for (auto & stmt : writers)
+            {
+                for (auto & access : stmt->array_accesses)
+                {
+                    auto source = access->array.get();
+                    if (!access->reading || source == array.get() || m_values.count(source))
+                        continue;
+                    ready = false;
+                    if (!candidates.count(source) || failed.count(source))
+                        failed.insert(array.get());
+                }
+            }
+
+            if (!ready)
+                continue;
+
+            if (evaluate(array, writers))
+                evaluated.push_back(array);
+            else
+                failed.insert(array.get());
+
+            progress = true;
+        }
+    }
+
+    // Replace evaluated arrays by tables.
+
+    for (auto & array : evaluated)
+    {
+        auto & values = m_values.at(array.get());
+        array->constant_values.clear();
+        for (auto & v : values)
+        {
+            constant_value c;
+            c.bits = v.bits;
+            c.number = v.number;
+            array->constant_values.push_back(c);
+        }
+
+        auto & writers = candidates.at(array.get());
+        auto & stmts = m_model.statements;
+        stmts.erase(std::remove_if(stmts.begin(), stmts.end(), [&](const stmt_ptr & s){
+            return std::find(writers.begin(), writers.end(), s) != writers.end();
+        }), stmts.end());
+
+        auto & arrays = m_model.arrays;
+        arrays.erase(std::remove(arrays.begin(), arrays.end(), array), arrays.end());
+
+        m_model.constant_arrays.push_back(array);
+
+        arrp::report()["constant_arrays"][array->name] = values.size();
+
+        ++m_evaluated_count;
+    }
+
+    if (verbose<constant_array_evaluation>::enabled())
+    {
+        for (auto & array : evaluated)
+        {
+            cout << "Evaluated array " << array->name
+                 << " (" << array->constant_values.size() << " elements)." << endl;
+        }
+        for (auto & array : failed)
+        {
+            cout << "Could not evaluate array " << array->name << "." << endl;
+        }
+    }
+}
+
+bool constant_array_evaluation::is_candidate
+(const array_ptr & array, const unordered_set<polyhedral::array*> & excluded,
+ vector<stmt_ptr> & writers)
+{
+    if (array->is_infinite || excluded.count(array.get()))
+        return false;
+
+    if (volume(*array) > m_max_size)
+    {
+        if (verbose<constant_array_evaluation>::enabled())
+            cout << "Array " << array->name << " is too large to evaluate." << endl;
+        return false;
+    }
+
+    for (auto & stmt : m_model.statements)
+    {
+        auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+        if (!assign)
+            continue;
+        auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+        if (!dest || dest->array != array)
+            continue;
+
+        if (stmt->is_infinite || stmt->is_input_or_output || has_external_call(stmt->expr))
+            return false;
+
+        writers.push_back(stmt);
+    }
+
+    return !writers.empty();
+}
+
+struct point_list
+{
+    int dimensions;
+    vector<vector<int64_t>> points;
+};
+
+static isl_stat add_point(isl_point * p, void * data)
+{
+    auto & list = *reinterpret_cast<point_list*>(data);
+
+    vector<int64_t> coords(list.dimensions);
+    for (int d = 0; d < list.dimensions; ++d)
+    {
+        isl_val * v = isl_point_get_coordinate_val(p, isl_dim_set, d);
+        coords[d] = isl_val_get_num_si(v);
+        isl_val_free(v);
+    }
+
+    isl_point_free(p);
+
+    list.points.push_back(coords);
+    return isl_stat_ok;
+}
+
+bool constant_array_evaluation::evaluate
+(const array_ptr & array, const vector<stmt_ptr> & writers)
+{
+    struct instance
+    {
+        statement * stmt;
+        point index;
+    };
+
+    vector<instance> pending;
+
+    for (auto & stmt : writers)
+    {
+        int64_t count = -1;
+        if (isl_val * v = isl_set_count_val(stmt->domain.get()))
+        {
+            if (isl_val_is_int(v) == isl_bool_true)
+                count = isl_val_get_num_si(v);
+            isl_val_free(v);
+        }
+
+        if (count < 0 || int64_t(pending.size()) + count > max_instance_count)
+        {
+            if (verbose<constant_array_evaluation>::enabled())
+                cout << "Array " << array->name << " has too many statement instances." << endl;
+            return false;
+        }
+
+        point_list list;
+        list.dimensions = stmt->domain.get_space().dimension(isl::space::variable);
+        isl_set_foreach_point(stmt->domain.get(), &add_point, &list);
+
+        for (auto & p : list.points)
+            pending.push_back({ stmt.get(), p });
+    }
+
+    value zero = convert(make_int(pt::int32, 0), array->type);
+
+    m_current = array.get();
+    m_values[m_current] = vector<value>(volume(*array), zero);
+    m_written = vector<bool>(volume(*array), false);
+
+    // Instances reading elements not yet written are deferred.
+    // The order of traversal alternates, so that recurrences
+    // in either direction complete in few rounds.
+
+    bool reverse = false;
+
+    try
+    {
+        while(!pending.empty())
+        {
+            vector<instance> deferred;
+
+            auto run = [&](instance & i)
+            {
+                try { execute(i.stmt, i.index); }
+                catch (not_ready &) { deferred.push_back(i); }
+            };
+
+            if (reverse)
+                std::for_each(pending.rbegin(), pending.rend(), run);
+            else
+                std::for_each(pending.begin(), pending.end(), run);
+
+            if (deferred.size() == pending.size())
+                throw not_constant();
+
+            pending.swap(deferred);
+            reverse = !reverse;
+        }
+    }
+    catch (not_constant &)
+    {
+        m_values.erase(m_current);
+        m_current = nullptr;
+        return false;
+    }
+
+    m_current = nullptr;
+    return true;
+}
+
+void constant_array_evaluation::execute(statement * stmt, const point & index)
+{
+    auto assign = static_cast<assignment*>(stmt->expr.get());
+    auto dest = static_cast<array_access*>(assign->destination.get());
+
+    int64_t element = element_index(dest, index);
+
+    if (m_written[element])
+        throw not_constant();
+
+    auto v = eval(assign->value, index);
+
+    m_values[m_current][element] = convert(v, m_current->type);
+    m_written[element] = true;
+}
+
+int64_t constant_array_evaluation::element_index(array_access * access, const point & index)
+{
+    auto dims = dimensions(*access->array);
+
+    int64_t element = 0;
+    for (int d = 0; d < (int) dims.size(); ++d)
+    {
+        int64_t i = 0;
+        if (d < (int) access->indexes.size())
+            i = int64_t(convert(eval(access->indexes[d], index), pt::int64).bits);
+        if (i < 0 || i >= dims[d])
+            throw not_constant();
+        element = element * dims[d] + i;
+    }
+
+    return element;
+}
+
+value constant_array_evaluation::eval(const expr_ptr & expr, const point & index)
+{
+    if (auto op = dynamic_cast<functional::primitive*>(expr.get()))
+    {
+        return eval_primitive(op, index);
+    }
+    else if (auto iterator = dynamic_cast<iterator_read*>(expr.get()))
+    {
+        assert_or_throw(iterator->index >= 0 && iterator->index < (int) index.size());
+        return make_int(pt::int32, index[iterator->index]);
+    }
+    else if (auto access = dynamic_cast<array_access*>(expr.get()))
+    {
+        auto values = m_values.find(access->array.get());
+        if (values == m_values.end())
+            throw not_constant();
+
+        int64_t element = element_index(access, index);
+
+        if (access->array.get() == m_current && !m_written[element])
+            throw not_ready();
+
+        return values->second[element];
+    }
+    else if (auto c = dynamic_cast<functional::int_const*>(expr.get()))
+    {
+        // Type of the literal in generated code
+        auto v = c->value();
+        if (is_signed_int(prim_type(expr)))
+        {
+            bool is_small = v >= INT32_MIN && v <= INT32_MAX;
+            return make_int(is_small ? pt::int32 : pt::int64, uint64_t(c->signed_value()));
+        }
+        else
+        {
+            bool is_small = v <= UINT32_MAX;
+            return make_int(is_small ? pt::uint32 : pt::uint64, c->unsigned_value());
+        }
+    }
+    else if (auto c = dynamic_cast<functional::constant<double>*>(expr.get()))
+    {
+        auto t = prim_type(expr);
+        if (!is_real(t))
+            throw not_constant();
+        return make_real(t, c->value);
+    }
+    else if (auto c = dynamic_cast<functional::bool_const*>(expr.get()))
+    {
+        return make_int(pt::boolean, c->value);
+    }
+    else if (auto c = dynamic_cast<functional::complex_const*>(expr.get()))
+    {
+        return make_complex(prim_type(expr), c->value);
+    }
+
+    throw not_constant();
+}
+
+// Evaluates primitive operations the same way as
+// the C++ code generated for them in cpp_from_polyhedral.
+
+value constant_array_evaluation::eval_primitive
+(functional::primitive * expr, const point & index)
+{
+    auto & operands = expr->operands;
+    auto r_t = prim_type(expr);
+
+    switch(expr->kind)
+    {
+    case primitive_op::logic_and:
+        return make_int(pt::boolean, truth(eval(operands[0], index)) &&
+                        truth(eval(operands[1], index)));
+    case primitive_op::logic_or:
+        return make_int(pt::boolean, truth(eval(operands[0], index)) ||
+                        truth(eval(operands[1], index)));
+    case primitive_op::conditional:
+    {
+        bool c = truth(eval(operands[0], index));
+        return convert(eval(operands[c ? 1 : 2], index), r_t);
+    }
+    default:
+        break;
+    }
+
+    vector<value> args;
+    vector<primitive_type> arg_types;
+    for (auto & operand : operands)
+    {
+        args.push_back(eval(operand, index));
+        arg_types.push_back(prim_type(operand.expr));
+    }
+
+    switch(expr->kind)
+    {
+    case primitive_op::negate:
+    {
+        auto & x = args[0];
+        if (r_t == pt::boolean)
+            return make_int(pt::boolean, !truth(x));
+        if (is_complex(x.type))
+            return make_complex(x.type, -x.number);
+        if (is_real(x.type))
+            return make_real(x.type, -x.number.real());
+        return make_int(promoted(x.type), -convert(x, promoted(x.type)).bits);
+    }
+    case primitive_op::add:
+    case primitive_op::subtract:
+    case primitive_op::multiply:
+    case primitive_op::divide:
+    {
+        auto & lhs = args[0];
+        auto & rhs = args[1];
+
+        if (is_complex(r_t))
+        {
+            auto c_t = r_t;
+            auto e_t = component_of(r_t);
+            lhs = convert(lhs, is_complex(arg_types[0]) ? c_t : e_t);
+            rhs = convert(rhs, is_complex(arg_types[1]) ? c_t : e_t);
+            if (r_t == pt::complex32)
+                return complex_arithmetic<float>(expr->kind, lhs, rhs, r_t);
+            else
+                return complex_arithmetic<double>(expr->kind, lhs, rhs, r_t);
+        }
+        else if (r_t == pt::real32)
+        {
+            if (arg_types[0] == pt::real64)
+                lhs = convert(lhs, pt::real32);
+            if (arg_types[1] == pt::real64)
+                rhs = convert(rhs, pt::real32);
+        }
+        else if (expr->kind == primitive_op::divide)
+        {
+            if (is_integer(arg_types[0]) && is_integer(arg_types[1]))
+                lhs = convert(lhs, r_t);
+        }
+
+        return arithmetic(expr->kind, lhs, rhs);
+    }
+    case primitive_op::divide_integer:
+    {
+        auto result = arithmetic(primitive_op::divide, args[0], args[1]);
+        if (is_integer(arg_types[0]) && is_integer(arg_types[1]))
+            return result;
+        return convert(result, pt::int32);
+    }
+    case primitive_op::modulo:
+    {
+        if (!is_integral(args[0].type) || !is_integral(args[1].type))
+            throw not_constant();
+        return arithmetic(primitive_op::modulo, args[0], args[1]);
+    }
+    case primitive_op::bitwise_not:
+    {
+        auto t = promoted(args[0].type);
+        if (!is_integer(t))
+            throw not_constant();
+        return make_int(t, ~convert(args[0], t).bits);
+    }
+    case primitive_op::bitwise_and:
+    case primitive_op::bitwise_or:
+    case primitive_op::bitwise_xor:
+    {
+        if (!is_integral(args[0].type) || !is_integral(args[1].type))
+            throw not_constant();
+        return arithmetic(expr->kind, args[0], args[1]);
+    }
+    case primitive_op::bitwise_lshift:
+    case primitive_op::bitwise_rshift:
+    {
+        if (!is_integral(args[0].type) || !is_integral(args[1].type))
+            throw not_constant();
+
+        auto t = promoted(args[0].type);
+        auto x = convert(args[0], t);
+        auto n = convert(args[1], pt::int64);
+        int64_t count = n.bits;
+        if (count < 0 || count >= bit_count(t))
+            throw not_constant();
+
+        if (expr->kind == primitive_op::bitwise_lshift)
+            return make_int(t, x.bits << count);
+        if (is_signed_int(t))
+            return make_int(t, uint64_t(int64_t(x.bits) >> count));
+        return make_int(t, x.bits >> count);
+    }
+    case primitive_op::compare_eq:
+    case primitive_op::compare_neq:
+    case primitive_op::compare_l:
+    case primitive_op::compare_g:
+    case primitive_op::compare_leq:
+    case primitive_op::compare_geq:
+        return compare(expr->kind, args[0], args[1]);
+    case primitive_op::raise:
+    {
+        if (is_complex(args[0].type) || is_complex(args[1].type))
+            throw not_constant();
+        if (args[0].type == pt::real32 && args[1].type == pt::real32)
+        {
+            return make_real(pt::real32, std::pow(float(args[0].number.real()),
+                                                  float(args[1].number.real())));
+        }
+        return make_real(pt::real64, std::pow(real_value(args[0]), real_value(args[1])));
+    }
+    case primitive_op::floor:
+    case primitive_op::ceil:
+    {
+        if (is_integer(arg_types[0]))
+            return args[0];
+        return math_function(expr->kind, args[0]);
+    }
+    case primitive_op::abs:
+    {
+        auto & x = args[0];
+        if (is_integral(x.type))
+        {
+            auto t = promoted(x.type);
+            auto v = convert(x, t);
+            if (is_signed_int(t) && int64_t(v.bits) < 0)
+                return make_int(t, -v.bits);
+            return v;
+        }
+        return math_function(expr->kind, x);
+    }
+    case primitive_op::max:
+    case primitive_op::min:
+    {
+        auto a = convert(args[0], r_t);
+        auto b = convert(args[1], r_t);
+        bool less = expr->kind == primitive_op::max ?
+                    truth(compare(primitive_op::compare_l, a, b)) :
+                    truth(compare(primitive_op::compare_l, b, a));
+        // std::max(a,b) = a < b ? b : a, std::min(a,b) = b < a ? b : a
+        return less ? b : a;
+    }
+    case primitive_op::exp2:
+    {
+        if (is_integer(arg_types[0]))
+            return convert(math_function(expr->kind, args[0]), arg_types[0]);
+        return math_function(expr->kind, args[0]);
+    }
+    case primitive_op::log:
+    case primitive_op::log2:
+    case primitive_op::log10:
+    case primitive_op::exp:
+    case primitive_op::sqrt:
+    case primitive_op::sin:
+    case primitive_op::cos:
+    case primitive_op::tan:
+    case primitive_op::asin:
+    case primitive_op::acos:
+    case primitive_op::atan:
+    {
+        return math_function(expr->kind, args[0]);
+    }
+    case primitive_op::real:
+    case primitive_op::imag:
+    {
+        auto & x = args[0];
+        if (!is_complex(x.type))
+            throw not_constant();
+        double part = expr->kind == primitive_op::real ? x.number.real() : x.number.imag();
+        return make_real(component_of(x.type), part);
+    }
+    case primitive_op::to_int8:
+        return convert(args[0], pt::int8);
+    case primitive_op::to_uint8:
+        return convert(args[0], pt::uint8);
+    case primitive_op::to_int16:
+        return convert(args[0], pt::int16);
+    case primitive_op::to_uint16:
+        return convert(args[0], pt::uint16);
+    case primitive_op::to_int:
+    case primitive_op::to_int32:
+        return convert(args[0], pt::int32);
+    case primitive_op::to_uint32:
+        return convert(args[0], pt::uint32);
+    case primitive_op::to_int64:
+        return convert(args[0], pt::int64);
+    case primitive_op::to_uint64:
+        return convert(args[0], pt::uint64);
+    case primitive_op::to_real32:
+    case primitive_op::to_real64:
+    case primitive_op::to_complex32:
+    case primitive_op::to_complex64:
+    {
+        // No conversion is generated if the type does not change.
+        if (arg_types[0] == r_t)
+            return args[0];
+        return convert(args[0], r_t);
+    }
+    default:
+        throw not_constant();
+    }
+}
+
+}
+}
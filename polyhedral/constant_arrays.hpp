@@ -0,0 +1,99 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_CONSTANT_ARRAYS_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_CONSTANT_ARRAYS_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace stream {
+namespace polyhedral {
+
+// Evaluation of finite arrays which do not depend on inputs.
+//
+// The statements writing such an array are interpreted for
+// every instance, with the same arithmetic as generated C++ code.
+// On success, the statements are removed, and the array is moved
+// from model.arrays to model.constant_arrays with its element values,
+// so that generated code stores it in a static table shared by all
+// instances of the program, instead of computing it in the prelude.
+//
+// An array is not evaluated if its statements call external functions,
+// read arrays which are not evaluated, or perform operations
+// whose result in C++ is undefined (e.g. integer division by zero).
+// Arrays passed to external functions (including outputs) are not
+// evaluated either, and neither are arrays with more than
+// a given number of elements.
+
+class constant_array_evaluation
+{
+public:
+    constant_array_evaluation(model &, int max_size = 1 << 16);
+
+    void process();
+
+    int evaluated_count() const { return m_evaluated_count; }
+
+    // A value with the C++ type of the generated expression,
+    // which may differ from the type in the model due to
+    // C++ integer promotion.
+    struct value
+    {
+        primitive_type type = primitive_type::undefined;
+        uint64_t bits = 0;
+        std::complex<double> number;
+    };
+
+    // Thrown when an expression can not be evaluated.
+    struct not_constant {};
+
+private:
+    // Thrown when an element of the array being evaluated
+    // is read before it is written.
+    struct not_ready {};
+
+    using point = vector<int64_t>;
+
+    bool is_candidate(const array_ptr &, const std::unordered_set<array*> & excluded,
+                      vector<stmt_ptr> & writers);
+    bool evaluate(const array_ptr &, const vector<stmt_ptr> & writers);
+    void execute(statement *, const point &);
+
+    value eval(const expr_ptr &, const point &);
+    value eval_primitive(functional::primitive *, const point &);
+    int64_t element_index(array_access *, const point &);
+
+    model & m_model;
+    int m_max_size;
+    int m_evaluated_count = 0;
+
+    std::unordered_map<array*, vector<value>> m_values;
+    array * m_current = nullptr;
+    vector<bool> m_written;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_CONSTANT_ARRAYS_INCLUDED
@@ -0,0 +1,325 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "cost_model.hpp"
+#include "../common/error.hpp"
+
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+#include <isl/val.h>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+static unordered_map<string, isl::set> domains_by_statement(const isl::union_map & sched)
+{
+    unordered_map<string, isl::set> domains;
+
+    sched.for_each([&](const isl::map & m){
+        auto d = m.domain();
+        auto name = d.name();
+        auto existing = domains.find(name);
+        if (existing == domains.end())
+            domains.emplace(name, d);
+        else
+            existing->second = existing->second | d;
+        return true;
+    });
+
+    return domains;
+}
+
+cost_model::cost_model(const model & m, const schedule & s)
+{
+    auto prelude_domains = domains_by_statement(s.prelude);
+    auto period_domains = domains_by_statement(s.period);
+
+    unordered_map<array*, isl::set> period_elements;
+
+    for (auto & stmt : m.statements)
+    {
+        statement_cost cost;
+        cost.stmt = stmt;
+        cost.prelude_instances = instance_count(prelude_domains, stmt->name, cost.exact);
+        cost.period_instances = instance_count(period_domains, stmt->name, cost.exact);
+
+        count_operations(stmt->expr, cost);
+
+        for (auto & access : stmt->array_accesses)
+            count_memory(access, cost);
+
+        auto period_domain = period_domains.find(stmt->name);
+        if (period_domain != period_domains.end())
+            count_period_memory(stmt, period_domain->second, period_elements, cost);
+
+        m_statements.push_back(cost);
+    }
+
+    for (auto & array : m.arrays)
+    {
+        auto elements = period_elements.find(array.get());
+        if (elements == period_elements.end())
+            continue;
+
+        bool exact;
+        auto bytes = element_bytes(array, elements->second, exact);
+        if (bytes < 0)
+        {
+            m_period_bytes = -1;
+            break;
+        }
+        m_period_bytes += bytes;
+    }
+
+    if (!m.outputs.empty())
+    {
+        auto & out = m.outputs.front();
+        if (out.array->is_infinite)
+            m_period_samples = out.array->period;
+    }
+}
+
+int64_t cost_model::instance_count
+(const unordered_map<string, isl::set> & domains, const string & name, bool & exact)
+{
+    auto d = domains.find(name);
+    if (d == domains.end())
+        return 0;
+
+    bool is_exact;
+    auto count = point_count(d->second, is_exact);
+    exact &= is_exact;
+    return count;
+}
+
+int64_t cost_model::point_count(const isl::set & set, bool & exact)
+{
+    exact = true;
+
+    if (set.is_empty())
+        return 0;
+
+    // Bounding box
+
+    auto box = isl::set::universe(set.get_space());
+    int64_t box_count = 1;
+
+    for (int dim = 0; dim < set.dimensions(); ++dim)
+    {
+        auto v = set.get_space().var(dim);
+        auto min = set.minimum(v);
+        auto max = set.maximum(v);
+        if (!min.is_integer() || !max.is_integer())
+            return -1;
+
+        auto box_v = box.get_space().var(dim);
+        box.add_constraint(box_v >= min.integer());
+        box.add_constraint(box_v <= max.integer());
+
+        box_count *= int64_t(max.integer()) - int64_t(min.integer()) + 1;
+    }
+
+    if (isl_set_is_equal(box.get(), set.get()) == isl_bool_true)
+        return box_count;
+
+    if (box_count > max_enumerated_points)
+    {
+        exact = false;
+        return box_count;
+    }
+
+    isl_val * val = isl_set_count_val(set.get());
+    if (!val)
+        throw error("Failed to count points of a set.");
+
+    if (isl_val_is_int(val) != isl_bool_true)
+    {
+        isl_val_free(val);
+        return -1;
+    }
+
+    int64_t count = isl_val_get_num_si(val);
+    isl_val_free(val);
+    return count;
+}
+
+static bool has_complex_type(const expr_ptr & e)
+{
+    return e->type && e->type->is_scalar() &&
+            is_complex(e->type->scalar()->primitive);
+}
+
+void cost_model::count_operations(const expr_ptr & e, statement_cost & cost)
+{
+    if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        bool is_complex_op = has_complex_type(op);
+        for (auto & operand : op->operands)
+            is_complex_op |= has_complex_type(operand.expr);
+
+        switch(op->kind)
+        {
+        case primitive_op::add:
+        case primitive_op::subtract:
+        case primitive_op::negate:
+            cost.arithmetic_ops += is_complex_op ? 2 : 1;
+            break;
+        case primitive_op::multiply:
+            cost.arithmetic_ops += is_complex_op ? 6 : 1;
+            break;
+        case primitive_op::divide:
+            cost.arithmetic_ops += is_complex_op ? 11 : 1;
+            break;
+        case primitive_op::abs:
+            if (is_complex_op)
+            {
+                cost.arithmetic_ops += 3;
+                cost.transcendental_ops += 1;
+            }
+            else
+            {
+                cost.arithmetic_ops += 1;
+            }
+            break;
+        case primitive_op::raise:
+        case primitive_op::exp:
+        case primitive_op::exp2:
+        case primitive_op::log:
+        case primitive_op::log2:
+        case primitive_op::log10:
+        case primitive_op::sqrt:
+        case primitive_op::sin:
+        case primitive_op::cos:
+        case primitive_op::tan:
+        case primitive_op::asin:
+        case primitive_op::acos:
+        case primitive_op::atan:
+            cost.transcendental_ops += is_complex_op ? 2 : 1;
+            break;
+        case primitive_op::real:
+        case primitive_op::imag:
+        case primitive_op::to_int:
+        case primitive_op::to_int8:
+        case primitive_op::to_uint8:
+        case primitive_op::to_int16:
+        case primitive_op::to_uint16:
+        case primitive_op::to_int32:
+        case primitive_op::to_uint32:
+        case primitive_op::to_int64:
+        case primitive_op::to_uint64:
+        case primitive_op::to_real32:
+        case primitive_op::to_real64:
+        case primitive_op::to_complex32:
+        case primitive_op::to_complex64:
+            break;
+        default:
+            // Integer, bitwise, comparison, logic operations, min, max,
+            // rounding and selection by conditional.
+            cost.arithmetic_ops += 1;
+        }
+
+        // Both branches of a conditional are counted,
+        // so this is an upper bound.
+        for (auto & operand : op->operands)
+            count_operations(operand.expr, cost);
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        cost.external_calls += 1;
+        cost.external_ops += call->attributes.cost;
+        for (auto & arg : call->args)
+            count_operations(arg, cost);
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        count_operations(assign->value, cost);
+    }
+
+    // Array index expressions are affine and
+    // mostly reduce to loop counters, so they are not counted.
+}
+
+void cost_model::count_period_memory
+(const stmt_ptr & stmt, const isl::set & period_domain,
+ unordered_map<array*, isl::set> & accessed,
+ statement_cost & cost)
+{
+    for (auto & access : stmt->array_accesses)
+    {
+        auto elements = access->map.in_domain(period_domain).range();
+
+        bool exact;
+        auto bytes = element_bytes(access->array, elements, exact);
+        cost.exact &= exact;
+
+        auto add = [&](int64_t & total)
+        {
+            if (bytes < 0 || total < 0)
+                total = -1;
+            else
+                total += bytes;
+        };
+
+        if (access->reading)
+            add(cost.period_bytes_read);
+        if (access->writing)
+            add(cost.period_bytes_written);
+
+        auto existing = accessed.find(access->array.get());
+        if (existing == accessed.end())
+            accessed.emplace(access->array.get(), elements);
+        else
+            existing->second = existing->second | elements;
+    }
+}
+
+int64_t cost_model::element_bytes
+(const array_ptr & array, const isl::set & elements, bool & exact)
+{
+    auto count = point_count(elements, exact);
+    if (count < 0)
+        return -1;
+    return count * size_in_bytes(array->type);
+}
+
+void cost_model::count_memory(const shared_ptr<array_access> & access, statement_cost & cost)
+{
+    int64_t size = size_in_bytes(access->array->type);
+
+    if (access->type && access->type->is_array())
+    {
+        for (auto s : access->type->array()->size)
+        {
+            assert_or_throw(s >= 0);
+            size *= s;
+        }
+    }
+
+    if (access->reading)
+        cost.bytes_read += size;
+    if (access->writing)
+        cost.bytes_written += size;
+}
+
+}
+}
@@ -0,0 +1,116 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#ifndef STREAM_LANG_POLYHEDRAL_COST_MODEL_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_COST_MODEL_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <unordered_map>
+#include <cstdint>
+
+namespace stream {
+namespace polyhedral {
+
+using std::unordered_map;
+
+// Static estimate of the computational cost of a program.
+//
+// Operations are counted per statement instance from the expression tree.
+// Complex operations are counted as the equivalent number of
+// real operations, transcendental functions are counted separately,
+// and conversions are not counted.
+// External calls are counted, and the operations they perform
+// are counted separately from the cost declared for each function.
+// Memory traffic is counted per instance from the array accesses,
+// as the size of the accessed elements, and per period as the size
+// of the distinct elements accessed by all instances in the period.
+// Instance and element counts are the number of points in a set,
+// computed as the product of extents if the set is a box, by enumeration
+// if its bounding box is small, and approximated by the size of the
+// bounding box otherwise.
+
+struct statement_cost
+{
+    stmt_ptr stmt;
+
+    // Instance counts are -1 if unbounded.
+    int64_t prelude_instances = 0;
+    int64_t period_instances = 0;
+    // False if any count is approximated by a bounding box.
+    bool exact = true;
+
+    // Per instance:
+    int arithmetic_ops = 0;
+    int transcendental_ops = 0;
+    int external_calls = 0;
+    int external_ops = 0;
+    int64_t bytes_read = 0;
+    int64_t bytes_written = 0;
+
+    // Per period, -1 if unbounded:
+    int64_t period_bytes_read = 0;
+    int64_t period_bytes_written = 0;
+};
+
+class cost_model
+{
+public:
+    cost_model(const model &, const schedule &);
+
+    const vector<statement_cost> & statements() const { return m_statements; }
+
+    // Number of elements of the first output stream produced by one period,
+    // or 0 if the output is not a stream.
+    int64_t period_samples() const { return m_period_samples; }
+
+    // Size of distinct elements accessed by one period, -1 if unbounded.
+    int64_t period_bytes() const { return m_period_bytes; }
+
+    // Number of points in a set, -1 if unbounded.
+    // Sets exact to false if the count is approximated.
+    static int64_t point_count(const isl::set &, bool & exact);
+
+    // Sets with more points in their bounding box are not enumerated.
+    static const int64_t max_enumerated_points = 1 << 16;
+
+    // Adds the operations of an expression to the cost.
+    static void count_operations(const expr_ptr &, statement_cost &);
+
+private:
+    void count_memory(const shared_ptr<array_access> &, statement_cost &);
+    int64_t instance_count(const unordered_map<string, isl::set> &, const string & name,
+                           bool & exact);
+    void count_period_memory(const stmt_ptr &, const isl::set & period_domain,
+                             unordered_map<array*, isl::set> & accessed,
+                             statement_cost &);
+    int64_t element_bytes(const array_ptr &, const isl::set & elements, bool & exact);
+
+    vector<statement_cost> m_statements;
+    int64_t m_period_samples = 0;
+    int64_t m_period_bytes = 0;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_COST_MODEL_INCLUDED
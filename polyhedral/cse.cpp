@@ -0,0 +1,368 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "cse.hpp"
+#include "../common/error.hpp"
+
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+static bool has_impure_external_call(const expr_ptr & e)
+{
+    if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        if (!call->attributes.pure)
+            return true;
+        for (auto & arg : call->args)
+            if (has_impure_external_call(arg))
+                return true;
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        return has_impure_external_call(assign->destination) ||
+                has_impure_external_call(assign->value);
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        for (auto & index : access->indexes)
+            if (has_impure_external_call(index))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (has_impure_external_call(operand.expr))
+                return true;
+    }
+
+    return false;
+}
+
+common_subexpression_elimination::common_subexpression_elimination(model & m):
+    m_model(m),
+    m_printer(m.context)
+{}
+
+void common_subexpression_elimination::process()
+{
+    bool merged;
+
+    do
+    {
+        merged = false;
+
+        unordered_set<array*> io_arrays;
+        for (auto & channel : m_model.inputs)
+            io_arrays.insert(channel.array.get());
+        for (auto & channel : m_model.outputs)
+            io_arrays.insert(channel.array.get());
+
+        unordered_map<array*, int> writer_counts;
+        for (auto & stmt : m_model.statements)
+        {
+            for (auto & access : stmt->array_accesses)
+            {
+                if (access->writing)
+                    ++writer_counts[access->array.get()];
+            }
+        }
+
+        vector<candidate> candidates;
+        for (auto & stmt : m_model.statements)
+        {
+            candidate c;
+            if (!find_candidate(stmt, c))
+                continue;
+            if (io_arrays.count(c.dest->array.get()))
+                continue;
+            if (writer_counts[c.dest->array.get()] != 1)
+                continue;
+            candidates.push_back(c);
+        }
+
+        for (int i = 0; i < (int) candidates.size() && !merged; ++i)
+        {
+            for (int j = i + 1; j < (int) candidates.size(); ++j)
+            {
+                if (are_equal(candidates[i], candidates[j]))
+                {
+                    merge(candidates[i], candidates[j]);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    while(merged);
+}
+
+bool common_subexpression_elimination::find_candidate(const stmt_ptr & stmt, candidate & c)
+{
+    if (stmt->is_input_or_output)
+        return false;
+
+    // Self relations impose additional order, which would have to be merged too.
+    if (stmt->self_relations.is_valid())
+        return false;
+
+    auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+    if (!assign)
+        return false;
+
+    auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+    if (!dest || !dest->writing)
+        return false;
+
+    if (has_impure_external_call(assign->value))
+        return false;
+
+    c.stmt = stmt;
+    c.dest = dest;
+    return true;
+}
+
+bool common_subexpression_elimination::are_equal
+(const candidate & kept, const candidate & removed)
+{
+    auto & a = kept.dest->array;
+    auto & b = removed.dest->array;
+
+    if (a->type != b->type || a->size != b->size || a->is_infinite != b->is_infinite)
+        return false;
+
+    if (kept.stmt->domain.dimensions() != removed.stmt->domain.dimensions())
+        return false;
+
+    {
+        auto b_domain = b->domain;
+        b_domain.set_name(a->name);
+        if (isl_set_is_equal(a->domain.get(), b_domain.get()) != isl_bool_true)
+            return false;
+    }
+
+    auto removed_domain = removed.stmt->domain;
+    removed_domain.set_name(kept.stmt->name);
+
+    pair_context ctx { kept, removed, kept.stmt->domain | removed_domain };
+
+    return equal_exprs(kept.stmt->expr, removed.stmt->expr, ctx);
+}
+
+bool common_subexpression_elimination::equal_exprs
+(const expr_ptr & a, const expr_ptr & b, const pair_context & ctx)
+{
+    if (!a || !b)
+        return a == b;
+
+    if (a->type && b->type)
+    {
+        if (*a->type != *b->type)
+            return false;
+    }
+    else if (a->type || b->type)
+    {
+        return false;
+    }
+
+    if (auto a_assign = dynamic_pointer_cast<assignment>(a))
+    {
+        auto b_assign = dynamic_pointer_cast<assignment>(b);
+        return b_assign &&
+                equal_exprs(a_assign->destination, b_assign->destination, ctx) &&
+                equal_exprs(a_assign->value, b_assign->value, ctx);
+    }
+    else if (auto a_access = dynamic_pointer_cast<array_access>(a))
+    {
+        auto b_access = dynamic_pointer_cast<array_access>(b);
+        return b_access && equal_accesses(a_access, b_access, ctx);
+    }
+    else if (auto a_it = dynamic_pointer_cast<iterator_read>(a))
+    {
+        auto b_it = dynamic_pointer_cast<iterator_read>(b);
+        return b_it && a_it->index == b_it->index;
+    }
+    else if (auto a_int = dynamic_pointer_cast<functional::int_const>(a))
+    {
+        auto b_int = dynamic_pointer_cast<functional::int_const>(b);
+        return b_int && a_int->value() == b_int->value();
+    }
+    else if (auto a_real = dynamic_pointer_cast<functional::real_const>(a))
+    {
+        auto b_real = dynamic_pointer_cast<functional::real_const>(b);
+        return b_real && a_real->value == b_real->value;
+    }
+    else if (auto a_complex = dynamic_pointer_cast<functional::complex_const>(a))
+    {
+        auto b_complex = dynamic_pointer_cast<functional::complex_const>(b);
+        return b_complex && a_complex->value == b_complex->value;
+    }
+    else if (auto a_bool = dynamic_pointer_cast<functional::bool_const>(a))
+    {
+        auto b_bool = dynamic_pointer_cast<functional::bool_const>(b);
+        return b_bool && a_bool->value == b_bool->value;
+    }
+    else if (auto a_op = dynamic_pointer_cast<functional::primitive>(a))
+    {
+        auto b_op = dynamic_pointer_cast<functional::primitive>(b);
+        if (!b_op || a_op->kind != b_op->kind ||
+                a_op->operands.size() != b_op->operands.size())
+            return false;
+        for (int i = 0; i < (int) a_op->operands.size(); ++i)
+        {
+            if (!equal_exprs(a_op->operands[i].expr, b_op->operands[i].expr, ctx))
+                return false;
+        }
+        return true;
+    }
+    else if (auto a_call = dynamic_pointer_cast<external_call>(a))
+    {
+        auto b_call = dynamic_pointer_cast<external_call>(b);
+        if (!b_call || a_call->name != b_call->name ||
+                a_call->is_builtin != b_call->is_builtin ||
+                !a_call->attributes.pure || !b_call->attributes.pure ||
+                a_call->args.size() != b_call->args.size())
+            return false;
+        for (int i = 0; i < (int) a_call->args.size(); ++i)
+        {
+            if (!equal_exprs(a_call->args[i], b_call->args[i], ctx))
+                return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool common_subexpression_elimination::equal_accesses
+(const shared_ptr<array_access> & a, const shared_ptr<array_access> & b,
+ const pair_context & ctx)
+{
+    if (a->reading != b->reading || a->writing != b->writing)
+        return false;
+
+    auto & kept_array = ctx.kept.dest->array;
+    auto & removed_array = ctx.removed.dest->array;
+
+    // Each statement may access its own array,
+    // but not the array of the other statement.
+
+    if (a->array == removed_array || b->array == kept_array)
+        return false;
+
+    bool own_array = b->array == removed_array;
+
+    if (own_array ? a->array != kept_array : a->array != b->array)
+        return false;
+
+    if (a->indexes.size() != b->indexes.size())
+        return false;
+
+    for (int i = 0; i < (int) a->indexes.size(); ++i)
+    {
+        if (!equal_exprs(a->indexes[i], b->indexes[i], ctx))
+            return false;
+    }
+
+    isl::map b_map = b->map;
+    b_map.set_name(isl::space::input, ctx.kept.stmt->name);
+    if (own_array)
+        b_map.set_name(isl::space::output, kept_array->name);
+
+    isl::map a_relation = isl_map_intersect_domain(a->map.copy(), ctx.domain.copy());
+    isl::map b_relation = isl_map_intersect_domain(b_map.copy(), ctx.domain.copy());
+
+    return isl_map_is_equal(a_relation.get(), b_relation.get()) == isl_bool_true;
+}
+
+void common_subexpression_elimination::merge
+(const candidate & kept, const candidate & removed)
+{
+    auto kept_array = kept.dest->array;
+    auto removed_array = removed.dest->array;
+
+    if (verbose<common_subexpression_elimination>::enabled())
+    {
+        cout << "Merging statement " << removed.stmt->name
+             << " into " << kept.stmt->name
+             << " and array " << removed_array->name
+             << " into " << kept_array->name << "." << endl;
+    }
+
+    {
+        auto removed_domain = removed.stmt->domain;
+        removed_domain.set_name(kept.stmt->name);
+        kept.stmt->domain = kept.stmt->domain | removed_domain;
+        kept.stmt->domain.coalesce();
+        kept.stmt->is_infinite = kept.stmt->is_infinite || removed.stmt->is_infinite;
+
+        if (verbose<common_subexpression_elimination>::enabled())
+        {
+            cout << "  Merged domain: ";
+            m_printer.print(kept.stmt->domain);
+            cout << endl;
+        }
+    }
+
+    for (auto & stmt : m_model.statements)
+    {
+        if (stmt == removed.stmt)
+            continue;
+
+        for (auto & access : stmt->array_accesses)
+        {
+            if (access->array != removed_array)
+                continue;
+
+            assert_or_throw(!access->writing);
+
+            access->array = kept_array;
+            access->map.set_name(isl::space::output, kept_array->name);
+        }
+    }
+
+    for (auto & entry : m_model.phase_ids)
+    {
+        if (entry.second == removed_array)
+            entry.second = kept_array;
+    }
+
+    {
+        auto & stmts = m_model.statements;
+        stmts.erase(std::remove(stmts.begin(), stmts.end(), removed.stmt), stmts.end());
+
+        auto & arrays = m_model.arrays;
+        arrays.erase(std::remove(arrays.begin(), arrays.end(), removed_array), arrays.end());
+    }
+
+    ++m_merged_count;
+}
+
+}
+}
@@ -0,0 +1,88 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_CSE_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_CSE_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <isl-cpp/printer.hpp>
+
+namespace stream {
+namespace polyhedral {
+
+// Common subexpression elimination across statements.
+//
+// Two statements are merged if each is the only writer of its array,
+// the arrays have the same type and domain, the statements write
+// the same elements and compute the same expression from the same
+// elements. Elements of the statement's own array count as the same
+// if they are at the same relative position, so that equal recurrences
+// are merged too.
+//
+// The merged statement is defined on the union of both domains.
+// Readers of the removed array are redirected to the remaining one.
+// Merging is repeated until no more statements are equal.
+//
+// Statements with external calls are not merged,
+// because external functions may have side effects,
+// unless the functions are declared pure.
+
+class common_subexpression_elimination
+{
+public:
+    common_subexpression_elimination(model &);
+
+    void process();
+
+    int merged_count() const { return m_merged_count; }
+
+private:
+    struct candidate
+    {
+        stmt_ptr stmt;
+        shared_ptr<array_access> dest;
+    };
+
+    struct pair_context
+    {
+        const candidate & kept;
+        const candidate & removed;
+        isl::set domain;
+    };
+
+    bool find_candidate(const stmt_ptr &, candidate &);
+    bool are_equal(const candidate & kept, const candidate & removed);
+    bool equal_exprs(const expr_ptr & a, const expr_ptr & b, const pair_context &);
+    bool equal_accesses(const shared_ptr<array_access> & a,
+                        const shared_ptr<array_access> & b,
+                        const pair_context &);
+    void merge(const candidate & kept, const candidate & removed);
+
+    model & m_model;
+    isl::printer m_printer;
+    int m_merged_count = 0;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_CSE_INCLUDED
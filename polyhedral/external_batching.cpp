@@ -0,0 +1,287 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "external_batching.hpp"
+#include "../common/error.hpp"
+#include "../compiler/report.hpp"
+
+#include <isl-cpp/space.hpp>
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+external_batching::external_batching(model & m, const vector<string> & functions):
+    m_model(m),
+    m_functions(functions.begin(), functions.end()),
+    m_printer(m.context)
+{}
+
+void external_batching::process()
+{
+    if (m_functions.empty())
+        return;
+
+    std::map<string,int> counts;
+
+    // Transformation replaces statements, so iterate over a copy.
+    auto statements = m_model.statements;
+
+    for (auto & stmt : statements)
+    {
+        auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+        if (!assign)
+            continue;
+        auto call = dynamic_pointer_cast<external_call>(assign->value);
+        if (!call || call->is_builtin || !m_functions.count(call->name))
+            continue;
+
+        string reason;
+        if (transform(stmt, reason))
+        {
+            ++m_count;
+            ++counts[call->name];
+        }
+        else if (verbose<external_batching>::enabled())
+        {
+            cout << "Not batching call to " << call->name
+                 << " in statement " << stmt->name << ": " << reason << endl;
+        }
+    }
+
+    for (auto & entry : counts)
+        arrp::report()["batched_externals"][entry.first] = entry.second;
+}
+
+bool external_batching::transform(const stmt_ptr & stmt, string & reason)
+{
+    auto assign = static_pointer_cast<assignment>(stmt->expr);
+    auto call = static_pointer_cast<external_call>(assign->value);
+
+    auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+    if (!dest)
+    {
+        reason = "No array destination.";
+        return false;
+    }
+
+    // The statement writes element [i...,j] in instance [i...,j].
+
+    int dim_count = stmt->domain.dimensions();
+    int last = dim_count - 1;
+
+    if (dim_count < 1 || (int) dest->indexes.size() != dim_count ||
+            (int) dest->array->size.size() != dim_count)
+    {
+        reason = "Destination is not indexed by all statement dimensions.";
+        return false;
+    }
+
+    for (int dim = 0; dim < dim_count; ++dim)
+    {
+        auto it = dynamic_pointer_cast<iterator_read>(dest->indexes[dim]);
+        if (!it || it->index != dim)
+        {
+            reason = "Destination is not indexed by all statement dimensions.";
+            return false;
+        }
+    }
+
+    int count = dest->array->size[last];
+    if (count < 1)
+    {
+        reason = "Last dimension is infinite.";
+        return false;
+    }
+
+    // Each argument reads element [...,j] of an array
+    // with the same size of the last dimension.
+
+    vector<shared_ptr<array_access>> args;
+
+    for (auto & arg : call->args)
+    {
+        auto access = dynamic_pointer_cast<array_access>(arg);
+        if (!access || !access->reading || !access->type || !access->type->is_scalar())
+        {
+            reason = "An argument is not an array element.";
+            return false;
+        }
+
+        auto & indexes = access->indexes;
+        if (indexes.empty() || indexes.size() != access->array->size.size())
+        {
+            reason = "An argument is not an array element.";
+            return false;
+        }
+
+        auto it = dynamic_pointer_cast<iterator_read>(indexes.back());
+        if (!it || it->index != last)
+        {
+            reason = "An argument is not indexed by the last statement dimension.";
+            return false;
+        }
+
+        for (int i = 0; i < (int) indexes.size() - 1; ++i)
+        {
+            if (uses_iterator(indexes[i], last))
+            {
+                reason = "An argument is indexed by the last statement dimension twice.";
+                return false;
+            }
+        }
+
+        if (access->array->size.back() != count)
+        {
+            reason = "An argument has a different size of the last dimension.";
+            return false;
+        }
+
+        if (access->array == dest->array)
+        {
+            reason = "An argument reads the destination.";
+            return false;
+        }
+
+        args.push_back(access);
+    }
+
+    // The new statement has the outer dimensions of the statement,
+    // or a single dimension fixed at 0.
+
+    string name = stmt->name + "_batch";
+    int outer_dim_count = std::max(last, 1);
+
+    auto stmt_space = stmt->domain.get_space();
+    auto outer_space = isl::space(m_model.context,
+                                  isl::set_tuple(isl::identifier(name), outer_dim_count));
+
+    // Maps the new statement [i...] to the statement at [i...,j]
+    // for all j in the last dimension.
+
+    auto map_space = isl::space::from(outer_space, stmt_space).wrapped();
+    auto m = isl::basic_set::universe(map_space);
+    for (int dim = 0; dim < last; ++dim)
+        m.add_constraint(map_space.var(outer_dim_count + dim) == map_space.var(dim));
+    if (last == 0)
+        m.add_constraint(map_space.var(0) == 0);
+    m.add_constraint(map_space.var(outer_dim_count + last) >= 0);
+    m.add_constraint(map_space.var(outer_dim_count + last) < count);
+
+    isl::map slices = m.unwrapped();
+
+    // The statement domain must contain the entire last dimension
+    // for each value of the outer dimensions.
+
+    auto domain = slices.inverse()(stmt->domain);
+    domain.coalesce();
+
+    auto covered = slices(domain);
+    if (isl_set_is_equal(covered.get(), stmt->domain.get()) != isl_bool_true)
+    {
+        reason = "Statement domain does not contain entire slices.";
+        return false;
+    }
+
+    auto new_stmt = make_shared<statement>(domain);
+    new_stmt->is_infinite = stmt->is_infinite;
+
+    auto batched_call = make_shared<external_call>(call->location);
+    batched_call->name = call->name;
+
+    auto slice_of = [&](const shared_ptr<array_access> & access, bool writing)
+    {
+        auto result = make_shared<array_access>(*access);
+        result->indexes.pop_back();
+        result->map = access->map(slices);
+        result->reading = !writing;
+        result->writing = writing;
+        result->type = make_shared<functional::array_type>
+                (functional::array_size_vec{ count }, access->array->type);
+        new_stmt->array_accesses.push_back(result);
+        return result;
+    };
+
+    for (auto & arg : args)
+        batched_call->args.push_back(slice_of(arg, false));
+
+    batched_call->args.push_back(slice_of(dest, true));
+    batched_call->args.push_back(functional::make_signed_int(count));
+
+    // No result value.
+    batched_call->type = nullptr;
+
+    new_stmt->expr = batched_call;
+
+    if (verbose<external_batching>::enabled())
+    {
+        cout << "Batching call to " << call->name
+             << " in statement " << stmt->name
+             << " over " << count << " elements." << endl;
+        cout << "  Domain: ";
+        m_printer.print(new_stmt->domain);
+        cout << endl;
+    }
+
+    auto pos = std::find(m_model.statements.begin(), m_model.statements.end(), stmt);
+    assert_or_throw(pos != m_model.statements.end());
+    *pos = new_stmt;
+
+    return true;
+}
+
+bool external_batching::uses_iterator(const expr_ptr & e, int index)
+{
+    if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        return it->index == index;
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        for (auto & i : access->indexes)
+            if (uses_iterator(i, index))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (uses_iterator(operand.expr, index))
+                return true;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        for (auto & arg : call->args)
+            if (uses_iterator(arg, index))
+                return true;
+    }
+
+    return false;
+}
+
+}
+}
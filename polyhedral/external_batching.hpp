@@ -0,0 +1,71 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_EXTERNAL_BATCHING_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_EXTERNAL_BATCHING_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <isl-cpp/printer.hpp>
+
+#include <unordered_set>
+
+namespace stream {
+namespace polyhedral {
+
+// Batching of calls to external functions.
+//
+// A statement of the form
+//   y[i..., j] = f(a[i..., j], b[i..., j], ...)
+// where f is a batched external function with a scalar result,
+// and j ranges over the entire last dimension of all the arrays
+// for every i..., is replaced by a statement
+//   f(a[i...], b[i...], ..., y[i...], n)
+// which calls f once for all j, with a pointer to the first element
+// of each slice and the number of elements n.
+// The C++ implementation of f is thus called as
+//   void f(const A * a, const B * b, ..., Y * y, int n)
+//
+// Other statements calling f are left unchanged.
+
+class external_batching
+{
+public:
+    external_batching(model &, const vector<string> & functions);
+
+    void process();
+
+    int batched_count() const { return m_count; }
+
+private:
+    bool transform(const stmt_ptr &, string & reason);
+    bool uses_iterator(const expr_ptr &, int index);
+
+    model & m_model;
+    std::unordered_set<string> m_functions;
+    isl::printer m_printer;
+    int m_count = 0;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_EXTERNAL_BATCHING_INCLUDED
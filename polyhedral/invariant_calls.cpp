@@ -0,0 +1,369 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+
+#include "invariant_calls.hpp"
+#include "../common/error.hpp"
+
+#include <isl-cpp/space.hpp>
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+invariant_call_motion::invariant_call_motion(model & m):
+    m_model(m),
+    m_printer(m.context)
+{}
+
+void invariant_call_motion::process()
+{
+    // New statements are added, so iterate over a copy.
+    auto statements = m_model.statements;
+
+    for (auto & stmt : statements)
+    {
+        if (stmt->is_input_or_output)
+            continue;
+
+        auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+        if (!assign)
+            continue;
+
+        auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+        if (!dest)
+            continue;
+
+        m_moved_accesses.clear();
+
+        assign->value = move_calls(assign->value, stmt, dest->array.get());
+
+        // Accesses by moved calls now belong to the new statements.
+
+        auto & accesses = stmt->array_accesses;
+        accesses.erase(std::remove_if(accesses.begin(), accesses.end(),
+                                      [&](const shared_ptr<array_access> & a){
+            return m_moved_accesses.count(a.get()) > 0;
+        }), accesses.end());
+    }
+}
+
+expr_ptr invariant_call_motion::move_calls
+(const expr_ptr & e, const stmt_ptr & stmt, array * dest)
+{
+    if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            operand.expr = move_calls(operand.expr, stmt, dest);
+        return e;
+    }
+
+    auto call = dynamic_pointer_cast<external_call>(e);
+    if (!call)
+        return e;
+
+    // Inner calls are moved first, so that they are not
+    // repeated for each instance of an outer call.
+
+    for (auto & arg : call->args)
+        arg = move_calls(arg, stmt, dest);
+
+    if (!call->attributes.pure || !call->type || !call->type->is_scalar())
+        return e;
+
+    int dim_count = stmt->domain.dimensions();
+
+    vector<bool> used_dims(dim_count, false);
+    for (auto & arg : call->args)
+    {
+        if (!is_movable(arg, dest, used_dims))
+            return e;
+    }
+
+    // The call is invariant in unused dimensions with more than one value.
+
+    vector<int> dims;
+    bool is_invariant = false;
+
+    for (int dim = 0; dim < dim_count; ++dim)
+    {
+        if (used_dims[dim])
+        {
+            dims.push_back(dim);
+            continue;
+        }
+
+        auto v = stmt->domain.get_space().var(dim);
+        auto min = stmt->domain.minimum(v);
+        auto max = stmt->domain.maximum(v);
+        if (!min.is_integer() || !max.is_integer() || min.integer() != max.integer())
+            is_invariant = true;
+    }
+
+    if (dims.empty() || !is_invariant)
+        return e;
+
+    return move(call, stmt, dims);
+}
+
+expr_ptr invariant_call_motion::move
+(const shared_ptr<external_call> & call, const stmt_ptr & stmt, const vector<int> & dims)
+{
+    auto assign = static_pointer_cast<assignment>(stmt->expr);
+    auto dest = static_pointer_cast<array_access>(assign->destination);
+
+    string array_name = dest->array->name + ".call" + to_string(m_count);
+    string stmt_name = array_name + ".s";
+
+    int dim_count = stmt->domain.dimensions();
+    int new_dim_count = dims.size();
+
+    auto stmt_space = stmt->domain.get_space();
+    auto space = isl::space(m_model.context,
+                            isl::set_tuple(isl::identifier(stmt_name), new_dim_count));
+
+    // Maps the statement at [i...,j...] to the new statement at [i...].
+
+    isl::map to_new(nullptr);
+    {
+        auto map_space = isl::space::from(stmt_space, space).wrapped();
+        auto m = isl::basic_set::universe(map_space);
+        for (int k = 0; k < new_dim_count; ++k)
+            m.add_constraint(map_space.var(dim_count + k) == map_space.var(dims[k]));
+        to_new = m.unwrapped();
+    }
+
+    auto domain = to_new(stmt->domain);
+    domain.coalesce();
+
+    // The new array is indexed by the iterators of the new statement,
+    // so they must range from 0, and only the first may be unbounded.
+
+    vector<int> size;
+    bool is_infinite = false;
+
+    for (int k = 0; k < new_dim_count; ++k)
+    {
+        auto v = domain.get_space().var(k);
+        auto min = domain.minimum(v);
+        auto max = domain.maximum(v);
+
+        if (!min.is_integer() || min.integer() < 0)
+            return call;
+
+        if (max.is_integer())
+        {
+            size.push_back(max.integer() + 1);
+        }
+        else if (k == 0)
+        {
+            size.push_back(infinite);
+            is_infinite = true;
+        }
+        else
+        {
+            return call;
+        }
+    }
+
+    auto array_space = isl::space(m_model.context,
+                                  isl::set_tuple(isl::identifier(array_name), new_dim_count));
+    auto array_domain = isl::set::universe(array_space);
+    for (int k = 0; k < new_dim_count; ++k)
+    {
+        array_domain.add_constraint(array_space.var(k) >= 0);
+        if (size[k] != infinite)
+            array_domain.add_constraint(array_space.var(k) < size[k]);
+    }
+
+    auto arr = make_shared<array>(array_name, array_domain, call->type->scalar()->primitive);
+    arr->is_infinite = is_infinite;
+    arr->size = size;
+    m_model.arrays.push_back(arr);
+
+    // The new statement at [i...] writes element [i...].
+
+    isl::map write_map(nullptr);
+    {
+        auto map_space = isl::space::from(space, array_space).wrapped();
+        auto m = isl::basic_set::universe(map_space);
+        for (int k = 0; k < new_dim_count; ++k)
+            m.add_constraint(map_space.var(new_dim_count + k) == map_space.var(k));
+        write_map = m.unwrapped();
+    }
+
+    auto new_stmt = make_shared<statement>(domain);
+    new_stmt->is_infinite = is_infinite;
+
+    vector<int> dim_map(dim_count, -1);
+    for (int k = 0; k < new_dim_count; ++k)
+        dim_map[dims[k]] = k;
+
+    auto value = relocated(call, dim_map, to_new.inverse(), new_stmt);
+
+    auto write = make_shared<array_access>();
+    write->location = call->location;
+    write->type = call->type;
+    write->array = arr;
+    write->writing = true;
+    write->map = write_map;
+    for (int k = 0; k < new_dim_count; ++k)
+        write->indexes.push_back(make_shared<iterator_read>(k));
+    new_stmt->array_accesses.push_back(write);
+
+    new_stmt->expr = make_shared<assignment>(write, value);
+
+    auto pos = std::find(m_model.statements.begin(), m_model.statements.end(), stmt);
+    assert_or_throw(pos != m_model.statements.end());
+    m_model.statements.insert(pos, new_stmt);
+
+    // The call is replaced by a read of the new array.
+
+    auto read = make_shared<array_access>();
+    read->location = call->location;
+    read->type = call->type;
+    read->array = arr;
+    read->reading = true;
+    read->map = write_map(to_new);
+    for (int dim : dims)
+        read->indexes.push_back(make_shared<iterator_read>(dim));
+    stmt->array_accesses.push_back(read);
+
+    if (verbose<invariant_call_motion>::enabled())
+    {
+        cout << "Moved call to " << call->name
+             << " out of statement " << stmt->name
+             << " into " << stmt_name << "." << endl;
+        cout << "  Domain: ";
+        m_printer.print(new_stmt->domain);
+        cout << endl;
+    }
+
+    ++m_count;
+
+    return read;
+}
+
+bool invariant_call_motion::is_movable
+(const expr_ptr & e, array * dest, vector<bool> & used_dims)
+{
+    if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        used_dims[it->index] = true;
+        return true;
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        if (!access->reading || access->array.get() == dest)
+            return false;
+        if (!access->type || !access->type->is_scalar())
+            return false;
+        for (auto & index : access->indexes)
+        {
+            if (!is_movable(index, dest, used_dims))
+                return false;
+        }
+        return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+        {
+            if (!is_movable(operand.expr, dest, used_dims))
+                return false;
+        }
+        return true;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        if (!call->attributes.pure || !call->type || !call->type->is_scalar())
+            return false;
+        for (auto & arg : call->args)
+        {
+            if (!is_movable(arg, dest, used_dims))
+                return false;
+        }
+        return true;
+    }
+    else if (dynamic_pointer_cast<functional::int_const>(e) ||
+             dynamic_pointer_cast<functional::real_const>(e) ||
+             dynamic_pointer_cast<functional::complex_const>(e) ||
+             dynamic_pointer_cast<functional::bool_const>(e))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+expr_ptr invariant_call_motion::relocated
+(const expr_ptr & e, const vector<int> & dim_map,
+ const isl::map & to_stmt, const stmt_ptr & new_stmt)
+{
+    if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        return make_shared<iterator_read>(dim_map[it->index], it->location);
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        auto result = make_shared<array_access>(*access);
+        result->indexes.clear();
+        for (auto & index : access->indexes)
+            result->indexes.push_back(relocated(index, dim_map, to_stmt, new_stmt));
+
+        result->map = access->map(to_stmt);
+
+        new_stmt->array_accesses.push_back(result);
+        m_moved_accesses.insert(access.get());
+        return result;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        auto result = make_shared<functional::primitive>(*op);
+        for (auto & operand : result->operands)
+            operand.expr = relocated(operand.expr, dim_map, to_stmt, new_stmt);
+        return result;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        auto result = make_shared<external_call>(*call);
+        for (auto & arg : result->args)
+            arg = relocated(arg, dim_map, to_stmt, new_stmt);
+        return result;
+    }
+    else if (dynamic_pointer_cast<functional::int_const>(e) ||
+             dynamic_pointer_cast<functional::real_const>(e) ||
+             dynamic_pointer_cast<functional::complex_const>(e) ||
+             dynamic_pointer_cast<functional::bool_const>(e))
+    {
+        return e;
+    }
+
+    throw error("Unexpected expression in moved call.");
+}
+
+}
+}
@@ -0,0 +1,76 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_INVARIANT_CALLS_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_INVARIANT_CALLS_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <isl-cpp/printer.hpp>
+
+#include <unordered_set>
+
+namespace stream {
+namespace polyhedral {
+
+// Loop-invariant motion of calls to pure external functions.
+//
+// In a statement
+//   y[i,j] = ... f(a[i]) ...
+// where f is declared pure, has a scalar result, and its arguments
+// do not depend on some dimensions of the statement (here j),
+// the call is moved into a new statement over the other dimensions:
+//   t[i] = f(a[i])
+//   y[i,j] = ... t[i] ...
+// so that f is called once for all j.
+//
+// Arguments may be array elements, iterators, constants,
+// primitive operations and calls to other pure functions.
+// Calls which read the array written by the statement are not moved.
+
+class invariant_call_motion
+{
+public:
+    invariant_call_motion(model &);
+
+    void process();
+
+    int moved_count() const { return m_count; }
+
+private:
+    expr_ptr move_calls(const expr_ptr &, const stmt_ptr &, array * dest);
+    expr_ptr move(const shared_ptr<external_call> &, const stmt_ptr &,
+                  const vector<int> & dims);
+    bool is_movable(const expr_ptr &, array * dest, vector<bool> & used_dims);
+    expr_ptr relocated(const expr_ptr &, const vector<int> & dim_map,
+                       const isl::map & to_stmt, const stmt_ptr & new_stmt);
+
+    model & m_model;
+    isl::printer m_printer;
+    // Accesses of the original statement moved into new statements.
+    std::unordered_set<array_access*> m_moved_accesses;
+    int m_count = 0;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_INVARIANT_CALLS_INCLUDED
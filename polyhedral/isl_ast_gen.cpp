@@ -19,6 +19,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "isl_ast_gen.hpp"
+#include "utility.hpp"
 #include "../utility/debug.hpp"
 #include "../utility/stacker.hpp"
 
@@ -29,6 +30,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <isl-cpp/schedule.hpp>
 
 #include <iostream>
+#include <memory>
 
 using namespace std;
 
@@ -94,7 +96,8 @@ ast_gen::ast_gen(model & m, schedule & s, const options & opt):
     m_schedule(s),
     m_options(opt),
     m_printer(m.context),
-    m_order(compute_order())
+    m_order(compute_order()),
+    m_thread_unsafe_statements(find_thread_unsafe_statements())
 {
 
 }
@@ -113,6 +116,67 @@ isl::union_map ast_gen::compute_order()
     return order;
 }
 
+static bool has_thread_unsafe_call(const expr_ptr & e)
+{
+    if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        if (!call->attributes.thread_safe)
+            return true;
+        for (auto & arg : call->args)
+            if (has_thread_unsafe_call(arg))
+                return true;
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        return has_thread_unsafe_call(assign->value);
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (has_thread_unsafe_call(operand.expr))
+                return true;
+    }
+
+    return false;
+}
+
+unordered_set<string> ast_gen::find_thread_unsafe_statements()
+{
+    // IO statements are excluded: their order is
+    // already constrained by the model.
+
+    unordered_set<string> names;
+    for (auto & stmt : m_model.statements)
+    {
+        if (stmt->is_input_or_output)
+            continue;
+        if (has_thread_unsafe_call(stmt->expr))
+            names.insert(stmt->name);
+    }
+    return names;
+}
+
+bool ast_gen::calls_thread_unsafe_function(isl_ast_build * builder)
+{
+    if (m_thread_unsafe_statements.empty())
+        return false;
+
+    isl::union_map schedule = isl_ast_build_get_schedule(builder);
+
+    bool found = false;
+    schedule.for_each([&](const isl::map & m){
+        auto name = m.get_space().id(isl::space::input).name();
+        if (m_thread_unsafe_statements.count(name))
+        {
+            found = true;
+            return false;
+        }
+        return true;
+    });
+
+    return found;
+}
+
 isl_ast_build * ast_gen::set_loop_iterators(isl_ast_build * ast, int count, int parallel_loop)
 {
     auto ctx = isl_ast_build_get_ctx(ast);
@@ -199,22 +263,33 @@ ast_isl ast_gen::generate()
     // Initialize parallel accesses to empty map
     m_model.parallel_accesses = isl::union_map(m_model.context);
 
-    if (m_schedule.tree.get())
+    vector<std::thread> workers;
+    vector<std::exception_ptr> errors;
+
+    if (can_generate_in_parallel())
     {
-        if (verbose<ast_gen>::enabled())
-            cout << endl << "** Building AST for entire program." << endl;
-        m_allow_parallel_for = false;
-        output.full =
-                isl_ast_build_node_from_schedule(build, m_schedule.tree.copy());
+        start_parallel_generation(output, workers, errors);
     }
-    if (m_schedule.prelude_tree.get())
+    else
     {
-        if (verbose<ast_gen>::enabled())
-            cout << endl << "** Building AST for prelude." << endl;
-        m_allow_parallel_for = false;
-        output.prelude =
-                isl_ast_build_node_from_schedule(build, m_schedule.prelude_tree.copy());
+        if (m_schedule.tree.get())
+        {
+            if (verbose<ast_gen>::enabled())
+                cout << endl << "** Building AST for entire program." << endl;
+            m_allow_parallel_for = false;
+            output.full =
+                    isl_ast_build_node_from_schedule(build, m_schedule.tree.copy());
+        }
+        if (m_schedule.prelude_tree.get())
+        {
+            if (verbose<ast_gen>::enabled())
+                cout << endl << "** Building AST for prelude." << endl;
+            m_allow_parallel_for = false;
+            output.prelude =
+                    isl_ast_build_node_from_schedule(build, m_schedule.prelude_tree.copy());
+        }
     }
+
     if (m_schedule.period_tree.get())
     {
         if (verbose<ast_gen>::enabled())
@@ -231,8 +306,26 @@ ast_isl ast_gen::generate()
 
         build = set_loop_iterators(build, num_sched_dim, m_options.parallel_dim);
 
-        output.period =
-                isl_ast_build_node_from_schedule(build, m_schedule.period_tree.copy());
+        try
+        {
+            output.period =
+                    isl_ast_build_node_from_schedule(build, m_schedule.period_tree.copy());
+        }
+        catch (...)
+        {
+            for (auto & worker : workers)
+                worker.join();
+            throw;
+        }
+    }
+
+    for (auto & worker : workers)
+        worker.join();
+
+    for (auto & e : errors)
+    {
+        if (e)
+            std::rethrow_exception(e);
     }
 
     isl_ast_build_free(build);
@@ -240,6 +333,91 @@ ast_isl ast_gen::generate()
     return output;
 }
 
+// ASTs are generated in parallel if requested, unless they are printed
+// or contain parameters, which would need renaming like statements.
+
+bool ast_gen::can_generate_in_parallel()
+{
+    if (m_options.jobs < 2 || m_options.separate_loops)
+        return false;
+
+    if (verbose<ast_gen>::enabled() || verbose<ast_isl>::enabled())
+        return false;
+
+    if (!m_schedule.period_tree.get())
+        return false;
+
+    if (!m_schedule.params.get() ||
+            m_schedule.params.get_space().dimension(isl::space::parameter) != 0)
+        return false;
+
+    return true;
+}
+
+// Starts generating ASTs for the entire program and the prelude,
+// each on a separate thread. isl contexts are not thread-safe,
+// so each thread uses its own context, with the schedule transferred
+// in text form and statements renamed, as in storage allocation.
+// The contexts are kept in the output, since they own the ASTs.
+// Loops in these ASTs are never parallel, so they need no annotations.
+
+void ast_gen::start_parallel_generation(ast_isl & output,
+                                        vector<std::thread> & workers,
+                                        vector<std::exception_ptr> & errors)
+{
+    unordered_map<string,string> names;
+    for (int i = 0; i < (int) m_model.statements.size(); ++i)
+    {
+        string name = "S" + to_string(i);
+        names.emplace(m_model.statements[i]->name, name);
+        output.statement_names.emplace(name, m_model.statements[i]->name);
+    }
+
+    struct job
+    {
+        isl_ast_node ** node;
+        string schedule_text;
+        shared_ptr<isl::context> context;
+    };
+
+    vector<job> jobs;
+
+    auto add_job = [&](isl::schedule & schedule, isl_ast_node ** node)
+    {
+        if (!schedule.get())
+            return;
+        auto text = arrp::to_text(arrp::renamed_tuples(schedule.map_on_domain(), names));
+        auto context = make_shared<isl::context>();
+        context->set_error_action(isl::context::abort_on_error);
+        output.contexts.push_back(context);
+        jobs.push_back({ node, text, context });
+    };
+
+    add_job(m_schedule.tree, &output.full);
+    add_job(m_schedule.prelude_tree, &output.prelude);
+
+    errors.resize(jobs.size());
+
+    for (int i = 0; i < (int) jobs.size(); ++i)
+    {
+        workers.emplace_back([&errors, i, job = jobs[i]]()
+        {
+            try
+            {
+                isl_ctx * ctx = job.context->get();
+                auto schedule = isl_union_map_read_from_str(ctx, job.schedule_text.c_str());
+                auto build = isl_ast_build_alloc(ctx);
+                *job.node = isl_ast_build_node_from_schedule_map(build, schedule);
+                isl_ast_build_free(build);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+}
+
 isl_id * ast_gen::before_for(isl_ast_build *builder)
 {
     if (verbose<ast_gen>::enabled())
@@ -321,6 +499,11 @@ isl_ast_node * ast_gen::after_for(isl_ast_node *node, isl_ast_build * builder)
         if (verbose<ast_gen>::enabled())
             cout << "   Not parallelizable." << endl;
     }
+    else if (calls_thread_unsafe_function(builder))
+    {
+        if (verbose<ast_gen>::enabled())
+            cout << "   Calls external functions which are not thread-safe." << endl;
+    }
     else if (m_options.parallel_dim < 0)
     {
         if (m_num_parallelizable_loops != 1)
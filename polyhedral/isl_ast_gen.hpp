@@ -27,6 +27,9 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <isl/ast_build.h>
 #include <isl/id.h>
 #include <stack>
+#include <unordered_set>
+#include <thread>
+#include <exception>
 
 namespace stream {
 namespace polyhedral {
@@ -40,6 +43,9 @@ public:
         bool parallel = false;
         int parallel_dim = -1;
         bool vectorize = false;
+        // With more than one job, ASTs for the entire program
+        // and the prelude are generated concurrently with the period.
+        int jobs = 1;
     };
 
     ast_gen(model &, schedule &, const options &);
@@ -48,7 +54,13 @@ public:
 
 private:
 
+    bool can_generate_in_parallel();
+    void start_parallel_generation(ast_isl &, std::vector<std::thread> &,
+                                   std::vector<std::exception_ptr> &);
+
     isl::union_map compute_order();
+    std::unordered_set<string> find_thread_unsafe_statements();
+    bool calls_thread_unsafe_function(isl_ast_build *);
 
     isl_ast_build * set_loop_iterators(isl_ast_build *, int count, int parallel_loop);
 
@@ -75,6 +87,7 @@ private:
     options m_options;
     isl::printer m_printer;
     isl::union_map m_order;
+    std::unordered_set<string> m_thread_unsafe_statements;
 
     bool m_allow_parallel_for = false;
     int m_parallel_loop_id = 0;
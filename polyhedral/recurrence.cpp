@@ -0,0 +1,1003 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "recurrence.hpp"
+#include "../common/error.hpp"
+
+#include <isl-cpp/space.hpp>
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+#include <isl-cpp/utility.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+static bool constant_value(const expr_ptr & e, double & value)
+{
+    if (auto c = dynamic_pointer_cast<functional::real_const>(e))
+    {
+        value = c->value;
+        return true;
+    }
+    if (auto c = dynamic_pointer_cast<functional::int_const>(e))
+    {
+        value = c->signed_value();
+        return true;
+    }
+    if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        if (op->kind == primitive_op::negate && constant_value(op->operands[0], value))
+        {
+            value = -value;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Maximum number of subexpressions visited while expanding
+// the terms of a recurrence.
+static const int max_expansion_size = 1 << 12;
+
+static bool is_unbounded(const isl::set & domain)
+{
+    auto time_var = domain.get_space()(isl::space::variable, 0);
+    try {
+        return domain.maximum(time_var).is_infinity();
+    } catch (isl::error &) {
+        throw error("Could not check whether statement domain is infinite.");
+    }
+}
+
+recurrence_lookahead::recurrence_lookahead(model & m, int distance):
+    m_model(m),
+    m_distance(distance),
+    m_printer(m.context)
+{}
+
+void recurrence_lookahead::process()
+{
+    if (m_distance < 2)
+        return;
+
+    // Transformation adds statements, so iterate over a copy.
+    auto statements = m_model.statements;
+
+    for (auto & stmt : statements)
+    {
+        recurrence rec;
+        if (!analyze(stmt, rec))
+            continue;
+
+        if (transform(rec))
+        {
+            ++m_transformed_count;
+            m_intermediates.insert(rec.intermediates.begin(), rec.intermediates.end());
+        }
+    }
+
+    remove_unused_instances();
+}
+
+void recurrence_lookahead::reject(const recurrence & rec, const string & reason)
+{
+    m_rejected[rec.stmt->name] = reason;
+
+    if (verbose<recurrence_lookahead>::enabled())
+        cout << "Not transforming statement " << rec.stmt->name << ": " << reason << endl;
+}
+
+bool recurrence_lookahead::analyze(const stmt_ptr & stmt, recurrence & rec)
+{
+    if (stmt->is_input_or_output)
+        return false;
+
+    auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+    if (!assign)
+        return false;
+
+    auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+    if (!dest || !is_real(dest->array->type))
+        return false;
+
+    int dim_count = stmt->domain.dimensions();
+    if (dim_count < 1 || (int) dest->indexes.size() != dim_count)
+        return false;
+
+    for (int dim = 0; dim < dim_count; ++dim)
+    {
+        auto it = dynamic_pointer_cast<iterator_read>(dest->indexes[dim]);
+        if (!it || it->index != dim)
+            return false;
+    }
+
+    rec.stmt = stmt;
+    rec.dest = dest;
+    rec.domain = stmt->domain;
+    rec.budget = max_expansion_size;
+
+    vector<term> terms;
+    collect_terms(assign->value, 1, terms);
+
+    bool calls_impure_function = false;
+
+    for (auto & t : terms)
+    {
+        if (!recurrent_read(t.expr, dest->array))
+        {
+            // External calls may have side effects,
+            // so they must not be evaluated more than once,
+            // unless they are declared pure.
+            if (has_impure_external_call(t.expr))
+                calls_impure_function = true;
+
+            rec.rest.push_back(t);
+            continue;
+        }
+
+        isl::map instances = isl_set_identity(rec.domain.copy());
+
+        string reason;
+        if (!expand(t.expr, instances, t.sign, rec, reason))
+        {
+            reject(rec, reason);
+            return false;
+        }
+    }
+
+    for (auto c = rec.coefs.begin(); c != rec.coefs.end(); )
+    {
+        if (c->second == 0)
+            c = rec.coefs.erase(c);
+        else
+            ++c;
+    }
+
+    if (rec.coefs.empty() || rec.rest.empty())
+        return false;
+
+    if (calls_impure_function)
+    {
+        reject(rec, "Calls an external function which is not pure.");
+        return false;
+    }
+
+    if (rec.domain.is_empty())
+        return false;
+
+    int shortest_lag = rec.coefs.begin()->first;
+    if (shortest_lag >= m_distance)
+    {
+        m_satisfied[stmt->name] = shortest_lag;
+
+        if (verbose<recurrence_lookahead>::enabled())
+            cout << "Not transforming statement " << stmt->name << ": "
+                 << dest->array->name << " is only read at least "
+                 << shortest_lag << " steps back." << endl;
+        return false;
+    }
+
+    if (verbose<recurrence_lookahead>::enabled())
+    {
+        cout << "Linear recurrence in statement " << stmt->name << ":" << endl;
+        cout << "  " << dest->array->name << "[t] = r(t)";
+        for (auto & c : rec.coefs)
+            cout << " + " << c.second << " * " << dest->array->name << "[t-" << c.first << "]";
+        cout << endl;
+        for (auto & a : rec.intermediates)
+            cout << "  Through array " << a->name << endl;
+        cout << "  Domain: ";
+        m_printer.print(rec.domain);
+        cout << endl;
+    }
+
+    return true;
+}
+
+void recurrence_lookahead::collect_terms(const expr_ptr & e, double sign, vector<term> & terms)
+{
+    auto op = dynamic_pointer_cast<functional::primitive>(e);
+    if (op && op->type && op->type->is_scalar() && is_real(op->type->scalar()->primitive))
+    {
+        switch(op->kind)
+        {
+        case primitive_op::add:
+            collect_terms(op->operands[0], sign, terms);
+            collect_terms(op->operands[1], sign, terms);
+            return;
+        case primitive_op::subtract:
+            collect_terms(op->operands[0], sign, terms);
+            collect_terms(op->operands[1], -sign, terms);
+            return;
+        case primitive_op::negate:
+            collect_terms(op->operands[0], -sign, terms);
+            return;
+        default:;
+        }
+    }
+
+    terms.push_back({ e, sign });
+}
+
+// Adds the expression 'e' evaluated at 'instances' (a relation
+// from instances of the recurrence to instances of the statement
+// containing 'e'), multiplied by 'coef', to the coefficients of
+// the recurrence. Reads of other arrays are expanded into the
+// expressions of the statements which compute the elements read.
+// The domain of the recurrence is restricted to where all the
+// elements read are computed by the same statements.
+
+bool recurrence_lookahead::expand
+(const expr_ptr & e, const isl::map & instances, double coef,
+ recurrence & rec, string & reason)
+{
+    auto & y = rec.dest->array;
+
+    if (--rec.budget < 0)
+    {
+        reason = "The expression using " + y->name + " is too large to analyze.";
+        return false;
+    }
+
+    if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        double c;
+
+        switch(op->kind)
+        {
+        case primitive_op::add:
+            return expand(op->operands[0], instances, coef, rec, reason) &&
+                    expand(op->operands[1], instances, coef, rec, reason);
+        case primitive_op::subtract:
+            return expand(op->operands[0], instances, coef, rec, reason) &&
+                    expand(op->operands[1], instances, -coef, rec, reason);
+        case primitive_op::negate:
+            return expand(op->operands[0], instances, -coef, rec, reason);
+        case primitive_op::multiply:
+        {
+            isl::set points = instances.range();
+            if (evaluate(op->operands[0], points, c, rec))
+                return expand(op->operands[1], instances, coef * c, rec, reason);
+            if (evaluate(op->operands[1], points, c, rec))
+                return expand(op->operands[0], instances, coef * c, rec, reason);
+            reason = "Multiplies " + y->name + " by a value which is not constant.";
+            return false;
+        }
+        case primitive_op::divide:
+        {
+            if (evaluate(op->operands[1], instances.range(), c, rec) && c != 0)
+                return expand(op->operands[0], instances, coef / c, rec, reason);
+            reason = "Divides " + y->name + " by a value which is not constant.";
+            return false;
+        }
+        default:;
+        }
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        if (access->array == y)
+        {
+            int lag;
+            if (!self_read_lag(access->map(instances), rec, lag))
+            {
+                reason = "Uses an element of " + y->name +
+                        " which is not a fixed number of steps back.";
+                return false;
+            }
+            rec.coefs[lag] += coef;
+            return true;
+        }
+
+        stmt_ptr writer;
+        isl::map writer_instances { nullptr };
+        if (!follow_read(access, instances, rec, writer, writer_instances, reason))
+            return false;
+
+        rec.intermediates.insert(access->array.get());
+
+        auto assign = dynamic_pointer_cast<assignment>(writer->expr);
+        return expand(assign->value, writer_instances, coef, rec, reason);
+    }
+
+    // Terms which do not depend on y must be zero,
+    // like the initial value of a delay.
+
+    double c;
+    if (evaluate(e, instances.range(), c, rec) && c == 0)
+        return true;
+
+    reason = "Uses " + y->name + " other than in a linear combination"
+            " of earlier elements with constant coefficients.";
+    return false;
+}
+
+struct point_coordinates
+{
+    int dimensions;
+    vector<int64_t> values;
+};
+
+static isl_stat store_point(isl_point * p, void * data)
+{
+    auto & point = *reinterpret_cast<point_coordinates*>(data);
+
+    for (int d = 0; d < point.dimensions; ++d)
+    {
+        isl_val * v = isl_point_get_coordinate_val(p, isl_dim_set, d);
+        point.values.push_back(isl_val_get_num_si(v));
+        isl_val_free(v);
+    }
+
+    isl_point_free(p);
+    return isl_stat_ok;
+}
+
+// Coordinates of the only element of a set.
+
+static bool single_point(isl::set s, vector<int64_t> & coordinates)
+{
+    if (isl_set_is_singleton(s.get()) != isl_bool_true)
+        return false;
+
+    point_coordinates point;
+    point.dimensions = s.get_space().dimension(isl::space::variable);
+
+    if (isl_set_foreach_point(s.get(), &store_point, &point) != isl_stat_ok)
+        return false;
+    if ((int) point.values.size() != point.dimensions)
+        return false;
+
+    coordinates = point.values;
+    return true;
+}
+
+// Evaluates an expression which has the same value
+// at all 'instances' of the statement containing it.
+
+bool recurrence_lookahead::evaluate
+(const expr_ptr & e, isl::set instances, double & value, recurrence & rec)
+{
+    if (--rec.budget < 0)
+        return false;
+
+    if (constant_value(e, value))
+        return true;
+
+    if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        vector<double> args;
+        for (auto & operand : op->operands)
+        {
+            double v;
+            if (!evaluate(operand.expr, instances, v, rec))
+                return false;
+            args.push_back(v);
+        }
+
+        switch(op->kind)
+        {
+        case primitive_op::negate:
+            value = -args[0]; return true;
+        case primitive_op::add:
+            value = args[0] + args[1]; return true;
+        case primitive_op::subtract:
+            value = args[0] - args[1]; return true;
+        case primitive_op::multiply:
+            value = args[0] * args[1]; return true;
+        case primitive_op::divide:
+            if (args[1] == 0)
+                return false;
+            value = args[0] / args[1]; return true;
+        case primitive_op::to_real32:
+            value = float(args[0]); return true;
+        case primitive_op::to_real64:
+            value = args[0]; return true;
+        default:
+            return false;
+        }
+    }
+    else if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        if (it->index >= instances.dimensions())
+            return false;
+        auto v = instances.get_space().var(it->index);
+        auto min = instances.minimum(v);
+        auto max = instances.maximum(v);
+        if (!min.is_integer() || !max.is_integer() || min.integer() != max.integer())
+            return false;
+        value = min.integer();
+        return true;
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        auto & a = access->array;
+
+        isl::set elements = isl_set_apply(instances.copy(), access->map.copy());
+
+        vector<int64_t> index;
+        if (!single_point(elements, index))
+            return false;
+
+        if (!a->constant_values.empty())
+        {
+            if (index.size() != a->size.size())
+                return false;
+            int64_t element = 0;
+            for (int d = 0; d < (int) index.size(); ++d)
+            {
+                if (index[d] < 0 || index[d] >= a->size[d])
+                    return false;
+                element = element * a->size[d] + index[d];
+            }
+            auto & c = a->constant_values[element];
+            if (is_real(a->type))
+                value = c.number.real();
+            else if (is_signed_int(a->type))
+                value = double(int64_t(c.bits));
+            else if (is_integer(a->type))
+                value = double(c.bits);
+            else
+                return false;
+            return true;
+        }
+
+        if (a == rec.dest->array)
+            return false;
+
+        for (auto & writer : m_model.statements)
+        {
+            auto assign = dynamic_pointer_cast<assignment>(writer->expr);
+            if (!assign || writer->is_input_or_output)
+                continue;
+            auto write = dynamic_pointer_cast<array_access>(assign->destination);
+            if (!write || write->array != a)
+                continue;
+
+            isl::set writer_instance =
+                    isl_set_apply(elements.copy(), write->map.inverse().copy());
+            writer_instance = writer_instance & writer->domain;
+            if (writer_instance.is_empty())
+                continue;
+
+            return evaluate(assign->value, writer_instance, value, rec);
+        }
+    }
+
+    return false;
+}
+
+// Finds the statement which computes the elements read by 'access'
+// at 'instances' (a relation from instances of the recurrence).
+// If the elements are computed by different statements at
+// different instances of a stream, the statement computing them
+// in the steady state is chosen.
+
+bool recurrence_lookahead::follow_read
+(const shared_ptr<array_access> & access, const isl::map & instances,
+ recurrence & rec, stmt_ptr & writer, isl::map & writer_instances,
+ string & reason)
+{
+    auto & y = rec.dest->array;
+    auto & a = access->array;
+
+    auto elements = access->map(instances);
+
+    vector<pair<stmt_ptr, isl::map>> candidates;
+
+    for (auto & stmt : m_model.statements)
+    {
+        auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+        if (!assign)
+            continue;
+        auto write = dynamic_pointer_cast<array_access>(assign->destination);
+        if (!write || write->array != a)
+            continue;
+
+        auto found = write->map.in_domain(stmt->domain).inverse()(elements);
+        found = found.in_domain(rec.domain);
+        if (found.is_empty())
+            continue;
+
+        candidates.emplace_back(stmt, found);
+    }
+
+    if (candidates.size() > 1)
+    {
+        decltype(candidates) steady;
+        for (auto & candidate : candidates)
+        {
+            if (is_unbounded(candidate.second.domain()))
+                steady.push_back(candidate);
+        }
+        candidates = steady;
+    }
+
+    if (candidates.size() != 1)
+    {
+        reason = y->name + " is used through array " + a->name +
+                ", which is not computed by a single statement.";
+        return false;
+    }
+
+    writer = candidates[0].first;
+    writer_instances = candidates[0].second;
+
+    if (isl_map_is_single_valued(writer_instances.get()) != isl_bool_true)
+    {
+        reason = y->name + " is used through array " + a->name +
+                ", with elements not computed by a single instance.";
+        return false;
+    }
+
+    rec.domain = rec.domain & writer_instances.domain();
+
+    return true;
+}
+
+// Gets the number of steps back of the elements of the recurrent
+// array read by all instances of the recurrence, if it is the same.
+
+bool recurrence_lookahead::self_read_lag
+(const isl::map & elements, const recurrence & rec, int & lag)
+{
+    isl::map steps = rec.dest->map.inverse()(elements);
+    isl::set distances = isl_map_deltas(steps.copy());
+
+    vector<int64_t> distance;
+    if (!single_point(distances, distance))
+        return false;
+
+    for (int dim = 1; dim < (int) distance.size(); ++dim)
+    {
+        if (distance[dim] != 0)
+            return false;
+    }
+
+    if (distance.empty() || distance[0] >= 0)
+        return false;
+
+    lag = int(-distance[0]);
+    return true;
+}
+
+// Returns the array read by the expression through which
+// 'dest' is reached: either 'dest' itself, or an array computed
+// from it, other than by the statement being analyzed.
+
+array_ptr recurrence_lookahead::recurrent_read(const expr_ptr & e, const array_ptr & dest)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        unordered_set<array*> visited;
+        if (access->array == dest || depends_on(access->array, dest, visited))
+            return access->array;
+        for (auto & index : access->indexes)
+            if (auto a = recurrent_read(index, dest))
+                return a;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (auto a = recurrent_read(operand.expr, dest))
+                return a;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        for (auto & arg : call->args)
+            if (auto a = recurrent_read(arg, dest))
+                return a;
+    }
+
+    return nullptr;
+}
+
+bool recurrence_lookahead::depends_on
+(const array_ptr & a, const array_ptr & dest, unordered_set<array*> & visited)
+{
+    if (!visited.insert(a.get()).second)
+        return false;
+
+    for (auto & stmt : m_model.statements)
+    {
+        bool writes = std::any_of(stmt->array_accesses.begin(), stmt->array_accesses.end(),
+                                  [&](const shared_ptr<array_access> & access)
+        { return access->writing && access->array == a; });
+        if (!writes)
+            continue;
+
+        for (auto & access : stmt->array_accesses)
+        {
+            if (!access->reading)
+                continue;
+            if (access->array == dest || depends_on(access->array, dest, visited))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool recurrence_lookahead::has_impure_external_call(const expr_ptr & e)
+{
+    if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        if (!call->attributes.pure)
+            return true;
+        for (auto & arg : call->args)
+            if (has_impure_external_call(arg))
+                return true;
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        for (auto & index : access->indexes)
+            if (has_impure_external_call(index))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (has_impure_external_call(operand.expr))
+                return true;
+    }
+
+    return false;
+}
+
+bool recurrence_lookahead::transform(recurrence & rec)
+{
+    int k = m_distance;
+
+    // Repeatedly substitute the recurrence for the lowest lag,
+    // until all lags are at least k.
+
+    std::map<int,double> y_coefs = rec.coefs;
+    std::map<int,double> r_coefs;
+    r_coefs[0] = 1;
+
+    while(y_coefs.begin()->first < k)
+    {
+        int lag = y_coefs.begin()->first;
+        double alpha = y_coefs.begin()->second;
+        y_coefs.erase(y_coefs.begin());
+
+        r_coefs[lag] += alpha;
+        for (auto & c : rec.coefs)
+            y_coefs[lag + c.first] += alpha * c.second;
+    }
+
+    // The transformation is valid where the original
+    // recurrence holds at all the substituted instances.
+
+    auto & stmt = rec.stmt;
+    auto space = stmt->domain.get_space();
+
+    auto domain = rec.domain;
+    for (int lag = 1; lag < k; ++lag)
+    {
+        auto shift = shift_map(space, stmt->name, lag);
+        domain = domain & shift.inverse()(rec.domain);
+    }
+    domain.coalesce();
+
+    if (domain.is_empty())
+    {
+        reject(rec, "The recurrence does not hold at " + to_string(k) +
+               " consecutive instances.");
+        return false;
+    }
+
+    isl::set remainder = isl_set_subtract(stmt->domain.copy(), domain.copy());
+    remainder.coalesce();
+
+    string name = stmt->name + "_la";
+    domain.set_name(name);
+
+    auto new_stmt = make_shared<statement>(domain);
+    new_stmt->is_infinite = is_unbounded(domain);
+
+    auto value_type = make_shared<functional::scalar_type>(rec.dest->array->type);
+
+    expr_ptr rest;
+    for (auto & t : rec.rest)
+    {
+        if (!rest)
+        {
+            if (t.sign > 0)
+                rest = t.expr;
+            else
+                rest = make_shared<functional::primitive>(primitive_op::negate, t.expr);
+        }
+        else
+        {
+            auto kind = t.sign > 0 ? primitive_op::add : primitive_op::subtract;
+            rest = make_shared<functional::primitive>(kind, rest, t.expr);
+        }
+        rest->type = value_type;
+    }
+
+    expr_ptr value;
+
+    auto add_term = [&](expr_ptr e, double coef)
+    {
+        if (coef == 0)
+            return;
+        if (coef != 1)
+        {
+            auto c = make_shared<functional::real_const>(coef, location_type(), value_type);
+            e = make_shared<functional::primitive>(primitive_op::multiply, c, e);
+            e->type = value_type;
+        }
+        if (value)
+        {
+            value = make_shared<functional::primitive>(primitive_op::add, value, e);
+            value->type = value_type;
+        }
+        else
+        {
+            value = e;
+        }
+    };
+
+    for (auto & c : r_coefs)
+    {
+        add_term(shifted(rest, c.first, space, new_stmt), c.second);
+    }
+
+    for (auto & c : y_coefs)
+    {
+        auto read = make_shared<array_access>(*rec.dest);
+        read->reading = true;
+        read->writing = false;
+        read->indexes.clear();
+        for (auto & index : rec.dest->indexes)
+            read->indexes.push_back(shifted(index, c.first, space, new_stmt));
+        read->map = rec.dest->map(shift_map(space, name, c.first));
+        new_stmt->array_accesses.push_back(read);
+
+        add_term(read, c.second);
+    }
+
+    auto dest = make_shared<array_access>(*rec.dest);
+    dest->map = rec.dest->map(shift_map(space, name, 0));
+    new_stmt->array_accesses.push_back(dest);
+
+    new_stmt->expr = make_shared<assignment>(dest, value);
+
+    if (verbose<recurrence_lookahead>::enabled())
+    {
+        cout << "Look-ahead statement " << name << ":" << endl;
+        cout << "  " << rec.dest->array->name << "[t] =";
+        for (auto & c : r_coefs)
+            cout << " + " << c.second << " * r(t-" << c.first << ")";
+        for (auto & c : y_coefs)
+            cout << " + " << c.second << " * " << rec.dest->array->name << "[t-" << c.first << "]";
+        cout << endl;
+        cout << "  Domain: ";
+        m_printer.print(new_stmt->domain);
+        cout << endl;
+        cout << "  Remaining original domain: ";
+        m_printer.print(remainder);
+        cout << endl;
+    }
+
+    auto pos = std::find(m_model.statements.begin(), m_model.statements.end(), stmt);
+    assert_or_throw(pos != m_model.statements.end());
+
+    if (remainder.is_empty())
+    {
+        *pos = new_stmt;
+    }
+    else
+    {
+        stmt->domain = remainder;
+        stmt->is_infinite = is_unbounded(remainder);
+        m_model.statements.insert(pos + 1, new_stmt);
+    }
+
+    return true;
+}
+
+// Transformed statements read the recurrent array directly, instead of
+// through intermediate arrays (e.g. the delay and the reduction of a
+// convolution), so most instances of their statements are not used any more.
+// Instances are used if they are read by statements other than those
+// of intermediate arrays, or by used instances of intermediate arrays.
+
+void recurrence_lookahead::remove_unused_instances()
+{
+    if (m_intermediates.empty())
+        return;
+
+    vector<stmt_ptr> writers;
+    isl::union_map writes(m_model.context);
+    isl::union_map writer_reads(m_model.context);
+    isl::union_set used_elements(m_model.context);
+
+    for (auto & stmt : m_model.statements)
+    {
+        auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+        auto dest = assign ? dynamic_pointer_cast<array_access>(assign->destination) : nullptr;
+        bool is_intermediate = dest && !stmt->is_input_or_output &&
+                m_intermediates.count(dest->array.get());
+
+        for (auto & access : stmt->array_accesses)
+        {
+            if (!access->reading)
+                continue;
+            auto reads = access->map.in_domain(stmt->domain);
+            if (is_intermediate)
+                writer_reads = writer_reads | reads;
+            else
+                used_elements = used_elements | reads.range();
+        }
+
+        if (is_intermediate)
+        {
+            writers.push_back(stmt);
+            writes = writes | dest->map.in_domain(stmt->domain);
+        }
+    }
+
+    // Each round adds the elements read by instances found in the
+    // previous round, e.g. one more step of a reduction.
+
+    isl::union_set used_instances(m_model.context);
+
+    for (int round = 0;; ++round)
+    {
+        if (round == max_expansion_size)
+        {
+            if (verbose<recurrence_lookahead>::enabled())
+                cout << "Could not find unused instances of intermediate arrays." << endl;
+            return;
+        }
+
+        used_instances = writes.inverse()(used_elements);
+
+        auto elements = used_elements | writer_reads.in_domain(used_instances).range();
+        if (isl_union_set_is_equal(elements.get(), used_elements.get()) == isl_bool_true)
+            break;
+
+        used_elements = elements;
+    }
+
+    for (auto & stmt : writers)
+    {
+        stmt->domain = stmt->domain & used_instances.set_for(stmt->domain.get_space());
+        stmt->domain.coalesce();
+
+        if (stmt->domain.is_empty())
+            continue;
+
+        stmt->is_infinite = stmt->domain.dimensions() > 0 && is_unbounded(stmt->domain);
+
+        if (verbose<recurrence_lookahead>::enabled())
+        {
+            cout << "Used instances of statement " << stmt->name << ": ";
+            m_printer.print(stmt->domain);
+            cout << endl;
+        }
+    }
+
+    auto & statements = m_model.statements;
+    statements.erase(std::remove_if(statements.begin(), statements.end(),
+                                    [&](const stmt_ptr & stmt)
+    {
+        bool removed = stmt->domain.is_empty() &&
+                std::find(writers.begin(), writers.end(), stmt) != writers.end();
+        if (removed && verbose<recurrence_lookahead>::enabled())
+            cout << "Removed statement " << stmt->name << endl;
+        return removed;
+    }), statements.end());
+
+    // Remove intermediate arrays which are not accessed any more.
+
+    auto & arrays = m_model.arrays;
+    arrays.erase(std::remove_if(arrays.begin(), arrays.end(), [&](const array_ptr & a)
+    {
+        if (!m_intermediates.count(a.get()))
+            return false;
+        for (auto & stmt : statements)
+        {
+            for (auto & access : stmt->array_accesses)
+            {
+                if (access->array == a)
+                    return false;
+            }
+        }
+        return true;
+    }), arrays.end());
+}
+
+isl::map recurrence_lookahead::shift_map
+(const isl::space & space, const string & name, int offset)
+{
+    // Maps 'name'[t,i...] to the statement space at [t-offset,i...]
+
+    int dim_count = space.dimension(isl::space::variable);
+
+    auto map_space = isl::space::from(space, space).wrapped();
+    auto m = isl::basic_set::universe(map_space);
+
+    m.add_constraint(map_space.var(dim_count) == map_space.var(0) - offset);
+    for (int dim = 1; dim < dim_count; ++dim)
+        m.add_constraint(map_space.var(dim_count + dim) == map_space.var(dim));
+
+    isl::map result = m.unwrapped();
+    result.set_name(isl::space::input, name);
+    return result;
+}
+
+expr_ptr recurrence_lookahead::shifted
+(const expr_ptr & e, int offset, const isl::space & space, const stmt_ptr & new_stmt)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        auto result = make_shared<array_access>(*access);
+        result->indexes.clear();
+        for (auto & index : access->indexes)
+            result->indexes.push_back(shifted(index, offset, space, new_stmt));
+
+        result->map = access->map(shift_map(space, new_stmt->name, offset));
+
+        new_stmt->array_accesses.push_back(result);
+        return result;
+    }
+    else if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        if (it->index != 0 || offset == 0)
+            return e;
+        auto result = make_shared<functional::primitive>
+                (primitive_op::subtract, e, functional::make_signed_int(offset));
+        result->type = e->type;
+        return result;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        auto result = make_shared<functional::primitive>(*op);
+        for (auto & operand : result->operands)
+            operand.expr = shifted(operand.expr, offset, space, new_stmt);
+        return result;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        auto result = make_shared<external_call>(*call);
+        for (auto & arg : result->args)
+            arg = shifted(arg, offset, space, new_stmt);
+        return result;
+    }
+    else if (dynamic_pointer_cast<functional::int_const>(e) ||
+             dynamic_pointer_cast<functional::real_const>(e) ||
+             dynamic_pointer_cast<functional::complex_const>(e) ||
+             dynamic_pointer_cast<functional::bool_const>(e))
+    {
+        return e;
+    }
+
+    throw error("Unexpected expression in linear recurrence.");
+}
+
+}
+}
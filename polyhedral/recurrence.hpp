@@ -0,0 +1,131 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_RECURRENCE_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_RECURRENCE_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <isl-cpp/printer.hpp>
+
+#include <map>
+#include <unordered_set>
+
+namespace stream {
+namespace polyhedral {
+
+// Look-ahead transformation of linear recurrences.
+//
+// A statement of the form
+//   y[t] = r(t) + a1 * y[t-1] + ... + ap * y[t-p]
+// where a1..ap are constants and r does not read y,
+// is rewritten (on the part of its domain where this is valid) as
+//   y[t] = b0 * r(t) + ... + b(k-1) * r(t-k+1) + c(k) * y[t-k] + ...
+// so that the shortest dependence distance on y becomes k.
+// This exposes k independent chains of computation to
+// instruction-level parallelism and vectorization.
+//
+// Elements of y may be read through other arrays, as long as
+// each term depending on y expands into a linear combination
+// of its earlier elements with constant coefficients.
+// For example, y may be delayed and summed with constant weights
+// by a reduction array, like the convolution in signal.iir.
+// Afterwards, instances of such arrays which are no longer used
+// are removed.
+//
+// Statements where y is read otherwise are not transformed,
+// and the reason is recorded in rejected(). Statements where
+// all elements of y are already read at least k steps back
+// are recorded in satisfied().
+
+class recurrence_lookahead
+{
+public:
+    recurrence_lookahead(model &, int distance);
+
+    void process();
+
+    int transformed_count() const { return m_transformed_count; }
+
+    // Reasons why statements which read their own array
+    // were not transformed, by statement name.
+    const std::map<string,string> & rejected() const { return m_rejected; }
+
+    // Shortest distance of elements read by statements which
+    // already satisfy the look-ahead distance, by statement name.
+    const std::map<string,int> & satisfied() const { return m_satisfied; }
+
+private:
+    struct term
+    {
+        expr_ptr expr;
+        double sign;
+    };
+
+    struct recurrence
+    {
+        stmt_ptr stmt;
+        shared_ptr<array_access> dest;
+        isl::set domain { nullptr };
+        // Coefficients of y[t-lag] by lag:
+        std::map<int,double> coefs;
+        vector<term> rest;
+        // Arrays other than y through which y is read.
+        std::unordered_set<array*> intermediates;
+        // Limit on the size of expanded expressions.
+        int budget = 0;
+    };
+
+    bool analyze(const stmt_ptr &, recurrence &);
+    void collect_terms(const expr_ptr &, double sign, vector<term> &);
+    bool expand(const expr_ptr &, const isl::map & instances, double coef,
+                recurrence &, string & reason);
+    bool evaluate(const expr_ptr &, isl::set instances, double & value,
+                  recurrence &);
+    bool follow_read(const shared_ptr<array_access> &, const isl::map & instances,
+                     recurrence &, stmt_ptr & writer, isl::map & writer_instances,
+                     string & reason);
+    bool self_read_lag(const isl::map & elements, const recurrence &, int & lag);
+    array_ptr recurrent_read(const expr_ptr &, const array_ptr & dest);
+    bool depends_on(const array_ptr &, const array_ptr & dest,
+                    std::unordered_set<array*> & visited);
+    void reject(const recurrence &, const string & reason);
+    bool has_impure_external_call(const expr_ptr &);
+    bool transform(recurrence &);
+    void remove_unused_instances();
+
+    isl::map shift_map(const isl::space &, const string & name, int offset);
+    expr_ptr shifted(const expr_ptr &, int offset,
+                     const isl::space & stmt_space, const stmt_ptr & new_stmt);
+
+    model & m_model;
+    int m_distance;
+    isl::printer m_printer;
+    int m_transformed_count = 0;
+    std::map<string,string> m_rejected;
+    std::map<string,int> m_satisfied;
+    std::unordered_set<array*> m_intermediates;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_RECURRENCE_INCLUDED
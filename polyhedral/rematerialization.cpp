@@ -0,0 +1,589 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#include "rematerialization.hpp"
+#include "cost_model.hpp"
+#include "../common/error.hpp"
+#include "../compiler/report.hpp"
+
+#include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <iostream>
+
+using namespace std;
+
+namespace stream {
+namespace polyhedral {
+
+// Whether the expression only consists of nodes that can be
+// substituted into other statements.
+
+static bool is_simple(const expr_ptr & e)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        if (access->writing)
+            return false;
+        for (auto & index : access->indexes)
+            if (!is_simple(index))
+                return false;
+        return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (!is_simple(operand.expr))
+                return false;
+        return true;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        // Only pure functions with a known cost and scalar arguments
+        // can be called again instead of reading the stored result.
+        if (!call->attributes.pure || call->attributes.cost <= 0)
+            return false;
+        for (auto & arg : call->args)
+        {
+            if (!arg->type || !arg->type->is_scalar() || !is_simple(arg))
+                return false;
+        }
+        return true;
+    }
+
+    return dynamic_pointer_cast<iterator_read>(e) ||
+            dynamic_pointer_cast<functional::int_const>(e) ||
+            dynamic_pointer_cast<functional::real_const>(e) ||
+            dynamic_pointer_cast<functional::complex_const>(e) ||
+            dynamic_pointer_cast<functional::bool_const>(e);
+}
+
+static bool reads_array(const expr_ptr & e, const array_ptr & array)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        if (access->array == array)
+            return true;
+        for (auto & index : access->indexes)
+            if (reads_array(index, array))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (reads_array(operand.expr, array))
+                return true;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        for (auto & arg : call->args)
+            if (reads_array(arg, array))
+                return true;
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        return reads_array(assign->destination, array) ||
+                reads_array(assign->value, array);
+    }
+
+    return false;
+}
+
+static bool passes_to_call(const expr_ptr & e, const array_ptr & array)
+{
+    if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        for (auto & arg : call->args)
+            if (reads_array(arg, array))
+                return true;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            if (passes_to_call(operand.expr, array))
+                return true;
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        return passes_to_call(assign->value, array);
+    }
+
+    return false;
+}
+
+// Product of the extents of a set of distances in each dimension,
+// 0 if the set is empty, or -1 if it is unbounded.
+
+static int64_t extent_volume(const isl::set & distances)
+{
+    if (distances.is_empty())
+        return 0;
+
+    int64_t volume = 1;
+    for (int dim = 0; dim < distances.dimensions(); ++dim)
+    {
+        auto v = distances.get_space().var(dim);
+        auto max = distances.maximum(v);
+        auto min = distances.minimum(v);
+        if (!max.is_integer() || !min.is_integer())
+            return -1;
+        volume *= max.integer() - min.integer() + 1;
+    }
+    return volume;
+}
+
+// Number of elements read by a single instance of the reading statements,
+// as a range along each dimension.
+
+static int64_t element_span(const isl::map & reads)
+{
+    if (reads.is_empty())
+        return 0;
+    auto same_instance = reads(reads.inverse());
+    return extent_volume(same_instance.deltas());
+}
+
+// Number of instances that read the same element.
+
+static int64_t reuse_count(const isl::map & reads)
+{
+    if (reads.is_empty())
+        return 0;
+    auto same_element = reads.inverse()(reads);
+    return extent_volume(same_element.deltas());
+}
+
+static void add_to(isl::map & relation, const isl::map & m)
+{
+    if (relation.is_valid())
+        relation = relation | m;
+    else
+        relation = m;
+}
+
+rematerialization::rematerialization(model & m, int max_operations):
+    m_model(m),
+    m_max_operations(max_operations),
+    m_printer(m.context)
+{}
+
+void rematerialization::process()
+{
+    bool changed;
+
+    do
+    {
+        changed = false;
+
+        unordered_set<array*> excluded;
+        for (auto & channel : m_model.inputs)
+            excluded.insert(channel.array.get());
+        for (auto & channel : m_model.outputs)
+            excluded.insert(channel.array.get());
+        for (auto & entry : m_model.phase_ids)
+            excluded.insert(entry.second.get());
+
+        unordered_map<array*, int> writer_counts;
+        for (auto & stmt : m_model.statements)
+        {
+            for (auto & access : stmt->array_accesses)
+            {
+                if (access->writing)
+                    ++writer_counts[access->array.get()];
+            }
+        }
+
+        for (auto & stmt : m_model.statements)
+        {
+            candidate c;
+            if (!find_candidate(stmt, c))
+                continue;
+
+            auto * array = c.dest->array.get();
+            if (excluded.count(array) || writer_counts[array] != 1)
+                continue;
+
+            vector<reader> readers;
+            if (!find_readers(c, readers))
+                continue;
+
+            if (!is_profitable(c, readers))
+                continue;
+
+            for (auto & r : readers)
+                inline_into(c, r);
+
+            remove(c);
+
+            changed = true;
+            break;
+        }
+    }
+    while(changed);
+}
+
+bool rematerialization::find_candidate(const stmt_ptr & stmt, candidate & c)
+{
+    if (stmt->is_input_or_output)
+        return false;
+
+    if (stmt->self_relations.is_valid())
+        return false;
+
+    auto assign = dynamic_pointer_cast<assignment>(stmt->expr);
+    if (!assign)
+        return false;
+
+    auto dest = dynamic_pointer_cast<array_access>(assign->destination);
+    if (!dest || !dest->writing)
+        return false;
+
+    auto & array = dest->array;
+
+    // Single-element arrays are read by every instance of their readers,
+    // so recomputing them never pays off.
+    if (array->size.empty())
+        return false;
+
+    // The statement must write element [i...] in instance [i...].
+
+    if ((int) dest->indexes.size() != stmt->domain.dimensions() ||
+            (int) array->size.size() != stmt->domain.dimensions())
+        return false;
+
+    for (int dim = 0; dim < (int) dest->indexes.size(); ++dim)
+    {
+        auto it = dynamic_pointer_cast<iterator_read>(dest->indexes[dim]);
+        if (!it || it->index != dim)
+            return false;
+    }
+
+    auto & value = assign->value;
+
+    if (!value->type || !value->type->is_scalar() ||
+            value->type->scalar()->primitive != array->type)
+        return false;
+
+    if (!is_simple(value) || reads_array(value, array))
+        return false;
+
+    statement_cost cost;
+    cost_model::count_operations(value, cost);
+    if (cost.transcendental_ops)
+        return false;
+
+    c.stmt = stmt;
+    c.dest = dest;
+    c.value = value;
+    c.operations = cost.arithmetic_ops + cost.external_ops;
+    return true;
+}
+
+bool rematerialization::find_readers(const candidate & c, vector<reader> & readers)
+{
+    auto & array = c.dest->array;
+    int dim_count = array->size.size();
+
+    for (auto & stmt : m_model.statements)
+    {
+        if (stmt == c.stmt)
+            continue;
+
+        reader r;
+        r.stmt = stmt;
+
+        for (auto & access : stmt->array_accesses)
+        {
+            if (access->array != array)
+                continue;
+
+            if (stmt->is_input_or_output || access->writing)
+                return false;
+
+            // Only reads of single elements can be replaced by an expression.
+            if ((int) access->indexes.size() != dim_count ||
+                    !access->type || !access->type->is_scalar())
+                return false;
+
+            r.accesses.push_back(access);
+        }
+
+        if (r.accesses.empty())
+            continue;
+
+        if (passes_to_call(stmt->expr, array))
+            return false;
+
+        readers.push_back(r);
+    }
+
+    return !readers.empty();
+}
+
+isl::map rematerialization::reader_to_writer
+(const candidate & c, const shared_ptr<array_access> & read, const stmt_ptr & reader)
+{
+    auto read_map = read->map.in_domain(reader->domain);
+    return c.dest->map.in_domain(c.stmt->domain).inverse()(read_map);
+}
+
+bool rematerialization::is_profitable(const candidate & c, const vector<reader> & readers)
+{
+    auto & array = c.dest->array;
+
+    // Work: each read of an element recomputes it.
+
+    int64_t reads_per_element = 0;
+
+    for (auto & r : readers)
+    {
+        for (auto & access : r.accesses)
+        {
+            auto count = reuse_count(access->map.in_domain(r.stmt->domain));
+            if (count < 0)
+                return false;
+            reads_per_element += count;
+        }
+    }
+
+    int64_t operations = int64_t(c.operations) * reads_per_element;
+
+    // Storage saved on the array itself.
+
+    int64_t saved = 0;
+
+    for (auto & r : readers)
+    {
+        isl::map reads { nullptr };
+        for (auto & access : r.accesses)
+            add_to(reads, access->map.in_domain(r.stmt->domain));
+
+        auto span = element_span(reads);
+        if (span < 0)
+            return false;
+        saved = std::max(saved, span);
+    }
+
+    saved *= size_in_bytes(array->type);
+
+    // Storage added to arrays read by the expression,
+    // which are now read by the readers instead.
+
+    int64_t added = 0;
+
+    unordered_map<polyhedral::array*, vector<shared_ptr<array_access>>> sources;
+    for (auto & access : c.stmt->array_accesses)
+    {
+        if (access->reading)
+            sources[access->array.get()].push_back(access);
+    }
+
+    for (auto & source : sources)
+    {
+        auto * source_array = source.first;
+
+        int64_t before = 0;
+        for (auto & stmt : m_model.statements)
+        {
+            isl::map reads { nullptr };
+            for (auto & access : stmt->array_accesses)
+            {
+                if (access->array.get() == source_array && access->reading)
+                    add_to(reads, access->map.in_domain(stmt->domain));
+            }
+            if (!reads.is_valid())
+                continue;
+
+            auto span = element_span(reads);
+            if (span < 0)
+                return false;
+            before = std::max(before, span);
+        }
+
+        int64_t after = before;
+        for (auto & r : readers)
+        {
+            isl::map reads { nullptr };
+            for (auto & access : r.stmt->array_accesses)
+            {
+                if (access->array.get() == source_array && access->reading)
+                    add_to(reads, access->map.in_domain(r.stmt->domain));
+            }
+            for (auto & read : r.accesses)
+            {
+                auto to_writer = reader_to_writer(c, read, r.stmt);
+                for (auto & access : source.second)
+                    add_to(reads, access->map(to_writer));
+            }
+
+            auto span = element_span(reads);
+            if (span < 0)
+                return false;
+            after = std::max(after, span);
+        }
+
+        added += (after - before) * size_in_bytes(source_array->type);
+    }
+
+    bool profitable = operations <= m_max_operations && added < saved;
+
+    if (verbose<rematerialization>::enabled())
+    {
+        cout << "Array " << array->name << ": "
+             << c.operations << " operations,"
+             << " " << reads_per_element << " reads per element,"
+             << " saves " << saved << " bytes,"
+             << " adds " << added << " bytes"
+             << (profitable ? " => rematerialize." : ".") << endl;
+    }
+
+    if (profitable)
+    {
+        auto & info = arrp::report()["rematerialized"][array->name];
+        info["operations"] = c.operations;
+        info["reads"] = reads_per_element;
+        info["saved_bytes"] = saved;
+        info["added_bytes"] = added;
+    }
+
+    return profitable;
+}
+
+void rematerialization::inline_into(const candidate & c, const reader & r)
+{
+    auto & stmt = r.stmt;
+
+    stmt->expr = replace_reads(stmt->expr, c, r);
+
+    auto & accesses = stmt->array_accesses;
+    accesses.erase(std::remove_if(accesses.begin(), accesses.end(),
+                                  [&](const shared_ptr<array_access> & a){
+        return a->array == c.dest->array;
+    }), accesses.end());
+
+    if (verbose<rematerialization>::enabled())
+    {
+        cout << "Inlined " << c.stmt->name << " into " << stmt->name << "." << endl;
+        for (auto & access : accesses)
+        {
+            cout << "  Access: ";
+            m_printer.print(access->map);
+            cout << endl;
+        }
+    }
+}
+
+expr_ptr rematerialization::replace_reads
+(const expr_ptr & e, const candidate & c, const reader & r)
+{
+    if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        if (access->array != c.dest->array)
+            return e;
+
+        auto to_writer = reader_to_writer(c, access, r.stmt);
+        return substitute(c.value, c, access, to_writer, r.stmt);
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        for (auto & operand : op->operands)
+            operand.expr = replace_reads(operand.expr, c, r);
+    }
+    else if (auto assign = dynamic_pointer_cast<assignment>(e))
+    {
+        assign->value = replace_reads(assign->value, c, r);
+    }
+
+    return e;
+}
+
+expr_ptr rematerialization::substitute
+(const expr_ptr & e, const candidate & c,
+ const shared_ptr<array_access> & read,
+ const isl::map & read_to_write,
+ const stmt_ptr & reader)
+{
+    if (auto it = dynamic_pointer_cast<iterator_read>(e))
+    {
+        // Instance [i...] of the inlined statement computes element [i...],
+        // so its iterators are the indexes of the replaced read.
+        return read->indexes[it->index];
+    }
+    else if (auto access = dynamic_pointer_cast<array_access>(e))
+    {
+        auto result = make_shared<array_access>(*access);
+        result->indexes.clear();
+        for (auto & index : access->indexes)
+            result->indexes.push_back(substitute(index, c, read, read_to_write, reader));
+
+        result->map = access->map(read_to_write);
+
+        reader->array_accesses.push_back(result);
+        return result;
+    }
+    else if (auto op = dynamic_pointer_cast<functional::primitive>(e))
+    {
+        auto result = make_shared<functional::primitive>(*op);
+        for (auto & operand : result->operands)
+            operand.expr = substitute(operand.expr, c, read, read_to_write, reader);
+        return result;
+    }
+    else if (auto call = dynamic_pointer_cast<external_call>(e))
+    {
+        auto result = make_shared<external_call>(*call);
+        for (auto & arg : result->args)
+            arg = substitute(arg, c, read, read_to_write, reader);
+        return result;
+    }
+    else if (dynamic_pointer_cast<functional::int_const>(e) ||
+             dynamic_pointer_cast<functional::real_const>(e) ||
+             dynamic_pointer_cast<functional::complex_const>(e) ||
+             dynamic_pointer_cast<functional::bool_const>(e))
+    {
+        return e;
+    }
+
+    throw error("Unexpected expression in rematerialized statement.");
+}
+
+void rematerialization::remove(const candidate & c)
+{
+    auto array = c.dest->array;
+
+    auto & stmts = m_model.statements;
+    stmts.erase(std::remove(stmts.begin(), stmts.end(), c.stmt), stmts.end());
+
+    auto & arrays = m_model.arrays;
+    arrays.erase(std::remove(arrays.begin(), arrays.end(), array), arrays.end());
+
+    if (verbose<rematerialization>::enabled())
+    {
+        cout << "Removed statement " << c.stmt->name
+             << " and array " << array->name << "." << endl;
+    }
+
+    ++m_count;
+}
+
+}
+}
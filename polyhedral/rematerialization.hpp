@@ -0,0 +1,100 @@
+/*
+Compiler for language for stream processing
+
+Copyright (C) 2016  Jakob Leben <jakob.leben@gmail.com>
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+#ifndef STREAM_LANG_POLYHEDRAL_REMATERIALIZATION_INCLUDED
+#define STREAM_LANG_POLYHEDRAL_REMATERIALIZATION_INCLUDED
+
+#include "../common/ph_model.hpp"
+#include "../utility/debug.hpp"
+
+#include <isl-cpp/printer.hpp>
+
+namespace stream {
+namespace polyhedral {
+
+// Recomputation of cheap arrays instead of storing them.
+//
+// The expression of a statement is inlined into all statements which
+// read its array, and the statement and the array are removed.
+// A statement is inlined if it is the only writer of its array,
+// it writes element [i...] in instance [i...], and its expression
+// only consists of arithmetic, reads of other arrays and constants
+// (no transcendental functions, and no external calls other than
+// pure functions with a declared cost and scalar arguments).
+//
+// Inlining is done if the number of operations spent on recomputing
+// an element (the operations of the expression, including the declared
+// cost of external calls, times the number of times each element
+// is read) does not exceed a limit, and the storage
+// saved on the removed array exceeds the storage added to arrays read
+// by the expression, which are now read later by the readers.
+// Storage is estimated from the range of elements read by
+// a single statement instance, before scheduling.
+//
+// Arrays read by IO statements or passed to external functions
+// are not inlined.
+
+class rematerialization
+{
+public:
+    rematerialization(model &, int max_operations);
+
+    void process();
+
+    int rematerialized_count() const { return m_count; }
+
+private:
+    struct candidate
+    {
+        stmt_ptr stmt;
+        shared_ptr<array_access> dest;
+        expr_ptr value;
+        int operations = 0;
+    };
+
+    struct reader
+    {
+        stmt_ptr stmt;
+        vector<shared_ptr<array_access>> accesses;
+    };
+
+    bool find_candidate(const stmt_ptr &, candidate &);
+    bool find_readers(const candidate &, vector<reader> &);
+    bool is_profitable(const candidate &, const vector<reader> &);
+    isl::map reader_to_writer(const candidate &, const shared_ptr<array_access> &,
+                              const stmt_ptr & reader);
+    void inline_into(const candidate &, const reader &);
+    expr_ptr replace_reads(const expr_ptr &, const candidate &, const reader &);
+    expr_ptr substitute(const expr_ptr &, const candidate &,
+                        const shared_ptr<array_access> & read,
+                        const isl::map & read_to_write,
+                        const stmt_ptr & reader);
+    void remove(const candidate &);
+
+    model & m_model;
+    int m_max_operations;
+    isl::printer m_printer;
+    int m_count = 0;
+};
+
+}
+}
+
+#endif // STREAM_LANG_POLYHEDRAL_REMATERIALIZATION_INCLUDED
@@ -41,6 +41,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 #include <limits>
 #include <cmath>
 #include <cstdlib>
+#include <numeric>
 
 using namespace std;
 
@@ -110,10 +111,7 @@ scheduler::schedule(const scheduler::options & options)
 
     polyhedral::schedule schedule(m_model.context);
 
-    schedule.tree = make_schedule(m_model_summary.domains,
-                                  m_model_summary.dependencies,
-                                  m_model_summary.order_relations,
-                                  options);
+    schedule.tree = make_schedule_with_fallbacks(options);
 
     schedule.full = schedule.tree.map().in_domain(m_model_summary.domains);
 
@@ -286,6 +284,9 @@ isl::schedule scheduler::make_schedule
     // seem to always end up with an empty schedule.
 
     isl_options_set_schedule_whole_component(domains.ctx().get(), !options.cluster);
+    isl_options_set_schedule_algorithm(domains.ctx().get(),
+                                       options.greedy ? ISL_SCHEDULE_ALGORITHM_FEAUTRIER
+                                                      : ISL_SCHEDULE_ALGORITHM_ISL);
 
     isl_schedule_constraints *constr =
             isl_schedule_constraints_on_domain(domains.copy());
@@ -323,6 +324,438 @@ isl::schedule scheduler::make_schedule
     return sched;
 }
 
+// Tries scheduling strategies of decreasing complexity:
+// the requested one, then a greedy schedule of the whole program
+// without proximity optimization, each with a limited number
+// of isl operations, and finally a sequence of statements,
+// with infinite statements interleaved periodically.
+
+isl::schedule scheduler::make_schedule_with_fallbacks(const options & opt)
+{
+    m_fallback.clear();
+
+    auto attempt = [&](const options & attempt_opt) -> isl::schedule
+    {
+        arrp::isl_operation_budget budget(m_model.context.get(), opt.max_operations);
+
+        isl::schedule sched { nullptr };
+        try
+        {
+            sched = make_schedule(m_model_summary.domains,
+                                  m_model_summary.dependencies,
+                                  m_model_summary.order_relations,
+                                  attempt_opt);
+        }
+        catch (error &)
+        {
+            if (!budget.exceeded())
+                throw;
+        }
+
+        if (budget.exceeded())
+        {
+            if (verbose<scheduler>::enabled())
+                cout << "Scheduling exceeded the isl operation limit." << endl;
+            return isl::schedule(nullptr);
+        }
+
+        return sched;
+    };
+
+    auto sched = attempt(opt);
+    if (sched.is_valid())
+        return sched;
+
+    {
+        m_fallback = "greedy";
+
+        auto greedy_opt = opt;
+        greedy_opt.cluster = false;
+        greedy_opt.optimize = false;
+        greedy_opt.greedy = true;
+
+        sched = attempt(greedy_opt);
+        if (sched.is_valid())
+            return sched;
+    }
+
+    // This one is cheap, so it is not limited.
+
+    m_fallback = "sequential";
+
+    sched = make_sequential_schedule();
+    if (sched.is_valid())
+        return sched;
+
+    throw error("Could not find a schedule within the isl operation limit.");
+}
+
+// Makes a schedule which executes finite statements one after another,
+// each in lexicographic order of its domain, in an order consistent
+// with dependencies between statements, followed by a periodic
+// interleaving of infinite statements (see find_periodic_timing).
+// Returns an invalid schedule if there is no such order,
+// or if the resulting schedule violates a dependency.
+
+isl::schedule scheduler::make_sequential_schedule()
+{
+    vector<stmt_ptr> finite;
+    vector<stmt_ptr> infinite;
+    for (auto & stmt : m_model.statements)
+    {
+        if (stmt->is_infinite)
+            infinite.push_back(stmt);
+        else
+            finite.push_back(stmt);
+    }
+
+    auto deps = m_model_summary.dependencies | m_model_summary.order_relations;
+
+    // Find dependencies between finite statements
+
+    unordered_map<string, unordered_set<string>> sources;
+
+    deps.for_each([&](const isl::map & m){
+        auto space = m.get_space();
+        string source = space.id(isl::space::input).name();
+        string sink = space.id(isl::space::output).name();
+        if (source != sink)
+            sources[sink].insert(source);
+        return true;
+    });
+
+    // Order finite statements topologically
+
+    vector<stmt_ptr> order;
+    unordered_set<string> done;
+
+    while(!finite.empty())
+    {
+        auto ready = std::find_if(finite.begin(), finite.end(),
+                                  [&](const stmt_ptr & stmt){
+            for (auto & source : sources[stmt->name])
+                if (!done.count(source))
+                    return false;
+            return true;
+        });
+
+        if (ready == finite.end())
+            return isl::schedule(nullptr);
+
+        done.insert((*ready)->name);
+        order.push_back(*ready);
+        finite.erase(ready);
+    }
+
+    // Find rates and offsets of infinite statements
+
+    vector<int64_t> rates;
+    vector<int64_t> offsets;
+    if (!infinite.empty() && !find_periodic_timing(infinite, deps, rates, offsets))
+        return isl::schedule(nullptr);
+
+    // Map finite statement k with domain S[i0, i1, ...] to time [k, i0, i1, ..., 0 ...]
+    // and infinite statement k to time [r i0 + o, k, i1, ..., 0 ...].
+    // With a part index as the first dimension, the maps make up
+    // the schedule of the entire program, used for validation.
+
+    int dim_count = 0;
+    for (auto & stmt : m_model.statements)
+    {
+        int stmt_dim_count = stmt->domain.get_space().dimension(isl::space::variable);
+        dim_count = std::max(dim_count, stmt_dim_count);
+    }
+
+    auto make_map = [&](const stmt_ptr & stmt, int k, bool is_infinite, int part) -> isl::map
+    {
+        int first_dim = part < 0 ? 0 : 1;
+        isl::space time_space(m_model.context, isl::set_tuple(first_dim + dim_count + 1));
+        auto space = isl::space::from(stmt->domain.get_space(), time_space);
+        int stmt_dim_count = stmt->domain.get_space().dimension(isl::space::variable);
+
+        auto m = isl::map::universe(space);
+
+        if (part >= 0)
+            m.add_constraint(space.out(0) == part);
+
+        int time_dim = first_dim;
+        if (is_infinite)
+        {
+            isl::value rate(m_model.context, (int) rates[k]);
+            m.add_constraint(space.out(time_dim++) - space.in(0) * rate == (int) offsets[k]);
+        }
+        m.add_constraint(space.out(time_dim++) == k);
+
+        // Remaining statement dimensions follow, in order.
+        int dim = is_infinite ? 1 : 0;
+        for (; time_dim < first_dim + dim_count + 1; ++time_dim, ++dim)
+        {
+            if (dim < stmt_dim_count)
+                m.add_constraint(space.out(time_dim) == space.in(dim));
+            else
+                m.add_constraint(space.out(time_dim) == 0);
+        }
+
+        return m.in_domain(stmt->domain);
+    };
+
+    isl::union_map sched_map(m_model.context);
+    isl::union_map finite_map(m_model.context);
+    isl::union_map infinite_map(m_model.context);
+    isl::union_set finite_domains(m_model.context);
+    isl::union_set infinite_domains(m_model.context);
+
+    for (int k = 0; k < (int) order.size(); ++k)
+    {
+        auto & stmt = order[k];
+        sched_map |= make_map(stmt, k, false, 0);
+        finite_map |= make_map(stmt, k, false, -1);
+        finite_domains |= stmt->domain;
+    }
+
+    for (int k = 0; k < (int) infinite.size(); ++k)
+    {
+        auto & stmt = infinite[k];
+        sched_map |= make_map(stmt, k, true, 1);
+        infinite_map |= make_map(stmt, k, true, -1);
+        infinite_domains |= stmt->domain;
+    }
+
+    if (!validate_schedule(sched_map))
+        return isl::schedule(nullptr);
+
+    auto make_part = [](const isl::union_set & domains, const isl::union_map & map)
+    {
+        isl_schedule * sched = isl_schedule_from_domain(domains.copy());
+        return isl_schedule_insert_partial_schedule
+                (sched, isl_multi_union_pw_aff_from_union_map(map.copy()));
+    };
+
+    if (infinite.empty())
+        return make_part(finite_domains, finite_map);
+
+    if (order.empty())
+        return make_part(infinite_domains, infinite_map);
+
+    return isl_schedule_sequence(make_part(finite_domains, finite_map),
+                                 make_part(infinite_domains, infinite_map));
+}
+
+// Finds times of infinite statements, so that statement k
+// executes instance S[i0, ...] at time r_k i0 + o_k.
+// The rates r_k keep pace between statements: if a statement
+// reads about a i0 elements of another one by its instance i0,
+// its rate is a times the rate of the other one.
+// The rates are found from the number of elements read between
+// two sample instances far from the start of the stream.
+// The offsets o_k are the smallest ones so that each instance
+// executes after the instances it depends on, and statements
+// with equal times execute in order of k.
+// Returns false if there are no such rates or offsets.
+
+bool scheduler::find_periodic_timing(const vector<stmt_ptr> & statements,
+                                     const isl::union_map & dependencies,
+                                     vector<int64_t> & rates,
+                                     vector<int64_t> & offsets)
+{
+    const int sample_time = 10080;
+    const int sample_span = 5040;
+    const int64_t max_rate = 1 << 20;
+
+    unordered_map<string, int> index;
+    for (int k = 0; k < (int) statements.size(); ++k)
+        index[statements[k]->name] = k;
+
+    struct dependency
+    {
+        int source;
+        int sink;
+        isl::map map;
+    };
+
+    vector<dependency> deps;
+
+    dependencies.for_each([&](const isl::map & m){
+        auto space = m.get_space();
+        auto source = index.find(space.id(isl::space::input).name());
+        auto sink = index.find(space.id(isl::space::output).name());
+        if (source != index.end() && sink != index.end() &&
+                source->second != sink->second)
+        {
+            deps.push_back({ source->second, sink->second, m });
+        }
+        return true;
+    });
+
+    // Maximum source instance read by the sink instance at given time.
+
+    auto max_source_time = [&](const isl::map & m, int sink_time, bool & ok) -> int64_t
+    {
+        auto mp = m;
+        auto space = mp.get_space();
+        mp.add_constraint(space.out(0) == sink_time);
+        auto sources = mp.domain();
+        if (sources.is_empty())
+        {
+            ok = false;
+            return 0;
+        }
+        auto max = sources.maximum(sources.get_space().var(0));
+        if (max.is_infinity())
+        {
+            ok = false;
+            return 0;
+        }
+        return int64_t(max.integer());
+    };
+
+    // Rates as fractions: rate of sink = rate of source * num / den.
+
+    struct ratio { int source; int sink; int64_t num; int64_t den; };
+    vector<ratio> ratios;
+
+    for (auto & dep : deps)
+    {
+        bool ok = true;
+        int64_t a = max_source_time(dep.map, sample_time, ok);
+        int64_t b = max_source_time(dep.map, sample_time + sample_span, ok);
+        if (!ok || b <= a)
+            continue;
+        int64_t div = std::gcd(b - a, int64_t(sample_span));
+        ratios.push_back({ dep.source, dep.sink, (b - a) / div, sample_span / div });
+    }
+
+    vector<int64_t> num(statements.size(), 0);
+    vector<int64_t> den(statements.size(), 1);
+
+    auto assign = [&](int k, int64_t n, int64_t d) -> bool
+    {
+        int64_t div = std::gcd(n, d);
+        n /= div;
+        d /= div;
+        if (n > max_rate || d > max_rate)
+            return false;
+        if (num[k] == 0)
+        {
+            num[k] = n;
+            den[k] = d;
+            return true;
+        }
+        return num[k] == n && den[k] == d;
+    };
+
+    for (int k = 0; k < (int) statements.size(); ++k)
+    {
+        if (num[k] != 0)
+            continue;
+
+        num[k] = 1;
+
+        bool changed = true;
+        while(changed)
+        {
+            changed = false;
+            for (auto & r : ratios)
+            {
+                bool has_source = num[r.source] != 0;
+                bool has_sink = num[r.sink] != 0;
+                if (has_source == has_sink)
+                {
+                    if (has_source && !assign(r.sink, num[r.source] * r.num, den[r.source] * r.den))
+                    {
+                        if (verbose<scheduler>::enabled())
+                            cout << "Inconsistent rates of statements "
+                                 << statements[r.source]->name << " and "
+                                 << statements[r.sink]->name << endl;
+                        return false;
+                    }
+                    continue;
+                }
+                bool ok = has_source ?
+                            assign(r.sink, num[r.source] * r.num, den[r.source] * r.den) :
+                            assign(r.source, num[r.sink] * r.den, den[r.sink] * r.num);
+                if (!ok)
+                    return false;
+                changed = true;
+            }
+        }
+    }
+
+    int64_t common_den = 1;
+    for (auto d : den)
+    {
+        common_den = std::lcm(common_den, d);
+        if (common_den > max_rate)
+            return false;
+    }
+
+    rates.resize(statements.size());
+    for (int k = 0; k < (int) statements.size(); ++k)
+        rates[k] = num[k] * (common_den / den[k]);
+
+    // Find offsets as longest paths through the dependencies,
+    // with the distance of each dependency as the maximum of
+    // r_source * source_i0 - r_sink * sink_i0.
+
+    vector<int64_t> distances;
+    for (auto & dep : deps)
+    {
+        auto pairs = dep.map.wrapped();
+        isl::local_space space(pairs.get_space());
+        int source_dim_count = dep.map.get_space().dimension(isl::space::input);
+        auto source = space(isl::space::variable, 0);
+        auto sink = space(isl::space::variable, source_dim_count);
+        auto max = pairs.maximum(source * isl::value(m_model.context, rates[dep.source]) -
+                                 sink * isl::value(m_model.context, rates[dep.sink]));
+        if (max.is_infinity())
+            return false;
+        int64_t distance = int64_t(max.integer());
+        if (dep.source >= dep.sink)
+            distance += 1;
+        distances.push_back(distance);
+    }
+
+    offsets.assign(statements.size(), 0);
+
+    bool changed = true;
+    for (int i = 0; changed; ++i)
+    {
+        if (i > (int) statements.size())
+        {
+            if (verbose<scheduler>::enabled())
+                cout << "Cyclic dependencies between statements"
+                     << " without a periodic order." << endl;
+            return false;
+        }
+
+        changed = false;
+        for (int d = 0; d < (int) deps.size(); ++d)
+        {
+            auto & dep = deps[d];
+            int64_t offset = offsets[dep.source] + distances[d];
+            if (offsets[dep.sink] < offset)
+            {
+                offsets[dep.sink] = offset;
+                changed = true;
+            }
+        }
+    }
+
+    int64_t min_offset = *std::min_element(offsets.begin(), offsets.end());
+    for (auto & offset : offsets)
+        offset -= min_offset;
+
+    if (verbose<scheduler>::enabled())
+    {
+        cout << "Periodic timing of statements:" << endl;
+        for (int k = 0; k < (int) statements.size(); ++k)
+            cout << "  " << statements[k]->name << ": "
+                 << rates[k] << " * i0 + " << offsets[k] << endl;
+    }
+
+    return true;
+}
+
 isl::union_map
 scheduler::make_proximity_dependencies(const isl::union_map & dependencies)
 {
@@ -639,11 +1072,56 @@ scheduler::make_periodic_schedule(polyhedral::schedule & sched, const options &
     }
     else
     {
+        // Tile finite schedule
+
+        if (!opt.tile_size.empty())
+        {
+            tile_finite_bands(root, opt);
+
+            sched.tree = isl_schedule_node_get_schedule(root.get());
+            sched.full = sched.tree.map_on_domain();
+
+            if (verbose<scheduler>::enabled())
+            {
+                cout << endl << "Tiled schedule:" << endl;
+                m_printer.print(sched.tree);
+                cout << endl;
+                m_printer.print_each_in(sched.full);
+            }
+        }
+
         sched.prelude_tree = sched.tree;
         sched.prelude = sched.tiled = sched.full;
     }
 }
 
+// Tiles the band at 'node', or the bands in each element
+// of a sequence at 'node'.
+// After this, 'node' still points at the same position in the tree.
+void scheduler::tile_finite_bands(isl::schedule_node & node, const options & opt)
+{
+    if (node.type() == isl_schedule_node_band)
+    {
+        tile(node, opt);
+    }
+    else if (node.type() == isl_schedule_node_sequence)
+    {
+        int elem_count = node.child_count();
+        for (int i = 0; i < elem_count; ++i)
+        {
+            node.to_child(i);
+            if (node.child_count())
+            {
+                node.to_child(0);
+                if (node.type() == isl_schedule_node_band)
+                    tile(node, opt);
+                node.to_parent();
+            }
+            node.to_parent();
+        }
+    }
+}
+
 // Modifies 'node' to represent the schedule of tiles,
 // while inserting a new child node representing the intra-tile schedule.
 void scheduler::tile(isl::schedule_node & node, const options & opt)
@@ -81,12 +81,20 @@ public:
         vector<int> periodic_tile_direction;
         int period_offset = 0; // time steps beyond minimum offset
         int period_scale = 1; // number of minimum period durations
+        // Maximum isl operations for each scheduling attempt (0 = no limit).
+        unsigned long max_operations = 0;
+        // Use the Feautrier scheduling algorithm.
+        bool greedy = false;
     };
 
     scheduler( model & m );
 
     polyhedral::schedule schedule(const options &);
 
+    // Description of the simpler scheduling strategy used
+    // when the isl operation limit was exceeded, or empty.
+    const string & fallback() const { return m_fallback; }
+
 private:
 
     struct data
@@ -130,6 +138,15 @@ private:
                                 const isl::union_map & order,
                                 const options &);
 
+    isl::schedule make_schedule_with_fallbacks(const options &);
+
+    isl::schedule make_sequential_schedule();
+
+    bool find_periodic_timing(const vector<stmt_ptr> & statements,
+                              const isl::union_map & dependencies,
+                              vector<int64_t> & rates,
+                              vector<int64_t> & offsets);
+
     isl::union_map make_proximity_dependencies(const isl::union_map & dependencies);
 
     void make_periodic_schedule(polyhedral::schedule &, const options &);
@@ -151,6 +168,8 @@ private:
 
     void tile(isl::schedule_node &, const options &);
 
+    void tile_finite_bands(isl::schedule_node &, const options &);
+
     void ensure_tile_parallelism(isl::schedule_node &, const options &);
 
     void permute_dimensions(isl::schedule_node &, const vector<int> & permutation);
@@ -173,6 +192,7 @@ private:
 
     model & m_model;
     model_summary m_model_summary;
+    string m_fallback;
 };
 
 }
@@ -19,6 +19,7 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "storage_alloc.hpp"
+#include "utility.hpp"
 
 #include <isl-cpp/space.hpp>
 #include <isl-cpp/set.hpp>
@@ -27,17 +28,26 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <stdexcept>
 #include <sstream>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <cstdlib>
+#include <algorithm>
 
 using namespace std;
 
 namespace stream {
 namespace polyhedral {
 
-storage_allocator::storage_allocator( model & m, bool classic):
+storage_allocator::storage_allocator( model & m, bool classic,
+                                      unsigned long max_operations,
+                                      int jobs ):
     m_model(m),
     m_model_summary(m),
     m_printer(m.context),
-    m_classic(classic)
+    m_classic(classic),
+    m_max_operations(max_operations),
+    m_jobs(jobs)
 {
 
 }
@@ -46,23 +56,168 @@ void storage_allocator::allocate(const polyhedral::schedule & schedule)
 {
     using namespace isl;
 
+    access_data data;
+    data.schedule = schedule.tiled;
+    data.write_relations = m_model_summary.write_relations.in_domain(m_model_summary.domains);
+    data.read_relations = m_model_summary.read_relations.in_domain(m_model_summary.domains);
+    data.parallel_accesses = m_model.parallel_accesses;
+
+    if (m_jobs > 1 && m_model.arrays.size() > 1 &&
+            !verbose<storage_allocator>::enabled())
+    {
+        compute_buffer_sizes_in_parallel(data);
+    }
+    else
+    {
+        for (auto & array : m_model.arrays)
+        {
+            if (verbose<storage_allocator>::enabled())
+            {
+                cout << endl << "== Array " << array->name << endl;
+            }
+
+            compute_buffer_size_with_fallbacks(data, array, array->domain);
+        }
+    }
 
     for (auto & array : m_model.arrays)
     {
-        if (verbose<storage_allocator>::enabled())
+        find_inter_period_dependency(schedule, array);
+    }
+}
+
+// Computes buffer sizes of different arrays concurrently.
+// isl contexts are not thread-safe, so each worker uses its own
+// context, with input data transferred in text form.
+
+void storage_allocator::compute_buffer_sizes_in_parallel(const access_data & data)
+{
+    unordered_map<string,string> names;
+    for (int i = 0; i < (int) m_model.statements.size(); ++i)
+        names.emplace(m_model.statements[i]->name, "S" + to_string(i));
+    for (int i = 0; i < (int) m_model.arrays.size(); ++i)
+        names.emplace(m_model.arrays[i]->name, "A" + to_string(i));
+    // Constant arrays are read, but have no buffers.
+    for (int i = 0; i < (int) m_model.constant_arrays.size(); ++i)
+        names.emplace(m_model.constant_arrays[i]->name, "C" + to_string(i));
+
+    string schedule_text = arrp::to_text(arrp::renamed_tuples(data.schedule, names));
+    string write_text = arrp::to_text(arrp::renamed_tuples(data.write_relations, names));
+    string read_text = arrp::to_text(arrp::renamed_tuples(data.read_relations, names));
+    string parallel_text = arrp::to_text(arrp::renamed_tuples(data.parallel_accesses, names));
+
+    vector<string> domain_texts;
+    for (auto & array : m_model.arrays)
+    {
+        isl::set domain = isl_set_set_tuple_name(array->domain.copy(),
+                                                 names.at(array->name).c_str());
+        char * text = isl_set_to_str(domain.get());
+        domain_texts.emplace_back(text);
+        free(text);
+    }
+
+    int array_count = m_model.arrays.size();
+    int worker_count = std::min(m_jobs, array_count);
+
+    std::atomic<int> next_array { 0 };
+    vector<std::exception_ptr> errors(worker_count);
+    vector<std::thread> workers;
+
+    for (int w = 0; w < worker_count; ++w)
+    {
+        workers.emplace_back([&, w]()
         {
-            cout << endl << "== Array " << array->name << endl;
+            try
+            {
+                isl::context ctx;
+                ctx.set_error_action(isl::context::abort_on_error);
+
+                access_data local;
+                local.schedule = isl_union_map_read_from_str(ctx.get(), schedule_text.c_str());
+                local.write_relations = isl_union_map_read_from_str(ctx.get(), write_text.c_str());
+                local.read_relations = isl_union_map_read_from_str(ctx.get(), read_text.c_str());
+                local.parallel_accesses = isl_union_map_read_from_str(ctx.get(), parallel_text.c_str());
+
+                int i;
+                while((i = next_array++) < array_count)
+                {
+                    isl::set domain = isl_set_read_from_str(ctx.get(), domain_texts[i].c_str());
+                    compute_buffer_size_with_fallbacks(local, m_model.arrays[i], domain);
+                }
+            }
+            catch (...)
+            {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+
+    for (auto & worker : workers)
+        worker.join();
+
+    for (auto & e : errors)
+    {
+        if (e)
+            std::rethrow_exception(e);
+    }
+}
+
+// Computes buffer size with a limited number of isl operations.
+// If the limit is exceeded, uses classic allocation instead,
+// and if that also exceeds the limit, stores entire finite arrays.
+
+void storage_allocator::compute_buffer_size_with_fallbacks
+( const access_data & data,
+  const array_ptr & array,
+  const isl::set & array_domain )
+{
+    auto attempt = [&](bool classic) -> bool
+    {
+        arrp::isl_operation_budget budget(array_domain.ctx().get(), m_max_operations);
+        try
+        {
+            compute_buffer_size(data, array, array_domain, classic);
         }
+        catch (error &)
+        {
+            if (!budget.exceeded())
+                throw;
+        }
+        return !budget.exceeded();
+    };
 
-        compute_buffer_size(schedule, array);
+    if (attempt(m_classic))
+        return;
 
-        find_inter_period_dependency(schedule, array);
+    if (!m_classic)
+    {
+        add_fallback(array->name, "classic");
+
+        if (attempt(true))
+            return;
     }
+
+    if (array->is_infinite)
+    {
+        throw error("Storage allocation for array " + array->name
+                    + " exceeded the isl operation limit.");
+    }
+
+    add_fallback(array->name, "entire array");
+    array->buffer_size = array->size;
+}
+
+void storage_allocator::add_fallback(const string & array_name, const string & method)
+{
+    std::lock_guard<std::mutex> lock(m_fallbacks_mutex);
+    m_fallbacks[array_name] = method;
 }
 
 void storage_allocator::compute_buffer_size
-( const polyhedral::schedule & schedule,
-  const array_ptr & array )
+( const access_data & data,
+  const array_ptr & array,
+  const isl::set & array_domain,
+  bool classic )
 {
     if (verbose<storage_allocator>::enabled())
     {
@@ -73,27 +228,24 @@ void storage_allocator::compute_buffer_size
     using isl::expression;
 
     isl::space sched_space(nullptr);
-    schedule.tiled.for_each([&](const isl::map & m){
+    data.schedule.for_each([&](const isl::map & m){
         sched_space = m.get_space().range();
         return false;
     });
 
-    auto array_space = array->domain.get_space();
+    auto array_space = array_domain.get_space();
 
     auto array_sched_space = isl::space::from(array_space, sched_space);
 
-    // Filter and map writers and readers
-
-    auto write_relations = m_model_summary.write_relations.in_domain(m_model_summary.domains);
-    auto read_relations = m_model_summary.read_relations.in_domain(m_model_summary.domains);
+    // Map writers and readers
 
-    auto all_write_sched = schedule.tiled;
-    all_write_sched.map_domain_through(write_relations);
-    auto write_sched = all_write_sched.map_for(array_sched_space).in_domain(array->domain);
+    auto all_write_sched = data.schedule;
+    all_write_sched.map_domain_through(data.write_relations);
+    auto write_sched = all_write_sched.map_for(array_sched_space).in_domain(array_domain);
 
-    auto all_read_sched = schedule.tiled;
-    all_read_sched.map_domain_through(read_relations);
-    auto read_sched = all_read_sched.map_for(array_sched_space).in_domain(array->domain);
+    auto all_read_sched = data.schedule;
+    all_read_sched.map_domain_through(data.read_relations);
+    auto read_sched = all_read_sched.map_for(array_sched_space).in_domain(array_domain);
 
     if (verbose<storage_allocator>::enabled())
     {
@@ -144,7 +296,7 @@ void storage_allocator::compute_buffer_size
     //cout << "Num access schedule sets: " << isl_map_n_basic_map(access_sched.get()) << endl;
 
     int buffer_dim_count = array_space.dimension(isl::space::variable);
-    array->buffer_size = vector<int>(buffer_dim_count, 1);
+    vector<int> buffer_size(buffer_dim_count, 1);
 
     // Read-write conflicts
     auto conflicts = compute_conflicts(write_sched, read_sched, order_less_than(sched_space));
@@ -155,7 +307,7 @@ void storage_allocator::compute_buffer_size
     conflicts |= read_sched.cross(read_sched).in_range(equal_time.wrapped()).domain().unwrapped();
 
     // Parallel conflicts
-    auto parallel_conflicts = m_model.parallel_accesses.map_for(conflicts.get_space());
+    auto parallel_conflicts = data.parallel_accesses.map_for(conflicts.get_space());
 
     if (verbose<storage_allocator>::enabled())
     {
@@ -164,7 +316,9 @@ void storage_allocator::compute_buffer_size
 
     conflicts |= parallel_conflicts;
 
-    compute_buffer_size_from_conflicts(conflicts, array->buffer_size);
+    compute_buffer_size_from_conflicts(conflicts, buffer_size, classic);
+
+    array->buffer_size = buffer_size;
 }
 
 /*
@@ -299,7 +453,7 @@ isl::set absolute_values(const isl::set & set)
 }
 
 void storage_allocator::compute_buffer_size_from_conflicts
-( const isl::map & conflicts, vector<int> & buffer_size )
+( const isl::map & conflicts, vector<int> & buffer_size, bool classic )
 {
     if (conflicts.is_empty())
     {
@@ -324,7 +478,7 @@ void storage_allocator::compute_buffer_size_from_conflicts
 
         deltas = absolute_values(deltas);
 
-        if (!m_classic)
+        if (!classic)
         {
 
         // For each dimension, find out the conflicts that can only be satisfied
@@ -26,21 +26,52 @@ along with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <isl-cpp/printer.hpp>
 
+#include <mutex>
+
 namespace stream {
 namespace polyhedral {
 
 class storage_allocator
 {
 public:
-    storage_allocator( model &, bool m_classic = false );
+    // Buffer sizes of different arrays are computed
+    // concurrently by given number of jobs.
+    storage_allocator( model &, bool m_classic = false,
+                       unsigned long max_operations = 0,
+                       int jobs = 1 );
 
     void allocate(const schedule &);
 
+    // Fallback allocation methods used for arrays
+    // when the isl operation limit was exceeded.
+    const unordered_map<string, string> & fallbacks() const { return m_fallbacks; }
+
 private:
 
+    // Schedule and access relations,
+    // in the context used to compute buffer sizes.
+    struct access_data
+    {
+        isl::union_map schedule { nullptr };
+        isl::union_map write_relations { nullptr };
+        isl::union_map read_relations { nullptr };
+        isl::union_map parallel_accesses { nullptr };
+    };
+
+    void compute_buffer_sizes_in_parallel(const access_data &);
+
+    void compute_buffer_size_with_fallbacks
+    ( const access_data &,
+      const array_ptr & array,
+      const isl::set & array_domain );
+
     void compute_buffer_size
-    ( const schedule &,
-      const array_ptr & array );
+    ( const access_data &,
+      const array_ptr & array,
+      const isl::set & array_domain,
+      bool classic );
+
+    void add_fallback(const string & array_name, const string & method);
 
     isl::map compute_conflicts
     (const isl::map & write_schedule,
@@ -48,7 +79,7 @@ private:
      const isl::map & order_relation);
 
     void compute_buffer_size_from_conflicts
-    ( const isl::map & conflict_set, vector<int> & buffer_size );
+    ( const isl::map & conflict_set, vector<int> & buffer_size, bool classic );
 
     void find_inter_period_dependency
     ( const schedule &,
@@ -59,6 +90,10 @@ private:
     isl::printer m_printer;
 
     bool m_classic = false;
+    unsigned long m_max_operations = 0;
+    int m_jobs = 1;
+    unordered_map<string, string> m_fallbacks;
+    std::mutex m_fallbacks_mutex;
 };
 
 struct storage_output {};
@@ -1,7 +1,9 @@
 #include "utility.hpp"
 #include "../common/error.hpp"
 #include <isl-cpp/printer.hpp>
+#include <isl/options.h>
 #include <iostream>
+#include <cstdlib>
 
 using namespace std;
 
@@ -167,4 +169,65 @@ ivector find_single_ray(const isl::basic_set & set, bool * tell_has_rays)
     return ray;
 }
 
+isl_operation_budget::isl_operation_budget(isl_ctx * ctx, unsigned long max_operations):
+    m_ctx(ctx),
+    m_max_operations(max_operations)
+{
+    if (!m_max_operations)
+        return;
+
+    m_on_error = isl_options_get_on_error(m_ctx);
+    isl_options_set_on_error(m_ctx, ISL_ON_ERROR_CONTINUE);
+    isl_ctx_reset_error(m_ctx);
+    isl_ctx_set_max_operations(m_ctx, m_max_operations);
+    isl_ctx_reset_operations(m_ctx);
+}
+
+isl_operation_budget::~isl_operation_budget()
+{
+    if (!m_max_operations)
+        return;
+
+    isl_ctx_set_max_operations(m_ctx, 0);
+    isl_ctx_reset_operations(m_ctx);
+    isl_ctx_reset_error(m_ctx);
+    isl_options_set_on_error(m_ctx, m_on_error);
+}
+
+bool isl_operation_budget::exceeded() const
+{
+    return m_max_operations && isl_ctx_last_error(m_ctx) == isl_error_quota;
+}
+
+isl::union_map renamed_tuples(const isl::union_map & umap,
+                              const std::unordered_map<string,string> & names)
+{
+    isl::union_map result(umap.ctx());
+
+    umap.for_each([&](const isl::map & m){
+        isl_map * r = m.copy();
+        for (auto type : { isl_dim_in, isl_dim_out })
+        {
+            if (!isl_map_has_tuple_name(r, type))
+                continue;
+            string old_name = isl_map_get_tuple_name(r, type);
+            auto name = names.find(old_name);
+            if (name != names.end())
+                r = isl_map_set_tuple_name(r, type, name->second.c_str());
+        }
+        result |= isl::map(r);
+        return true;
+    });
+
+    return result;
+}
+
+string to_text(const isl::union_map & umap)
+{
+    char * text = isl_union_map_to_str(umap.get());
+    string result(text);
+    free(text);
+    return result;
+}
+
 }
@@ -1,14 +1,47 @@
 
 #include <isl-cpp/set.hpp>
+#include <isl-cpp/map.hpp>
+#include <isl/ctx.h>
 #include <vector>
+#include <string>
+#include <unordered_map>
 
 namespace arrp
 {
 using std::vector;
 using ivector = std::vector<int>;
+using std::string;
 
 void find_rays(const isl::basic_set &, vector<ivector> & rays);
 
 ivector find_single_ray(const isl::basic_set &, bool * has_rays = nullptr);
 
+// Limits the number of isl operations while in scope.
+// When the limit is reached, isl operations fail and return null,
+// rather than aborting, and exceeded() returns true.
+// A limit of zero means no limit.
+
+class isl_operation_budget
+{
+public:
+    isl_operation_budget(isl_ctx *, unsigned long max_operations);
+    ~isl_operation_budget();
+
+    bool exceeded() const;
+
+private:
+    isl_ctx * m_ctx;
+    unsigned long m_max_operations;
+    int m_on_error;
+};
+
+// Renames tuples, so that the text form of isl objects can be parsed,
+// for example to transfer them to another isl context.
+// Array and statement names may contain characters not accepted by isl.
+
+isl::union_map renamed_tuples(const isl::union_map &,
+                              const std::unordered_map<string,string> & names);
+
+string to_text(const isl::union_map &);
+
 }
@@ -0,0 +1,38 @@
+# Building and running programs with the stdio interface,
+# shared by the comparison and benchmark scripts.
+#
+# Uses the environment variables ARRP_INSTALL_DIR and CXX,
+# like compile_and_evaluate.sh.
+
+import os
+import json
+import subprocess
+from pathlib import Path
+
+install_dir = os.environ.get('ARRP_INSTALL_DIR', '/usr/local')
+cxx = os.environ.get('CXX', 'c++')
+arrp = str(Path(install_dir) / 'bin' / 'arrp')
+
+type_sizes = {
+    'bool': 1,
+    'int8': 1, 'uint8': 1,
+    'int16': 2, 'uint16': 2,
+    'int32': 4, 'uint32': 4,
+    'int64': 8, 'uint64': 8,
+    'real32': 4, 'real64': 8,
+    'complex32': 8, 'complex64': 16
+}
+
+def run(cmd):
+    subprocess.run(cmd, shell=True, check=True)
+
+# Compiles source into program 'name' in the current directory
+# and returns the compiler report.
+def build(source, name, options, cxx_options):
+    report = name + '.report.json'
+    run('"{}" "{}" --interface stdio --report "{}" --output "{}" {}'
+        .format(arrp, source, report, name, options))
+    run('"{}" -std=c++17 {} "{}-stdio-main.cpp" -I. "-I{}/include" -o "{}"'
+        .format(cxx, cxx_options, name, install_dir, name))
+    with open(report, 'r') as f:
+        return json.load(f)
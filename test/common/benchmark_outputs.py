@@ -0,0 +1,85 @@
+#! /usr/bin/env python3
+
+# Measures the time of programs compiled with --output-selection
+# when only some outputs are active. For each source, the program is run
+# with the first 1, 2, ..., N outputs active, producing the same amount of
+# the first output, and the time is reported relative to all outputs.
+#
+# Uses the environment variables ARRP_INSTALL_DIR and CXX,
+# like compile_and_evaluate.sh.
+
+import os
+import json
+import time
+import argparse
+import tempfile
+from pathlib import Path
+
+from arrp_build import type_sizes, run, build
+
+parser = argparse.ArgumentParser()
+parser.add_argument('sources', nargs='+')
+parser.add_argument('--bench-count', type=int, default=100000,
+                    help='Number of values of the first output to produce.')
+parser.add_argument('--compile-options', default='')
+parser.add_argument('--cxx-options', default='-O3')
+parser.add_argument('--json', help='Write results to this file.')
+args = parser.parse_args()
+
+def output_time(name, outputs, active_count, count):
+    first = outputs[0]
+    size = type_sizes[first['type']] * first.get('size', 1)
+    active = [o['name'] for o in outputs[:active_count]]
+    destinations = ' '.join('{}=/dev/null:raw'.format(n) for n in active[1:])
+    cmd = './{} --outputs={} {}=pipe:raw {} | head -c {} > /dev/null'.format(
+        name, ','.join(active), first['name'], destinations, count * size)
+    start = time.perf_counter()
+    run(cmd)
+    return time.perf_counter() - start
+
+def measure(source):
+    source = str(Path(source).resolve())
+    name = 'program'
+
+    report = build(source, name, '--output-selection ' + args.compile_options,
+                   args.cxx_options)
+    outputs = report['outputs']
+    if not outputs:
+        raise Exception('No outputs.')
+
+    times = [output_time(name, outputs, n, args.bench_count)
+             for n in range(1, len(outputs) + 1)]
+
+    return {
+        'outputs': [o['name'] for o in outputs],
+        'guarded-statements': len(report.get('output_selection', {})),
+        'time': times,
+        'relative-time': [t / times[-1] if times[-1] > 0 else None for t in times]
+    }
+
+results = {}
+failed = False
+
+for source in args.sources:
+    with tempfile.TemporaryDirectory() as work_dir:
+        cwd = os.getcwd()
+        os.chdir(work_dir)
+        try:
+            result = measure(source)
+            results[source] = result
+            print('{}:'.format(source))
+            for n, t in enumerate(result['time']):
+                print('  {} active output(s): {:.3f} s ({:.2f})'
+                      .format(n + 1, t, result['relative-time'][n] or 0))
+        except Exception as e:
+            print('{}: failed: {}'.format(source, e))
+            failed = True
+        finally:
+            os.chdir(cwd)
+
+if args.json:
+    with open(args.json, 'w') as f:
+        json.dump(results, f, indent=2)
+
+if failed:
+    exit(1)
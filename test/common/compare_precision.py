@@ -0,0 +1,109 @@
+#! /usr/bin/env python3
+
+# Compares programs compiled with and without additional variant options
+# (--single-precision by default, or e.g. --fast-math <level> or --dispatch <isa>).
+# For each source, reports the maximum and RMS difference of the first
+# output values and the speedup of producing a larger amount of output.
+#
+# Uses the environment variables ARRP_INSTALL_DIR and CXX,
+# like compile_and_evaluate.sh.
+
+import os
+import re
+import json
+import math
+import time
+import argparse
+import tempfile
+import subprocess
+from pathlib import Path
+
+from arrp_build import type_sizes, run, build
+
+parser = argparse.ArgumentParser()
+parser.add_argument('sources', nargs='+')
+parser.add_argument('--count', type=int, default=1000,
+                    help='Number of output values to compare.')
+parser.add_argument('--bench-count', type=int, default=10000000,
+                    help='Number of output values to produce when measuring time.')
+parser.add_argument('--compile-options', default='')
+parser.add_argument('--variant-options', default='--single-precision',
+                    help='Compile options of the variant compared to the reference.')
+parser.add_argument('--cxx-options', default='-O3')
+parser.add_argument('--json', help='Write results to this file.')
+args = parser.parse_args()
+
+number = re.compile(r'[-+]?(?:\d+\.?\d*|\.\d+)(?:[eE][-+]?\d+)?|[-+]?(?:inf|nan)')
+
+def output_values(name, count):
+    cmd = './{} -f text | head -n {}'.format(name, count)
+    result = subprocess.run(cmd, shell=True, stdout=subprocess.PIPE, universal_newlines=True)
+    values = [float(v) for v in number.findall(result.stdout)]
+    return values[:count]
+
+def output_time(name, report, count):
+    output = report['outputs'][0]
+    size = type_sizes[output['type']]
+    cmd = './{} -f raw | head -c {} > /dev/null'.format(name, count * size)
+    start = time.perf_counter()
+    run(cmd)
+    return time.perf_counter() - start
+
+def compare(source):
+    source = str(Path(source).resolve())
+    reference = 'reference'
+    variant = 'variant'
+
+    reference_report = build(source, reference, args.compile_options, args.cxx_options)
+    variant_report = build(source, variant, args.compile_options + ' ' + args.variant_options,
+                           args.cxx_options)
+
+    a = output_values(reference, args.count)
+    b = output_values(variant, args.count)
+
+    count = min(len(a), len(b))
+    if count == 0:
+        raise Exception('No output values.')
+
+    errors = [abs(a[i] - b[i]) for i in range(count)]
+    max_error = max(errors)
+    rms_error = math.sqrt(sum(e * e for e in errors) / count)
+
+    reference_time = output_time(reference, reference_report, args.bench_count)
+    variant_time = output_time(variant, variant_report, args.bench_count)
+
+    return {
+        'variant-options': args.variant_options,
+        'compared-values': count,
+        'max-error': max_error,
+        'rms-error': rms_error,
+        'time-reference': reference_time,
+        'time-variant': variant_time,
+        'speedup': reference_time / variant_time if variant_time > 0 else None
+    }
+
+results = {}
+failed = False
+
+for source in args.sources:
+    with tempfile.TemporaryDirectory() as work_dir:
+        cwd = os.getcwd()
+        os.chdir(work_dir)
+        try:
+            result = compare(source)
+            results[source] = result
+            print('{}: max error {:.3g}, RMS error {:.3g}, speedup {:.2f}'
+                  .format(source, result['max-error'], result['rms-error'],
+                          result['speedup'] or 0))
+        except Exception as e:
+            print('{}: failed: {}'.format(source, e))
+            failed = True
+        finally:
+            os.chdir(cwd)
+
+if args.json:
+    with open(args.json, 'w') as f:
+        json.dump(results, f, indent=2)
+
+if failed:
+    exit(1)
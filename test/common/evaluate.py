@@ -1,6 +1,7 @@
 #! /usr/bin/env python3
 
 import sys
+import math
 import json
 from pathlib import Path;
 import argparse
@@ -11,6 +12,9 @@ parser.add_argument('source')
 parser.add_argument('report')
 parser.add_argument('--program')
 parser.add_argument('--program-options')
+parser.add_argument('--expect-report', default='',
+                    help='Expected values in the report, as space-separated'
+                         ' <key>.<key>...=<json value>.')
 args = parser.parse_args()
 
 # Parse report
@@ -21,6 +25,25 @@ def read_report(path):
 
 report = read_report(args.report)
 
+# Compare expected report values
+
+def report_value(path):
+    value = report
+    for key in path.split('.'):
+        if not isinstance(value, dict) or key not in value:
+            return None
+        value = value[key]
+    return value
+
+for expectation in args.expect_report.split():
+    path, expected_text = expectation.split('=', 1)
+    expected = json.loads(expected_text)
+    actual = report_value(path)
+    if actual != expected:
+        print("Report {} = {} (Error: Expected {}).".format(path, json.dumps(actual), expected_text))
+        exit(1)
+    print("Report {} = {} OK.".format(path, expected_text))
+
 # Parse source
 
 source = open(args.source, 'r')
@@ -120,9 +143,16 @@ if len(actual_values) < len(values):
           " output elements but got only " + str(len(actual_values)))
     exit(1)
 
+def value_matches(expected, actual):
+    if math.isnan(expected):
+        return math.isnan(actual)
+    if math.isinf(expected):
+        return expected == actual
+    return abs(expected - actual) <= 0.001
+
 values_ok = True
 for i in range(0,len(values)):
-    if abs(values[i] - actual_values[i]) > 0.001:
+    if not value_matches(values[i], actual_values[i]):
         print("Output[{}] = {:.3f} (Error: Expected {:.3f}).".format(i, actual_values[i], values[i]))
         values_ok = False
     else:
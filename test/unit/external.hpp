@@ -1,15 +1,12 @@
 
-#include <io.hpp>
-
-namespace test { struct traits; }
+// External functions for the stdio interface,
+// used with --stdio-externals.
 
 namespace arrp {
-namespace testing {
+namespace generic_io {
 
-template<>
-class io<test::traits>
+struct External_Functions
 {
-public:
     void f(int in[4], int out[2])
     {
         out[0] = in[0] + in[1];
@@ -39,6 +36,13 @@ public:
             out[i] = in / double(i+1);
         }
     }
+
+    // Batched with --batch-external f4
+    void f4(const int * in, double * out, int count)
+    {
+        for(int i = 0; i < count; ++i)
+            out[i] = double(in[i]) / 2;
+    }
 };
 
 }
@@ -224,6 +224,9 @@ void func_signature::generate(cpp_gen::state & state, ostream & stream)
     if (inlining == explicit_inline)
         stream << "inline ";
 
+    if (!attribute.empty())
+        stream << attribute << ' ';
+
     type->generate(state, stream);
 
     if (!name.empty())
@@ -383,6 +383,8 @@ public:
     {}
 
     inline_mode inlining = default_inline;
+    // Printed before the return type, e.g. a compiler-specific attribute.
+    string attribute;
     string name;
     type_ptr type;
     vector<string> template_parameters;
@@ -10,6 +10,8 @@ struct platform
 {
     virtual string executable_path() { return string(); }
     virtual string builtin_import_path() { return string(); }
+    // Peak resident memory of this process in kilobytes, or -1 if unknown.
+    virtual long peak_memory_usage() { return -1; }
 };
 
 platform * get_platform();
@@ -1,5 +1,6 @@
 #include "platform.hpp"
 #include "../common/error.hpp"
+#include <sys/resource.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -28,6 +29,7 @@ class linux_platform : public platform
 {
     string executable_path() override;
     string builtin_import_path() override;
+    long peak_memory_usage() override;
 };
 
 platform * get_platform()
@@ -64,4 +66,13 @@ string linux_platform::builtin_import_path()
     return exe_path + "/../lib/arrp/library";
 }
 
+long linux_platform::peak_memory_usage()
+{
+    // ru_maxrss is in kilobytes on this platform.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return usage.ru_maxrss;
+}
+
 }
@@ -1,5 +1,6 @@
 #include "platform.hpp"
 #include "../common/error.hpp"
+#include <sys/resource.h>
 #include <mach-o/dyld.h>
 
 #include <vector>
@@ -27,6 +28,7 @@ class macos_platform : public platform
 {
     string executable_path() override;
     string builtin_import_path() override;
+    long peak_memory_usage() override;
 };
 
 platform * get_platform()
@@ -69,4 +71,13 @@ string macos_platform::builtin_import_path()
     return exe_path + "/../lib/arrp/library";
 }
 
+long macos_platform::peak_memory_usage()
+{
+    // ru_maxrss is in bytes on this platform.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return usage.ru_maxrss / 1024;
+}
+
 }